@@ -1057,7 +1057,16 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   ("TileColumnWidthArray",                            cfg_ColumnWidth,                        cfg_ColumnWidth, "Array containing tile column width values in units of CTU")
   ("TileRowHeightArray",                              cfg_RowHeight,                            cfg_RowHeight, "Array containing tile row height values in units of CTU")
   ("LFCrossTileBoundaryFlag",                         m_bLFCrossTileBoundaryFlag,                        true, "1: cross-tile-boundary loop filtering. 0:non-cross-tile-boundary loop filtering")
+#if TILE_PARALLEL_ENCODING
+  ("TileThreads",                                     m_iTileThreads,                                       1, "Number of threads compressing and entropy coding the tiles of a slice, 1: serial")
+#endif
   ("WaveFrontSynchro",                                m_entropyCodingSyncEnabledFlag,                   false, "0: entropy coding sync disabled; 1 entropy coding sync enabled")
+#if WPP_PARALLEL_ENCODING
+  ("WaveFrontThreads",                                m_iWaveFrontThreads,                                  1, "Number of threads compressing the CTU rows of a wavefront slice, 1: serial")
+#endif
+#if FRAME_PARALLEL_ENCODING
+  ("FrameThreads",                                    m_iFrameThreads,                                      1, "Number of threads compressing consecutive pictures that do not reference each other, 1: serial")
+#endif
   ("ScalingList",                                     m_useScalingListId,                    SCALING_LIST_OFF, "0/off: no scaling list, 1/default: default scaling lists, 2/file: scaling lists specified in ScalingListFile")
   ("ScalingListFile",                                 m_scalingListFileName,                       string(""), "Scaling list file name. Use an empty string to produce help.")
   ("SignHideFlag,-SBH",                               m_signHideFlag,                                    true)
@@ -1254,6 +1263,37 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   ("InterpolationMethodC,-interpC",              m_inputGeoParam.iInterp[CHANNEL_TYPE_CHROMA], (Int)SI_LANCZOS2,            "Interpolation method for chroma, 0: default setting(lanczos2); 1:NN, 2: bilinear, 3: bicubic, 4: lanczos2, 5: lanczos3")
   ("ResampleChroma,-rc",                         m_inputGeoParam.bResampleChroma,     false,                                "ResampleChroma indiates to do conversion with aligned phase with luma")
   ("ChromaSampleLocType,-csl",                   m_inputGeoParam.iChromaSampleLocType, 2,                                   "Chroma sample location type relative to luma, 0: 0.5 shift in vertical direction; 1: 0.5 shift in both directions, 2: aligned with luma (default setting), 3: 0.5 shift in horizontal direction")
+#if SVIDEO_MT_GEOCONVERT
+  ("GeoConvertThreads",                          m_iGeoConvertThreads,                1,                                    "Number of threads for geometry conversion and sphere padding, 1: serial")
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  ("PackedResampleMap",                          m_bPackedResampleMap,                false,                                "Use the packed resampling map with 1/16 phase precision for geometry conversion (not bit-exact with the default map)")
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+  ("SeparableResample",                          m_bSeparableResample,                false,                                "Use separable horizontal/vertical filtering for ERP to ERP and EAP to EAP conversion without rotation (not bit-exact with the default map)")
+#endif
+#if SVIDEO_BATCH_MAPPING
+  ("FastProjectionMath",                         m_bFastProjectionMath,               false,                                "Use polynomial approximations of the trigonometric functions in the ERP/EAP/CPP projections (not bit-exact with the default)")
+#endif
+#if SVIDEO_GEOMAP_CACHE
+  ("GeoMapCacheDir",                             m_geoMapCacheDir,                    string(""),                           "Directory to load/store the geometry mapping tables, empty: no cache")
+#endif
+#if SVIDEO_ASYNC_METRICS
+  ("SphMetricThreads",                           m_iSphMetricThreads,                 0,                                    "Number of threads for the spherical metrics on a background thread, 0: computed on the encoding thread. "
+                                                                                                                            "When >0 the per-frame spherical metrics are not on the frame summary line but on a later line \"POC <n> [metrics]\" in coding order")
+#endif
+#if SVIDEO_MMAP_YUV_READER
+  ("MemoryMappedInput",                          m_iMemoryMappedInput,                0,                                    "Read the input YUV files through a memory map, 0: stream, 1: memory map, 2: memory map with read-ahead of the next frame")
+#endif
+#if SVIDEO_FUSED_YUV_WRITE
+  ("AsyncOutputWrite",                           m_bAsyncOutputWrite,                 false,                                "Write the reconstructed YUV file on a background thread")
+#endif
+#if SVIDEO_FACE_TILES
+  ("SVideoFaceTiles",                            m_bSVideoFaceTiles,                  false,                                "Use one tile per face of the coding frame packing structure (overrides the tile settings)")
+#endif
+#if SVIDEO_FUSED_METRICS
+  ("FusedMetrics",                               m_bFusedMetrics,                     false,                                "Compute PSNR, WS-PSNR and S-PSNR-NN in one pass over the original and reconstructed pictures")
+#endif
 #if SVIDEO_VIEWPORT_PSNR
   ("ViewPortPSNREnable,-vppsnr",           m_viewPortPSNRParam.bViewPortPSNREnabled,       true,               "Flag to enable viewport PSNR calculation")  
   ("ViewPortList",                               m_viewPortPSNRParam.viewPortSettingsList,              defViewPortLists,   "Viewport settings list for static viewport PSNR calculation") 
@@ -1264,7 +1304,7 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   ("SPSNR_NN,-spsnr_nn",                   m_bSPSNRNNEnabled,                            true,  "Flag to enable spsnr calculation")
 #endif
 #if SVIDEO_SPSNR_NN || SVIDEO_SPSNR_I
-  ("SphFile,s",                                  cfg_SphFile,                                           string(""),         "Spherical points data file name for S-PSNR calculation")
+  ("SphFile,s",                                  cfg_SphFile,                                           string(""),         "Spherical points data file name for S-PSNR calculation, text or binary; fibonacci:<N> generates N points")
 #endif
 #if SVIDEO_WSPSNR
   ("WSPSNR,-wspsnr",                       m_bWSPSNREnabled,                            true,  "Flag to enable ws-psnr calculation")
@@ -1420,6 +1460,29 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
     m_tileRowHeight.clear();
   }
 
+#if SVIDEO_EXT && SVIDEO_FACE_TILES
+  if(m_bSVideo && m_bSVideoFaceTiles)
+  {
+    // the faces must tile the coding picture and be aligned with the CTU grid
+    const SVideoFPStruct &frmPack = m_codingSVideoInfo.framePackStruct;
+    if(m_isField || m_iSourceWidth != m_codingSVideoInfo.iFaceWidth*frmPack.cols || m_iSourceHeight != m_codingSVideoInfo.iFaceHeight*frmPack.rows)
+    {
+      printf("SVideoFaceTiles: the faces (%dx%d, %dx%d) do not tile the coding picture (%dx%d).\n", m_codingSVideoInfo.iFaceWidth, m_codingSVideoInfo.iFaceHeight, frmPack.cols, frmPack.rows, m_iSourceWidth, m_iSourceHeight);
+      exit( EXIT_FAILURE );
+    }
+    if((m_codingSVideoInfo.iFaceWidth % m_uiMaxCUWidth) != 0 || (m_codingSVideoInfo.iFaceHeight % m_uiMaxCUHeight) != 0)
+    {
+      printf("SVideoFaceTiles: face size %dx%d is not a multiple of the CTU size %dx%d.\n", m_codingSVideoInfo.iFaceWidth, m_codingSVideoInfo.iFaceHeight, m_uiMaxCUWidth, m_uiMaxCUHeight);
+      exit( EXIT_FAILURE );
+    }
+    m_tileUniformSpacingFlag = false;
+    m_numTileColumnsMinus1   = frmPack.cols - 1;
+    m_numTileRowsMinus1      = frmPack.rows - 1;
+    m_tileColumnWidth.assign(m_numTileColumnsMinus1, m_codingSVideoInfo.iFaceWidth / m_uiMaxCUWidth);
+    m_tileRowHeight.assign(m_numTileRowsMinus1, m_codingSVideoInfo.iFaceHeight / m_uiMaxCUHeight);
+  }
+#endif
+
   /* rules for input, output and internal bitdepths as per help text */
   if (m_MSBExtendedBitDepth[CHANNEL_TYPE_LUMA  ] == 0)
   {
@@ -2450,6 +2513,15 @@ Void TAppEncCfg::xCheckParameter()
   {
     xConfirmPara( tileFlag && m_entropyCodingSyncEnabledFlag, "Tiles and entropy-coding-sync (Wavefronts) can not be applied together, except in the High Throughput Intra 4:4:4 16 profile");
   }
+#if WPP_PARALLEL_ENCODING
+  xConfirmPara( m_iWaveFrontThreads < 1, "WaveFrontThreads must be greater than 0" );
+#endif
+#if TILE_PARALLEL_ENCODING
+  xConfirmPara( m_iTileThreads < 1, "TileThreads must be greater than 0" );
+#endif
+#if FRAME_PARALLEL_ENCODING
+  xConfirmPara( m_iFrameThreads < 1, "FrameThreads must be greater than 0" );
+#endif
 
   xConfirmPara( m_iSourceWidth  % TComSPS::getWinUnitX(m_chromaFormatIDC) != 0, "Picture width must be an integer multiple of the specified chroma subsampling");
   xConfirmPara( m_iSourceHeight % TComSPS::getWinUnitY(m_chromaFormatIDC) != 0, "Picture height must be an integer multiple of the specified chroma subsampling");
@@ -2986,6 +3058,15 @@ Void TAppEncCfg::xCheckParameter()
   if(m_bSVideo)
   {
     xConfirmPara(m_faceSizeAlignment<0, "FaceSizeAlignment must be no less than 0");
+#if SVIDEO_MT_GEOCONVERT
+    xConfirmPara(m_iGeoConvertThreads<=0, "GeoConvertThreads must be greater than 0");
+#endif
+#if SVIDEO_ASYNC_METRICS
+    xConfirmPara(m_iSphMetricThreads<0, "SphMetricThreads must be no less than 0");
+#endif
+#if SVIDEO_MMAP_YUV_READER
+    xConfirmPara(m_iMemoryMappedInput<0 || m_iMemoryMappedInput>2, "MemoryMappedInput must be 0, 1 or 2");
+#endif
     //check source;
     if(m_sourceSVideoInfo.geoType == SVIDEO_EQUIRECT || m_sourceSVideoInfo.geoType == SVIDEO_EQUALAREA)
     {
@@ -3302,6 +3383,15 @@ Void TAppEncCfg::xPrintParameter()
   printf("PME:%d ", m_log2ParallelMergeLevel);
   const Int iWaveFrontSubstreams = m_entropyCodingSyncEnabledFlag ? (m_iSourceHeight + m_uiMaxCUHeight - 1) / m_uiMaxCUHeight : 1;
   printf(" WaveFrontSynchro:%d WaveFrontSubstreams:%d", m_entropyCodingSyncEnabledFlag?1:0, iWaveFrontSubstreams);
+#if WPP_PARALLEL_ENCODING
+  printf(" WaveFrontThreads:%d", m_entropyCodingSyncEnabledFlag ? m_iWaveFrontThreads : 1);
+#endif
+#if TILE_PARALLEL_ENCODING
+  printf(" TileThreads:%d", (m_numTileColumnsMinus1 > 0 || m_numTileRowsMinus1 > 0) ? m_iTileThreads : 1);
+#endif
+#if FRAME_PARALLEL_ENCODING
+  printf(" FrameThreads:%d", m_iFrameThreads);
+#endif
   printf(" ScalingList:%d ", m_useScalingListId );
   printf("TMVPMode:%d ", m_TMVPModeId     );
 #if ADAPTIVE_QP_SELECTION
@@ -3343,6 +3433,39 @@ Void TAppEncCfg::xPrintParameter()
     printf("Packed frame resolution: %dx%d (Input face resolution:%dx%d)\n", m_iSourceWidth, m_iSourceHeight, m_iCodingFaceWidth, m_iCodingFaceHeight);
     printf("Interpolation method for luma: %d, interpolation method for chroma: %d\n", m_inputGeoParam.iInterp[CHANNEL_TYPE_LUMA], m_inputGeoParam.iInterp[CHANNEL_TYPE_CHROMA]);
     printf("ChromaSampleLocType: %d\n", m_inputGeoParam.iChromaSampleLocType);
+#if SVIDEO_MT_GEOCONVERT
+    printf("GeoConvertThreads: %d\n", m_iGeoConvertThreads);
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+    printf("PackedResampleMap: %d\n", m_bPackedResampleMap);
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+    printf("SeparableResample: %d\n", m_bSeparableResample);
+#endif
+#if SVIDEO_BATCH_MAPPING
+    printf("FastProjectionMath: %d\n", m_bFastProjectionMath);
+#endif
+#if SVIDEO_GEOMAP_CACHE
+    printf("GeoMapCacheDir: %s\n", m_geoMapCacheDir.empty()? "(none)" : m_geoMapCacheDir.c_str());
+#endif
+#if SVIDEO_ASYNC_METRICS
+    printf("SphMetricThreads: %d\n", m_iSphMetricThreads);
+#endif
+#if SVIDEO_MMAP_YUV_READER
+    printf("MemoryMappedInput: %d\n", m_iMemoryMappedInput);
+#endif
+#if SVIDEO_FUSED_YUV_WRITE
+    printf("AsyncOutputWrite: %d\n", m_bAsyncOutputWrite);
+#endif
+#if SVIDEO_FUSED_METRICS
+    printf("FusedMetrics: %d\n", m_bFusedMetrics);
+#endif
+#if SVIDEO_FACE_TILES
+    if(m_bSVideoFaceTiles)
+    {
+      printf("SVideoFaceTiles: %dx%d tiles\n", m_numTileColumnsMinus1+1, m_numTileRowsMinus1+1);
+    }
+#endif
     printf("Input ChromaFormatIDC: %d; ", m_InputChromaFormatIDC);    
     if(m_inputGeoParam.chromaFormat == CHROMA_420)
       printf("Internal ChromaFormatIDC: %d, ChromaResample: %d; ", m_inputGeoParam.chromaFormat, m_inputGeoParam.bResampleChroma);
@@ -86,6 +86,36 @@ protected:
   Int       m_iCodingFaceHeight;
   Int       m_faceSizeAlignment;
   InputGeoParam m_inputGeoParam;
+#if SVIDEO_MT_GEOCONVERT
+  Int       m_iGeoConvertThreads;                             ///< number of threads for geometry conversion, 1: serial
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  Bool      m_bPackedResampleMap;                             ///< packed map with quantised phase for geometry conversion
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+  Bool      m_bSeparableResample;                             ///< two-pass resampling between ERP or EAP geometries without rotation
+#endif
+#if SVIDEO_BATCH_MAPPING
+  Bool      m_bFastProjectionMath;                            ///< polynomial trigonometry in the projection mapping
+#endif
+#if SVIDEO_GEOMAP_CACHE
+  std::string m_geoMapCacheDir;                               ///< directory of the geometry mapping table cache, empty: disabled
+#endif
+#if SVIDEO_ASYNC_METRICS
+  Int       m_iSphMetricThreads;                              ///< threads for the spherical metrics, 0: computed on the encoding thread
+#endif
+#if SVIDEO_MMAP_YUV_READER
+  Int       m_iMemoryMappedInput;                             ///< 0: stream input, 1: memory-mapped input, 2: with read-ahead
+#endif
+#if SVIDEO_FUSED_YUV_WRITE
+  Bool      m_bAsyncOutputWrite;                              ///< reconstructed frames are written on a background thread
+#endif
+#if SVIDEO_FACE_TILES
+  Bool      m_bSVideoFaceTiles;                               ///< one tile per face of the coding frame packing structure
+#endif
+#if SVIDEO_FUSED_METRICS
+  Bool      m_bFusedMetrics;                                  ///< PSNR, WS-PSNR and S-PSNR-NN in one pass over the pictures
+#endif
 #if SVIDEO_VIEWPORT_PSNR
   ViewPortPSNRParam m_viewPortPSNRParam;
 #endif
@@ -287,6 +317,15 @@ protected:
   std::vector<Int> m_tileColumnWidth;
   std::vector<Int> m_tileRowHeight;
   Bool      m_entropyCodingSyncEnabledFlag;
+#if WPP_PARALLEL_ENCODING
+  Int       m_iWaveFrontThreads;                              ///< threads compressing the CTU rows of a wavefront slice, 1: serial
+#endif
+#if TILE_PARALLEL_ENCODING
+  Int       m_iTileThreads;                                   ///< threads coding the tiles of a slice, 1: serial
+#endif
+#if FRAME_PARALLEL_ENCODING
+  Int       m_iFrameThreads;                                  ///< threads compressing pictures that do not reference each other, 1: serial
+#endif
 
   Bool      m_bUseConstrainedIntraPred;                       ///< flag for using constrained intra prediction
   Bool      m_bFastUDIUseMPMEnabled;
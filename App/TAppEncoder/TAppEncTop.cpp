@@ -363,6 +363,15 @@ Void TAppEncTop::xInitLibCfg()
   }
   m_cTEncTop.setLFCrossTileBoundaryFlag                           ( m_bLFCrossTileBoundaryFlag );
   m_cTEncTop.setEntropyCodingSyncEnabledFlag                      ( m_entropyCodingSyncEnabledFlag );
+#if WPP_PARALLEL_ENCODING
+  m_cTEncTop.setWaveFrontThreads                                  ( m_iWaveFrontThreads );
+#endif
+#if TILE_PARALLEL_ENCODING
+  m_cTEncTop.setTileThreads                                       ( m_iTileThreads );
+#endif
+#if FRAME_PARALLEL_ENCODING
+  m_cTEncTop.setFrameThreads                                      ( m_iFrameThreads );
+#endif
   m_cTEncTop.setTMVPModeId                                        ( m_TMVPModeId );
   m_cTEncTop.setUseScalingListId                                  ( m_useScalingListId  );
   m_cTEncTop.setScalingListFileName                               ( m_scalingListFileName );
@@ -426,6 +435,15 @@ Void TAppEncTop::xInitLibCfg()
 Void TAppEncTop::xCreateLib()
 {
   // Video I/O
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER
+  m_cTVideoIOYuvInputFile.setMemoryMapped(m_iMemoryMappedInput>0, m_iMemoryMappedInput>1);
+#if SVIDEO_VIEWPORT_PSNR
+  m_cTVideoIOYuvInputFile4VPPSNR.setMemoryMapped(m_iMemoryMappedInput>0, m_iMemoryMappedInput>1);
+#endif
+#if SVIDEO_WSPSNR_E2E
+  m_cTVideoIOYuvInputFile4E2EWSPSNR.setMemoryMapped(m_iMemoryMappedInput>0, m_iMemoryMappedInput>1);
+#endif
+#endif
   m_cTVideoIOYuvInputFile.open( m_inputFileName,     false, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth );  // read  mode
 #if SVIDEO_EXT
   m_cTVideoIOYuvInputFile.skipFrames(m_FrameSkip, m_iInputWidth, m_iInputHeight, m_InputChromaFormatIDC);
@@ -442,6 +460,9 @@ Void TAppEncTop::xCreateLib()
 #endif
   if (!m_reconFileName.empty())
   {
+#if SVIDEO_EXT && SVIDEO_FUSED_YUV_WRITE
+    m_cTVideoIOYuvReconFile.setAsyncWrite(m_bAsyncOutputWrite);
+#endif
     m_cTVideoIOYuvReconFile.open(m_reconFileName, true, m_outputBitDepth, m_outputBitDepth, m_internalBitDepth);  // write mode
   }
 
@@ -557,10 +578,35 @@ Void TAppEncTop::encode()
 
       pcInputGeomtry = TGeometry::create(m_sourceSVideoInfo, &m_inputGeoParam); 
       pcCodingGeomtry = TGeometry::create(m_codingSVideoInfo, &m_inputGeoParam);
+#if SVIDEO_MT_GEOCONVERT
+      m_cGeoThreadPool.create(m_iGeoConvertThreads);
+      pcInputGeomtry->setThreadPool(&m_cGeoThreadPool);
+      pcCodingGeomtry->setThreadPool(&m_cGeoThreadPool);
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+      pcCodingGeomtry->setPackedMap(m_bPackedResampleMap);
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+      pcCodingGeomtry->setSeparableMap(m_bSeparableResample);
+#endif
+#if SVIDEO_BATCH_MAPPING
+      pcInputGeomtry->setFastProjectionMath(m_bFastProjectionMath);
+      pcCodingGeomtry->setFastProjectionMath(m_bFastProjectionMath);
+#endif
+#if SVIDEO_GEOMAP_CACHE
+      pcInputGeomtry->setMapCacheDir(m_geoMapCacheDir);
+      pcCodingGeomtry->setMapCacheDir(m_geoMapCacheDir);
+#endif
     }
+#if SVIDEO_ASYNC_METRICS
+    m_cTEncTop.setSphMetricThreads(m_iSphMetricThreads);
+#endif
 #if SVIDEO_VIEWPORT_PSNR
     m_cTEncTop.setViewPortPSNRParam(m_viewPortPSNRParam);
     m_cTEncTop.initSphericalPSNR(m_sourceSVideoInfo, m_codingSVideoInfo, &m_inputGeoParam, m_cTVideoIOYuvInputFile4VPPSNR, m_iInputWidth, m_iInputHeight);
+#if SVIDEO_VIEWPORT_PSNR_MT
+    m_cTEncTop.getViewPortPSNR()->setThreadPool(&m_cGeoThreadPool);
+#endif
 #endif
 #if SVIDEO_SPSNR_NN
     m_cTEncTop.getGOPEncoder()->getSPSNRMetric()->setSPSNREnabledFlag(m_bSPSNRNNEnabled);
@@ -580,6 +626,9 @@ Void TAppEncTop::encode()
       m_cTEncTop.getGOPEncoder()->getWSPSNRMetric()->setOutputBitDepth(m_internalBitDepth);
       m_cTEncTop.getGOPEncoder()->getWSPSNRMetric()->setReferenceBitDepth(m_internalBitDepth);
       m_cTEncTop.getGOPEncoder()->getWSPSNRMetric()->createTable(pcPicYuvOrg, pcCodingGeomtry);
+#if SVIDEO_WSPSNR_SPANS
+      m_cTEncTop.getGOPEncoder()->getWSPSNRMetric()->setThreadPool(&m_cGeoThreadPool);
+#endif
     }
 #if SVIDEO_WSPSNR_E2E
     m_cTEncTop.getGOPEncoder()->getE2EWSPSNRMetric()->setWSPSNREnabledFlag(m_bE2EWSPSNREnabled);
@@ -589,6 +638,9 @@ Void TAppEncTop::encode()
       m_cTEncTop.getGOPEncoder()->getE2EWSPSNRMetric()->setOutputBitDepth(m_internalBitDepth);
       m_cTEncTop.getGOPEncoder()->getE2EWSPSNRMetric()->setReferenceBitDepth(m_internalBitDepth);
       m_cTEncTop.getGOPEncoder()->getE2EWSPSNRMetric()->createTable(((!bGeoConvertSkip)? pcPicYuvReadFromFile : pcPicYuvOrg), pcInputGeomtry);
+#if SVIDEO_WSPSNR_SPANS
+      m_cTEncTop.getGOPEncoder()->getE2EWSPSNRMetric()->setThreadPool(&m_cGeoThreadPool);
+#endif
     }
 #endif
 #endif
@@ -610,6 +662,19 @@ Void TAppEncTop::encode()
       m_cTEncTop.getGOPEncoder()->getCPPPSNRMetric()->setReferenceBitDepth(m_internalBitDepth);
       m_cTEncTop.getGOPEncoder()->getCPPPSNRMetric()->initCPPPSNR(m_inputGeoParam, m_iSourceWidth, m_iSourceHeight, m_codingSVideoInfo, m_codingSVideoInfo);
     }
+#if SVIDEO_FUSED_METRICS
+    if(m_bFusedMetrics)
+    {
+      TEncGOP *pcGOPEncoder = m_cTEncTop.getGOPEncoder();
+      TFusedMetricCalc *pcFusedMetricCalc = pcGOPEncoder->getFusedMetricCalc();
+      pcFusedMetricCalc->setBitDepths(m_internalBitDepth, m_internalBitDepth);
+      pcFusedMetricCalc->setPSNRPadding(m_aiPad[0], m_aiPad[1]);
+      pcFusedMetricCalc->setSPSNRMetric(pcGOPEncoder->getSPSNRMetric()->getSPSNREnabled()? pcGOPEncoder->getSPSNRMetric() : NULL);
+      pcFusedMetricCalc->setWSPSNRMetric(pcGOPEncoder->getWSPSNRMetric()->getWSPSNREnabled()? pcGOPEncoder->getWSPSNRMetric() : NULL);
+      pcFusedMetricCalc->setThreadPool(&m_cGeoThreadPool);
+      pcFusedMetricCalc->init(pcPicYuvOrg);
+    }
+#endif
   }
 #endif
 
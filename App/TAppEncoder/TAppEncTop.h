@@ -75,6 +75,9 @@ private:
 #if SVIDEO_WSPSNR_E2E
   TVideoIOYuv                m_cTVideoIOYuvInputFile4E2EWSPSNR;       ///< input YUV file for viewport PSNR calculation;
 #endif
+#if SVIDEO_MT_GEOCONVERT
+  TComThreadPool             m_cGeoThreadPool;             ///< worker threads for geometry conversion
+#endif
 #endif
 protected:
   // initialization
@@ -43,6 +43,7 @@
 #include <limits>
 #include <math.h>
 #include <iomanip>
+#include <chrono>
 #include "TApp360Def.h"
 #include "TApp360ChromaFormat.h"
 #include "TApp360PicYuv.h"
@@ -51,6 +52,9 @@
 #include "TApp360ConvertCfg.h"
 #include "TAppCommon/program_options_lite.h"
 #include "TLibVideoIO/TVideoIOYuv.h"
+#if SVIDEO_CONVERT_PIPELINE
+#include "TApp360ConvertPipeline.h"
+#endif
 #if SVIDEO_SPSNR_NN
 #include "TLib360/TPSNRMetricCalc.h"
 #include "TLib360/TSPSNRMetricCalc.h"
@@ -64,6 +68,12 @@
 #if SVIDEO_CPPPSNR
 #include "TLib360/TCPPPSNRMetricCalc.h"
 #endif
+#if SVIDEO_SPH_SAMPLE_POINTS
+#include "TLib360/TSphSamplePoints.h"
+#endif
+#if SVIDEO_FUSED_METRICS
+#include "TLib360/TFusedMetricCalc.h"
+#endif
 
 #ifdef WIN32
 #define strdup _strdup
@@ -106,6 +116,36 @@ TApp360ConvertCfg::TApp360ConvertCfg()
   , m_outputInternalColourSpace(false)
   , m_temporalSubsampleRatio(1)
   , m_faceSizeAlignment(8)
+#if SVIDEO_MT_GEOCONVERT
+  , m_iGeoConvertThreads(1)
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  , m_bPackedResampleMap(false)
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+  , m_bSeparableResample(false)
+#endif
+#if SVIDEO_BATCH_MAPPING
+  , m_bFastProjectionMath(false)
+#endif
+#if SVIDEO_DIRECT_GEOCONVERT
+  , m_iViewPortDirectFrames(2)
+#endif
+#if SVIDEO_CONVERT_PIPELINE
+  , m_iPipelineWorkers(0)
+#endif
+#if SVIDEO_MMAP_YUV_READER
+  , m_iMemoryMappedInput(0)
+#endif
+#if SVIDEO_FUSED_YUV_WRITE
+  , m_bAsyncOutputWrite(false)
+#endif
+#if SVIDEO_FUSED_METRICS
+  , m_bFusedMetrics(false)
+#endif
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  , m_bExtraOutput(false)
+#endif
 {
 }
 
@@ -117,6 +157,11 @@ TApp360ConvertCfg::~TApp360ConvertCfg()
   if(m_pchSphData) free(m_pchSphData); m_pchSphData=NULL;
   if(m_pchVPortFile) free(m_pchVPortFile); m_pchVPortFile=NULL;
   if(m_pchSpherePointsFile) free(m_pchSpherePointsFile); m_pchSpherePointsFile=NULL;
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  for(size_t i=0; i<m_extraOutputs.size(); i++)
+    delete m_extraOutputs[i];
+  m_extraOutputs.clear();
+#endif
 }
 
 Void TApp360ConvertCfg::create()
@@ -341,6 +386,9 @@ Bool TApp360ConvertCfg::parseCfg( Int argc, Char* argv[] )
   Int tmpReferenceChromaFormat;
 #endif
   string inputColourSpaceConvert;
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  string cfg_ExtraOutputConfig[SV_MAX_EXTRA_OUTPUTS];
+#endif
 
   Int warnUnknowParameter = 0;
 
@@ -365,7 +413,7 @@ Bool TApp360ConvertCfg::parseCfg( Int argc, Char* argv[] )
     ("InputFile,i",                                     cfg_InputFile,                               string(""), "Original YUV input file name")
     ("OutputFile,o",                                    cfg_OutputFile,                              string(""), "Converted YUV output file name")
     ("RefFile,r",                                       cfg_RefFile,                                 string(""), "Ref YUV file name for PSNR calculation")
-    ("SphFile,s",                                       cfg_SphFile,                                 string(""), "Spherical points data file name for S-PSNR-NN/S-PSNR-I calculation")
+    ("SphFile,s",                                       cfg_SphFile,                                 string(""), "Spherical points data file name for S-PSNR-NN/S-PSNR-I calculation, text or binary; fibonacci:<N> generates N points")
     ("ViewPortFile,v",                                  cfg_ViewFile,                                string(""), "Viewport paramete file name for dynamic viewport generation")
     ("SpherePointsFile,p",                              cfg_SpherePointsFile,                        string(""), "File name for point coordinates on the sphere of the converted projction")
     ("SourceWidth,-wdt",                                m_iInputWidth,                                        0, "Source picture width")
@@ -438,7 +486,48 @@ Bool TApp360ConvertCfg::parseCfg( Int argc, Char* argv[] )
     ("InterpolationMethodY,-interpY",                   m_inputGeoParam.iInterp[CHANNEL_TYPE_LUMA],   (Int)SI_LANCZOS3,            "Interpolation method for luma, 0: default setting(lanczos3); 1:NN, 2: bilinear, 3: bicubic, 4: lanczos2, 5: lanczos3")
     ("InterpolationMethodC,-interpC",                   m_inputGeoParam.iInterp[CHANNEL_TYPE_CHROMA], (Int)SI_LANCZOS2,            "Interpolation method for chroma, 0: default setting(lanczos2); 1:NN, 2: bilinear, 3: bicubic, 4: lanczos2, 5: lanczos3")
     ("ChromaSampleLocType,-csl",                        m_inputGeoParam.iChromaSampleLocType,                 2,                                   "Chroma sample location type relative to luma, 0: 0.5 shift in vertical direction; 1: 0.5 shift in both directions, 2: aligned with luma (default setting), 3: 0.5 shift in horizontal direction")
+#if SVIDEO_MT_GEOCONVERT
+    ("GeoConvertThreads,-gt",                           m_iGeoConvertThreads,                                 1,                                    "Number of threads for geometry conversion and sphere padding, 1: serial")
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+    ("PackedResampleMap",                               m_bPackedResampleMap,                             false,                                    "Use the packed resampling map with 1/16 phase precision for geometry conversion (not bit-exact with the default map)")
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+    ("SeparableResample",                               m_bSeparableResample,                             false,                                    "Use separable horizontal/vertical filtering for ERP to ERP and EAP to EAP conversion without rotation (not bit-exact with the default map)")
+#endif
+#if SVIDEO_BATCH_MAPPING
+    ("FastProjectionMath",                              m_bFastProjectionMath,                            false,                                    "Use polynomial approximations of the trigonometric functions in the ERP/EAP/CPP projections (not bit-exact with the default)")
+#endif
+#if SVIDEO_GEOMAP_CACHE
+    ("GeoMapCacheDir",                                  m_geoMapCacheDir,                                 string(""),                               "Directory to load/store the geometry mapping tables, empty: no cache")
+#endif
+#if SVIDEO_DIRECT_GEOCONVERT
+    ("ViewPortDirectFrames",                            m_iViewPortDirectFrames,                              2,                                    "Viewports of the viewport file kept for fewer frames are converted without building the mapping tables, 0: never")
+#endif
+#if SVIDEO_CONVERT_PIPELINE
+    ("PipelineWorkers",                                 m_iPipelineWorkers,                                   0,                                    "Number of frame conversion workers of the read/convert/write/metric pipeline, 0: frames are processed one after another")
+#endif
+#if SVIDEO_MMAP_YUV_READER
+    ("MemoryMappedInput",                               m_iMemoryMappedInput,                                 0,                                    "Read the input and reference YUV files through a memory map, 0: stream, 1: memory map, 2: memory map with read-ahead of the next frame")
+#endif
+#if SVIDEO_FUSED_YUV_WRITE
+    ("AsyncOutputWrite",                                m_bAsyncOutputWrite,                              false,                                    "Write the output YUV file on a background thread")
+#endif
+#if SVIDEO_SPH_SAMPLE_POINTS
+    ("SphFileBinaryOutput",                             m_sphFileBinaryOutput,                            string(""),                               "Write the spherical points of SphFile to this file in the binary format, with precomputed Cartesian coordinates")
+#endif
+#if SVIDEO_FUSED_METRICS
+    ("FusedMetrics",                                    m_bFusedMetrics,                                  false,                                    "Compute PSNR, WS-PSNR and S-PSNR-NN in one pass over the reference and output frames")
+#endif
     ;
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  for(Int i=1; i<SV_MAX_EXTRA_OUTPUTS+1; i++)
+  {
+    std::ostringstream cOSS;
+    cOSS<<"ExtraOutputConfig"<<i;
+    opts.addOptions()(cOSS.str(), cfg_ExtraOutputConfig[i-1], string(""), "Configuration file of an extra output converted from the same source (coding geometry, face size, packing, chroma format, output file)");
+  }
+#endif
 
   po::setDefaults(opts);
   po::ErrorReporter err;
@@ -664,12 +753,84 @@ Bool TApp360ConvertCfg::parseCfg( Int argc, Char* argv[] )
   // check validity of input parameters
   xCheckParameter();
 
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  for(Int i=0; i<SV_MAX_EXTRA_OUTPUTS && !m_bExtraOutput; i++)
+  {
+    if(!cfg_ExtraOutputConfig[i].empty() && !xParseExtraOutput(argc, argv, cfg_ExtraOutputConfig[i]))
+    {
+      exit(EXIT_FAILURE);
+    }
+  }
+  if(m_bExtraOutput)
+  {
+    return true;
+  }
+#endif
   // print-out parameters
   xPrintParameter();
 
   return true;
 }
 
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+/**
+ * \brief the extra output is parsed from the command line followed by cfgFile; the output options of the command line belong to
+ * the main output and are reset to their defaults before cfgFile, the other options are shared;
+ * the source and the conversion parameters must be those of this configuration, as the source is converted once for all outputs;
+ */
+Bool TApp360ConvertCfg::xParseExtraOutput(Int argc, Char* argv[], const std::string& cfgFile)
+{
+  static Char sOutputDefaults[][40] = { "--OutputFile=", "--CodingGeometryType=0", "--CodingFPStructure=0 0", "--CodingCompactFPStructure=1",
+                                        "--SVideoRotation=0 0 0", "--ViewPortSettings=0 0 0 0", "--CodingFaceWidth=0", "--CodingFaceHeight=0",
+                                        "--OutputChromaFormat=0", "--OutputBitDepth=0", "--OutputBitDepthC=0", "-c" };
+  std::vector<Char*> args(argv, argv+argc);
+  for(size_t i=0; i<sizeof(sOutputDefaults)/sizeof(sOutputDefaults[0]); i++)
+    args.push_back(sOutputDefaults[i]);
+  std::vector<Char> cfgName(cfgFile.begin(), cfgFile.end());
+  cfgName.push_back('\0');
+  args.push_back(&cfgName[0]);
+
+  TApp360ConvertCfg *pcCfg = new TApp360ConvertCfg;
+  pcCfg->m_bExtraOutput = true;
+  if(!pcCfg->parseCfg((Int)args.size(), &args[0]))
+  {
+    delete pcCfg;
+    return false;
+  }
+
+  Bool check_failed = false;
+#define xConfirmPara(a,b) check_failed |= confirmPara(a,b)
+  xConfirmPara(isGeoConvertSkipped() || isDirectFPConvert(),                    "ExtraOutputConfig requires a geometry conversion for the main output");
+  xConfirmPara(pcCfg->isGeoConvertSkipped() || pcCfg->isDirectFPConvert(),      "ExtraOutputConfig requires a geometry conversion for every extra output");
+  xConfirmPara(!pcCfg->m_pchOutputFile || (m_pchOutputFile && !strcmp(pcCfg->m_pchOutputFile, m_pchOutputFile)), "ExtraOutputConfig requires an OutputFile different from the main one");
+  xConfirmPara(!pcCfg->m_pchInputFile || !m_pchInputFile || strcmp(pcCfg->m_pchInputFile, m_pchInputFile) || pcCfg->m_iInputWidth != m_iInputWidth || pcCfg->m_iInputHeight != m_iInputHeight
+               || pcCfg->m_InputChromaFormatIDC != m_InputChromaFormatIDC || pcCfg->m_FrameSkip != m_FrameSkip || pcCfg->m_framesToBeConverted != m_framesToBeConverted
+               || pcCfg->m_temporalSubsampleRatio != m_temporalSubsampleRatio,  "ExtraOutputConfig cannot change the input file or its format");
+  xConfirmPara(pcCfg->m_sourceSVideoInfo.geoType != m_sourceSVideoInfo.geoType || pcCfg->m_sourceSVideoInfo.iCompactFPStructure != m_sourceSVideoInfo.iCompactFPStructure
+               || memcmp(&pcCfg->m_sourceSVideoInfo.framePackStruct, &m_sourceSVideoInfo.framePackStruct, sizeof(SVideoFPStruct)),
+                                                                               "ExtraOutputConfig cannot change the input geometry");
+  for(Int ch=0; ch<MAX_NUM_CHANNEL_TYPE; ch++)
+  {
+    xConfirmPara(pcCfg->m_inputBitDepth[ch] != m_inputBitDepth[ch] || pcCfg->m_MSBExtendedBitDepth[ch] != m_MSBExtendedBitDepth[ch] || pcCfg->m_internalBitDepth[ch] != m_internalBitDepth[ch],
+                                                                               "ExtraOutputConfig cannot change the input or internal bit depths");
+    xConfirmPara(pcCfg->m_inputGeoParam.iInterp[ch] != m_inputGeoParam.iInterp[ch], "ExtraOutputConfig cannot change the interpolation methods");
+  }
+  xConfirmPara(pcCfg->m_inputGeoParam.chromaFormat != m_inputGeoParam.chromaFormat || pcCfg->m_inputGeoParam.bResampleChroma != m_inputGeoParam.bResampleChroma
+               || pcCfg->m_inputGeoParam.iChromaSampleLocType != m_inputGeoParam.iChromaSampleLocType,
+                                                                               "ExtraOutputConfig cannot change InternalChromaFormat, ResampleChroma or ChromaSampleLocType");
+  xConfirmPara(pcCfg->m_inputColourSpaceConvert != m_inputColourSpaceConvert,  "ExtraOutputConfig cannot change InputColourSpaceConvert");
+#undef xConfirmPara
+  if(check_failed)
+  {
+    printf("Error: invalid ExtraOutputConfig %s\n", cfgFile.c_str());
+    delete pcCfg;
+    return false;
+  }
+  m_extraOutputs.push_back(pcCfg);
+  return true;
+}
+#endif
+
 Void TApp360ConvertCfg::fillSourceSVideoInfo(SVideoInfo& sVidInfo, Int inputWidth, Int inputHeight)
 {
 #if SVIDEO_CPPPSNR
@@ -1062,6 +1223,18 @@ Void TApp360ConvertCfg::xCheckParameter()
   xConfirmPara( m_confWinBottom % TComSPS::getWinUnitY(m_OutputChromaFormatIDC) != 0, "Bottom conformance window offset must be an integer multiple of the specified chroma subsampling");
   */
   xConfirmPara(m_faceSizeAlignment<=0, "FaceSizeAlignment must be greater than 0");
+#if SVIDEO_MT_GEOCONVERT
+  xConfirmPara(m_iGeoConvertThreads<=0, "GeoConvertThreads must be greater than 0");
+#endif
+#if SVIDEO_DIRECT_GEOCONVERT
+  xConfirmPara(m_iViewPortDirectFrames<0, "ViewPortDirectFrames must not be negative");
+#endif
+#if SVIDEO_CONVERT_PIPELINE
+  xConfirmPara(m_iPipelineWorkers<0, "PipelineWorkers must not be negative");
+#endif
+#if SVIDEO_MMAP_YUV_READER
+  xConfirmPara(m_iMemoryMappedInput<0 || m_iMemoryMappedInput>2, "MemoryMappedInput must be 0, 1 or 2");
+#endif
   //check source;
   if(m_sourceSVideoInfo.geoType == SVIDEO_EQUIRECT || m_sourceSVideoInfo.geoType == SVIDEO_EQUALAREA)
   {
@@ -1205,12 +1378,22 @@ Void TApp360ConvertCfg::xCheckParameter()
 #endif
   {
     xConfirmPara(!(m_pchSphData), "SphFile has to be specified\n");
+#if SVIDEO_SPH_SAMPLE_POINTS
+    if(!TSphSamplePoints::isGenerated(m_pchSphData))
+    {
+#endif
     FILE *fp = fopen(m_pchSphData, "r");
     if(!fp)
       m_psnrEnabled[METRIC_SPSNR_NN] = false;
     else
       fclose(fp);
+#if SVIDEO_SPH_SAMPLE_POINTS
+    }
+#endif
   }
+#endif
+#if SVIDEO_SPH_SAMPLE_POINTS
+  xConfirmPara(!m_sphFileBinaryOutput.empty() && !m_pchSphData, "SphFileBinaryOutput requires SphFile");
 #endif
   if(isGeoConvertSkipped() && m_pchOutputFile)
   {
@@ -1272,6 +1455,52 @@ Void TApp360ConvertCfg::xPrintParameter()
   printf("\n\nPacked frame resolution: %dx%d (Input face resolution:%dx%d)", m_iSourceWidth, m_iSourceHeight, m_iCodingFaceWidth, m_iCodingFaceHeight);
   printf("\nInterpolation method for luma: %d, interpolation method for chroma: %d", m_inputGeoParam.iInterp[CHANNEL_TYPE_LUMA], m_inputGeoParam.iInterp[CHANNEL_TYPE_CHROMA]);
   printf("\nChromaSampleLocType: %d", m_inputGeoParam.iChromaSampleLocType);
+#if SVIDEO_MT_GEOCONVERT
+  printf("\nGeoConvertThreads: %d", m_iGeoConvertThreads);
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  printf("\nPackedResampleMap: %d", m_bPackedResampleMap);
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+  printf("\nSeparableResample: %d", m_bSeparableResample);
+#endif
+#if SVIDEO_BATCH_MAPPING
+  printf("\nFastProjectionMath: %d", m_bFastProjectionMath);
+#endif
+#if SVIDEO_GEOMAP_CACHE
+  printf("\nGeoMapCacheDir: %s", m_geoMapCacheDir.empty()? "(none)" : m_geoMapCacheDir.c_str());
+#endif
+#if SVIDEO_DIRECT_GEOCONVERT
+  if(m_pchVPortFile)
+    printf("\nViewPortDirectFrames: %d", m_iViewPortDirectFrames);
+#endif
+#if SVIDEO_CONVERT_PIPELINE
+  printf("\nPipelineWorkers: %d", m_iPipelineWorkers);
+#endif
+#if SVIDEO_MMAP_YUV_READER
+  printf("\nMemoryMappedInput: %d", m_iMemoryMappedInput);
+#endif
+#if SVIDEO_FUSED_YUV_WRITE
+  printf("\nAsyncOutputWrite: %d", m_bAsyncOutputWrite);
+#endif
+#if SVIDEO_SPH_SAMPLE_POINTS
+  if(!m_sphFileBinaryOutput.empty())
+    printf("\nSphFileBinaryOutput: %s", m_sphFileBinaryOutput.c_str());
+#endif
+#if SVIDEO_FUSED_METRICS
+  printf("\nFusedMetrics: %d", m_bFusedMetrics);
+#endif
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  for(size_t i=0; i<m_extraOutputs.size(); i++)
+  {
+    TApp360ConvertCfg *pcCfg = m_extraOutputs[i];
+    printf("\nExtra output %d: ", (Int)i+1);
+    printGeoTypeName(pcCfg->m_codingSVideoInfo.geoType, pcCfg->m_codingSVideoInfo.iCompactFPStructure);
+    printf("ChromaFormat:%d Resolution:%dx%dxF%d FPStructure:%dx%d Packed frame resolution:%dx%d File:%s", pcCfg->m_codingSVideoInfo.framePackStruct.chromaFormatIDC,
+      pcCfg->m_codingSVideoInfo.iFaceWidth, pcCfg->m_codingSVideoInfo.iFaceHeight, pcCfg->m_codingSVideoInfo.iNumFaces, pcCfg->m_codingSVideoInfo.framePackStruct.cols,
+      pcCfg->m_codingSVideoInfo.framePackStruct.rows, pcCfg->m_iSourceWidth, pcCfg->m_iSourceHeight, pcCfg->m_pchOutputFile);
+  }
+#endif
   if(isGeoConvertSkipped())
     printf("\nGeometry conversion is skipped!");
   printf("\n\n");
@@ -1370,6 +1599,9 @@ Void  TApp360ConvertCfg::convert()
   TComPicYuv*       pcPicYuvOrg = NULL;
   Int iNextFrame=0;
   FILE *fViewPort=NULL;
+#if SVIDEO_DIRECT_GEOCONVERT
+  Bool bDirectViewPort = false;   //the current viewport is converted without mapping tables;
+#endif
   Bool bGeoConvertSkip = isGeoConvertSkipped();
   Bool bDirectFPConvert = isDirectFPConvert();
   if(bDirectFPConvert)   assert(!bGeoConvertSkip); 
@@ -1377,6 +1609,20 @@ Void  TApp360ConvertCfg::convert()
   TVideoIOYuv cTVideoIOYuvInputFile, cTVideoIOYuvOutputFile, cTVideoIOYuvRefFile;
 
   Double  dPSNRSum[METRIC_NUM][MAX_NUM_COMPONENT];
+#if SVIDEO_SPH_SAMPLE_POINTS
+  if(!m_sphFileBinaryOutput.empty())
+  {
+    const TSphSamplePoints *pcSphPoints = TSphSamplePoints::get(m_pchSphData);
+    if(pcSphPoints && pcSphPoints->writeBinary(m_sphFileBinaryOutput.c_str()))
+      printf("%d spherical points of %s written to %s\n", pcSphPoints->getNumPoints(), m_pchSphData, m_sphFileBinaryOutput.c_str());
+    else
+      printf("\nWARNING: cannot write the spherical points of %s to %s\n", m_pchSphData, m_sphFileBinaryOutput.c_str());
+  }
+#endif
+#if SVIDEO_MMAP_YUV_READER
+  cTVideoIOYuvInputFile.setMemoryMapped(m_iMemoryMappedInput>0, m_iMemoryMappedInput>1);
+  cTVideoIOYuvRefFile.setMemoryMapped(m_iMemoryMappedInput>0, m_iMemoryMappedInput>1);
+#endif
   cTVideoIOYuvInputFile.open( m_pchInputFile,     false, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth );  // read  mode
   cTVideoIOYuvInputFile.skipFrames(m_FrameSkip, m_iInputWidth, m_iInputHeight, m_InputChromaFormatIDC);
 
@@ -1388,6 +1634,9 @@ Void  TApp360ConvertCfg::convert()
 
   if (m_pchOutputFile)
   {
+#if SVIDEO_FUSED_YUV_WRITE
+    cTVideoIOYuvOutputFile.setAsyncWrite(m_bAsyncOutputWrite);
+#endif
     cTVideoIOYuvOutputFile.open(m_pchOutputFile, true, m_outputBitDepth, m_outputBitDepth, m_outputBitDepth);  // write mode
   }  
   printChromaFormat();
@@ -1415,6 +1664,9 @@ Void  TApp360ConvertCfg::convert()
 #endif
 #if SVIDEO_CPPPSNR
   TCPPPSNRMetric cCPPPSNRCalc;
+#endif
+#if SVIDEO_FUSED_METRICS
+  TFusedMetricCalc cFusedCalc;
 #endif
   pcPicYuvReadFromFile = new TComPicYuv;
   pcPicYuvReadFromFile->createWithoutCUInfo ( m_iInputWidth, m_iInputHeight, m_InputChromaFormatIDC, true );
@@ -1482,6 +1734,59 @@ Void  TApp360ConvertCfg::convert()
 
   pcInputGeomtry = TGeometry::create(m_sourceSVideoInfo, &m_inputGeoParam); 
   pcCodingGeomtry = TGeometry::create(m_codingSVideoInfo, &m_inputGeoParam);
+#if SVIDEO_MT_GEOCONVERT
+  m_cThreadPool.create(m_iGeoConvertThreads);
+  pcInputGeomtry->setThreadPool(&m_cThreadPool);
+  pcCodingGeomtry->setThreadPool(&m_cThreadPool);
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  pcCodingGeomtry->setPackedMap(m_bPackedResampleMap);
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+  pcCodingGeomtry->setSeparableMap(m_bSeparableResample);
+#endif
+#if SVIDEO_BATCH_MAPPING
+  pcInputGeomtry->setFastProjectionMath(m_bFastProjectionMath);
+  pcCodingGeomtry->setFastProjectionMath(m_bFastProjectionMath);
+#endif
+#if SVIDEO_GEOMAP_CACHE
+  pcInputGeomtry->setMapCacheDir(m_geoMapCacheDir);
+  pcCodingGeomtry->setMapCacheDir(m_geoMapCacheDir);
+#endif
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  //the extra outputs are converted from the padded source of pcInputGeomtry in the same pass as pcCodingGeomtry;
+  Int iNumExtraOutputs = (Int)m_extraOutputs.size();
+  std::vector<TGeometry*> extraGeometries(iNumExtraOutputs, (TGeometry*)NULL);
+  std::vector<TComPicYuv*> extraPicYuvTrueOrg(iNumExtraOutputs, (TComPicYuv*)NULL), extraPicYuvOrg(iNumExtraOutputs, (TComPicYuv*)NULL);
+  std::vector<TVideoIOYuv*> extraOutputFiles(iNumExtraOutputs, (TVideoIOYuv*)NULL);
+  for(Int k=0; k<iNumExtraOutputs; k++)
+  {
+    TApp360ConvertCfg *pcCfg = m_extraOutputs[k];
+    extraGeometries[k] = TGeometry::create(pcCfg->m_codingSVideoInfo, &pcCfg->m_inputGeoParam);
+    extraGeometries[k]->setThreadPool(&m_cThreadPool);
+#if SVIDEO_PACKED_RESAMPLE_MAP
+    extraGeometries[k]->setPackedMap(pcCfg->m_bPackedResampleMap);
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+    extraGeometries[k]->setSeparableMap(pcCfg->m_bSeparableResample);
+#endif
+#if SVIDEO_BATCH_MAPPING
+    extraGeometries[k]->setFastProjectionMath(m_bFastProjectionMath);
+#endif
+#if SVIDEO_GEOMAP_CACHE
+    extraGeometries[k]->setMapCacheDir(m_geoMapCacheDir);
+#endif
+    extraPicYuvTrueOrg[k] = new TComPicYuv;
+    extraPicYuvTrueOrg[k]->createWithoutCUInfo( pcCfg->m_iSourceWidth, pcCfg->m_iSourceHeight, pcCfg->m_OutputChromaFormatIDC, true );
+    extraPicYuvOrg[k] = new TComPicYuv;
+    extraPicYuvOrg[k]->createWithoutCUInfo( pcCfg->m_iSourceWidth, pcCfg->m_iSourceHeight, pcCfg->m_OutputChromaFormatIDC, true );
+    extraOutputFiles[k] = new TVideoIOYuv;
+#if SVIDEO_FUSED_YUV_WRITE
+    extraOutputFiles[k]->setAsyncWrite(pcCfg->m_bAsyncOutputWrite);
+#endif
+    extraOutputFiles[k]->open(pcCfg->m_pchOutputFile, true, pcCfg->m_outputBitDepth, pcCfg->m_outputBitDepth, pcCfg->m_outputBitDepth);  // write mode
+  }
+#endif
 #if SVIDEO_CPPPSNR
   //pcReferenceGeometry = TGeometry::create(m_referenceSVideoInfo, &m_inputGeoParam);
 #endif
@@ -1508,6 +1813,9 @@ Void  TApp360ConvertCfg::convert()
   {
     cWSPSNRCalc.setCodingGeoInfo(*pcCodingGeomtry->getSVideoInfo(), m_inputGeoParam.iChromaSampleLocType);
     cWSPSNRCalc.createTable(pcPicYuvReadFromRefFile, pcCodingGeomtry);
+#if SVIDEO_WSPSNR_SPANS
+    cWSPSNRCalc.setThreadPool(&m_cThreadPool);
+#endif
   }
 #endif
 #if SVIDEO_SPSNR_I
@@ -1523,6 +1831,16 @@ Void  TApp360ConvertCfg::convert()
   {
     cCPPPSNRCalc.initCPPPSNR(m_inputGeoParam, m_cppPsnrWidth, m_cppPsnrHeight, m_codingSVideoInfo, m_referenceSVideoInfo);
   }
+#endif
+#if SVIDEO_FUSED_METRICS
+  if(m_bFusedMetrics)
+  {
+    cFusedCalc.setBitDepths(m_outputBitDepth, m_referenceBitDepth);
+    cFusedCalc.setSPSNRMetric(m_psnrEnabled[METRIC_SPSNR_NN]? &cSPSNRCalc : NULL);
+    cFusedCalc.setWSPSNRMetric(m_psnrEnabled[METRIC_WSPSNR]? &cWSPSNRCalc : NULL);
+    cFusedCalc.setThreadPool(&m_cThreadPool);
+    cFusedCalc.init(pcPicYuvReadFromRefFile);
+  }
 #endif
   //dump all points on the sphere;
   if(m_pchSpherePointsFile)
@@ -1548,39 +1866,397 @@ Void  TApp360ConvertCfg::convert()
       fclose(fViewPort);
       fViewPort = NULL;
     }
+#if SVIDEO_DIRECT_GEOCONVERT
+    bDirectViewPort = !m_bPackedResampleMap && iNextFrame < m_iViewPortDirectFrames;
+#endif
   }
 
+#if SVIDEO_CONVERT_PIPELINE
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  //source picture pcPicRead to the faces of pcInGeo;
+  auto convertSource = [&](TGeometry *pcInGeo, TComPicYuv *pcPicRead, TComPicYuv *pcPicRot)
+  {
+    if(pcPicRot)
+    {
+      pcPicRead->rot(pcPicRot, (360-m_sourceSVideoInfo.framePackStruct.faces[0][0].rot)%360);
+      pcInGeo->convertYuv(pcPicRot);
+    }
+    else
+    {
+      if((pcInGeo->getSVideoInfo()->geoType == SVIDEO_OCTAHEDRON || pcInGeo->getSVideoInfo()->geoType == SVIDEO_ICOSAHEDRON) && pcInGeo->getSVideoInfo()->iCompactFPStructure) 
+      {
+        pcInGeo->compactFramePackConvertYuv(pcPicRead);
+      }
+      else
+      {
+        pcInGeo->convertYuv(pcPicRead);//***m_pFacesOrig//[face][component][raster scan position]
+      }
+    }  
+  };
+  //faces of pcCodGeo to the output picture pcOrg;
+  auto packFrame = [&](TGeometry *pcCodGeo, TComPicYuv& cTrueOrg, TComPicYuv *pcOrg)
+  {
+    if((pcCodGeo->getSVideoInfo()->geoType == SVIDEO_OCTAHEDRON || pcCodGeo->getSVideoInfo()->geoType == SVIDEO_ICOSAHEDRON) && pcCodGeo->getSVideoInfo()->iCompactFPStructure)
+    {
+      pcCodGeo->compactFramePack(&cTrueOrg);
+    }
+    else
+    {
+      pcCodGeo->framePack(&cTrueOrg);
+    }
+    TVideoIOYuv::ColourSpaceConvert(cTrueOrg, *pcOrg, ipCSC, true);
+  };
+  //conversion of one frame from pcPicRead to pcPicYuvOrg and the pictures of the extra outputs, with one sphere padding of the source;
+  auto convertFrames = [&](TComPicYuv *pcPicRead, Bool bDirect)
+  {
+    convertSource(pcInputGeomtry, pcPicRead, pcPicYuvRot);
+    std::vector<TGeometry*> geoDsts;
+#if SVIDEO_DIRECT_GEOCONVERT
+    if(bDirect)
+      pcInputGeomtry->geoConvertDirect(pcCodingGeomtry);
+    else
+#endif
+    geoDsts.push_back(pcCodingGeomtry);
+    geoDsts.insert(geoDsts.end(), extraGeometries.begin(), extraGeometries.end());
+    pcInputGeomtry->geoConvert(geoDsts);
+
+    packFrame(pcCodingGeomtry, cPicYuvTrueOrg, pcPicYuvOrg);
+    for(Int k=0; k<iNumExtraOutputs; k++)
+      packFrame(extraGeometries[k], *extraPicYuvTrueOrg[k], extraPicYuvOrg[k]);
+  };
+#endif
+  //conversion of one frame from pcPicRead to pcOrg;
+  auto convertFrame = [&](TGeometry *pcInGeo, TGeometry *pcCodGeo, TComPicYuv *pcPicRead, TComPicYuv *pcPicRot, TComPicYuv& cTrueOrg, TComPicYuv *pcOrg, Bool bDirect)
+  {
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+    convertSource(pcInGeo, pcPicRead, pcPicRot);
+#else
+    if(pcPicRot)
+    {
+      pcPicRead->rot(pcPicRot, (360-m_sourceSVideoInfo.framePackStruct.faces[0][0].rot)%360);
+      pcInGeo->convertYuv(pcPicRot);
+    }
+    else
+    {
+      if((pcInGeo->getSVideoInfo()->geoType == SVIDEO_OCTAHEDRON || pcInGeo->getSVideoInfo()->geoType == SVIDEO_ICOSAHEDRON) && pcInGeo->getSVideoInfo()->iCompactFPStructure) 
+      {
+        pcInGeo->compactFramePackConvertYuv(pcPicRead);
+      }
+      else
+      {
+        pcInGeo->convertYuv(pcPicRead);//***m_pFacesOrig//[face][component][raster scan position]
+      }
+    }  
+#endif
+
+    if(!bDirectFPConvert)
+    {
+#if SVIDEO_DIRECT_GEOCONVERT
+      if(bDirect)
+        pcInGeo->geoConvertDirect(pcCodGeo);
+      else
+#endif
+      pcInGeo->geoConvert(pcCodGeo);
+    }
+    else
+    {
+      pcInGeo->setPaddingFlag(true);
+    }
+    if((pcCodGeo->getSVideoInfo()->geoType == SVIDEO_OCTAHEDRON || pcCodGeo->getSVideoInfo()->geoType == SVIDEO_ICOSAHEDRON) && pcCodGeo->getSVideoInfo()->iCompactFPStructure)
+    {
+      if(!bDirectFPConvert)
+      {
+        pcCodGeo->compactFramePack(&cTrueOrg);
+      }
+      else
+      {
+        pcInGeo->compactFramePack(&cTrueOrg);
+      }
+    }
+    else
+    {
+      if(!bDirectFPConvert)
+      {
+        pcCodGeo->framePack(&cTrueOrg);
+      }
+      else
+      {
+        pcInGeo->framePack(&cTrueOrg);
+      }
+    }
+    TVideoIOYuv::ColourSpaceConvert(cTrueOrg, *pcOrg, ipCSC, true);
+  };
+  //metrics of one frame, printed and accumulated;
+  auto calculateMetrics = [&](TComPicYuv *pcRef, TComPicYuv *pcOrg)
+  {
+#if SVIDEO_FUSED_METRICS
+    if(m_bFusedMetrics)
+    {
+      cFusedCalc.calculate(pcRef, pcOrg, m_psnrEnabled[METRIC_PSNR]);
+      if(m_psnrEnabled[METRIC_PSNR])
+        cFusedCalc.setPSNR(&cPSNRCalc, pcOrg);
+    }
+#endif
+#if SVIDEO_SPSNR_NN
+    if(m_psnrEnabled[METRIC_PSNR])
+    {
+#if SVIDEO_FUSED_METRICS
+      if(!m_bFusedMetrics)
+#endif
+      cPSNRCalc.xCalculatePSNR(pcRef, pcOrg);
+      printf(" %6.4lf dB    %6.4lf dB    %6.4lf dB |", cPSNRCalc.getPSNR()[COMPONENT_Y], cPSNRCalc.getPSNR()[COMPONENT_Cb], cPSNRCalc.getPSNR()[COMPONENT_Cr] );
+    }
+    if(m_psnrEnabled[METRIC_SPSNR_NN])
+    {
+#if SVIDEO_FUSED_METRICS
+      if(!m_bFusedMetrics)
+#endif
+      cSPSNRCalc.xCalculateSPSNR(pcRef, pcOrg);
+      printf(" %6.4lf dB    %6.4lf dB    %6.4lf dB |", cSPSNRCalc.getSPSNR()[COMPONENT_Y], cSPSNRCalc.getSPSNR()[COMPONENT_Cb], cSPSNRCalc.getSPSNR()[COMPONENT_Cr] );
+    }
+#endif
+#if SVIDEO_WSPSNR
+    if(m_psnrEnabled[METRIC_WSPSNR])
+    {
+#if SVIDEO_FUSED_METRICS
+      if(!m_bFusedMetrics)
+#endif
+      cWSPSNRCalc.xCalculateWSPSNR(pcRef, pcOrg);
+      printf(" %6.4lf dB    %6.4lf dB    %6.4lf dB |", cWSPSNRCalc.getWSPSNR()[COMPONENT_Y], cWSPSNRCalc.getWSPSNR()[COMPONENT_Cb], cWSPSNRCalc.getWSPSNR()[COMPONENT_Cr] );
+    }
+#endif
+#if SVIDEO_SPSNR_I
+    if(m_psnrEnabled[METRIC_SPSNR_I])
+    {
+      cSPSNRICalc.xCalculateSPSNRI(pcRef, pcOrg);
+      printf(" %6.4lf dB    %6.4lf dB    %6.4lf dB |", cSPSNRICalc.getSPSNRI()[COMPONENT_Y], cSPSNRICalc.getSPSNRI()[COMPONENT_Cb], cSPSNRICalc.getSPSNRI()[COMPONENT_Cr] );
+    }
+#endif
+#if SVIDEO_CPPPSNR
+    if(m_psnrEnabled[METRIC_CPPPSNR])
+    {
+      cCPPPSNRCalc.xCalculateCPPPSNR(pcRef, pcOrg);
+      printf(" %6.4lf dB    %6.4lf dB    %6.4lf dB |", cCPPPSNRCalc.getCPPPSNR()[COMPONENT_Y], cCPPPSNRCalc.getCPPPSNR()[COMPONENT_Cb], cCPPPSNRCalc.getCPPPSNR()[COMPONENT_Cr] );
+    }
+#endif
+    for( Int i = 0; i < MAX_NUM_COMPONENT; i++)
+    {
+#if SVIDEO_SPSNR_NN
+      if(m_psnrEnabled[METRIC_PSNR])
+      {
+        dPSNRSum[METRIC_PSNR][i] += cPSNRCalc.getPSNR()[i];
+      }
+      if(m_psnrEnabled[METRIC_SPSNR_NN])
+      {
+        dPSNRSum[METRIC_SPSNR_NN][i] += cSPSNRCalc.getSPSNR()[i];
+      }
+#endif
+#if SVIDEO_WSPSNR
+      if(m_psnrEnabled[METRIC_WSPSNR])
+      {
+        dPSNRSum[METRIC_WSPSNR][i] += cWSPSNRCalc.getWSPSNR()[i];
+      }
+#endif
+#if SVIDEO_SPSNR_I
+      if(m_psnrEnabled[METRIC_SPSNR_I])
+      {
+        dPSNRSum[METRIC_SPSNR_I][i] += cSPSNRICalc.getSPSNRI()[i];
+      }
+#endif
+#if SVIDEO_CPPPSNR
+      if(m_psnrEnabled[METRIC_CPPPSNR])
+      {
+        dPSNRSum[METRIC_CPPPSNR][i] += cCPPPSNRCalc.getCPPPSNR()[i];
+      }
+#endif
+    }
+  };
+
+#endif
   // starting time
   Double dResult;
   clock_t lBefore = clock();
-
-  while ( !bEos && m_framesToBeConverted)
+#if SVIDEO_MT_GEOMAPPING
+  std::chrono::steady_clock::time_point tBefore = std::chrono::steady_clock::now();
+#endif
+#if SVIDEO_CONVERT_PIPELINE
+  TApp360ConvertPipeline cPipeline;
+  Int iNumWorkers = m_iPipelineWorkers;
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  if(iNumWorkers > 0 && iNumExtraOutputs > 0)
   {
-    // read input YUV file
-    Int aiPad[2]={0,0};
-    cTVideoIOYuvInputFile.read(NULL, pcPicYuvReadFromFile, IPCOLOURSPACE_UNCHANGED, aiPad, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
-    if (cTVideoIOYuvInputFile.isEof())
-      break;
-
-    if(!bGeoConvertSkip)
+    //the outputs share the padded source, the frames are converted one after another with the row bands of all outputs in parallel;
+    printf("PipelineWorkers is ignored with ExtraOutputConfig.\n");
+    iNumWorkers = 0;
+  }
+#endif
+  //worker 0 uses pcInputGeomtry and pcCodingGeomtry, the others have their own geometries and buffers;
+  std::vector<TGeometry*> workerInputGeometries(iNumWorkers, (TGeometry*)NULL), workerCodingGeometries(iNumWorkers, (TGeometry*)NULL);
+  std::vector<TComPicYuv*> workerPicYuvRot(iNumWorkers, (TComPicYuv*)NULL), workerPicYuvTrueOrg(iNumWorkers, (TComPicYuv*)NULL);
+  std::vector<UInt> workerViewPortId(iNumWorkers, 0);
+  std::vector<TApp360PipelineFrame*> pipelineFrames;
+  if(iNumWorkers > 0)
+  {
+    for(Int w=0; w<iNumWorkers; w++)
     {
+      if(w == 0)
+      {
+        workerInputGeometries[w] = pcInputGeomtry;
+        workerCodingGeometries[w] = pcCodingGeomtry;
+        workerPicYuvRot[w] = pcPicYuvRot;
+        workerPicYuvTrueOrg[w] = &cPicYuvTrueOrg;
+        continue;
+      }
+      TGeometry *pcGeometries[2] = { TGeometry::create(m_sourceSVideoInfo, &m_inputGeoParam), TGeometry::create(m_codingSVideoInfo, &m_inputGeoParam) };
+      for(Int i=0; i<2; i++)
+      {
+#if SVIDEO_MT_GEOCONVERT
+        pcGeometries[i]->setThreadPool(&m_cThreadPool);
+#endif
+#if SVIDEO_BATCH_MAPPING
+        pcGeometries[i]->setFastProjectionMath(m_bFastProjectionMath);
+#endif
+#if SVIDEO_GEOMAP_CACHE
+        pcGeometries[i]->setMapCacheDir(m_geoMapCacheDir);
+#endif
+      }
+#if SVIDEO_PACKED_RESAMPLE_MAP
+      pcGeometries[1]->setPackedMap(m_bPackedResampleMap);
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+      pcGeometries[1]->setSeparableMap(m_bSeparableResample);
+#endif
+      workerInputGeometries[w] = pcGeometries[0];
+      workerCodingGeometries[w] = pcGeometries[1];
       if(pcPicYuvRot)
       {
-        pcPicYuvReadFromFile->rot(pcPicYuvRot, (360-m_sourceSVideoInfo.framePackStruct.faces[0][0].rot)%360);
-        pcInputGeomtry->convertYuv(pcPicYuvRot);
+        workerPicYuvRot[w] = new TComPicYuv;
+        workerPicYuvRot[w]->createWithoutCUInfo( iAdjustWidth, iAdjustHeight, m_InputChromaFormatIDC, true );
       }
-      else
+      if(!bGeoConvertSkip)
       {
-        if((pcInputGeomtry->getSVideoInfo()->geoType == SVIDEO_OCTAHEDRON || pcInputGeomtry->getSVideoInfo()->geoType == SVIDEO_ICOSAHEDRON) && pcInputGeomtry->getSVideoInfo()->iCompactFPStructure) 
+        workerPicYuvTrueOrg[w] = new TComPicYuv;
+        workerPicYuvTrueOrg[w]->createWithoutCUInfo( m_iSourceWidth, m_iSourceHeight, m_OutputChromaFormatIDC, true );
+      }
+    }
+    //two frames per worker and one each for reading and writing;
+    pipelineFrames.resize(2*iNumWorkers+2);
+    for(size_t i=0; i<pipelineFrames.size(); i++)
+    {
+      TApp360PipelineFrame *pcFrame = new TApp360PipelineFrame;
+      pcFrame->pcPicYuvRead = new TComPicYuv;
+      pcFrame->pcPicYuvRead->createWithoutCUInfo( m_iInputWidth, m_iInputHeight, m_InputChromaFormatIDC, true );
+      pcFrame->pcPicYuvOrg = pcFrame->pcPicYuvRead;
+      if(!bGeoConvertSkip)
+      {
+        pcFrame->pcPicYuvOrg = new TComPicYuv;
+        pcFrame->pcPicYuvOrg->createWithoutCUInfo( m_iSourceWidth, m_iSourceHeight, m_OutputChromaFormatIDC, true );
+      }
+      pcFrame->pcPicYuvRef = NULL;
+      if(m_pchRefFile)
+      {
+        pcFrame->pcPicYuvRef = new TComPicYuv;
+        pcFrame->pcPicYuvRef->createWithoutCUInfo( pcPicYuvReadFromRefFile->getWidth(COMPONENT_Y), pcPicYuvReadFromRefFile->getHeight(COMPONENT_Y), pcPicYuvReadFromRefFile->getChromaFormat(), true );
+      }
+      pipelineFrames[i] = pcFrame;
+    }
+
+    //the viewport file is parsed by the reader, the viewport of each frame travels with the frame;
+    Float fCurViewPort[4] = { m_codingSVideoInfo.viewPort.hFOV, m_codingSVideoInfo.viewPort.vFOV, m_codingSVideoInfo.viewPort.fYaw, m_codingSVideoInfo.viewPort.fPitch };
+    UInt uiViewPortId = 0;
+    auto readFrame = [&](TApp360PipelineFrame& frame) -> Bool
+    {
+      Int aiPad[2]={0,0};
+      cTVideoIOYuvInputFile.read(NULL, frame.pcPicYuvRead, IPCOLOURSPACE_UNCHANGED, aiPad, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+      if (cTVideoIOYuvInputFile.isEof())
+        return false;
+
+      frame.bViewPortError = false;
+      if(!bGeoConvertSkip && fViewPort && iNextFrame==frame.iFrame)
+      {
+        Float fovx,fovy,yaw,pitch;
+        if(fscanf(fViewPort, "%f %f %f %f ", &fovx,&fovy,&yaw,&pitch) == 4)
         {
-          pcInputGeomtry->compactFramePackConvertYuv(pcPicYuvReadFromFile);
+          fCurViewPort[0] = fovx; fCurViewPort[1] = fovy; fCurViewPort[2] = yaw; fCurViewPort[3] = pitch;
+          uiViewPortId++;
+          if(fscanf(fViewPort, "%d ", &iNextFrame) != 1)
+            iNextFrame = m_framesToBeConverted+1;
+#if SVIDEO_DIRECT_GEOCONVERT
+          bDirectViewPort = !m_bPackedResampleMap && (iNextFrame-frame.iFrame) < m_iViewPortDirectFrames;
+#endif
         }
         else
         {
-          pcInputGeomtry->convertYuv(pcPicYuvReadFromFile);//***m_pFacesOrig//[face][component][raster scan position]
+          frame.bViewPortError = true;
+          iNextFrame = m_framesToBeConverted+1;
+#if SVIDEO_DIRECT_GEOCONVERT
+          bDirectViewPort = false;
+#endif
         }
-      }  
+      }
+      for(Int i=0; i<4; i++)
+        frame.fViewPort[i] = fCurViewPort[i];
+      frame.uiViewPortId = uiViewPortId;
+#if SVIDEO_DIRECT_GEOCONVERT
+      frame.bDirectViewPort = bDirectViewPort;
+#else
+      frame.bDirectViewPort = false;
+#endif
 
+      // temporally skip frames
+      if( m_temporalSubsampleRatio > 1 )
+      {
+        cTVideoIOYuvInputFile.skipFrames(m_temporalSubsampleRatio-1, m_iInputWidth, m_iInputHeight, m_InputChromaFormatIDC);
+      }
+      frame.bRefValid = false;
+      if(m_pchRefFile)
+      {
+        cTVideoIOYuvRefFile.read(NULL, frame.pcPicYuvRef, IPCOLOURSPACE_UNCHANGED, aiPad, m_OutputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+        frame.bRefValid = !cTVideoIOYuvRefFile.isEof();
+      }
+      return true;
+    };
+    auto convertPipelineFrame = [&](Int iWorker, TApp360PipelineFrame& frame)
+    {
+      if(bGeoConvertSkip)
+        return;
+      if(workerViewPortId[iWorker] != frame.uiViewPortId)
+      {
+        ((TViewPort*)workerCodingGeometries[iWorker])->setViewPort(frame.fViewPort[0], frame.fViewPort[1], frame.fViewPort[2], frame.fViewPort[3]);
+        workerViewPortId[iWorker] = frame.uiViewPortId;
+      }
+      convertFrame(workerInputGeometries[iWorker], workerCodingGeometries[iWorker], frame.pcPicYuvRead, workerPicYuvRot[iWorker], *workerPicYuvTrueOrg[iWorker], frame.pcPicYuvOrg, frame.bDirectViewPort);
+    };
+    auto writeFrame = [&](TApp360PipelineFrame& frame)
+    {
+      if (m_pchOutputFile)
+      {
+        cTVideoIOYuvOutputFile.write( frame.pcPicYuvOrg, ipCSCOutput, m_confWinLeft, m_confWinRight, m_confWinTop, m_confWinBottom, NUM_CHROMA_FORMAT, m_bClipOutputVideoToRec709Range  );
+      }
+    };
+    auto metricFrame = [&](TApp360PipelineFrame& frame)
+    {
+      if(frame.bViewPortError)
+        printf("Frame:%d, format error for viewport settings. The viewport will not be changed any more!\n", frame.iFrame);
+      printf("\nFrame:%d ", frame.iFrame);
+      if(m_pchRefFile && frame.bRefValid)
+        calculateMetrics(frame.pcPicYuvRef, frame.pcPicYuvOrg);
+    };
+    iNumConverted = cPipeline.run(iNumWorkers, m_framesToBeConverted, pipelineFrames, readFrame, convertPipelineFrame, writeFrame, metricFrame);
+    bEos = true;
+  }
+#endif
+
+  while ( !bEos && m_framesToBeConverted)
+  {
+    // read input YUV file
+    Int aiPad[2]={0,0};
+    cTVideoIOYuvInputFile.read(NULL, pcPicYuvReadFromFile, IPCOLOURSPACE_UNCHANGED, aiPad, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+    if (cTVideoIOYuvInputFile.isEof())
+      break;
+
+    if(!bGeoConvertSkip)
+    {
       if(fViewPort)
       {
         if (iNextFrame==iNumConverted)
@@ -1591,17 +2267,62 @@ Void  TApp360ConvertCfg::convert()
             ((TViewPort*)pcCodingGeomtry)->setViewPort(fovx,fovy,yaw,pitch);
             if(fscanf(fViewPort, "%d ", &iNextFrame) != 1)
               iNextFrame = m_framesToBeConverted+1;
+#if SVIDEO_DIRECT_GEOCONVERT
+            //the mapping tables do not pay off for viewports kept only a few frames;
+            bDirectViewPort = !m_bPackedResampleMap && (iNextFrame-iNumConverted) < m_iViewPortDirectFrames;
+#endif
           }
           else
           {
             printf("Frame:%d, format error for viewport settings. The viewport will not be changed any more!\n", iNumConverted);
             iNextFrame = m_framesToBeConverted+1;
+#if SVIDEO_DIRECT_GEOCONVERT
+            bDirectViewPort = false;
+#endif
           }
         }
       }
 
+#if SVIDEO_CONVERT_PIPELINE
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+      if(iNumExtraOutputs > 0)
+#if SVIDEO_DIRECT_GEOCONVERT
+        convertFrames(pcPicYuvReadFromFile, bDirectViewPort);
+#else
+        convertFrames(pcPicYuvReadFromFile, false);
+#endif
+      else
+#endif
+#if SVIDEO_DIRECT_GEOCONVERT
+      convertFrame(pcInputGeomtry, pcCodingGeomtry, pcPicYuvReadFromFile, pcPicYuvRot, cPicYuvTrueOrg, pcPicYuvOrg, bDirectViewPort);
+#else
+      convertFrame(pcInputGeomtry, pcCodingGeomtry, pcPicYuvReadFromFile, pcPicYuvRot, cPicYuvTrueOrg, pcPicYuvOrg, false);
+#endif
+#else
+      if(pcPicYuvRot)
+      {
+        pcPicYuvReadFromFile->rot(pcPicYuvRot, (360-m_sourceSVideoInfo.framePackStruct.faces[0][0].rot)%360);
+        pcInputGeomtry->convertYuv(pcPicYuvRot);
+      }
+      else
+      {
+        if((pcInputGeomtry->getSVideoInfo()->geoType == SVIDEO_OCTAHEDRON || pcInputGeomtry->getSVideoInfo()->geoType == SVIDEO_ICOSAHEDRON) && pcInputGeomtry->getSVideoInfo()->iCompactFPStructure) 
+        {
+          pcInputGeomtry->compactFramePackConvertYuv(pcPicYuvReadFromFile);
+        }
+        else
+        {
+          pcInputGeomtry->convertYuv(pcPicYuvReadFromFile);//***m_pFacesOrig//[face][component][raster scan position]
+        }
+      }  
+
       if(!bDirectFPConvert)
       {
+#if SVIDEO_DIRECT_GEOCONVERT
+        if(bDirectViewPort)
+          pcInputGeomtry->geoConvertDirect(pcCodingGeomtry);
+        else
+#endif
         pcInputGeomtry->geoConvert(pcCodingGeomtry);
       }
       else
@@ -1631,6 +2352,7 @@ Void  TApp360ConvertCfg::convert()
         }
       }
       cTVideoIOYuvInputFile.ColourSpaceConvert(cPicYuvTrueOrg, *pcPicYuvOrg, ipCSC, true);
+#endif
     }
     else
       pcPicYuvOrg = pcPicYuvReadFromFile;
@@ -1646,6 +2368,14 @@ Void  TApp360ConvertCfg::convert()
     {
       cTVideoIOYuvOutputFile.write( pcPicYuvOrg, ipCSCOutput, m_confWinLeft, m_confWinRight, m_confWinTop, m_confWinBottom, NUM_CHROMA_FORMAT, m_bClipOutputVideoToRec709Range  );
     }
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+    for(Int k=0; k<iNumExtraOutputs; k++)
+    {
+      TApp360ConvertCfg *pcCfg = m_extraOutputs[k];
+      const InputColourSpaceConversion extraCSCOutput = (!pcCfg->m_outputInternalColourSpace) ? ipCSC : IPCOLOURSPACE_UNCHANGED;
+      extraOutputFiles[k]->write( extraPicYuvOrg[k], extraCSCOutput, pcCfg->m_confWinLeft, pcCfg->m_confWinRight, pcCfg->m_confWinTop, pcCfg->m_confWinBottom, NUM_CHROMA_FORMAT, pcCfg->m_bClipOutputVideoToRec709Range );
+    }
+#endif
 
     // temporally skip frames
     if( m_temporalSubsampleRatio > 1 )
@@ -1657,14 +2387,31 @@ Void  TApp360ConvertCfg::convert()
       cTVideoIOYuvRefFile.read(NULL, pcPicYuvReadFromRefFile, IPCOLOURSPACE_UNCHANGED, aiPad, m_OutputChromaFormatIDC, m_bClipInputVideoToRec709Range );
       if (!cTVideoIOYuvRefFile.isEof())
       {
+#if SVIDEO_CONVERT_PIPELINE
+        calculateMetrics(pcPicYuvReadFromRefFile, pcPicYuvOrg);
+#else
+#if SVIDEO_FUSED_METRICS
+        if(m_bFusedMetrics)
+        {
+          cFusedCalc.calculate(pcPicYuvReadFromRefFile, pcPicYuvOrg, m_psnrEnabled[METRIC_PSNR]);
+          if(m_psnrEnabled[METRIC_PSNR])
+            cFusedCalc.setPSNR(&cPSNRCalc, pcPicYuvOrg);
+        }
+#endif
 #if SVIDEO_SPSNR_NN
         if(m_psnrEnabled[METRIC_PSNR])
         {
+#if SVIDEO_FUSED_METRICS
+          if(!m_bFusedMetrics)
+#endif
           cPSNRCalc.xCalculatePSNR(pcPicYuvReadFromRefFile, pcPicYuvOrg);
           printf(" %6.4lf dB    %6.4lf dB    %6.4lf dB |", cPSNRCalc.getPSNR()[COMPONENT_Y], cPSNRCalc.getPSNR()[COMPONENT_Cb], cPSNRCalc.getPSNR()[COMPONENT_Cr] );
         }
         if(m_psnrEnabled[METRIC_SPSNR_NN])
         {
+#if SVIDEO_FUSED_METRICS
+          if(!m_bFusedMetrics)
+#endif
           cSPSNRCalc.xCalculateSPSNR(pcPicYuvReadFromRefFile, pcPicYuvOrg);
           printf(" %6.4lf dB    %6.4lf dB    %6.4lf dB |", cSPSNRCalc.getSPSNR()[COMPONENT_Y], cSPSNRCalc.getSPSNR()[COMPONENT_Cb], cSPSNRCalc.getSPSNR()[COMPONENT_Cr] );
         }
@@ -1672,6 +2419,9 @@ Void  TApp360ConvertCfg::convert()
 #if SVIDEO_WSPSNR
         if(m_psnrEnabled[METRIC_WSPSNR])
         {
+#if SVIDEO_FUSED_METRICS
+          if(!m_bFusedMetrics)
+#endif
           cWSPSNRCalc.xCalculateWSPSNR(pcPicYuvReadFromRefFile, pcPicYuvOrg);
           printf(" %6.4lf dB    %6.4lf dB    %6.4lf dB |", cWSPSNRCalc.getWSPSNR()[COMPONENT_Y], cWSPSNRCalc.getWSPSNR()[COMPONENT_Cb], cWSPSNRCalc.getWSPSNR()[COMPONENT_Cr] );
         }
@@ -1721,6 +2471,7 @@ Void  TApp360ConvertCfg::convert()
           }
 #endif
         }
+#endif
       }
     }
   }
@@ -1736,9 +2487,49 @@ Void  TApp360ConvertCfg::convert()
     printf("\n");
   }
 
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  if(!bGeoConvertSkip && !bDirectFPConvert
+#if SVIDEO_SEPARABLE_RESAMPLE
+     && !pcCodingGeomtry->isSeparableMapped()
+#endif
+    )
+  {
+    const Double dMB = 1.0/(1024*1024);
+    printf("\n Resampling map memory (MB): map %.3f + weights %.3f (%s layout in use); map %.3f + weights %.3f with the %s layout\n",
+           pcCodingGeomtry->getMapMemorySize(m_bPackedResampleMap)*dMB, pcInputGeomtry->getWeightLutMemorySize(m_bPackedResampleMap)*dMB, m_bPackedResampleMap? "packed" : "default",
+           pcCodingGeomtry->getMapMemorySize(!m_bPackedResampleMap)*dMB, pcInputGeomtry->getWeightLutMemorySize(!m_bPackedResampleMap)*dMB, m_bPackedResampleMap? "default" : "packed");
+  }
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+  if(!bGeoConvertSkip && !bDirectFPConvert && pcCodingGeomtry->isSeparableMapped())
+    printf("\n Separable resampling map memory (MB): %.3f\n", pcCodingGeomtry->getSeparableMapMemorySize()/(1024.0*1024));
+#endif
+
   // ending time
   dResult = (Double)(clock()-lBefore) / CLOCKS_PER_SEC;
   printf("\n Total Time: %12.3f sec.\n", dResult);
+#if SVIDEO_MT_GEOMAPPING
+  if(!bGeoConvertSkip)
+  {
+    Double dWallTime = std::chrono::duration<Double>(std::chrono::steady_clock::now() - tBefore).count();
+    Double dMappingTime = pcInputGeomtry->getMappingTime() + pcCodingGeomtry->getMappingTime();
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+    for(Int k=0; k<iNumExtraOutputs; k++)
+      dMappingTime += extraGeometries[k]->getMappingTime();
+#endif
+#if SVIDEO_CONVERT_PIPELINE
+    //the workers build their tables concurrently;
+    for(Int w=1; w<iNumWorkers; w++)
+      dMappingTime = std::max(dMappingTime, workerInputGeometries[w]->getMappingTime() + workerCodingGeometries[w]->getMappingTime());
+#endif
+    printf(" Mapping table build time (wall): %12.3f sec.\n", dMappingTime);
+    printf(" Frame processing time (wall):    %12.3f sec.\n", dWallTime - dMappingTime);
+  }
+#endif
+#if SVIDEO_CONVERT_PIPELINE
+  if(iNumWorkers > 0)
+    cPipeline.printStatistics();
+#endif
 
   if(fViewPort)
     fclose(fViewPort);
@@ -1783,6 +2574,40 @@ Void  TApp360ConvertCfg::convert()
     delete pcPicYuvReadFromRefFile;
     pcPicYuvReadFromRefFile = NULL;
   }
+#if SVIDEO_CONVERT_PIPELINE
+  for(size_t i=0; i<pipelineFrames.size(); i++)
+  {
+    TApp360PipelineFrame *pcFrame = pipelineFrames[i];
+    if(pcFrame->pcPicYuvOrg != pcFrame->pcPicYuvRead)
+    {
+      pcFrame->pcPicYuvOrg->destroy();
+      delete pcFrame->pcPicYuvOrg;
+    }
+    pcFrame->pcPicYuvRead->destroy();
+    delete pcFrame->pcPicYuvRead;
+    if(pcFrame->pcPicYuvRef)
+    {
+      pcFrame->pcPicYuvRef->destroy();
+      delete pcFrame->pcPicYuvRef;
+    }
+    delete pcFrame;
+  }
+  for(Int w=1; w<iNumWorkers; w++)
+  {
+    if(workerPicYuvRot[w])
+    {
+      workerPicYuvRot[w]->destroy();
+      delete workerPicYuvRot[w];
+    }
+    if(workerPicYuvTrueOrg[w])
+    {
+      workerPicYuvTrueOrg[w]->destroy();
+      delete workerPicYuvTrueOrg[w];
+    }
+    delete workerInputGeometries[w];
+    delete workerCodingGeometries[w];
+  }
+#endif
   if(pcInputGeomtry)
   {
     delete pcInputGeomtry;
@@ -1793,6 +2618,18 @@ Void  TApp360ConvertCfg::convert()
     delete pcCodingGeomtry;
     pcCodingGeomtry=NULL;
   }
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  for(Int k=0; k<iNumExtraOutputs; k++)
+  {
+    extraOutputFiles[k]->close();
+    delete extraOutputFiles[k];
+    extraPicYuvTrueOrg[k]->destroy();
+    delete extraPicYuvTrueOrg[k];
+    extraPicYuvOrg[k]->destroy();
+    delete extraPicYuvOrg[k];
+    delete extraGeometries[k];
+  }
+#endif
 }
 
 Bool confirmPara(Bool bflag, const Char* message)
@@ -62,6 +62,9 @@ enum SNRType
 #endif
   METRIC_NUM
 };
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+static const Int SV_MAX_EXTRA_OUTPUTS = 8;                    ///< max. number of ExtraOutputConfig options
+#endif
 
 // ====================================================================================================================
 // Class definition
@@ -127,6 +130,44 @@ protected:
 
   UInt  m_temporalSubsampleRatio;                         ///< temporal subsample ratio, 2 means code every two frames
   Int   m_faceSizeAlignment;
+#if SVIDEO_MT_GEOCONVERT
+  Int   m_iGeoConvertThreads;                             ///< number of threads for geometry conversion, 1: serial
+  TComThreadPool m_cThreadPool;
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  Bool  m_bPackedResampleMap;                             ///< packed map with quantised phase for geometry conversion
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+  Bool  m_bSeparableResample;                             ///< two-pass resampling between ERP or EAP geometries without rotation
+#endif
+#if SVIDEO_BATCH_MAPPING
+  Bool  m_bFastProjectionMath;                            ///< polynomial trigonometry in the projection mapping
+#endif
+#if SVIDEO_GEOMAP_CACHE
+  std::string m_geoMapCacheDir;                           ///< directory of the geometry mapping table cache, empty: disabled
+#endif
+#if SVIDEO_DIRECT_GEOCONVERT
+  Int   m_iViewPortDirectFrames;                          ///< viewports of the viewport file kept for fewer frames are converted without mapping tables
+#endif
+#if SVIDEO_CONVERT_PIPELINE
+  Int   m_iPipelineWorkers;                               ///< frame conversion workers of the pipeline, 0: sequential
+#endif
+#if SVIDEO_MMAP_YUV_READER
+  Int   m_iMemoryMappedInput;                             ///< 0: stream input, 1: memory-mapped input, 2: with read-ahead
+#endif
+#if SVIDEO_FUSED_YUV_WRITE
+  Bool  m_bAsyncOutputWrite;                              ///< output frames are written on a background thread
+#endif
+#if SVIDEO_SPH_SAMPLE_POINTS
+  std::string m_sphFileBinaryOutput;                      ///< binary sphere point file written from SphFile, empty: none
+#endif
+#if SVIDEO_FUSED_METRICS
+  Bool  m_bFusedMetrics;                                  ///< PSNR, WS-PSNR and S-PSNR-NN in one pass over the frames
+#endif
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  Bool  m_bExtraOutput;                                   ///< this configuration describes an extra output of another one
+  std::vector<TApp360ConvertCfg*> m_extraOutputs;         ///< outputs converted from the same source in the same run
+#endif
 
   //snr flags
   Bool m_psnrEnabled[METRIC_NUM];                                     //0-psnr;1-spsnr;2-wspsnr;
@@ -147,6 +188,9 @@ protected:
   Void  xCheckParameter ();                                   ///< check validity of configuration values
   Void  xPrintParameter ();                                   ///< print configuration values
   Void  xPrintUsage     ();                                   ///< print usage
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  Bool  xParseExtraOutput(Int argc, Char* argv[], const std::string& cfgFile); ///< parse one ExtraOutputConfig on top of the command line
+#endif
 
   Void fillSourceSVideoInfo(SVideoInfo& sourceSVideoInfo, Int inputWidth, Int inputHeight);
   Void calcOutputResolution(SVideoInfo& sourceSVideoInfo, SVideoInfo& codingSVideoInfo, Int& iOutputWidth, Int& iOutputHeight, Int minCuSize=8);
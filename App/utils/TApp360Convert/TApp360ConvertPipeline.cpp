@@ -0,0 +1,250 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2016, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TApp360ConvertPipeline.cpp
+    \brief    read / convert / write / metric pipeline of the 360 converter
+*/
+
+#include <stdio.h>
+#include <thread>
+#include <chrono>
+#include "TApp360ConvertPipeline.h"
+
+#if SVIDEO_CONVERT_PIPELINE
+
+//! \ingroup TApp360Convert
+//! \{
+
+typedef std::chrono::steady_clock PipelineClock;
+
+static Double getSeconds(const PipelineClock::time_point& tStart)
+{
+  return std::chrono::duration<Double>(PipelineClock::now() - tStart).count();
+}
+
+// ====================================================================================================================
+// TApp360PipelineQueue
+// ====================================================================================================================
+
+TApp360PipelineQueue::TApp360PipelineQueue()
+: m_bClosed      (false)
+, m_dOccupancySum(0)
+, m_iNumPush     (0)
+, m_iMaxOccupancy(0)
+{
+}
+
+Void TApp360PipelineQueue::push(TApp360PipelineFrame *pcFrame)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frames.push_back(pcFrame);
+    Int iOccupancy = (Int)m_frames.size();
+    m_dOccupancySum += iOccupancy;
+    m_iNumPush++;
+    m_iMaxOccupancy = std::max(m_iMaxOccupancy, iOccupancy);
+  }
+  m_cv.notify_all();
+}
+
+TApp360PipelineFrame* TApp360PipelineQueue::pop()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [this]() { return !m_frames.empty() || m_bClosed; });
+  if(m_frames.empty())
+  {
+    return NULL;
+  }
+  TApp360PipelineFrame *pcFrame = m_frames.front();
+  m_frames.pop_front();
+  return pcFrame;
+}
+
+TApp360PipelineFrame* TApp360PipelineQueue::popFrame(Int iFrame)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  std::deque<TApp360PipelineFrame*>::iterator it;
+  m_cv.wait(lock, [this, iFrame, &it]()
+  {
+    for(it = m_frames.begin(); it != m_frames.end(); it++)
+    {
+      if((*it)->iFrame == iFrame)
+      {
+        return true;
+      }
+    }
+    return m_bClosed;
+  });
+  if(it == m_frames.end())
+  {
+    return NULL;
+  }
+  TApp360PipelineFrame *pcFrame = *it;
+  m_frames.erase(it);
+  return pcFrame;
+}
+
+Void TApp360PipelineQueue::close()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bClosed = true;
+  }
+  m_cv.notify_all();
+}
+
+// ====================================================================================================================
+// TApp360ConvertPipeline
+// ====================================================================================================================
+
+TApp360ConvertPipeline::TApp360ConvertPipeline()
+: m_iNumWorkers(0)
+, m_dWallTime  (0)
+{
+  for(Int i=0; i<NUM_STAGES; i++)
+  {
+    m_aiFrames[i] = 0;
+    m_adBusyTime[i] = 0;
+  }
+}
+
+Int TApp360ConvertPipeline::run(Int iNumWorkers, Int iMaxFrames, std::vector<TApp360PipelineFrame*>& frames,
+                                const ReadFunc& readFrame, const ConvertFunc& convertFrame, const FrameFunc& writeFrame, const FrameFunc& metricFrame)
+{
+  PipelineClock::time_point tStart = PipelineClock::now();
+  m_iNumWorkers = iNumWorkers;
+  for(size_t i=0; i<frames.size(); i++)
+  {
+    m_freeQueue.push(frames[i]);
+  }
+
+  std::thread reader([&]()
+  {
+    for(Int iFrame=0; iFrame<iMaxFrames; iFrame++)
+    {
+      TApp360PipelineFrame *pcFrame = m_freeQueue.pop();
+      PipelineClock::time_point t = PipelineClock::now();
+      pcFrame->iFrame = iFrame;
+      Bool bRead = readFrame(*pcFrame);
+      m_adBusyTime[STAGE_READ] += getSeconds(t);
+      if(!bRead)
+      {
+        break;
+      }
+      m_aiFrames[STAGE_READ]++;
+      m_convertQueue.push(pcFrame);
+    }
+    m_convertQueue.close();
+  });
+
+  Int iNumActiveWorkers = iNumWorkers;
+  std::vector<std::thread> workers;
+  for(Int iWorker=0; iWorker<iNumWorkers; iWorker++)
+  {
+    workers.push_back(std::thread([&, iWorker]()
+    {
+      Double dBusyTime = 0;
+      Int iFrames = 0;
+      while(TApp360PipelineFrame *pcFrame = m_convertQueue.pop())
+      {
+        PipelineClock::time_point t = PipelineClock::now();
+        convertFrame(iWorker, *pcFrame);
+        dBusyTime += getSeconds(t);
+        iFrames++;
+        m_writeQueue.push(pcFrame);
+      }
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_adBusyTime[STAGE_CONVERT] += dBusyTime;
+      m_aiFrames[STAGE_CONVERT] += iFrames;
+      if(--iNumActiveWorkers == 0)
+      {
+        m_writeQueue.close();
+      }
+    }));
+  }
+
+  //the output is written in frame order;
+  std::thread writer([&]()
+  {
+    for(Int iFrame=0; ; iFrame++)
+    {
+      TApp360PipelineFrame *pcFrame = m_writeQueue.popFrame(iFrame);
+      if(!pcFrame)
+      {
+        break;
+      }
+      PipelineClock::time_point t = PipelineClock::now();
+      writeFrame(*pcFrame);
+      m_adBusyTime[STAGE_WRITE] += getSeconds(t);
+      m_aiFrames[STAGE_WRITE]++;
+      m_metricQueue.push(pcFrame);
+    }
+    m_metricQueue.close();
+  });
+
+  //the metrics and the per-frame printout stay on the calling thread;
+  while(TApp360PipelineFrame *pcFrame = m_metricQueue.pop())
+  {
+    PipelineClock::time_point t = PipelineClock::now();
+    metricFrame(*pcFrame);
+    m_adBusyTime[STAGE_METRIC] += getSeconds(t);
+    m_aiFrames[STAGE_METRIC]++;
+    m_freeQueue.push(pcFrame);
+  }
+
+  reader.join();
+  for(size_t i=0; i<workers.size(); i++)
+  {
+    workers[i].join();
+  }
+  writer.join();
+  m_dWallTime = getSeconds(tStart);
+  return m_aiFrames[STAGE_METRIC];
+}
+
+Void TApp360ConvertPipeline::printStatistics()
+{
+  static const Char *stageNames[NUM_STAGES] = { "read", "convert", "write", "metric" };
+  const TApp360PipelineQueue *inputQueues[NUM_STAGES] = { &m_freeQueue, &m_convertQueue, &m_writeQueue, &m_metricQueue };
+  printf("\n Pipeline: %d conversion worker(s), wall time %.3f sec.\n", m_iNumWorkers, m_dWallTime);
+  printf(" Stage      Frames   Busy(sec)   Frames/busy sec   Input queue avg/max\n");
+  for(Int i=0; i<NUM_STAGES; i++)
+  {
+    printf(" %-8s %8d %11.3f %17.2f %14.2f/%d\n", stageNames[i], m_aiFrames[i], m_adBusyTime[i], m_adBusyTime[i] > 0? m_aiFrames[i]/m_adBusyTime[i] : 0.0,
+           inputQueues[i]->getAverageOccupancy(), inputQueues[i]->getMaxOccupancy());
+  }
+}
+
+//! \}
+
+#endif
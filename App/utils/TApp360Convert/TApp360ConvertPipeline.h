@@ -0,0 +1,131 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2016, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TApp360ConvertPipeline.h
+    \brief    read / convert / write / metric pipeline of the 360 converter (header)
+*/
+
+#ifndef __TAPP360CONVERTPIPELINE__
+#define __TAPP360CONVERTPIPELINE__
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+#include "TLib360/TGeometry.h"
+
+#if SVIDEO_CONVERT_PIPELINE
+
+//! \ingroup TApp360Convert
+//! \{
+
+class TComPicYuv;
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// one frame in flight; the pictures are owned by the caller and reused for later frames
+struct TApp360PipelineFrame
+{
+  Int         iFrame;               ///< index of the converted frame, set by the pipeline
+  TComPicYuv *pcPicYuvRead;         ///< input as read from the file
+  TComPicYuv *pcPicYuvOrg;          ///< converted frame
+  TComPicYuv *pcPicYuvRef;          ///< reference for the metrics, NULL: no reference file
+  Bool        bRefValid;            ///< reference frame read
+  Bool        bViewPortError;       ///< format error of the viewport file at this frame
+  Float       fViewPort[4];         ///< fovx, fovy, yaw, pitch of this frame
+  UInt        uiViewPortId;         ///< incremented whenever the viewport file sets a viewport
+  Bool        bDirectViewPort;      ///< convert without mapping tables
+};
+
+/// FIFO between two stages; the number of frames in flight is bounded by the frame pool
+class TApp360PipelineQueue
+{
+public:
+  TApp360PipelineQueue();
+
+  Void  push          ( TApp360PipelineFrame *pcFrame );
+  /// next frame, NULL when the queue is closed and empty
+  TApp360PipelineFrame* pop ();
+  /// frame iFrame, in order of the frame indices; NULL when the queue is closed and the frame is missing
+  TApp360PipelineFrame* popFrame ( Int iFrame );
+  Void  close         ();
+
+  Double getAverageOccupancy() const { return m_iNumPush? m_dOccupancySum/m_iNumPush : 0; }
+  Int    getMaxOccupancy    () const { return m_iMaxOccupancy; }
+
+private:
+  std::deque<TApp360PipelineFrame*> m_frames;
+  std::mutex                        m_mutex;
+  std::condition_variable           m_cv;
+  Bool                              m_bClosed;
+  Double                            m_dOccupancySum;  ///< occupancy after each push
+  Int                               m_iNumPush;
+  Int                               m_iMaxOccupancy;
+};
+
+/// reader thread -> conversion workers -> ordered writer thread -> metric stage on the calling thread
+class TApp360ConvertPipeline
+{
+public:
+  typedef std::function<Bool(TApp360PipelineFrame&)>      ReadFunc;     ///< false: no more frames
+  typedef std::function<Void(Int, TApp360PipelineFrame&)> ConvertFunc;  ///< (worker index, frame)
+  typedef std::function<Void(TApp360PipelineFrame&)>      FrameFunc;
+
+  TApp360ConvertPipeline();
+
+  /// run the stages until the reader returns false or iMaxFrames frames are read; returns the number of frames passed through
+  Int   run           ( Int iNumWorkers, Int iMaxFrames, std::vector<TApp360PipelineFrame*>& frames,
+                        const ReadFunc& readFrame, const ConvertFunc& convertFrame, const FrameFunc& writeFrame, const FrameFunc& metricFrame );
+  Void  printStatistics();
+
+private:
+  enum Stage { STAGE_READ = 0, STAGE_CONVERT, STAGE_WRITE, STAGE_METRIC, NUM_STAGES };
+
+  Int                   m_iNumWorkers;
+  Int                   m_aiFrames[NUM_STAGES];
+  Double                m_adBusyTime[NUM_STAGES];   ///< seconds, summed over the workers
+  Double                m_dWallTime;
+  std::mutex            m_mutex;
+  TApp360PipelineQueue  m_freeQueue;
+  TApp360PipelineQueue  m_convertQueue;
+  TApp360PipelineQueue  m_writeQueue;
+  TApp360PipelineQueue  m_metricQueue;
+};
+
+//! \}
+
+#endif
+#endif // __TAPP360CONVERTPIPELINE__
@@ -0,0 +1,547 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2016, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Conformance check of the SIMD functions: every SIMD level supported by the
+ * CPU is run on random blocks and compared with the C functions (SIMD_NONE).
+ * Returns EXIT_FAILURE if any level differs. */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "TLibCommon/TComInterpolationFilter.h"
+#include "TLibCommon/TComChromaFormat.h"
+#include "TLibCommon/TComRdCost.h"
+#include "TLibCommon/TComPattern.h"
+#include "TLibCommon/TComRom.h"
+#include "TLibCommon/TComSimd.h"
+#include "TLib360/TGeometry.h"
+#include "TLib360/TWSPSNRMetricCalc.h"
+#include "TLib360/TSphMath.h"
+
+using namespace std;
+
+#if SIMD_INTERPOLATION_FILTER || SIMD_DISTORTION || SVIDEO_SIMD_FILTER_GATHER || SVIDEO_SIMD_WSPSNR || SVIDEO_SIMD_SPH_MATH
+static UInt s_seed = 1;
+
+static Int xRand( Int range )
+{
+  s_seed = s_seed * 1103515245 + 12345;
+  return Int( ( s_seed >> 8 ) % UInt( range ) );
+}
+#endif
+
+#if SIMD_INTERPOLATION_FILTER
+
+static const Int S_BUF_STRIDE = 96;   ///< room for 80 columns plus the filter margins
+static const Int S_BUF_HEIGHT = 48;
+static const Int S_BUF_MARGIN = 8;    ///< rows and columns in front of the block read by the filters
+static const Pel S_DST_GUARD  = 0x5A5A;
+
+/// fills the source with samples of bitDepth bits, or with intermediate values of the two-stage filter
+static Void xFillSource( vector<Pel>& src, Int bitDepth, Bool isFirst )
+{
+  for ( size_t i = 0; i < src.size(); i++ )
+  {
+    src[i] = isFirst ? Pel( xRand( 1 << bitDepth ) ) : Pel( xRand( 1 << 16 ) - ( 1 << 15 ) );
+  }
+}
+
+/**
+ * \brief filters the same block with the C functions and with the SIMD level, for every fractional position,
+ * both directions and every first/last stage; the destination is compared with its guard band
+ * \param bPrintMismatch print the first block that differs
+ * \returns the number of blocks that differ
+ */
+static Int xCheckInterpolationFilter( SimdLevel level, Int bitDepth, Int width, Int height, Bool bPrintMismatch )
+{
+  TComInterpolationFilter filter;
+  vector<Pel> src( S_BUF_STRIDE * S_BUF_HEIGHT );
+  vector<Pel> dstC( S_BUF_STRIDE * S_BUF_HEIGHT );
+  vector<Pel> dstSimd( S_BUF_STRIDE * S_BUF_HEIGHT );
+  Pel *pSrc = &src[S_BUF_MARGIN * S_BUF_STRIDE + S_BUF_MARGIN];
+  Int numErrors = 0;
+
+  for ( Int comp = 0; comp < 2; comp++ )
+  {
+    // luma has quarter sample positions; the chroma positions of 4:2:0 are the 1/8 sample positions of the 4-tap filter
+    const ComponentID compID  = comp ? COMPONENT_Cb : COMPONENT_Y;
+    const Int         numFrac = comp ? CHROMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS : LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS;
+    for ( Int frac = 1; frac < numFrac; frac++ )
+    {
+      // 0/1: horizontal last or not; 2..5: vertical with isFirst = mode & 1, isLast = mode & 2
+      for ( Int mode = 0; mode < 6; mode++ )
+      {
+        const Bool isVertical = mode >= 2;
+        const Bool isFirst    = isVertical ? ( mode & 1 ) != 0 : true;
+        const Bool isLast     = isVertical ? ( mode & 2 ) != 0 : mode == 1;
+        xFillSource( src, bitDepth, isFirst );
+
+        for ( Int run = 0; run < 2; run++ )
+        {
+          vector<Pel>& dst = run ? dstSimd : dstC;
+          fill( dst.begin(), dst.end(), S_DST_GUARD );
+          setSimdLevel( run ? level : SIMD_NONE );
+          if ( isVertical )
+          {
+            filter.filterVer( compID, pSrc, S_BUF_STRIDE, &dst[S_BUF_MARGIN], S_BUF_STRIDE, width, height, frac, isFirst, isLast, CHROMA_420, bitDepth );
+          }
+          else
+          {
+            filter.filterHor( compID, pSrc, S_BUF_STRIDE, &dst[S_BUF_MARGIN], S_BUF_STRIDE, width, height, frac, isLast, CHROMA_420, bitDepth );
+          }
+        }
+        if ( dstC != dstSimd )
+        {
+          if ( bPrintMismatch && numErrors == 0 )
+          {
+            printf( "\n  mismatch: %s frac %d %s isFirst %d isLast %d bit depth %d block %dx%d", comp ? "chroma" : "luma", frac,
+                    isVertical ? "vertical" : "horizontal", isFirst, isLast, bitDepth, width, height );
+          }
+          numErrors++;
+        }
+      }
+    }
+  }
+  return numErrors;
+}
+
+static Bool checkInterpolationFilter( SimdLevel level )
+{
+  Int numErrors = 0;
+  Int numBlocks = 0;
+  for ( Int bitDepth = 8; bitDepth <= 12; bitDepth++ )
+  {
+    // every width up to 80 covers all splits between the AVX2, SSE4.1 and C columns
+    for ( Int width = 1; width <= 80; width++ )
+    {
+      numErrors += xCheckInterpolationFilter( level, bitDepth, width, 1 + xRand( 16 ), numErrors == 0 );
+      numBlocks++;
+    }
+  }
+  printf( "\n  interpolation filter: %d block sizes, %s", numBlocks, numErrors ? "FAILED" : "OK" );
+  return numErrors == 0;
+}
+
+#endif
+
+#if SIMD_DISTORTION
+
+static const Int S_DIST_STRIDE = 72;   ///< room for 64 columns plus a misaligned start
+static const Int S_DIST_HEIGHT = 64;
+
+/// true if the entry eDFunc of the TComRdCost function table supports blocks of the width
+static Bool xDistFuncFits( Int eDFunc, Int width )
+{
+  if ( eDFunc >= DF_SAD12 )
+  {
+    return width == 12 << ( ( eDFunc - DF_SAD12 ) % 3 );
+  }
+  // 0: any width, 1..5: 4xM..64xM, 6: 16NxM; the Hadamard entries all support any width
+  const Int idx = ( eDFunc - DF_SSE ) % ( DF_SAD - DF_SSE );
+  return idx == 0 || eDFunc >= DF_HADS || ( idx == 6 ? width % 16 == 0 : width == 2 << idx );
+}
+
+/**
+ * \brief distortion of the same block with every SAD, SSE and Hadamard entry of a TComRdCost built for the C functions
+ * and of one built for the SIMD level, and the 4-candidate SAD of the integer motion search, with and without subsampling
+ * \param bExtreme samples of 0 and the maximum value, half of the candidates the opposite of the original
+ * \param bPrintMismatch print the first function that differs
+ * \returns the number of functions that differ
+ */
+static Int xCheckDistortion( TComRdCost* rdCost, Int bitDepth, Int width, Int height, Bool bExtreme, Bool bPrintMismatch )
+{
+  const Int maxVal = ( 1 << bitDepth ) - 1;
+  vector<Pel> org( S_DIST_STRIDE * S_DIST_HEIGHT );
+  vector<Pel> cur[4];
+  for ( size_t i = 0; i < org.size(); i++ )
+  {
+    org[i] = Pel( bExtreme ? xRand( 2 ) * maxVal : xRand( maxVal + 1 ) );
+  }
+  Pel *pOrg = &org[xRand( 8 )];
+  const Pel *pCur[4];
+  for ( Int k = 0; k < 4; k++ )
+  {
+    cur[k].resize( org.size() );
+    for ( size_t i = 0; i < org.size(); i++ )
+    {
+      cur[k][i] = Pel( !bExtreme ? xRand( maxVal + 1 ) : ( k & 1 ) ? maxVal - org[i] : xRand( 2 ) * maxVal );
+    }
+    pCur[k] = &cur[k][xRand( 8 )];
+  }
+  Int numErrors = 0;
+
+  for ( Int iSubShift = 0; iSubShift < 2; iSubShift++ )
+  {
+    for ( Int eDFunc = DF_SSE; eDFunc <= DF_SADS48; eDFunc++ )
+    {
+      if ( ( eDFunc > DF_HADS16N && eDFunc < DF_SAD12 ) || !xDistFuncFits( eDFunc, width ) )
+      {
+        continue;
+      }
+      Distortion uiDist[2];
+      for ( Int run = 0; run < 2; run++ )
+      {
+        // setDistParam() selects the entry base + g_aucConvertToBit[width] + 1
+        DistParam cDtParam;
+        rdCost[run].setDistParam( width, height, DFunc( eDFunc - g_aucConvertToBit[width] - 1 ), cDtParam );
+        cDtParam.pOrg       = pOrg;
+        cDtParam.pCur       = pCur[0];
+        cDtParam.iStrideOrg = S_DIST_STRIDE;
+        cDtParam.iStrideCur = S_DIST_STRIDE;
+        cDtParam.bitDepth   = bitDepth;
+        cDtParam.iSubShift  = iSubShift;
+        uiDist[run] = cDtParam.DistFunc( &cDtParam );
+      }
+      if ( uiDist[0] != uiDist[1] )
+      {
+        if ( bPrintMismatch && numErrors == 0 )
+        {
+          printf( "\n  mismatch: function %d bit depth %d block %dx%d subsampling %d", eDFunc, bitDepth, width, height, iSubShift );
+        }
+        numErrors++;
+      }
+    }
+
+    // the C table has no 4-candidate function, the motion search then calls DistFunc per candidate
+    TComPattern cPattern;
+    cPattern.initPattern( pOrg, width, height, S_DIST_STRIDE, bitDepth );
+    Distortion uiSum[2][4];
+    for ( Int run = 0; run < 2; run++ )
+    {
+      DistParam cDtParam;
+      rdCost[run].setDistParam( &cPattern, pCur[0], S_DIST_STRIDE, cDtParam );
+      cDtParam.bitDepth  = bitDepth;
+      cDtParam.iSubShift = iSubShift;
+      if ( cDtParam.DistFunc4 != NULL )
+      {
+        cDtParam.DistFunc4( &cDtParam, pCur, uiSum[run] );
+      }
+      else
+      {
+        for ( Int k = 0; k < 4; k++ )
+        {
+          cDtParam.pCur = pCur[k];
+          uiSum[run][k] = cDtParam.DistFunc( &cDtParam );
+        }
+      }
+    }
+    if ( memcmp( uiSum[0], uiSum[1], sizeof( uiSum[0] ) ) != 0 )
+    {
+      if ( bPrintMismatch && numErrors == 0 )
+      {
+        printf( "\n  mismatch: 4-candidate SAD bit depth %d block %dx%d subsampling %d", bitDepth, width, height, iSubShift );
+      }
+      numErrors++;
+    }
+  }
+  return numErrors;
+}
+
+static Bool checkDistortion( SimdLevel level )
+{
+  // the function tables are filled by init() for the SIMD level at that time
+  TComRdCost rdCost[2];
+  setSimdLevel( SIMD_NONE );
+  rdCost[0].init();
+  setSimdLevel( level );
+  rdCost[1].init();
+
+  // even heights for the subsampling; 2 and 6 rows take the 2x2 Hadamard, 4 and 12 the 4x4 one
+  static const Int heights[] = { 2, 4, 6, 8, 12, 16, 64 };
+  Int numErrors = 0;
+  Int numBlocks = 0;
+  for ( Int bitDepth = 8; bitDepth <= 12; bitDepth++ )
+  {
+    // every multiple of 4 up to 64: the 4xM..64xM, 12/24/48 and 16NxM functions and the tails of the general ones
+    for ( Int width = 4; width <= 64; width += 4 )
+    {
+      for ( Int i = 0; i < Int( sizeof( heights ) / sizeof( heights[0] ) ); i++ )
+      {
+        for ( Int bExtreme = 0; bExtreme < 2; bExtreme++ )
+        {
+          numErrors += xCheckDistortion( rdCost, bitDepth, width, heights[i], bExtreme != 0, numErrors == 0 );
+          numBlocks++;
+        }
+      }
+    }
+  }
+  printf( "\n  distortion: %d blocks, %s", numBlocks, numErrors ? "FAILED" : "OK" );
+  return numErrors == 0;
+}
+
+#endif
+
+#if SVIDEO_SIMD_FILTER_GATHER
+
+static Int xFilterGather( Int iTaps, const Pel *pSrc, Int iStride, const Int *pWeight )
+{
+  return TGeometry::getFilterGather( iTaps )( pSrc, iStride, pWeight );
+}
+
+#if SVIDEO_PACKED_RESAMPLE_MAP
+static Int xFilterGather( Int iTaps, const Pel *pSrc, Int iStride, const Short *pWeight )
+{
+  return TGeometry::getPackedFilterGather( iTaps )( pSrc, iStride, pWeight );
+}
+#endif
+
+/**
+ * \brief runs the geometry conversion kernel of iTaps x iTaps samples with the C functions and with the SIMD level;
+ * the window and the weights fill their buffers exactly, so a read past them is caught by an address sanitizer
+ * \returns 1 if the sums differ
+ */
+template<typename TWeight>
+static Int xCheckFilterGather( SimdLevel level, Int iTaps, Int bitDepth )
+{
+  const Int iStride = iTaps + xRand( 8 );
+  vector<Pel>     src( ( iTaps - 1 ) * iStride + iTaps );
+  vector<TWeight> weight( iTaps * iTaps );
+  for ( size_t i = 0; i < src.size(); i++ )
+  {
+    src[i] = Pel( xRand( 1 << bitDepth ) );
+  }
+  // the weights of the conversion sum to 1<<S_INTERPOLATE_PrecisionBD, single weights stay within +-(1<<13) here to avoid an overflow of the sum
+  for ( size_t i = 0; i < weight.size(); i++ )
+  {
+    weight[i] = TWeight( xRand( 1 << 14 ) - ( 1 << 13 ) );
+  }
+
+  Int sum[2];
+  for ( Int run = 0; run < 2; run++ )
+  {
+    setSimdLevel( run ? level : SIMD_NONE );
+    sum[run] = xFilterGather( iTaps, &src[0], iStride, &weight[0] );
+  }
+  return sum[0] != sum[1] ? 1 : 0;
+}
+
+static Bool checkFilterGather( SimdLevel level )
+{
+  static const Int taps[] = { 1, 2, 4, 6 };
+  Int numErrors = 0;
+  Int numWindows = 0;
+  for ( Int i = 0; i < 4; i++ )
+  {
+    for ( Int bitDepth = 8; bitDepth <= 12; bitDepth++ )
+    {
+      for ( Int n = 0; n < 1000; n++ )
+      {
+        numErrors += xCheckFilterGather<Int>( level, taps[i], bitDepth );
+#if SVIDEO_PACKED_RESAMPLE_MAP
+        numErrors += xCheckFilterGather<Short>( level, taps[i], bitDepth );
+        numWindows++;
+#endif
+        numWindows++;
+      }
+    }
+  }
+  printf( "\n  geometry conversion kernels: %d windows, %s", numWindows, numErrors ? "FAILED" : "OK" );
+  return numErrors == 0;
+}
+
+#endif
+
+#if SVIDEO_SIMD_WSPSNR
+
+/**
+ * \brief weighted SSD of a WS-PSNR span with the C functions and with the SIMD level, with a weight per sample or one weight;
+ * the sums are Doubles and must be identical, also between the sample and the squared difference (fused metrics) versions
+ * \returns 1 if the sums differ
+ */
+static Int xCheckWSPSNRSpan( SimdLevel level, Int iNum, Bool bWeighted, Int bitDepth )
+{
+  const Int x = xRand( 8 );
+  const Int iOrgShift = xRand( 3 );
+  const Int iRecShift = xRand( 3 );
+  vector<Pel>    org( x + iNum );
+  vector<Pel>    rec( x + iNum );
+  vector<Double> weight( iNum );
+  vector<Intermediate_Int> diff2( x + iNum );
+  for ( Int i = 0; i < x + iNum; i++ )
+  {
+    org[i] = Pel( xRand( 1 << bitDepth ) );
+    rec[i] = Pel( xRand( 1 << bitDepth ) );
+    const Intermediate_Int iDiff = ( org[i] << iOrgShift ) - ( rec[i] << iRecShift );
+    diff2[i] = iDiff * iDiff;
+  }
+  for ( Int i = 0; i < iNum; i++ )
+  {
+    weight[i] = ( xRand( 1 << 24 ) + 1 ) / 3.0e10;
+  }
+  const WSPSNRSpan span = { x, iNum, bWeighted ? 0 : weight[0], bWeighted ? &weight[0] : NULL };
+
+  Double dSSD[2][2] = { { 0, 0 }, { 0, 0 } };
+  for ( Int run = 0; run < 2; run++ )
+  {
+    setSimdLevel( run ? level : SIMD_NONE );
+    dSSD[run][0] = TWSPSNRMetric::calcSpanWSSD( span, &org[0], &rec[0], iOrgShift, iRecShift );
+#if SVIDEO_FUSED_METRICS
+    dSSD[run][1] = TWSPSNRMetric::calcSpanWSSD( span, &diff2[0] );
+#else
+    dSSD[run][1] = dSSD[run][0];
+#endif
+  }
+  return ( dSSD[0][0] != dSSD[1][0] || dSSD[0][1] != dSSD[1][1] || dSSD[0][0] != dSSD[0][1] ) ? 1 : 0;
+}
+
+static Bool checkWSPSNR( SimdLevel level )
+{
+  Int numErrors = 0;
+  Int numSpans = 0;
+  for ( Int bitDepth = 8; bitDepth <= 12; bitDepth++ )
+  {
+    // every length up to 80 covers the tails of the 8-sample loop, the longer spans the ERP rows
+    for ( Int iNum = 1; iNum <= 80; iNum++ )
+    {
+      for ( Int bWeighted = 0; bWeighted < 2; bWeighted++ )
+      {
+        numErrors += xCheckWSPSNRSpan( level, iNum, bWeighted != 0, bitDepth );
+        numErrors += xCheckWSPSNRSpan( level, iNum * 37, bWeighted != 0, bitDepth );
+        numSpans += 2;
+      }
+    }
+  }
+  printf( "\n  WS-PSNR spans: %d spans, %s", numSpans, numErrors ? "FAILED" : "OK" );
+  return numErrors == 0;
+}
+
+#endif
+
+#if SVIDEO_SIMD_SPH_MATH
+
+/// compares the bits, so that NaN and the sign of zero are checked as well
+static Bool xSameDoubles( const vector<Double>& a, const vector<Double>& b )
+{
+  return a.empty() || memcmp( &a[0], &b[0], a.size() * sizeof( Double ) ) == 0;
+}
+
+/**
+ * \brief batch atan2/acos/asin/sincos of the fast projection math with the C functions and with the SIMD level; the inputs
+ * are random angles and coordinates mixed with the values where the selections of the functions switch
+ * \returns the number of functions that differ
+ */
+static Int xCheckSphMathBatch( SimdLevel level, Int iNum )
+{
+  static const Double special[] = { 0, -0.0, 1, -1, 0.41421356237309504880, -0.41421356237309504880, 1e-300, -1e-300, 2, -2,
+                                    0.78539816339744830962, -0.78539816339744830962, 1e6, -1e6 };
+  const Int numSpecial = Int( sizeof( special ) / sizeof( special[0] ) );
+  vector<Double> in0( iNum ), in1( iNum );
+  for ( Int i = 0; i < iNum; i++ )
+  {
+    in0[i] = xRand( 4 ) ? ( xRand( 1 << 24 ) - ( 1 << 23 ) ) / Double( 1 << 21 ) : special[xRand( numSpecial )];
+    in1[i] = xRand( 4 ) ? ( xRand( 1 << 24 ) - ( 1 << 23 ) ) / Double( 1 << 21 ) : special[xRand( numSpecial )];
+  }
+
+  vector<Double> out[2][5];
+  for ( Int run = 0; run < 2; run++ )
+  {
+    setSimdLevel( run ? level : SIMD_NONE );
+    for ( Int f = 0; f < 5; f++ )
+    {
+      out[run][f].assign( iNum, 0 );
+    }
+    if ( iNum )
+    {
+      fastAtan2Batch( &in0[0], &in1[0], &out[run][0][0], iNum );
+      fastAcosBatch( &in0[0], &out[run][1][0], iNum );
+      fastAsinBatch( &in1[0], &out[run][2][0], iNum );
+      fastSinCosBatch( &in0[0], &out[run][3][0], &out[run][4][0], iNum );
+    }
+  }
+  Int numErrors = 0;
+  for ( Int f = 0; f < 5; f++ )
+  {
+    numErrors += xSameDoubles( out[0][f], out[1][f] ) ? 0 : 1;
+  }
+  return numErrors;
+}
+
+static Bool checkSphMath( SimdLevel level )
+{
+  Int numErrors = 0;
+  Int numArrays = 0;
+  // every length up to 40 covers the tails of the 4-value kernels
+  for ( Int n = 0; n < 200; n++ )
+  {
+    numErrors += xCheckSphMathBatch( level, n < 40 ? n : 1000 );
+    numArrays++;
+  }
+  printf( "\n  projection math: %d arrays, %s", numArrays, numErrors ? "FAILED" : "OK" );
+  return numErrors == 0;
+}
+
+#endif
+
+int main()
+{
+#if SIMD_INTERPOLATION_FILTER || SIMD_DISTORTION || SVIDEO_SIMD_FILTER_GATHER || SVIDEO_SIMD_WSPSNR || SVIDEO_SIMD_SPH_MATH
+  static const char* levelNames[] = { "C", "SSE4.1", "AVX2", "AVX-512" };
+  const SimdLevel maxLevel = getSimdLevel();
+  Bool ok = true;
+#if SIMD_DISTORTION
+  initROM();   // setDistParam() reads g_aucConvertToBit
+#endif
+
+  printf( "CPU SIMD level: %s", levelNames[maxLevel] );
+  for ( Int level = SIMD_SSE41; level <= maxLevel; level++ )
+  {
+    printf( "\n%s:", levelNames[level] );
+#if SIMD_INTERPOLATION_FILTER
+    ok &= checkInterpolationFilter( SimdLevel( level ) );
+#endif
+#if SIMD_DISTORTION
+    ok &= checkDistortion( SimdLevel( level ) );
+#endif
+#if SVIDEO_SIMD_FILTER_GATHER
+    ok &= checkFilterGather( SimdLevel( level ) );
+#endif
+#if SVIDEO_SIMD_WSPSNR
+    ok &= checkWSPSNR( SimdLevel( level ) );
+#endif
+#if SVIDEO_SIMD_SPH_MATH
+    ok &= checkSphMath( SimdLevel( level ) );
+#endif
+  }
+  setSimdLevel( maxLevel );
+#if SIMD_DISTORTION
+  destroyROM();
+#endif
+  printf( "\n%s\n", ok ? "all SIMD functions match the C functions" : "SIMD functions differ from the C functions" );
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+#else
+  printf( "SIMD functions are disabled in this build\n" );
+  return EXIT_SUCCESS;
+#endif
+}
@@ -41,7 +41,11 @@
 
 TCPPPSNRMetric::TCPPPSNRMetric()
 : m_bCPPPSNREnabled(false)
+#if SVIDEO_SPH_SAMPLE_POINTS
+, m_pcSphPoints(NULL)
+#else
 , m_pCart2D(NULL)
+#endif
 , m_fpTable(NULL)
 {
   m_dCPPPSNR[0] = m_dCPPPSNR[1] = m_dCPPPSNR[2] = 0;
@@ -49,14 +53,21 @@ TCPPPSNRMetric::TCPPPSNRMetric()
   m_pcReferenceGeomtry = NULL;
   m_pcOutputCPPGeomtry = NULL;
   m_pcRefCPPGeomtry    = NULL;
+#if SVIDEO_CPPPSNR_VALID_RUNS
+  m_pcRefCPPPicYuv     = NULL;
+  m_pcOutCPPPicYuv     = NULL;
+  memset(m_iNumValidSamples, 0, sizeof(m_iNumValidSamples));
+#endif
 }
 
 TCPPPSNRMetric::~TCPPPSNRMetric()
 {
+#if !SVIDEO_SPH_SAMPLE_POINTS
   if(m_pCart2D)
   {
     free(m_pCart2D); m_pCart2D = NULL;
   }
+#endif
   if (m_fpTable)
   {
     free(m_fpTable); m_fpTable = NULL;
@@ -78,6 +89,18 @@ TCPPPSNRMetric::~TCPPPSNRMetric()
   {
     delete m_pcRefCPPGeomtry; m_pcRefCPPGeomtry = NULL;
   }
+#if SVIDEO_CPPPSNR_VALID_RUNS
+  if (m_pcRefCPPPicYuv)
+  {
+    m_pcRefCPPPicYuv->destroy();
+    delete m_pcRefCPPPicYuv; m_pcRefCPPPicYuv = NULL;
+  }
+  if (m_pcOutCPPPicYuv)
+  {
+    m_pcOutCPPPicYuv->destroy();
+    delete m_pcOutCPPPicYuv; m_pcOutCPPPicYuv = NULL;
+  }
+#endif
 }
 
 Void TCPPPSNRMetric::setOutputBitDepth(Int iOutputBitDepth[MAX_NUM_CHANNEL_TYPE])
@@ -293,8 +316,69 @@ Void TCPPPSNRMetric::initCPPPSNR(InputGeoParam inputGeoParam, Int cppWidth, Int
   m_pcOutputCPPGeomtry = TGeometry::create(m_cppVideoInfo, &m_cppGeoParam);
   m_pcRefCPPGeomtry = TGeometry::create(m_cppVideoInfo, &m_cppGeoParam);
   m_pcReferenceGeomtry = TGeometry::create(m_cppRefVideoInfo, &m_cppGeoParam);
+
+#if SVIDEO_CPPPSNR_VALID_RUNS
+  m_pcRefCPPPicYuv = new TComPicYuv;
+  m_pcRefCPPPicYuv->createWithoutCUInfo( m_cppWidth, m_cppHeight, m_chromaFormatIDC, true );
+  m_pcOutCPPPicYuv = new TComPicYuv;
+  m_pcOutCPPPicYuv->createWithoutCUInfo( m_cppWidth, m_cppHeight, m_chromaFormatIDC, true );
+  initValidRuns();
+#endif
 }
 
+#if SVIDEO_CPPPSNR_VALID_RUNS
+/**
+ * \brief collect the samples of each component whose inverse CPP mapping lands inside the picture;
+ */
+Void TCPPPSNRMetric::initValidRuns()
+{
+  for(Int chan=0; chan<m_pcRefCPPPicYuv->getNumberValidComponents(); chan++)
+  {
+    const ComponentID ch = ComponentID(chan);
+    const Int iWidth     = m_pcRefCPPPicYuv->getWidth (ch);
+    const Int iHeight    = m_pcRefCPPPicYuv->getHeight(ch);
+    double fPhi, fLambda;
+    double fIdxX, fIdxY;
+    double fLamdaX, fLamdaY;
+
+    m_validRuns[chan].clear();
+    m_iNumValidSamples[chan] = 0;
+    for(Int y=0;y<iHeight;y++)
+    {
+      Bool bRunOpen = false;
+      for(Int x=0;x<iWidth;x++)
+      {
+        fLamdaX = ((double)x / (iWidth)) * (2 * S_PI) - S_PI;
+        fLamdaY = ((double)y / (iHeight)) * S_PI - (S_PI_2);
+
+        fPhi = 3 * sasin(fLamdaY / S_PI);
+        fLambda = fLamdaX / (2 * scos(2 * fPhi / 3) - 1);
+
+        fLamdaX = (fLambda + S_PI) / 2 / S_PI * (iWidth);
+        fLamdaY = (fPhi + (S_PI / 2)) / S_PI *  (iHeight);
+
+        fIdxX = (int)((fLamdaX < 0) ? fLamdaX - 0.5 : fLamdaX + 0.5);
+        fIdxY = (int)((fLamdaY < 0) ? fLamdaY - 0.5 : fLamdaY + 0.5);
+
+        if(fIdxY >= 0 && fIdxX >= 0 && fIdxX < iWidth && fIdxY < iHeight)
+        {
+          if(!bRunOpen)
+          {
+            CPPValidRun run = { y, x, 0 };
+            m_validRuns[chan].push_back(run);
+            bRunOpen = true;
+          }
+          m_validRuns[chan].back().iNum++;
+          m_iNumValidSamples[chan]++;
+        }
+        else
+          bRunOpen = false;
+      }
+    }
+  }
+}
+#endif
+
 Void TCPPPSNRMetric::sphSampoints(Char* cSphDataFile)
 {
   if(cSphDataFile == NULL)
@@ -303,6 +387,16 @@ Void TCPPPSNRMetric::sphSampoints(Char* cSphDataFile)
     return;
   }
 
+#if SVIDEO_SPH_SAMPLE_POINTS
+  m_pcSphPoints = TSphSamplePoints::get(cSphDataFile);
+  if(!m_pcSphPoints)
+  {
+    printf("SPSNR-NN is disabled because metadata file (%s) cannot be opened!\n", cSphDataFile);
+    m_bCPPPSNREnabled = false;
+    return;
+  }
+  m_iSphNumPoints = m_pcSphPoints->getNumPoints();
+#else
   // read data
   FILE *fp = fopen(cSphDataFile,"r");
   if(!fp)
@@ -330,6 +424,7 @@ Void TCPPPSNRMetric::sphSampoints(Char* cSphDataFile)
       exit(EXIT_FAILURE); 
     }
   }
+#endif
 }
 
 Void TCPPPSNRMetric::xCalculateCPPPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPicD)
@@ -352,11 +447,16 @@ Void TCPPPSNRMetric::xCalculateCPPPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcP
   Double SCPPDspsnr[3]={0, 0 ,0};
 
   // Convert Output and Ref to CPP_Projection
+#if SVIDEO_CPPPSNR_VALID_RUNS
+  TPicYUVRefCPP = m_pcRefCPPPicYuv;
+  TPicYUVOutCPP = m_pcOutCPPPicYuv;
+#else
   TPicYUVRefCPP = new TComPicYuv;
   TPicYUVRefCPP->createWithoutCUInfo  ( m_cppWidth, m_cppHeight, m_chromaFormatIDC, true );
 
   TPicYUVOutCPP = new TComPicYuv;
   TPicYUVOutCPP->createWithoutCUInfo  ( m_cppWidth, m_cppHeight, m_chromaFormatIDC, true );
+#endif
 
   // Converting Reference to CPP
   if ((m_pcReferenceGeomtry->getSVideoInfo()->geoType == SVIDEO_OCTAHEDRON || m_pcReferenceGeomtry->getSVideoInfo()->geoType == SVIDEO_ICOSAHEDRON) && m_pcReferenceGeomtry->getSVideoInfo()->iCompactFPStructure)
@@ -382,6 +482,31 @@ Void TCPPPSNRMetric::xCalculateCPPPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcP
   m_pcOutputGeomtry->geoConvert(m_pcOutputCPPGeomtry);
   m_pcOutputCPPGeomtry->framePack(TPicYUVOutCPP);
 
+#if SVIDEO_CPPPSNR_VALID_RUNS
+  for(Int chan=0; chan<pcPicD->getNumberValidComponents(); chan++)
+  {
+    const ComponentID ch=ComponentID(chan);
+    const Pel*  pOrg       = TPicYUVOutCPP->getAddr(ch);
+    const Int   iOrgStride = TPicYUVOutCPP->getStride(ch);
+    const Pel*  pRec       = TPicYUVRefCPP->getAddr(ch);
+    const Int   iRecStride = TPicYUVRefCPP->getStride(ch);
+    const Int   iOrgShift  = iReferenceBitShift[toChannelType(ch)];
+    const Int   iRecShift  = iOutputBitShift[toChannelType(ch)];
+    const std::vector<CPPValidRun>& validRuns = m_validRuns[chan];
+
+    for(size_t r=0; r<validRuns.size(); r++)
+    {
+      const Pel *pOrgRun = pOrg + validRuns[r].y*iOrgStride + validRuns[r].x;
+      const Pel *pRecRun = pRec + validRuns[r].y*iRecStride + validRuns[r].x;
+      for(Int x=0; x<validRuns[r].iNum; x++)
+      {
+        Intermediate_Int iDifflp  = (Intermediate_Int)((pOrgRun[x]<<iOrgShift) - (pRecRun[x]<<iRecShift) );
+        SCPPDspsnr[chan]         += iDifflp * iDifflp;
+      }
+    }
+    SCPPDspsnr[chan] /= m_iNumValidSamples[chan];
+  }
+#else
  for(Int chan=0; chan<pcPicD->getNumberValidComponents(); chan++)
   {
     const ComponentID ch=ComponentID(chan);
@@ -425,6 +550,7 @@ Void TCPPPSNRMetric::xCalculateCPPPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcP
     }
     SCPPDspsnr[chan] /= iSize;
   }
+#endif
 
   for (Int ch_indx = 0; ch_indx < pcPicD->getNumberValidComponents(); ch_indx++)
   {
@@ -435,6 +561,7 @@ Void TCPPPSNRMetric::xCalculateCPPPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcP
     m_dCPPPSNR[ch_indx] = ( SCPPDspsnr[ch_indx] ? 10.0 * log10( fReflpsnr / (Double)SCPPDspsnr[ch_indx] ) : 999.99 );
   }
 
+#if !SVIDEO_CPPPSNR_VALID_RUNS
   if(TPicYUVRefCPP)
   {
     TPicYUVRefCPP->destroy();
@@ -447,6 +574,7 @@ Void TCPPPSNRMetric::xCalculateCPPPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcP
     delete TPicYUVOutCPP;
     TPicYUVOutCPP = NULL;
   }
+#endif
 }
 
 #endif // SVIDEO_CPPPSNR
\ No newline at end of file
@@ -38,6 +38,9 @@
 #ifndef __TCPPPSNRCALC__
 #define __TCPPPSNRCALC__
 #include "TGeometry.h"
+#if SVIDEO_SPH_SAMPLE_POINTS
+#include "TSphSamplePoints.h"
+#endif
 
 // ====================================================================================================================
 // Class definition
@@ -45,13 +48,27 @@
 
 #if SVIDEO_CPPPSNR
 
+#if SVIDEO_CPPPSNR_VALID_RUNS
+//horizontal run of samples inside the CPP projection;
+struct CPPValidRun
+{
+  Int y;
+  Int x;
+  Int iNum;
+};
+#endif
+
 class TCPPPSNRMetric
 {
 private:
   Bool          m_bCPPPSNREnabled;
   Double        m_dCPPPSNR[3];
                 
+#if SVIDEO_SPH_SAMPLE_POINTS
+  const TSphSamplePoints* m_pcSphPoints;          //shared, not owned;
+#else
   CPos2D*       m_pCart2D;
+#endif
   IPos2D*       m_fpTable;
   Int           m_iSphNumPoints;
   Int           m_cppWidth;
@@ -73,6 +90,14 @@ private:
   TGeometry     *m_pcOutputCPPGeomtry;
   TGeometry     *m_pcRefCPPGeomtry;
 
+#if SVIDEO_CPPPSNR_VALID_RUNS
+  TComPicYuv    *m_pcRefCPPPicYuv;
+  TComPicYuv    *m_pcOutCPPPicYuv;
+  std::vector<CPPValidRun> m_validRuns[MAX_NUM_COMPONENT];
+  Int           m_iNumValidSamples[MAX_NUM_COMPONENT];
+  Void          initValidRuns();
+#endif
+
 public:
   TCPPPSNRMetric();
   virtual ~TCPPPSNRMetric();
@@ -56,6 +56,9 @@ public:
 
   virtual Void map2DTo3D(SPos& IPosIn, SPos *pSPosOut); 
   virtual Void map3DTo2D(SPos *pSPosIn, SPos *pSPosOut); 
+#if SVIDEO_BATCH_MAPPING
+  virtual Void map2DTo3DBatch(const SPosArray& in, SPosArray& out);
+#endif
   virtual Bool insideFace(Int fId, Int x, Int y, ComponentID chId, ComponentID origchId);
 };
 
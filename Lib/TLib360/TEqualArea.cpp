@@ -178,4 +178,102 @@ Void TEqualArea::map3DTo2D(SPos *pSPosIn, SPos *pSPosOut)
   //pSPosOut->y -= 0.5;
 }
 
+#if SVIDEO_BATCH_MAPPING
+Void TEqualArea::map2DTo3DBatch(const SPosArray& in, SPosArray& out)
+{
+  if(!m_bFastProjectionMath)
+  {
+    TGeometry::map2DTo3DBatch(in, out);
+    return;
+  }
+  Int iNum = in.size();
+  out.resize(iNum);
+  if(!iNum)
+    return;
+  //u and the asin argument first; out is written only after in is read, as both may be the same array;
+  std::vector<Double> yaw(iNum), pitch(iNum), cosAngle(iNum);
+  for(Int k=0; k<iNum; k++)
+  {
+    POSType u = in.x[k] + (POSType)(0.5);
+    POSType v = in.y[k] + (POSType)(0.5);
+    wrapPos(u, v);
+
+    yaw[k] = u;
+    pitch[k] = (Double)v/m_sVideoInfo.iFaceHeight-0.5;
+    out.faceIdx[k] = in.faceIdx[k];
+  }
+  fastAsinBatch(&pitch[0], &pitch[0], iNum);
+  for(Int k=0; k<iNum; k++)
+  {
+    pitch[k] = (POSType)(3 * pitch[k]);
+    cosAngle[k] = 2 * pitch[k]/3;
+  }
+  fastSinCosBatch(&cosAngle[0], NULL, &cosAngle[0], iNum);   //cos(2*pitch/3);
+  for(Int k=0; k<iNum; k++)
+  {
+    POSType u = yaw[k];
+    yaw[k] = (POSType)((2 * S_PI * (Double)u/m_sVideoInfo.iFaceWidth - S_PI) / (2 * cosAngle[k] - 1));
+    pitch[k] = -pitch[k];
+  }
+  fastSinCosBatch(&yaw[0], &out.z[0], &out.x[0], iNum);         //sin(yaw), cos(yaw);
+  fastSinCosBatch(&pitch[0], &out.y[0], &cosAngle[0], iNum);    //sin(pitch), cos(pitch);
+  for(Int k=0; k<iNum; k++)
+  {
+    if(-S_PI_2 <= pitch[k] && pitch[k] <= S_PI_2 && -S_PI <= yaw[k] && yaw[k] <= S_PI)
+    {
+      out.x[k] = (POSType)(cosAngle[k]*out.x[k]);
+      out.z[k] = -(POSType)(cosAngle[k]*out.z[k]);
+    }
+    else
+    {
+      out.x[k] = 1.0;
+      out.y[k] = out.z[k] = 0.0;
+    }
+  }
+}
+
+Void TEqualArea::map3DTo2DBatch(const SPosArray& in, SPosArray& out)
+{
+  if(!m_bFastProjectionMath)
+  {
+    TGeometry::map3DTo2DBatch(in, out);
+    return;
+  }
+  Int iNum = in.size();
+  out.resize(iNum);
+  if(!iNum)
+    return;
+  std::vector<Double> yaw(iNum), pitch(iNum), angle2(iNum);
+  fastAtan2Batch(&in.z[0], &in.x[0], &yaw[0], iNum);
+  for(Int k=0; k<iNum; k++)
+  {
+    POSType x = in.x[k];
+    POSType y = in.y[k];
+    POSType z = in.z[k];
+    POSType len = ssqrt(x*x + y*y + z*z);
+    pitch[k] = y/len;
+  }
+  fastAcosBatch(&pitch[0], &pitch[0], iNum);
+  for(Int k=0; k<iNum; k++)
+  {
+    POSType p = pitch[k] - S_PI_2;
+    p = -p;
+    yaw[k] = -yaw[k];
+    pitch[k] = p / 3;
+    angle2[k] = 2 * p / 3;
+  }
+  fastSinCosBatch(&pitch[0], &pitch[0], NULL, iNum);      //sin(pitch/3);
+  fastSinCosBatch(&angle2[0], NULL, &angle2[0], iNum);    //cos(2*pitch/3);
+  for(Int k=0; k<iNum; k++)
+  {
+    out.faceIdx[k] = 0;
+    out.z[k] = 0;
+    out.y[k] = 0.5 + (0.5 - pitch[k]) * m_sVideoInfo.iFaceHeight;
+    out.y[k] -= 0.5;
+    out.x[k] = 0.5 + (yaw[k] * (2 * angle2[k] - 1) / (S_PI * 2) + 0.5) * m_sVideoInfo.iFaceWidth;
+    out.x[k] -= 0.5;
+  }
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -56,6 +56,10 @@ public:
 
   virtual Void map2DTo3D(SPos& IPosIn, SPos *pSPosOut); 
   virtual Void map3DTo2D(SPos *pSPosIn, SPos *pSPosOut); 
+#if SVIDEO_BATCH_MAPPING
+  virtual Void map2DTo3DBatch(const SPosArray& in, SPosArray& out);
+  virtual Void map3DTo2DBatch(const SPosArray& in, SPosArray& out);
+#endif
 };
 
 #endif
@@ -379,4 +379,73 @@ Void TEquiRect::framePack(TComPicYuv *pDstYuv)
   }
 }
 
+#if SVIDEO_BATCH_MAPPING
+Void TEquiRect::map2DTo3DBatch(const SPosArray& in, SPosArray& out)
+{
+  if(!m_bFastProjectionMath)
+  {
+    TGeometry::map2DTo3DBatch(in, out);
+    return;
+  }
+  Int iNum = in.size();
+  out.resize(iNum);
+  if(!iNum)
+    return;
+  //the angles of all positions first, then the batch sin/cos; out may be in, it is written once in is read;
+  std::vector<Double> yaw(iNum), pitch(iNum);
+  for(Int k=0; k<iNum; k++)
+  {
+    POSType u = in.x[k] + (POSType)(0.5);
+    POSType v = in.y[k] + (POSType)(0.5);
+    wrapPos(u, v);
+
+    yaw[k] = (POSType)(u*S_PI*2/m_sVideoInfo.iFaceWidth - S_PI);
+    pitch[k] = (POSType)(S_PI_2 - v*S_PI/m_sVideoInfo.iFaceHeight);
+    out.faceIdx[k] = in.faceIdx[k];
+  }
+  fastSinCosBatch(&yaw[0], &out.z[0], &out.x[0], iNum);      //sin(yaw), cos(yaw);
+  fastSinCosBatch(&pitch[0], &out.y[0], &pitch[0], iNum);    //sin(pitch), cos(pitch);
+  for(Int k=0; k<iNum; k++)
+  {
+    out.x[k] = (POSType)(pitch[k]*out.x[k]);
+    out.z[k] = -(POSType)(pitch[k]*out.z[k]);
+  }
+}
+
+Void TEquiRect::map3DTo2DBatch(const SPosArray& in, SPosArray& out)
+{
+  if(!m_bFastProjectionMath)
+  {
+    TGeometry::map3DTo2DBatch(in, out);
+    return;
+  }
+  Int iNum = in.size();
+  out.resize(iNum);
+  if(!iNum)
+    return;
+  std::vector<Double> yaw(iNum), len(iNum), pitch(iNum);
+  fastAtan2Batch(&in.z[0], &in.x[0], &yaw[0], iNum);
+  for(Int k=0; k<iNum; k++)
+  {
+    POSType x = in.x[k];
+    POSType y = in.y[k];
+    POSType z = in.z[k];
+    len[k] = ssqrt(x*x + y*y + z*z);
+    pitch[k] = y/len[k];
+  }
+  fastAcosBatch(&pitch[0], &pitch[0], iNum);
+  for(Int k=0; k<iNum; k++)
+  {
+    out.faceIdx[k] = 0;
+    out.z[k] = 0;
+    //yaw;
+    out.x[k] = (POSType)((S_PI-yaw[k])*m_sVideoInfo.iFaceWidth/(2*S_PI));
+    out.x[k] -= 0.5;
+    //pitch;
+    out.y[k] = (POSType)((len[k] < S_EPS? 0.5 : pitch[k]/S_PI)*m_sVideoInfo.iFaceHeight);
+    out.y[k] -= 0.5;
+  }
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -54,12 +54,40 @@ private:
   Void sPadH(Pel *pSrc, Pel *pDst, Int iCount);
   Void sPadV(Pel *pSrc, Pel *pDst, Int iStride, Int iCount); 
 
+protected:
+#if SVIDEO_BATCH_MAPPING
+  //wrap (u, v) outside the frame around the sphere, as map2DTo3D does;
+  inline Void wrapPos(POSType &u, POSType &v)
+  {
+    if ((u < 0 || u >= m_sVideoInfo.iFaceWidth) && ( v >= 0 && v < m_sVideoInfo.iFaceHeight)) 
+    {
+      u = u < 0 ? m_sVideoInfo.iFaceWidth+u : (u - m_sVideoInfo.iFaceWidth);
+    }
+    else if (v < 0)
+    {
+      v = -v; 
+      u = u + (m_sVideoInfo.iFaceWidth>>1);
+      u = u >= m_sVideoInfo.iFaceWidth ? u - m_sVideoInfo.iFaceWidth : u;
+    }
+    else if(v >= m_sVideoInfo.iFaceHeight)
+    {
+      v = (m_sVideoInfo.iFaceHeight<<1)-v; 
+      u = u + (m_sVideoInfo.iFaceWidth>>1);
+      u = u >= m_sVideoInfo.iFaceWidth ? u - m_sVideoInfo.iFaceWidth : u;
+    }
+  }
+#endif
+
 public:
   TEquiRect(SVideoInfo& sVideoInfo, InputGeoParam *pInGeoParam);
   virtual ~TEquiRect();
 
   virtual Void map2DTo3D(SPos& IPosIn, SPos *pSPosOut); 
   virtual Void map3DTo2D(SPos *pSPosIn, SPos *pSPosOut);
+#if SVIDEO_BATCH_MAPPING
+  virtual Void map2DTo3DBatch(const SPosArray& in, SPosArray& out);
+  virtual Void map3DTo2DBatch(const SPosArray& in, SPosArray& out);
+#endif
 
   //own methods;
   virtual Void convertYuv(TComPicYuv *pSrcYuv);
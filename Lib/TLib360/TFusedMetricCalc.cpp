@@ -0,0 +1,171 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2015, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/** \file     TFusedMetricCalc.cpp
+    \brief    single-pass evaluation of PSNR, WS-PSNR and S-PSNR-NN
+*/
+
+#include <functional>
+#include "TFusedMetricCalc.h"
+
+#if SVIDEO_FUSED_METRICS
+
+TFusedMetricCalc::TFusedMetricCalc()
+: m_iPadX(0)
+, m_iPadY(0)
+, m_pcSPSNRMetric(NULL)
+, m_pcWSPSNRMetric(NULL)
+, m_pcThreadPool(NULL)
+{
+  memset(m_iReferenceBitShift, 0, sizeof(m_iReferenceBitShift));
+  memset(m_iOutputBitShift, 0, sizeof(m_iOutputBitShift));
+  memset(m_uiSSD, 0, sizeof(m_uiSSD));
+}
+
+Void TFusedMetricCalc::setBitDepths(const Int iOutputBitDepth[MAX_NUM_CHANNEL_TYPE], const Int iReferenceBitDepth[MAX_NUM_CHANNEL_TYPE])
+{
+  for(Int i = 0; i < MAX_NUM_CHANNEL_TYPE; i++)
+  {
+    Int iBitDepthForPSNRCalc = std::max(iOutputBitDepth[i], iReferenceBitDepth[i]);
+    m_iReferenceBitShift[i] = iBitDepthForPSNRCalc - iReferenceBitDepth[i];
+    m_iOutputBitShift[i]    = iBitDepthForPSNRCalc - iOutputBitDepth[i];
+  }
+}
+
+Void TFusedMetricCalc::init(TComPicYuv* pcPicD)
+{
+  if(m_pcSPSNRMetric)
+  {
+    m_pcSPSNRMetric->initGatherRows(pcPicD);
+  }
+}
+
+/**
+ * \brief row bands of all components are evaluated in parallel; the PSNR and S-PSNR sums of every band are integers
+ *        and WS-PSNR keeps one sum per row, so the merged results do not depend on the number of threads;
+ */
+Void TFusedMetricCalc::calculate(TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPicD, Bool bPSNR)
+{
+  Int iNumComp = pcPicD->getNumberValidComponents();
+  memset(m_uiSSD, 0, sizeof(m_uiSSD));
+  if(!bPSNR && !m_pcWSPSNRMetric)
+  {
+    //the points alone are cheaper to gather than a pass over the picture;
+    if(m_pcSPSNRMetric)
+    {
+      m_pcSPSNRMetric->xCalculateSPSNR(pcOrgPicYuv, pcPicD);
+    }
+    return;
+  }
+
+  std::vector<Int> bandStart(1, 0);
+  for(Int chan=0; chan<iNumComp; chan++)
+    bandStart.push_back(bandStart.back() + (pcPicD->getHeight(ComponentID(chan))+S_ROW_BAND_HEIGHT-1)/S_ROW_BAND_HEIGHT);
+  std::vector<UInt64> bandSSD(bandStart.back(), 0);
+  std::vector<Int64>  bandSphSSD(bandStart.back(), 0);
+
+  std::function<Void(Int)> rowBand = [&](Int iBand)
+  {
+    Int chan = 0;
+    while(iBand >= bandStart[chan+1])
+      chan++;
+    const ComponentID ch = ComponentID(chan);
+    const Int iOrgStride  = pcOrgPicYuv->getStride(ch);
+    const Int iRecStride  = pcPicD->getStride(ch);
+    const Int iWidth      = pcPicD->getWidth(ch);
+    const Int iHeight     = pcPicD->getHeight(ch);
+    const Int iPSNRWidth  = iWidth - (m_iPadX >> pcPicD->getComponentScaleX(ch));
+    const Int iPSNRHeight = bPSNR? iHeight - (m_iPadY >> pcPicD->getComponentScaleY(ch)) : 0;
+    const Int iOrgShift   = m_iReferenceBitShift[toChannelType(ch)];
+    const Int iRecShift   = m_iOutputBitShift[toChannelType(ch)];
+    Int yStart = (iBand-bandStart[chan])*S_ROW_BAND_HEIGHT;
+    Int yEnd = std::min(yStart+S_ROW_BAND_HEIGHT, iHeight);
+    std::vector<Intermediate_Int> diff2(iWidth);
+    UInt64 uiSSD = 0;
+    Int64  iSphSSD = 0;
+
+    for(Int y = yStart; y < yEnd; y++)
+    {
+      const Pel *pOrg = pcOrgPicYuv->getAddr(ch) + y*iOrgStride;
+      const Pel *pRec = pcPicD->getAddr(ch) + y*iRecStride;
+      for(Int x = 0; x < iWidth; x++)
+      {
+        Intermediate_Int iDiff = (Intermediate_Int)( (pOrg[x]<<iOrgShift) - (pRec[x]<<iRecShift) );
+        diff2[x] = iDiff * iDiff;
+      }
+      if(y < iPSNRHeight)
+      {
+        for(Int x = 0; x < iPSNRWidth; x++)
+          uiSSD += diff2[x];
+      }
+      if(m_pcWSPSNRMetric)
+        m_pcWSPSNRMetric->xAddRowSSD(chan, y, &diff2[0]);
+      if(m_pcSPSNRMetric)
+        iSphSSD += m_pcSPSNRMetric->xCalcRowGatherSSD(chan, y, &diff2[0]);
+    }
+    bandSSD[iBand] = uiSSD;
+    bandSphSSD[iBand] = iSphSSD;
+  };
+  if(m_pcThreadPool)
+    m_pcThreadPool->parallelFor(bandStart.back(), rowBand);
+  else
+  {
+    for(Int i=0; i<bandStart.back(); i++)
+      rowBand(i);
+  }
+
+  Double dSphSSD[MAX_NUM_COMPONENT] = { 0, 0, 0 };
+  for(Int chan=0; chan<iNumComp; chan++)
+  {
+    Int64 iSphSSD = 0;
+    for(Int i=bandStart[chan]; i<bandStart[chan+1]; i++)
+    {
+      m_uiSSD[chan] += bandSSD[i];
+      iSphSSD += bandSphSSD[i];
+    }
+    dSphSSD[chan] = (Double)iSphSSD;
+  }
+  if(m_pcWSPSNRMetric)
+    m_pcWSPSNRMetric->xSetWSPSNR(iNumComp);
+  if(m_pcSPSNRMetric)
+    m_pcSPSNRMetric->setSSD(dSphSSD, iNumComp);
+}
+
+Void TFusedMetricCalc::setPSNR(TPSNRMetric *pcMetric, TComPicYuv* pcPicD)
+{
+  Double dSSD[MAX_NUM_COMPONENT] = { 0, 0, 0 };
+  for(Int chan=0; chan<pcPicD->getNumberValidComponents(); chan++)
+    dSSD[chan] = (Double)m_uiSSD[chan];
+  pcMetric->setSSD(dSSD, pcPicD);
+}
+
+#endif
@@ -0,0 +1,84 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2015, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/** \file     TFusedMetricCalc.h
+    \brief    single-pass evaluation of PSNR, WS-PSNR and S-PSNR-NN (header)
+*/
+
+#ifndef __TFUSEDMETRICCALC__
+#define __TFUSEDMETRICCALC__
+#include "TGeometry.h"
+#include "TPSNRMetricCalc.h"
+#include "TSPSNRMetricCalc.h"
+#include "TWSPSNRMetricCalc.h"
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+#if SVIDEO_FUSED_METRICS
+/// computes the full-frame metrics of a picture pair in one pass: every row is read once into its squared differences,
+/// which feed the PSNR, the weighted spans of WS-PSNR and the sample counts of S-PSNR-NN; the metrics have to use the
+/// bit depths given to setBitDepths(), their results are stored into the metric objects;
+class TFusedMetricCalc
+{
+private:
+  Int             m_iReferenceBitShift[MAX_NUM_CHANNEL_TYPE];
+  Int             m_iOutputBitShift[MAX_NUM_CHANNEL_TYPE];
+  Int             m_iPadX;                   //luma samples right of the PSNR area;
+  Int             m_iPadY;                   //luma rows below the PSNR area;
+  TSPSNRMetric   *m_pcSPSNRMetric;           //not owned; NULL: not evaluated;
+  TWSPSNRMetric  *m_pcWSPSNRMetric;          //not owned; NULL: not evaluated;
+  TComThreadPool *m_pcThreadPool;            //not owned; NULL: serial;
+  UInt64          m_uiSSD[MAX_NUM_COMPONENT];
+
+public:
+  TFusedMetricCalc();
+  virtual ~TFusedMetricCalc() {}
+
+  Void    setBitDepths(const Int iOutputBitDepth[MAX_NUM_CHANNEL_TYPE], const Int iReferenceBitDepth[MAX_NUM_CHANNEL_TYPE]);
+  Void    setPSNRPadding(Int iPadX, Int iPadY) { m_iPadX = iPadX; m_iPadY = iPadY; }
+  Void    setSPSNRMetric(TSPSNRMetric *pcMetric) { m_pcSPSNRMetric = pcMetric; }
+  Void    setWSPSNRMetric(TWSPSNRMetric *pcMetric) { m_pcWSPSNRMetric = pcMetric; }
+  Void    setThreadPool(TComThreadPool *pcThreadPool) { m_pcThreadPool = pcThreadPool; }
+  TSPSNRMetric*  getSPSNRMetric()  { return m_pcSPSNRMetric; }
+  TWSPSNRMetric* getWSPSNRMetric() { return m_pcWSPSNRMetric; }
+  Bool    isEnabled() { return m_pcSPSNRMetric || m_pcWSPSNRMetric; }
+
+  Void    init(TComPicYuv* pcPicD);                                        //after createTable() of the metrics;
+  Void    calculate(TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPicD, Bool bPSNR);
+  UInt64  getSSD(ComponentID ch) { return m_uiSSD[ch]; }                   //PSNR area, valid if bPSNR was set;
+  Void    setPSNR(TPSNRMetric *pcMetric, TComPicYuv* pcPicD);
+};
+#endif
+
+#endif // __TFUSEDMETRICCALC__
@@ -0,0 +1,237 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2015, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TGeoMapCache.cpp
+    \brief    on-disk cache of geometry mapping tables
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "TGeoMapCache.h"
+
+static const Char   S_GEOMAP_CACHE_MAGIC[8] = { '3', '6', '0', 'G', 'M', 'A', 'P', '\0' };
+static const UInt   S_GEOMAP_CACHE_VERSION  = 1;
+static const UInt64 S_GEOMAP_CACHE_ALIGN    = 64;
+
+//followed by uiNumBlocks block sizes (UInt64); each block starts at a S_GEOMAP_CACHE_ALIGN aligned offset;
+struct GeoMapCacheHeader
+{
+  Char   magic[8];
+  UInt   uiVersion;
+  UInt   uiNumBlocks;
+  UInt64 uiKey;
+};
+
+static UInt64 alignCacheOffset(UInt64 uiPos)
+{
+  return (uiPos + S_GEOMAP_CACHE_ALIGN - 1) & ~(S_GEOMAP_CACHE_ALIGN - 1);
+}
+
+static UInt64 getCacheBlockOffsets(const std::vector<UInt64>& blockSizes, std::vector<UInt64>& blockOffset)
+{
+  UInt64 uiPos = alignCacheOffset(sizeof(GeoMapCacheHeader) + blockSizes.size()*sizeof(UInt64));
+  blockOffset.resize(blockSizes.size());
+  for(size_t i=0; i<blockSizes.size(); i++)
+  {
+    blockOffset[i] = uiPos;
+    uiPos = alignCacheOffset(uiPos + blockSizes[i]);
+  }
+  return uiPos;
+}
+
+Void TGeoMapHash::add(const Void *pData, size_t iSize)
+{
+  const UChar *p = (const UChar *)pData;
+  for(size_t i=0; i<iSize; i++)
+  {
+    m_uiHash ^= p[i];
+    m_uiHash *= 1099511628211ULL;
+  }
+}
+
+TGeoMapCache::TGeoMapCache()
+: m_pBase(NULL)
+, m_iSize(0)
+{
+}
+
+TGeoMapCache::~TGeoMapCache()
+{
+  release();
+}
+
+std::string TGeoMapCache::getFileName(const std::string& dir, const Char *pPrefix, UInt64 uiKey)
+{
+  std::ostringstream oss;
+  oss << dir;
+  if(!dir.empty() && dir[dir.size()-1] != '/' && dir[dir.size()-1] != '\\')
+    oss << '/';
+  oss << pPrefix << "_" << std::hex << std::setw(16) << std::setfill('0') << uiKey << ".bin";
+  return oss.str();
+}
+
+/**
+ * \brief write the blocks to a temporary file and rename it, so concurrent jobs and threads never see a partial cache file;
+ */
+Bool TGeoMapCache::write(const std::string& fileName, UInt64 uiKey, const std::vector<const Void*>& blocks, const std::vector<UInt64>& blockSizes)
+{
+  assert(blocks.size() == blockSizes.size());
+  std::ostringstream oss;
+  oss << fileName << ".tmp" << getpid() << "_" << std::this_thread::get_id();
+  std::string tmpFileName = oss.str();
+  FILE *fp = fopen(tmpFileName.c_str(), "wb");
+  if(!fp)
+    return false;
+
+  GeoMapCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, S_GEOMAP_CACHE_MAGIC, sizeof(header.magic));
+  header.uiVersion = S_GEOMAP_CACHE_VERSION;
+  header.uiNumBlocks = (UInt)blocks.size();
+  header.uiKey = uiKey;
+
+  std::vector<UInt64> blockOffset;
+  getCacheBlockOffsets(blockSizes, blockOffset);
+  static const UChar zeros[S_GEOMAP_CACHE_ALIGN] = { 0 };
+
+  Bool bOK = fwrite(&header, sizeof(header), 1, fp) == 1;
+  bOK = bOK && (blockSizes.empty() || fwrite(&blockSizes[0], sizeof(UInt64), blockSizes.size(), fp) == blockSizes.size());
+  UInt64 uiPos = sizeof(header) + blockSizes.size()*sizeof(UInt64);
+  for(size_t i=0; bOK && i<blocks.size(); i++)
+  {
+    bOK = (blockOffset[i] == uiPos || fwrite(zeros, 1, (size_t)(blockOffset[i]-uiPos), fp) == blockOffset[i]-uiPos);
+    bOK = bOK && (!blockSizes[i] || fwrite(blocks[i], 1, (size_t)blockSizes[i], fp) == blockSizes[i]);
+    uiPos = blockOffset[i] + blockSizes[i];
+  }
+  bOK = (fclose(fp) == 0) && bOK;
+
+  if(bOK && rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+  {
+    //another job may have written the same file in the meantime;
+    FILE *fpExisting = fopen(fileName.c_str(), "rb");
+    bOK = fpExisting != NULL;
+    if(fpExisting)
+      fclose(fpExisting);
+  }
+  remove(tmpFileName.c_str());
+  return bOK;
+}
+
+Bool TGeoMapCache::load(const std::string& fileName, UInt64 uiKey, const std::vector<UInt64>& blockSizes)
+{
+  release();
+
+#ifdef _WIN32
+  FILE *fp = fopen(fileName.c_str(), "rb");
+  if(!fp)
+    return false;
+  fseek(fp, 0, SEEK_END);
+  long iFileSize = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  if(iFileSize <= 0)
+  {
+    fclose(fp);
+    return false;
+  }
+  m_pBase = malloc(iFileSize);
+  m_iSize = (size_t)iFileSize;
+  Bool bRead = m_pBase && fread(m_pBase, 1, m_iSize, fp) == m_iSize;
+  fclose(fp);
+  if(!bRead)
+  {
+    release();
+    return false;
+  }
+#else
+  Int fd = open(fileName.c_str(), O_RDONLY);
+  if(fd < 0)
+    return false;
+  struct stat st;
+  if(fstat(fd, &st) != 0 || st.st_size <= 0)
+  {
+    close(fd);
+    return false;
+  }
+  Void *pBase = mmap(NULL, (size_t)st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(pBase == MAP_FAILED)
+    return false;
+  m_pBase = pBase;
+  m_iSize = (size_t)st.st_size;
+#endif
+
+  //validate;
+  UInt64 uiTotalSize = getCacheBlockOffsets(blockSizes, m_blockOffset);
+  const GeoMapCacheHeader *pHeader = (const GeoMapCacheHeader *)m_pBase;
+  const UInt64 *pBlockSizes = (const UInt64 *)(pHeader+1);
+  Bool bValid = m_iSize >= uiTotalSize
+             && !memcmp(pHeader->magic, S_GEOMAP_CACHE_MAGIC, sizeof(pHeader->magic))
+             && pHeader->uiVersion == S_GEOMAP_CACHE_VERSION
+             && pHeader->uiNumBlocks == blockSizes.size()
+             && pHeader->uiKey == uiKey
+             && (blockSizes.empty() || !memcmp(pBlockSizes, &blockSizes[0], blockSizes.size()*sizeof(UInt64)));
+  if(!bValid)
+  {
+    release();
+    return false;
+  }
+  return true;
+}
+
+Void TGeoMapCache::release()
+{
+  if(m_pBase)
+  {
+#ifdef _WIN32
+    free(m_pBase);
+#else
+    munmap(m_pBase, m_iSize);
+#endif
+  }
+  m_pBase = NULL;
+  m_iSize = 0;
+  m_blockOffset.clear();
+}
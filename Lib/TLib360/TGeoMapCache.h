@@ -0,0 +1,84 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2015, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TGeoMapCache.h
+    \brief    on-disk cache of geometry mapping tables (header)
+*/
+
+#ifndef __TGEOMAPCACHE__
+#define __TGEOMAPCACHE__
+#include <string>
+#include <vector>
+#include "../TLibCommon/CommonDef.h"
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// 64-bit FNV-1a hash of the parameters a mapping table depends on
+class TGeoMapHash
+{
+private:
+  UInt64 m_uiHash;
+
+public:
+  TGeoMapHash() : m_uiHash(14695981039346656037ULL) {}
+  Void   add(const Void *pData, size_t iSize);
+  Void   add(Int iValue)     { add(&iValue, sizeof(iValue)); }
+  Void   add(Float fValue)   { add(&fValue, sizeof(fValue)); }
+  UInt64 get() const         { return m_uiHash; }
+};
+
+/// cache file made of a header and a list of 64-byte aligned blocks; the file is mapped privately (copy-on-write),
+/// so the tables are used in place without copying and can still be overwritten by the owner;
+class TGeoMapCache
+{
+private:
+  Void*                m_pBase;
+  size_t               m_iSize;
+  std::vector<UInt64>  m_blockOffset;
+
+public:
+  TGeoMapCache();
+  virtual ~TGeoMapCache();
+
+  static std::string getFileName(const std::string& dir, const Char *pPrefix, UInt64 uiKey);
+  static Bool        write(const std::string& fileName, UInt64 uiKey, const std::vector<const Void*>& blocks, const std::vector<UInt64>& blockSizes);
+
+  Bool  load(const std::string& fileName, UInt64 uiKey, const std::vector<UInt64>& blockSizes);   ///< false if missing or not matching;
+  Void  release();
+  Bool  isLoaded() const { return m_pBase != NULL; }
+  Void* getBlock(Int i)  { return (UChar*)m_pBase + m_blockOffset[i]; }
+};
+
+#endif // __TGEOMAPCACHE__
@@ -37,6 +37,7 @@
 
 #include <assert.h>
 #include <math.h>
+#include <chrono>
 #include "../TLibCommon/TComChromaFormat.h"
 #include "TGeometry.h"
 #include "TEquiRect.h"
@@ -48,6 +49,9 @@
 #if SVIDEO_CPPPSNR
 #include "TCrastersParabolic.h"
 #endif
+#if SVIDEO_SIMD_FILTER_GATHER
+#include "../TLibCommon/TComSimd.h"
+#endif
 
 #if SVIDEO_EXT
 
@@ -65,6 +69,157 @@ static inline Int filter1D(T *pSrc, Int iStride, Filter1DInfo* pFilter)
   return ret;
 }
 
+#if SVIDEO_FILTER_GATHER_KERNEL
+/**
+ * \brief weighted sum of an iTapsH x iTapsV window; the tap counts are compile-time constants so the loops are fully unrolled;
+ * the accumulation order is the same as the generic loop, so the result is bit-exact;
+ */
+template<typename TWeight, Int iTapsH, Int iTapsV>
+static Int filterGather(const Pel *pSrc, Int iStride, const TWeight *pWeight)
+{
+  Int sum = 0;
+  for(Int m=0; m<iTapsV; m++)
+  {
+    for(Int n=0; n<iTapsH; n++)
+      sum += pSrc[n]*pWeight[n];
+    pSrc += iStride;
+    pWeight += iTapsH;
+  }
+  return sum;
+}
+#endif
+
+#if SVIDEO_SIMD_FILTER_GATHER
+/**
+ * SIMD versions of filterGather for square windows of 4 and 6 taps, the 1 and 2 tap windows are too small to gain;
+ * the products are exact 32-bit integers, so the sum is the same as the C kernel in any order. Int weights are
+ * multiplied with mullo_epi32, Short weights with madd_epi16. A row of 6 samples is loaded as 4+2 to stay inside the window.
+ */
+template<Int iTaps>
+SIMD_TARGET("sse4.1")
+static inline __m128i loadGatherRow_SSE41(const Short *p)
+{
+  if(iTaps == 4)
+    return _mm_loadl_epi64((const __m128i*)p);
+  else
+    return _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)p), _mm_loadu_si32(p+4));
+}
+
+SIMD_TARGET("sse4.1")
+static inline Int horSumGather_SSE41(__m128i vSum)
+{
+  vSum = _mm_add_epi32(vSum, _mm_shuffle_epi32(vSum, 0x4e));
+  vSum = _mm_add_epi32(vSum, _mm_shuffle_epi32(vSum, 0xb1));
+  return _mm_cvtsi128_si32(vSum);
+}
+
+template<Int iTaps>
+SIMD_TARGET("sse4.1")
+static Int filterGather_SSE41(const Pel *pSrc, Int iStride, const Int *pWeight)
+{
+  __m128i vSum = _mm_setzero_si128();
+  for(Int m=0; m<iTaps; m++)
+  {
+    vSum = _mm_add_epi32(vSum, _mm_mullo_epi32(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*)pSrc)), _mm_loadu_si128((const __m128i*)pWeight)));
+    if(iTaps == 6)
+      vSum = _mm_add_epi32(vSum, _mm_mullo_epi32(_mm_cvtepi16_epi32(_mm_loadu_si32(pSrc+4)), _mm_loadl_epi64((const __m128i*)(pWeight+4))));
+    pSrc += iStride;
+    pWeight += iTaps;
+  }
+  return horSumGather_SSE41(vSum);
+}
+
+template<Int iTaps>
+SIMD_TARGET("sse4.1")
+static Int packedFilterGather_SSE41(const Pel *pSrc, Int iStride, const Short *pWeight)
+{
+  __m128i vSum;
+  if(iTaps == 4)
+  {
+    const __m128i vSrc01 = _mm_unpacklo_epi64(loadGatherRow_SSE41<4>(pSrc), loadGatherRow_SSE41<4>(pSrc+iStride));
+    const __m128i vSrc23 = _mm_unpacklo_epi64(loadGatherRow_SSE41<4>(pSrc+2*iStride), loadGatherRow_SSE41<4>(pSrc+3*iStride));
+    vSum = _mm_add_epi32(_mm_madd_epi16(vSrc01, _mm_loadu_si128((const __m128i*)pWeight)), _mm_madd_epi16(vSrc23, _mm_loadu_si128((const __m128i*)(pWeight+8))));
+  }
+  else
+  {
+    vSum = _mm_setzero_si128();
+    for(Int m=0; m<iTaps; m++)
+    {
+      vSum = _mm_add_epi32(vSum, _mm_madd_epi16(loadGatherRow_SSE41<iTaps>(pSrc), loadGatherRow_SSE41<iTaps>(pWeight)));
+      pSrc += iStride;
+      pWeight += iTaps;
+    }
+  }
+  return horSumGather_SSE41(vSum);
+}
+
+SIMD_TARGET("avx2")
+static inline Int horSumGather_AVX2(__m256i vSum)
+{
+  return horSumGather_SSE41(_mm_add_epi32(_mm256_castsi256_si128(vSum), _mm256_extracti128_si256(vSum, 1)));
+}
+
+/// two rows of the window in the two 128-bit lanes
+template<Int iTaps>
+SIMD_TARGET("avx2")
+static inline __m256i loadGatherRows_AVX2(const Short *p0, const Short *p1)
+{
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(loadGatherRow_SSE41<iTaps>(p0)), loadGatherRow_SSE41<iTaps>(p1), 1);
+}
+
+template<Int iTaps>
+SIMD_TARGET("avx2")
+static Int filterGather_AVX2(const Pel *pSrc, Int iStride, const Int *pWeight)
+{
+  __m256i vSum = _mm256_setzero_si256();
+  if(iTaps == 4)
+  {
+    for(Int m=0; m<iTaps; m+=2)
+    {
+      const __m128i vSrc = _mm_unpacklo_epi64(loadGatherRow_SSE41<4>(pSrc), loadGatherRow_SSE41<4>(pSrc+iStride));
+      vSum = _mm256_add_epi32(vSum, _mm256_mullo_epi32(_mm256_cvtepi16_epi32(vSrc), _mm256_loadu_si256((const __m256i*)pWeight)));
+      pSrc += 2*iStride;
+      pWeight += 2*iTaps;
+    }
+  }
+  else
+  {
+    const __m256i vMask = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+    for(Int m=0; m<iTaps; m++)
+    {
+      vSum = _mm256_add_epi32(vSum, _mm256_mullo_epi32(_mm256_cvtepi16_epi32(loadGatherRow_SSE41<6>(pSrc)), _mm256_maskload_epi32(pWeight, vMask)));
+      pSrc += iStride;
+      pWeight += iTaps;
+    }
+  }
+  return horSumGather_AVX2(vSum);
+}
+
+template<Int iTaps>
+SIMD_TARGET("avx2")
+static Int packedFilterGather_AVX2(const Pel *pSrc, Int iStride, const Short *pWeight)
+{
+  __m256i vSum;
+  if(iTaps == 4)
+  {
+    const __m128i vSrc01 = _mm_unpacklo_epi64(loadGatherRow_SSE41<4>(pSrc), loadGatherRow_SSE41<4>(pSrc+iStride));
+    const __m128i vSrc23 = _mm_unpacklo_epi64(loadGatherRow_SSE41<4>(pSrc+2*iStride), loadGatherRow_SSE41<4>(pSrc+3*iStride));
+    vSum = _mm256_madd_epi16(_mm256_inserti128_si256(_mm256_castsi128_si256(vSrc01), vSrc23, 1), _mm256_loadu_si256((const __m256i*)pWeight));
+  }
+  else
+  {
+    vSum = _mm256_setzero_si256();
+    for(Int m=0; m<iTaps; m+=2)
+    {
+      vSum = _mm256_add_epi32(vSum, _mm256_madd_epi16(loadGatherRows_AVX2<6>(pSrc, pSrc+iStride), loadGatherRows_AVX2<6>(pWeight, pWeight+iTaps)));
+      pSrc += 2*iStride;
+      pWeight += 2*iTaps;
+    }
+  }
+  return horSumGather_AVX2(vSum);
+}
+#endif
+
 Char TGeometry::m_strGeoName[SVIDEO_TYPE_NUM][256] = { {"Equirectangular"},
                                                        {"Cubemap"},
                                                        {"Equal-area"},
@@ -117,6 +272,19 @@ TGeometry::TGeometry()
   m_WeightMap_NumOfBits4Faces = 0;
   memset(m_pPixelWeight, 0, sizeof(m_pPixelWeight));
   m_interpolateWeight[0] = m_interpolateWeight[1] = NULL;
+#if SVIDEO_FILTER_GATHER_KERNEL
+  m_filterGather[0] = m_filterGather[1] = NULL;
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  m_bPackedMap = false;
+  m_pPackedWeightLut[0] = m_pPackedWeightLut[1] = NULL;
+  m_packedFilterGather[0] = m_packedFilterGather[1] = NULL;
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+  m_bSeparableMap = false;
+  m_bSeparableMapped = false;
+  m_pSepWeightLut[0] = m_pSepWeightLut[1] = NULL;
+#endif
   m_iLanczosParamA[0] = m_iLanczosParamA[1] = 0;
   m_pfLanczosFltCoefLut[0] = m_pfLanczosFltCoefLut[1] = NULL;
   m_bGeometryMapping4SpherePadding = false;
@@ -125,6 +293,15 @@ TGeometry::TGeometry()
   memset(m_pWeightLut, 0, sizeof(m_pWeightLut));
   memset(m_iInterpFilterTaps, 0, sizeof(m_iInterpFilterTaps));
   m_bConvOutputPaddingNeeded = false;
+#if SVIDEO_MT_GEOCONVERT
+  m_pcThreadPool = NULL;
+#endif
+#if SVIDEO_MT_GEOMAPPING
+  m_dMappingTime = 0;
+#endif
+#if SVIDEO_BATCH_MAPPING
+  m_bFastProjectionMath = false;
+#endif
 }
 
 Void TGeometry::geoInit(SVideoInfo& sVideoInfo, InputGeoParam *pInGeoParam)
@@ -224,6 +401,13 @@ TGeometry::~TGeometry()
     xFree(m_pUpsTempBuf);
     m_pUpsTempBuf = NULL;
   }
+#if SVIDEO_GEOMAP_CACHE
+  //tables loaded from the cache are released with the cache;
+  if(m_mapCache.isLoaded())
+    memset(m_pPixelWeight, 0, sizeof(m_pPixelWeight));
+  if(m_spMapCache.isLoaded())
+    memset(m_pPixelWeight4SherePadding, 0, sizeof(m_pPixelWeight4SherePadding));
+#endif
   for(Int i=0; i<SV_MAX_NUM_FACES; i++)
   {
     if(m_pPixelWeight[i])
@@ -253,6 +437,20 @@ TGeometry::~TGeometry()
     }
   }
 
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  for(Int j=0; j<2; j++)
+  {
+    delete[] m_pPackedWeightLut[j];
+    m_pPackedWeightLut[j] = NULL;
+  }
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+  for(Int j=0; j<2; j++)
+  {
+    delete[] m_pSepWeightLut[j];
+    m_pSepWeightLut[j] = NULL;
+  }
+#endif
   for(Int j=0; j<2; j++)
   {
     if(m_pWeightLut[j])
@@ -473,115 +671,320 @@ Void TGeometry::initFilterWeightLut()
           m_pWeightLut[i][k] = m_pWeightLut[i][0] + k*iFilterSize;//Brave:pointer init
 
         //calculate the weight;
-        if(m_InterpolationType[i] == SI_NN)
-        {
-          Int w = 1<<(S_INTERPOLATE_PrecisionBD);
-          assert(iFilterSize == 1);
-          for(Int m=0; m<(S_LANCZOS_LUT_SCALE+1); m++)
-            for(Int n=0; n<(S_LANCZOS_LUT_SCALE+1); n++)
-                m_pWeightLut[i][m*(S_LANCZOS_LUT_SCALE+1)+n][0] = w;
-        }
-        else if(m_InterpolationType[i] == SI_BILINEAR)
-        {
-          Int mul = 1<<(S_INTERPOLATE_PrecisionBD);
-          assert(iFilterSize == 4);
-          Double dScale = 1.0/S_LANCZOS_LUT_SCALE;
-          for(Int m=0; m<(S_LANCZOS_LUT_SCALE+1); m++)
+        calcFilterWeights(i, S_LANCZOS_LUT_SCALE, m_pWeightLut[i][0]);
+    }
+  }
+}
+
+/**
+ * \brief weights of filter i for (iPhaseScale+1)x(iPhaseScale+1) fractional positions; 
+ * pWeights[(phaseY*(iPhaseScale+1)+phaseX)*filterSize + r*taps + c];
+ */
+Void TGeometry::calcFilterWeights(Int i, Int iPhaseScale, Int *pWeights)
+{
+  Int iFilterSize = getFilterSize(m_InterpolationType[i]);
+  if(m_InterpolationType[i] == SI_NN)
+  {
+    Int w = 1<<(S_INTERPOLATE_PrecisionBD);
+    assert(iFilterSize == 1);
+    for(Int m=0; m<(iPhaseScale+1); m++)
+      for(Int n=0; n<(iPhaseScale+1); n++)
+        pWeights[m*(iPhaseScale+1)+n] = w;
+  }
+  else if(m_InterpolationType[i] == SI_BILINEAR)
+  {
+    Int mul = 1<<(S_INTERPOLATE_PrecisionBD);
+    assert(iFilterSize == 4);
+    Double dScale = 1.0/iPhaseScale;
+    for(Int m=0; m<(iPhaseScale+1); m++)
+    {
+      Double fy = m*dScale;
+      for(Int n=0; n<(iPhaseScale+1); n++)
+      {              
+        Double fx = n*dScale;
+        Int *pW = pWeights + (m*(iPhaseScale+1)+n)*iFilterSize;
+        pW[0] = round((1 - fx)*(1 -fy)*mul);
+        pW[1] = round((fx)*(1 -fy)*mul);
+        pW[2] = round((1 - fx)*(fy)*mul);
+        pW[3] = mul - pW[0] -pW[1] -pW[2];
+      }
+    }
+  }
+  else if(m_InterpolationType[i] == SI_BICUBIC)
+  {
+    Int mul = 1<<(S_INTERPOLATE_PrecisionBD);
+    assert(iFilterSize == 16);
+    Double dScale = 1.0/iPhaseScale;
+    for(Int m=0; m<(iPhaseScale+1); m++)
+    {
+      Double t = m*dScale, wy[4];
+      wy[0] = (POSType)(0.5*(-t*t*t + 2*t*t - t)); 
+      wy[1] = (POSType)(0.5*(3*t*t*t -5*t*t + 2));
+      wy[2] = (POSType)(0.5*(-3*t*t*t + 4*t*t + t));
+      wy[3] = (POSType)(0.5*(t*t*t - t*t));
+
+      for(Int n=0; n<(iPhaseScale+1); n++)
+      {
+        Int *pW = pWeights + (m*(iPhaseScale+1)+n)*iFilterSize;
+        Int sum=0;
+        Double wx[4];
+        t = n*dScale;
+        wx[0] = (POSType)(0.5*(-t*t*t + 2*t*t - t)); 
+        wx[1] = (POSType)(0.5*(3*t*t*t -5*t*t + 2));
+        wx[2] = (POSType)(0.5*(-3*t*t*t + 4*t*t + t));
+        wx[3] = (POSType)(0.5*(t*t*t - t*t));
+
+        for(Int r=0; r<4; r++)
+          for(Int c=0; c<4; c++)
           {
-            Double fy = m*dScale;
-            for(Int n=0; n<(S_LANCZOS_LUT_SCALE+1); n++)
-            {              
-              Double fx = n*dScale;
-              Int *pW = m_pWeightLut[i][m*(S_LANCZOS_LUT_SCALE+1)+n];
-              pW[0] = round((1 - fx)*(1 -fy)*mul);
-              pW[1] = round((fx)*(1 -fy)*mul);
-              pW[2] = round((1 - fx)*(fy)*mul);
-              pW[3] = mul - pW[0] -pW[1] -pW[2];
-            }
+            Int w;
+            if(c!=3 || r!=3)
+              w = round(wy[r]*wx[c]*mul);
+            else
+              w = mul - sum;
+            pW[r*4+c] = w;
+            sum += w;
           }
-        }
-        else if(m_InterpolationType[i] == SI_BICUBIC)
-        {
-          Int mul = 1<<(S_INTERPOLATE_PrecisionBD);
-          assert(iFilterSize == 16);
-          Double dScale = 1.0/S_LANCZOS_LUT_SCALE;
-          for(Int m=0; m<(S_LANCZOS_LUT_SCALE+1); m++)
-          {
-            Double t = m*dScale, wy[4];
-            wy[0] = (POSType)(0.5*(-t*t*t + 2*t*t - t)); 
-            wy[1] = (POSType)(0.5*(3*t*t*t -5*t*t + 2));
-            wy[2] = (POSType)(0.5*(-3*t*t*t + 4*t*t + t));
-            wy[3] = (POSType)(0.5*(t*t*t - t*t));
+      }
+    }
+  }
+  else if(m_InterpolationType[i] == SI_LANCZOS2 || m_InterpolationType[i] == SI_LANCZOS3)
+  {
+    Int mul = 1<<(S_INTERPOLATE_PrecisionBD);
+    assert((m_InterpolationType[i] == SI_LANCZOS2 && iFilterSize == 16) || (m_InterpolationType[i] == SI_LANCZOS3 && iFilterSize == 36));
+    Double dScale = 1.0/iPhaseScale;//Brave:min
+    POSType *pfLanczosFltCoefLut;
+    pfLanczosFltCoefLut = m_pfLanczosFltCoefLut[i];
+    for(Int m=0; m<(iPhaseScale+1); m++)//Brave:Combination of various possibilities.  x 100 y 100
+    {
+      Double t = m*dScale;
+      POSType wy[6];
+      for(Int k=-m_iLanczosParamA[i]; k<m_iLanczosParamA[i]; k++)//Brave:y  6 points
+        wy[k + m_iLanczosParamA[i]] = pfLanczosFltCoefLut[(Int)((sfabs(t-k-1) + m_iLanczosParamA[i])* S_LANCZOS_LUT_SCALE + 0.5)]; 
 
-            for(Int n=0; n<(S_LANCZOS_LUT_SCALE+1); n++)
-            {
-              Int *pW = m_pWeightLut[i][m*(S_LANCZOS_LUT_SCALE+1)+n];
-              Int sum=0;
-              Double wx[4];
-              t = n*dScale;
-              wx[0] = (POSType)(0.5*(-t*t*t + 2*t*t - t)); 
-              wx[1] = (POSType)(0.5*(3*t*t*t -5*t*t + 2));
-              wx[2] = (POSType)(0.5*(-3*t*t*t + 4*t*t + t));
-              wx[3] = (POSType)(0.5*(t*t*t - t*t));
-
-              for(Int r=0; r<4; r++)
-                for(Int c=0; c<4; c++)
-                {
-                  Int w;
-                  if(c!=3 || r!=3)
-                    w = round(wy[r]*wx[c]*mul);
-                  else
-                    w = mul - sum;
-                  pW[r*4+c] = w;
-                  sum += w;
-                }
-            }
+      for(Int n=0; n<(iPhaseScale+1); n++)
+      {
+        POSType wx[6];
+        Int *pW = pWeights + (m*(iPhaseScale+1)+n)*iFilterSize;
+        Int sum=0;
+        t = n*dScale;
+        for(Int k=-m_iLanczosParamA[i]; k<m_iLanczosParamA[i]; k++)
+          wx[k + m_iLanczosParamA[i]] = pfLanczosFltCoefLut[(Int)((sfabs(t-k-1) + m_iLanczosParamA[i])* S_LANCZOS_LUT_SCALE + 0.5)]; 
+        //normalize;
+        POSType dSum = 0;
+        for(Int r=0; r<(m_iLanczosParamA[i]<<1); r++)
+          for(Int c=0; c<(m_iLanczosParamA[i]<<1); c++)
+              dSum += wy[r]*wx[c];
+        for(Int r=0; r<(m_iLanczosParamA[i]<<1); r++)
+          for(Int c=0; c<(m_iLanczosParamA[i]<<1); c++)
+          {
+            Int w;
+            if(c!=(m_iLanczosParamA[i]<<1)-1 || r!=(m_iLanczosParamA[i]<<1)-1)
+              w = round((POSType)(wy[r]*wx[c]*mul/dSum));
+            else
+              w = mul - sum;
+            pW[r*(m_iLanczosParamA[i]<<1)+c] = w;
+            sum += w;
           }
-        }
-        else if(m_InterpolationType[i] == SI_LANCZOS2 || m_InterpolationType[i] == SI_LANCZOS3)
+      }
+    }
+  }
+}
+
+#if SVIDEO_PACKED_RESAMPLE_MAP
+Void TGeometry::initPackedWeightLut()
+{
+  if(!m_pPackedWeightLut[0])
+  {
+    Int iNumWLuts = (m_chromaFormatIDC==CHROMA_400 || (m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
+    Int iNumPhases = (S_PACKED_MAP_PHASE_SCALE+1)*(S_PACKED_MAP_PHASE_SCALE+1);
+    for(Int i=0; i<iNumWLuts; i++)
+    {
+      Int iFilterSize = getFilterSize(m_InterpolationType[i]);
+      Int *pWeights = new Int[iNumPhases*iFilterSize];
+      calcFilterWeights(i, S_PACKED_MAP_PHASE_SCALE, pWeights);
+      m_pPackedWeightLut[i] = new Short[iNumPhases*iFilterSize];
+      for(Int k=0; k<iNumPhases*iFilterSize; k++)
+      {
+        assert(pWeights[k] >= std::numeric_limits<Short>::min() && pWeights[k] <= std::numeric_limits<Short>::max());
+        m_pPackedWeightLut[i][k] = (Short)pWeights[k];
+      }
+      delete[] pWeights;
+    }
+  }
+}
+
+/**
+ * \brief packed map entry of a position in this geometry, with the phase quantised to 1/S_PACKED_MAP_PHASE_SCALE;
+ */
+Void TGeometry::getPackedMapEntry(ComponentID chId, SPos *pSPosIn, Int &facePos, UShort &phase)
+{
+  ChannelType chType = toChannelType(chId);
+  Int x, y;
+  if(m_InterpolationType[chType] == SI_NN)
+  {
+    x = round(pSPosIn->x);
+    y = round(pSPosIn->y);
+    phase = 0;
+  }
+  else
+  {
+    x = (Int)sfloor(pSPosIn->x);
+    y = (Int)sfloor(pSPosIn->y);
+    phase = (UShort)(round((pSPosIn->y -y)*S_PACKED_MAP_PHASE_SCALE)*(S_PACKED_MAP_PHASE_SCALE+1) + round((pSPosIn->x-x)*S_PACKED_MAP_PHASE_SCALE));
+  }
+  Int iTLPos = (y -((m_iInterpFilterTaps[chType][1]-1)>>1))*getStride(chId) + x -((m_iInterpFilterTaps[chType][0]-1)>>1);
+  facePos = (iTLPos<<m_WeightMap_NumOfBits4Faces) | pSPosIn->faceIdx;
+}
+
+Int64 TGeometry::getMapMemorySize(Bool bPacked)
+{
+  Int iNumMaps = (m_chromaFormatIDC==CHROMA_400 || (m_chromaFormatIDC==CHROMA_444 && m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
+  Int64 iSize = 0;
+  for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
+  {
+    for(Int ch=0; ch<iNumMaps; ch++)
+    {
+      ComponentID chId = (ComponentID)ch;
+      Int iWidth = m_sVideoInfo.iFaceWidth >> getComponentScaleX(chId);
+      Int iHeight = m_sVideoInfo.iFaceHeight >> getComponentScaleY(chId);
+      Int nMarginX = m_iMarginX >> getComponentScaleX(chId); 
+      Int nMarginY = m_iMarginY >> getComponentScaleY(chId);
+      if(!bPacked)
+      {
+        iSize += (Int64)getStride(chId)*(iHeight+(nMarginY<<1))*sizeof(PxlFltLut);
+        continue;
+      }
+      Int64 iNumSamples = 0, iNumRuns = 0;
+      for(Int j=-nMarginY; j<iHeight+nMarginY; j++)
+      {
+        Bool bRunOpen = false;
+        for(Int i=-nMarginX; i<iWidth+nMarginX; i++)
         {
-          Int mul = 1<<(S_INTERPOLATE_PrecisionBD);
-          assert((m_InterpolationType[i] == SI_LANCZOS2 && iFilterSize == 16) || (m_InterpolationType[i] == SI_LANCZOS3 && iFilterSize == 36));
-          Double dScale = 1.0/S_LANCZOS_LUT_SCALE;//Brave:min
-          POSType *pfLanczosFltCoefLut;
-          pfLanczosFltCoefLut = m_pfLanczosFltCoefLut[i];
-          for(Int m=0; m<(S_LANCZOS_LUT_SCALE+1); m++)//Brave:Combination of various possibilities.  x 100 y 100
+          if(!m_bConvOutputPaddingNeeded && !insideFace(fIdx, (i<<getComponentScaleX(chId)), (j<<getComponentScaleY(chId)), COMPONENT_Y, chId))
           {
-            Double t = m*dScale;
-            POSType wy[6];
-            for(Int k=-m_iLanczosParamA[i]; k<m_iLanczosParamA[i]; k++)//Brave:y  6 points
-              wy[k + m_iLanczosParamA[i]] = pfLanczosFltCoefLut[(Int)((sfabs(t-k-1) + m_iLanczosParamA[i])* S_LANCZOS_LUT_SCALE + 0.5)]; 
-
-            for(Int n=0; n<(S_LANCZOS_LUT_SCALE+1); n++)
-            {
-              POSType wx[6];
-              Int *pW = m_pWeightLut[i][m*(S_LANCZOS_LUT_SCALE+1)+n];
-              Int sum=0;
-              t = n*dScale;
-              for(Int k=-m_iLanczosParamA[i]; k<m_iLanczosParamA[i]; k++)
-                wx[k + m_iLanczosParamA[i]] = pfLanczosFltCoefLut[(Int)((sfabs(t-k-1) + m_iLanczosParamA[i])* S_LANCZOS_LUT_SCALE + 0.5)]; 
-              //normalize;
-              POSType dSum = 0;
-              for(Int r=0; r<(m_iLanczosParamA[i]<<1); r++)
-                for(Int c=0; c<(m_iLanczosParamA[i]<<1); c++)
-                    dSum += wy[r]*wx[c];
-              for(Int r=0; r<(m_iLanczosParamA[i]<<1); r++)
-                for(Int c=0; c<(m_iLanczosParamA[i]<<1); c++)
-                {
-                  Int w;
-                  if(c!=(m_iLanczosParamA[i]<<1)-1 || r!=(m_iLanczosParamA[i]<<1)-1)
-                    w = round((POSType)(wy[r]*wx[c]*mul/dSum));
-                  else
-                    w = mul - sum;
-                  pW[r*(m_iLanczosParamA[i]<<1)+c] = w;
-                  sum += w;
-                }
-            }
+            bRunOpen = false;
+            continue;
           }
+          iNumRuns += bRunOpen? 0 : 1;
+          bRunOpen = true;
+          iNumSamples++;
         }
+      }
+      iSize += iNumSamples*(sizeof(Int)+sizeof(UShort)) + iNumRuns*sizeof(PackedMapRun) + (iHeight+(nMarginY<<1)+1)*sizeof(Int);
+    }
+  }
+  return iSize;
+}
+
+Int64 TGeometry::getWeightLutMemorySize(Bool bPacked)
+{
+  Int iNumWLuts = (m_chromaFormatIDC==CHROMA_400 || (m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
+  Int iScale = bPacked? S_PACKED_MAP_PHASE_SCALE : S_LANCZOS_LUT_SCALE;
+  Int64 iSize = 0;
+  for(Int i=0; i<iNumWLuts; i++)
+    iSize += (Int64)(iScale+1)*(iScale+1)*(getFilterSize(m_InterpolationType[i])*(bPacked? sizeof(Short) : sizeof(Int)) + (bPacked? 0 : sizeof(Int*)));
+  return iSize;
+}
+#endif
+
+#if SVIDEO_SEPARABLE_RESAMPLE
+Void TGeometry::initSeparableWeightLut()
+{
+  if(!m_pSepWeightLut[0])
+  {
+    Int iNumWLuts = (m_chromaFormatIDC==CHROMA_400 || (m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
+    for(Int i=0; i<iNumWLuts; i++)
+    {
+      m_pSepWeightLut[i] = new Int[(S_LANCZOS_LUT_SCALE+1)*m_iInterpFilterTaps[i][0]];
+      calcSeparableWeights(i, S_LANCZOS_LUT_SCALE, m_pSepWeightLut[i]);
+    }
+  }
+}
+
+/**
+ * \brief 1D weights of filter i for iPhaseScale+1 fractional positions, normalised as calcFilterWeights; 
+ * pWeights[phase*taps + c];
+ */
+Void TGeometry::calcSeparableWeights(Int i, Int iPhaseScale, Int *pWeights)
+{
+  Int iTaps = m_iInterpFilterTaps[i][0];
+  Int mul = 1<<(S_INTERPOLATE_PrecisionBD);
+  Double dScale = 1.0/iPhaseScale;
+  for(Int n=0; n<(iPhaseScale+1); n++)
+  {
+    Double t = n*dScale;
+    POSType w[6];
+    Int *pW = pWeights + n*iTaps;
+    if(m_InterpolationType[i] == SI_NN)
+      w[0] = 1;
+    else if(m_InterpolationType[i] == SI_BILINEAR)
+    {
+      w[0] = (POSType)(1 - t);
+      w[1] = (POSType)t;
+    }
+    else if(m_InterpolationType[i] == SI_BICUBIC)
+    {
+      w[0] = (POSType)(0.5*(-t*t*t + 2*t*t - t)); 
+      w[1] = (POSType)(0.5*(3*t*t*t -5*t*t + 2));
+      w[2] = (POSType)(0.5*(-3*t*t*t + 4*t*t + t));
+      w[3] = (POSType)(0.5*(t*t*t - t*t));
+    }
+    else if(m_InterpolationType[i] == SI_LANCZOS2 || m_InterpolationType[i] == SI_LANCZOS3)
+    {
+      //normalize;
+      POSType dSum = 0;
+      for(Int k=-m_iLanczosParamA[i]; k<m_iLanczosParamA[i]; k++)
+      {
+        w[k + m_iLanczosParamA[i]] = m_pfLanczosFltCoefLut[i][(Int)((sfabs(t-k-1) + m_iLanczosParamA[i])* S_LANCZOS_LUT_SCALE + 0.5)]; 
+        dSum += w[k + m_iLanczosParamA[i]];
+      }
+      for(Int c=0; c<iTaps; c++)
+        w[c] /= dSum;
+    }
+    else
+      assert(!"Not supported yet");
+
+    Int sum = 0;
+    for(Int c=0; c<iTaps; c++)
+    {
+      pW[c] = (c!=iTaps-1)? round(w[c]*mul) : mul - sum;
+      sum += pW[c];
+    }
+  }
+}
+
+Int64 TGeometry::getSeparableMapMemorySize()
+{
+  Int64 iSize = 0;
+  for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
+    for(Int ch=0; ch<2; ch++)
+    {
+      const SeparableResampleMap& sepMap = m_sepMap[fIdx][ch];
+      iSize += (Int64)(sepMap.colPos.size() + sepMap.rowPos.size() + sepMap.rowExceptions.size())*sizeof(Int) + (Int64)(sepMap.colPhase.size() + sepMap.rowPhase.size())*sizeof(UShort)
+               + (Int64)sepMap.exceptions.size()*sizeof(SeparableMapException);
     }
+  return iSize;
+}
+
+/**
+ * \brief first tap and phase of a source coordinate p of the separable map, as the interpolate_*_weight functions quantise it;
+ */
+Void TGeometry::getSeparableEntry(ChannelType chType, POSType p, Int iTaps, Int &iPos, UShort &phase)
+{
+  if(m_InterpolationType[chType] == SI_NN)
+  {
+    iPos = round(p);
+    phase = 0;
+  }
+  else
+  {
+    iPos = (Int)sfloor(p);
+    phase = (UShort)round((p - iPos)*S_LANCZOS_LUT_SCALE);
   }
+  iPos -= (iTaps-1)>>1;
 }
+#endif
 
 //nearest neighboring;
 Void TGeometry::interpolate_nn_weight(ComponentID chId, SPos *pSPosIn, PxlFltLut &wlist)
@@ -648,11 +1051,49 @@ Void TGeometry::geometryMapping(TGeometry *pGeoSrc)
   assert(!m_bGeometryMapping);
     
     Int iNumMaps = (m_chromaFormatIDC==CHROMA_400 || (m_chromaFormatIDC==CHROMA_444 && m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
-    Int *pRot = m_sVideoInfo.sVideoRotation.degree;
 
     if((m_sVideoInfo.framePackStruct.chromaFormatIDC==CHROMA_420) && ( (m_chromaFormatIDC == CHROMA_444) || (m_chromaFormatIDC == CHROMA_420 && m_bResampleChroma) ) )
       m_bConvOutputPaddingNeeded = true;
 
+    //For ViewPort, Set Rotation Matrix and K matrix
+    if (m_sVideoInfo.geoType==SVIDEO_VIEWPORT)
+    {
+      ((TViewPort*)this)->setRotMat();
+      ((TViewPort*)this)->setInvK();
+    }
+
+#if SVIDEO_SEPARABLE_RESAMPLE
+    if(isSeparableMapping(pGeoSrc))
+    {
+      geometryMappingSeparable(pGeoSrc);
+      m_bSeparableMapped = true;
+      m_bGeometryMapping = true;
+      return;
+    }
+#endif
+#if SVIDEO_GEOMAP_CACHE
+    Bool bWriteCache = false;
+    UInt64 uiCacheKey = 0;
+    if(!m_mapCacheDir.empty()
+#if SVIDEO_PACKED_RESAMPLE_MAP
+       && !m_bPackedMap
+#endif
+      )
+    {
+      TGeoMapHash hash;
+      hash.add("map", 3);
+      hashGeoParams(hash);
+      pGeoSrc->hashGeoParams(hash);
+      uiCacheKey = hash.get();
+      if(loadMappingCache(uiCacheKey))
+      {
+        m_bGeometryMapping = true;
+        return;
+      }
+      bWriteCache = true;
+    }
+#endif
+
     for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
     {
      for(Int ch=0; ch<iNumMaps; ch++)
@@ -661,6 +1102,17 @@ Void TGeometry::geometryMapping(TGeometry *pGeoSrc)
        Int iWidthPW = getStride(chId);
        Int iHeightPW = (m_sVideoInfo.iFaceHeight+(m_iMarginY<<1))>>getComponentScaleY(chId);
 
+#if SVIDEO_PACKED_RESAMPLE_MAP
+       if(m_bPackedMap)
+       {
+         PackedResampleMap& packedMap = m_packedMap[fIdx][ch];
+         packedMap.facePos.clear();
+         packedMap.phase.clear();
+         packedMap.runs.clear();
+         packedMap.rowRuns.assign(iHeightPW+1, 0);
+         continue;
+       }
+#endif
        if(!m_pPixelWeight[fIdx][ch])
        {
          m_pPixelWeight[fIdx][ch] = new PxlFltLut[iWidthPW*iHeightPW];
@@ -668,174 +1120,888 @@ Void TGeometry::geometryMapping(TGeometry *pGeoSrc)
      }
     }
 
-    //For ViewPort, Set Rotation Matrix and K matrix
-    if (m_sVideoInfo.geoType==SVIDEO_VIEWPORT)
-    {
-      ((TViewPort*)this)->setRotMat();
-      ((TViewPort*)this)->setInvK();
-    }
     //Brave:add
     braveLocation = (Pel **)xMalloc(Pel*,iNumMaps);
+    for(Int ch=0; ch<iNumMaps; ch++)
+      braveLocation[ch] = (Pel *)xMalloc(Pel,m_sVideoInfo.iFaceHeight >> getComponentScaleY((ComponentID)ch));
     //Brave:add
 
     //generate the map;
+#if SVIDEO_MT_GEOMAPPING
+    //the samples are mapped independently; the packed map is built per band and concatenated in raster order;
+    std::vector<GeoRowBand> bands;
+    for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
+      for(Int ch=0; ch<iNumMaps; ch++)
+        addRowBands(bands, fIdx, ch);
+#if SVIDEO_PACKED_RESAMPLE_MAP
+    std::vector<PackedResampleMap> bandMaps(m_bPackedMap? bands.size() : 0);
+    runRowBands(bands, [this, pGeoSrc, &bands, &bandMaps](const GeoRowBand& band)
+    {
+      geometryMappingRows(pGeoSrc, band.fIdx, band.ch, band.jStart, band.jEnd, m_bPackedMap? &bandMaps[&band-&bands[0]] : NULL);
+    });
+    if(m_bPackedMap)
+    {
+      for(Int k=0; k<(Int)bands.size(); k++)
+        appendPackedMapRows(bands[k], bandMaps[k]);
+    }
+#else
+    runRowBands(bands, [this, pGeoSrc](const GeoRowBand& band) { geometryMappingRows(pGeoSrc, band.fIdx, band.ch, band.jStart, band.jEnd); });
+#endif
+#else
     for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
     {
       for(Int ch=0; ch<iNumMaps; ch++)
       {
-        //Brave:add
-        braveLocation[ch] = (Pel *)xMalloc(Pel,m_sVideoInfo.iFaceHeight >> getComponentScaleY((ComponentID)ch));
-        //Brave:add
         ComponentID chId = (ComponentID)ch;
-        Int iStridePW = getStride(chId);
-        Int iWidth = m_sVideoInfo.iFaceWidth >> getComponentScaleX(chId);
         Int iHeight = m_sVideoInfo.iFaceHeight >> getComponentScaleY(chId);
-        Int nMarginX = m_iMarginX >> getComponentScaleX(chId); 
         Int nMarginY = m_iMarginY >> getComponentScaleY(chId);
-        for(Int j=-nMarginY; j<iHeight+nMarginY; j++) 
+#if SVIDEO_PACKED_RESAMPLE_MAP
+        geometryMappingRows(pGeoSrc, fIdx, ch, -nMarginY, iHeight+nMarginY, m_bPackedMap? &m_packedMap[fIdx][ch] : NULL);
+#else
+        geometryMappingRows(pGeoSrc, fIdx, ch, -nMarginY, iHeight+nMarginY);
+#endif
+      }
+    }
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+    if(m_bPackedMap)
+    {
+      for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
+        for(Int ch=0; ch<iNumMaps; ch++)
         {
-          //Brave:add
-          int braveCount = 0;
-          if ((j >= 0) && (j < iHeight))
-          {
-            braveLocation[chId][j] = 0;
-          }
-          //Brave:add
-          for(Int i=-nMarginX; i<iWidth+nMarginX; i++)  
-          {
-            if(!m_bConvOutputPaddingNeeded && !insideFace(fIdx, (i<<getComponentScaleX(chId)), (j<<getComponentScaleY(chId)), COMPONENT_Y, chId))
-              continue;
-
-            //Brave:add
-//            if (i < 0 || i > iWidth)
-//              continue;
-            //Brave:add end
-            Int xOrg = (i+nMarginX);
-            Int yOrg = (j+nMarginY);
-            Int ic = i;
-            Int jc = j;
-            {
-              PxlFltLut& wList = m_pPixelWeight[fIdx][ch][yOrg*iStridePW + xOrg];
-              POSType x = (ic) * (1<<getComponentScaleX(chId));
-              POSType y = (jc) * (1<<getComponentScaleY(chId)); 
-              SPos in(fIdx, x, y, 0), pos3D;
-              
-              map2DTo3D(in, &pos3D);
-              rotate3D(pos3D, pRot[0], pRot[1], pRot[2]);
-              //Brave:add
-              if((pos3D.x == 1) && (pos3D.y == 0) && (pos3D.z == 0))
-              {
-                if (i <= iWidth / 2)
-                {
-                  ++ braveCount;
-                  //if (j > 10 || j < iHeight / 2)
-                  //{
-                  //  
-                  //}
-                  braveLocation[chId][j] = braveCount;
-                }
-              }
-              //Brave:add
-              pGeoSrc->map3DTo2D(&pos3D, &pos3D);
-
-              pos3D.x = pos3D.x/POSType(1<<getComponentScaleX(chId));
-              pos3D.y = pos3D.y/POSType(1<<getComponentScaleY(chId));
-              (pGeoSrc->*pGeoSrc->m_interpolateWeight[toChannelType(chId)])(chId, &pos3D, wList);
-            }    
-          }
+          PackedResampleMap& packedMap = m_packedMap[fIdx][ch];
+          std::vector<Int>(packedMap.facePos).swap(packedMap.facePos);
+          std::vector<UShort>(packedMap.phase).swap(packedMap.phase);
+          std::vector<PackedMapRun>(packedMap.runs).swap(packedMap.runs);
         }
-      }
     }
+#endif
+#if SVIDEO_GEOMAP_CACHE
+    if(bWriteCache)
+      writeMappingCache(uiCacheKey);
+#endif
     m_bGeometryMapping = true;
     
 }
 
-/***************************************************
-//convert source geometry to destination geometry;
-****************************************************/
-Void TGeometry::geoConvert(TGeometry *pGeoDst)
+/**
+ * \brief map rows [jStart, jEnd) of one face channel (margins included) to the source geometry;
+ * with the packed map the rows are appended to *pPackedMap, whose rowRuns is indexed by j-jStart;
+ */
+#if SVIDEO_PACKED_RESAMPLE_MAP
+Void TGeometry::geometryMappingRows(TGeometry *pGeoSrc, Int fIdx, Int ch, Int jStart, Int jEnd, PackedResampleMap *pPackedMap)
+#else
+Void TGeometry::geometryMappingRows(TGeometry *pGeoSrc, Int fIdx, Int ch, Int jStart, Int jEnd)
+#endif
 {
-  //padding;
-  spherePadding();
+#if !SVIDEO_BATCH_MAPPING
+  Int *pRot = m_sVideoInfo.sVideoRotation.degree;
+#endif
+  ComponentID chId = (ComponentID)ch;
+  Int iStridePW = getStride(chId);
+  Int iWidth = m_sVideoInfo.iFaceWidth >> getComponentScaleX(chId);
+  Int iHeight = m_sVideoInfo.iFaceHeight >> getComponentScaleY(chId);
+  Int nMarginX = m_iMarginX >> getComponentScaleX(chId); 
+  Int nMarginY = m_iMarginY >> getComponentScaleY(chId);
+  //Brave: only the last face's result is kept, as when the faces were mapped one after another;
+  Bool bBraveFace = (fIdx == m_sVideoInfo.iNumFaces-1);
+#if SVIDEO_BATCH_MAPPING
+  std::vector<Int> cols;
+  SPosArray rowPos;
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  if(pPackedMap)
+  {
+    pPackedMap->facePos.clear();
+    pPackedMap->phase.clear();
+    pPackedMap->runs.clear();
+    pPackedMap->rowRuns.assign(jEnd-jStart+1, 0);
+  }
+#endif
+  for(Int j=jStart; j<jEnd; j++) 
+  {
+    //Brave:add
+#if !SVIDEO_BATCH_MAPPING
+    int braveCount = 0;
+#endif
+    if (bBraveFace && (j >= 0) && (j < iHeight))
+    {
+      braveLocation[chId][j] = 0;
+    }
+    //Brave:add
+#if SVIDEO_BATCH_MAPPING
+    cols.clear();
+    for(Int i=-nMarginX; i<iWidth+nMarginX; i++)  
+    {
+      if(m_bConvOutputPaddingNeeded || insideFace(fIdx, (i<<getComponentScaleX(chId)), (j<<getComponentScaleY(chId)), COMPONENT_Y, chId))
+        cols.push_back(i);
+    }
+    mapRowToSource(pGeoSrc, fIdx, chId, j, cols, rowPos, bBraveFace? braveLocation[chId] : NULL);
+#if SVIDEO_PACKED_RESAMPLE_MAP
+    if(pPackedMap)
+      pPackedMap->rowRuns[j-jStart] = (Int)pPackedMap->runs.size();
+#endif
+    for(Int k=0; k<(Int)cols.size(); k++)
+    {
+      Int i = cols[k];
+      SPos pos3D = rowPos.get(k);
+#if SVIDEO_PACKED_RESAMPLE_MAP
+      if(pPackedMap)
+      {
+        Int facePos;
+        UShort phase;
+        pGeoSrc->getPackedMapEntry(chId, &pos3D, facePos, phase);
+        if(k==0 || i!=cols[k-1]+1)
+        {
+          PackedMapRun run = { i, 0, (Int)pPackedMap->facePos.size() };
+          pPackedMap->runs.push_back(run);
+        }
+        pPackedMap->runs.back().iNum++;
+        pPackedMap->facePos.push_back(facePos);
+        pPackedMap->phase.push_back(phase);
+        continue;
+      }
+#endif
+      PxlFltLut& wList = m_pPixelWeight[fIdx][ch][(j+nMarginY)*iStridePW + (i+nMarginX)];
+      (pGeoSrc->*pGeoSrc->m_interpolateWeight[toChannelType(chId)])(chId, &pos3D, wList);
+    }
+#else
+#if SVIDEO_PACKED_RESAMPLE_MAP
+    Bool bRunOpen = false;
+    if(pPackedMap)
+      pPackedMap->rowRuns[j-jStart] = (Int)pPackedMap->runs.size();
+#endif
+    for(Int i=-nMarginX; i<iWidth+nMarginX; i++)  
+    {
+      if(!m_bConvOutputPaddingNeeded && !insideFace(fIdx, (i<<getComponentScaleX(chId)), (j<<getComponentScaleY(chId)), COMPONENT_Y, chId))
+      {
+#if SVIDEO_PACKED_RESAMPLE_MAP
+        bRunOpen = false;
+#endif
+        continue;
+      }
+
+      Int xOrg = (i+nMarginX);
+      Int yOrg = (j+nMarginY);
+      POSType x = (i) * (1<<getComponentScaleX(chId));
+      POSType y = (j) * (1<<getComponentScaleY(chId)); 
+      SPos in(fIdx, x, y, 0), pos3D;
+
+      map2DTo3D(in, &pos3D);
+      rotate3D(pos3D, pRot[0], pRot[1], pRot[2]);
+      //Brave:add
+      if(bBraveFace && (pos3D.x == 1) && (pos3D.y == 0) && (pos3D.z == 0))
+      {
+        if (i <= iWidth / 2)
+        {
+          ++ braveCount;
+          braveLocation[chId][j] = braveCount;
+        }
+      }
+      //Brave:add
+      pGeoSrc->map3DTo2D(&pos3D, &pos3D);
+
+      pos3D.x = pos3D.x/POSType(1<<getComponentScaleX(chId));
+      pos3D.y = pos3D.y/POSType(1<<getComponentScaleY(chId));
+#if SVIDEO_PACKED_RESAMPLE_MAP
+      if(pPackedMap)
+      {
+        Int facePos;
+        UShort phase;
+        pGeoSrc->getPackedMapEntry(chId, &pos3D, facePos, phase);
+        if(!bRunOpen)
+        {
+          PackedMapRun run = { i, 0, (Int)pPackedMap->facePos.size() };
+          pPackedMap->runs.push_back(run);
+          bRunOpen = true;
+        }
+        pPackedMap->runs.back().iNum++;
+        pPackedMap->facePos.push_back(facePos);
+        pPackedMap->phase.push_back(phase);
+        continue;
+      }
+#endif
+      PxlFltLut& wList = m_pPixelWeight[fIdx][ch][yOrg*iStridePW + xOrg];
+      (pGeoSrc->*pGeoSrc->m_interpolateWeight[toChannelType(chId)])(chId, &pos3D, wList);
+    }
+#endif
+  }
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  if(pPackedMap)
+    pPackedMap->rowRuns[jEnd-jStart] = (Int)pPackedMap->runs.size();
+#endif
+}
+
+#if SVIDEO_MT_GEOMAPPING && SVIDEO_PACKED_RESAMPLE_MAP
+/**
+ * \brief append the packed map of one band to m_packedMap; the bands of a face channel must be appended top to bottom;
+ */
+Void TGeometry::appendPackedMapRows(const GeoRowBand& band, const PackedResampleMap& bandMap)
+{
+  PackedResampleMap& packedMap = m_packedMap[band.fIdx][band.ch];
+  Int nMarginY = m_iMarginY >> getComponentScaleY((ComponentID)band.ch);
+  Int iSampleOffset = (Int)packedMap.facePos.size();
+  Int iRunOffset = (Int)packedMap.runs.size();
+
+  packedMap.facePos.insert(packedMap.facePos.end(), bandMap.facePos.begin(), bandMap.facePos.end());
+  packedMap.phase.insert(packedMap.phase.end(), bandMap.phase.begin(), bandMap.phase.end());
+  for(Int r=0; r<(Int)bandMap.runs.size(); r++)
+  {
+    PackedMapRun run = bandMap.runs[r];
+    run.iIdx += iSampleOffset;
+    packedMap.runs.push_back(run);
+  }
+  for(Int j=band.jStart; j<=band.jEnd; j++)
+    packedMap.rowRuns[j+nMarginY] = bandMap.rowRuns[j-band.jStart] + iRunOffset;
+}
+#endif
+
+#if SVIDEO_SEPARABLE_RESAMPLE
+/**
+ * \brief ERP to ERP and EAP to EAP without rotation map columns and rows independently, apart from the vertical margins;
+ */
+Bool TGeometry::isSeparableMapping(TGeometry *pGeoSrc)
+{
+  Int *pRot = m_sVideoInfo.sVideoRotation.degree;
+  return m_bSeparableMap && getType() == pGeoSrc->getType() && (getType() == SVIDEO_EQUIRECT || getType() == SVIDEO_EQUALAREA)
+         && m_sVideoInfo.iNumFaces == 1 && pGeoSrc->m_sVideoInfo.iNumFaces == 1 && !pRot[0] && !pRot[1] && !pRot[2];
+}
+
+/**
+ * \brief build m_sepMap: the column table from the centre row, the row table from the centre column, and the exceptions;
+ */
+Void TGeometry::geometryMappingSeparable(TGeometry *pGeoSrc)
+{
+  Int iNumMaps = (m_chromaFormatIDC==CHROMA_400 || (m_chromaFormatIDC==CHROMA_444 && m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
+
+  //Brave:add
+  braveLocation = (Pel **)xMalloc(Pel*,iNumMaps);
+  for(Int ch=0; ch<iNumMaps; ch++)
+    braveLocation[ch] = (Pel *)xMalloc(Pel,m_sVideoInfo.iFaceHeight >> getComponentScaleY((ComponentID)ch));
+  //Brave:add
+
+  std::vector<GeoRowBand> bands;
+  for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
+  {
+    for(Int ch=0; ch<iNumMaps; ch++)
+    {
+      ComponentID chId = (ComponentID)ch;
+      ChannelType chType = toChannelType(chId);
+      Int nWidth = m_sVideoInfo.iFaceWidth >> getComponentScaleX(chId);
+      Int nHeight = m_sVideoInfo.iFaceHeight >> getComponentScaleY(chId);
+      Int nMarginX = m_bConvOutputPaddingNeeded? (m_iMarginX >> getComponentScaleX(chId)) : 0;
+      Int nMarginY = m_bConvOutputPaddingNeeded? (m_iMarginY >> getComponentScaleY(chId)) : 0;
+      SeparableResampleMap& sepMap = m_sepMap[fIdx][ch];
+      sepMap.iColStart = -nMarginX;
+      sepMap.iColEnd = nWidth+nMarginX;
+      sepMap.iRowStart = -nMarginY;
+      sepMap.iRowEnd = nHeight+nMarginY;
+
+      std::vector<Int> cols;
+      SPosArray pos;
+      for(Int i=sepMap.iColStart; i<sepMap.iColEnd; i++)
+        cols.push_back(i);
+      mapRowToSource(pGeoSrc, fIdx, chId, nHeight>>1, cols, pos, NULL);
+      sepMap.colPos.resize(cols.size());
+      sepMap.colPhase.resize(cols.size());
+      for(Int k=0; k<(Int)cols.size(); k++)
+        pGeoSrc->getSeparableEntry(chType, pos.x[k], pGeoSrc->m_iInterpFilterTaps[chType][0], sepMap.colPos[k], sepMap.colPhase[k]);
+      sepMap.rowPos.resize(sepMap.iRowEnd-sepMap.iRowStart);
+      sepMap.rowPhase.resize(sepMap.iRowEnd-sepMap.iRowStart);
+      sepMap.rowExceptions.assign(sepMap.iRowEnd-sepMap.iRowStart+1, 0);
+      sepMap.exceptions.clear();
+      addRowBands(bands, fIdx, ch);
+    }
+  }
+
+  //the rows are mapped in bands; the exceptions of a band are appended in raster order;
+  std::vector<std::vector<SeparableMapException> > bandExceptions(bands.size());
+  runRowBands(bands, [this, pGeoSrc, &bands, &bandExceptions](const GeoRowBand& band)
+  {
+    geometryMappingSeparableRows(pGeoSrc, band.fIdx, band.ch, band.jStart, band.jEnd, bandExceptions[&band-&bands[0]]);
+  });
+  for(Int k=0; k<(Int)bands.size(); k++)
+  {
+    SeparableResampleMap& sepMap = m_sepMap[bands[k].fIdx][bands[k].ch];
+    Int iOffset = (Int)sepMap.exceptions.size();
+    for(Int j=std::max(bands[k].jStart, sepMap.iRowStart); j<std::min(bands[k].jEnd, sepMap.iRowEnd); j++)
+      sepMap.rowExceptions[j-sepMap.iRowStart] += iOffset;
+    sepMap.exceptions.insert(sepMap.exceptions.end(), bandExceptions[k].begin(), bandExceptions[k].end());
+    sepMap.rowExceptions.back() = (Int)sepMap.exceptions.size();
+  }
+}
+
+/**
+ * \brief map rows [jStart, jEnd) of one face channel, set their row table entries and collect the samples the tables do not describe;
+ * rowExceptions of the rows are relative to the first exception of the band;
+ */
+Void TGeometry::geometryMappingSeparableRows(TGeometry *pGeoSrc, Int fIdx, Int ch, Int jStart, Int jEnd, std::vector<SeparableMapException>& exceptions)
+{
+  ComponentID chId = (ComponentID)ch;
+  ChannelType chType = toChannelType(chId);
+  SeparableResampleMap& sepMap = m_sepMap[fIdx][ch];
+  Int nWidth = m_sVideoInfo.iFaceWidth >> getComponentScaleX(chId);
+  Int nHeight = m_sVideoInfo.iFaceHeight >> getComponentScaleY(chId);
+  Int iTapsX = pGeoSrc->m_iInterpFilterTaps[chType][0];
+  Int iTapsY = pGeoSrc->m_iInterpFilterTaps[chType][1];
+  Int iRefCol = (nWidth>>1) - sepMap.iColStart;
+
+  std::vector<Int> cols;
+  SPosArray pos;
+  for(Int i=sepMap.iColStart; i<sepMap.iColEnd; i++)
+    cols.push_back(i);
+  for(Int j=std::max(jStart, sepMap.iRowStart); j<std::min(jEnd, sepMap.iRowEnd); j++)
+  {
+    Bool bFaceRow = (j >= 0) && (j < nHeight);
+    //Brave:add
+    if (bFaceRow)
+    {
+      braveLocation[chId][j] = 0;
+    }
+    //Brave:add
+    mapRowToSource(pGeoSrc, fIdx, chId, j, cols, pos, bFaceRow? braveLocation[chId] : NULL);
+
+    Int r = j - sepMap.iRowStart;
+    pGeoSrc->getSeparableEntry(chType, pos.y[iRefCol], iTapsY, sepMap.rowPos[r], sepMap.rowPhase[r]);
+    sepMap.rowExceptions[r] = (Int)exceptions.size();
+    //Brave: samples of [0, nWidth) outside [iBraveStart, iBraveEnd] are overwritten by braveRows and need no exception;
+    Int iBraveStart = 0, iBraveEnd = nWidth;
+    if(bFaceRow && nWidth/2 > braveLocation[chId][j])
+    {
+      iBraveStart = braveLocation[chId][j];
+      iBraveEnd = iBraveStart + 2*(nWidth/2 - iBraveStart);
+    }
+    for(Int k=0; k<(Int)cols.size(); k++)
+    {
+      Int i = cols[k];
+      if(bFaceRow && i >= 0 && i < nWidth && (i < iBraveStart || i > iBraveEnd))
+        continue;
+      Int iPosX, iPosY;
+      UShort phaseX, phaseY;
+      pGeoSrc->getSeparableEntry(chType, pos.x[k], iTapsX, iPosX, phaseX);
+      pGeoSrc->getSeparableEntry(chType, pos.y[k], iTapsY, iPosY, phaseY);
+      if(iPosX == sepMap.colPos[k] && phaseX == sepMap.colPhase[k] && iPosY == sepMap.rowPos[r] && phaseY == sepMap.rowPhase[r])
+        continue;
+      SeparableMapException exception;
+      SPos pos2D = pos.get(k);
+      exception.x = i;
+      (pGeoSrc->*pGeoSrc->m_interpolateWeight[chType])(chId, &pos2D, exception.wList);
+      exceptions.push_back(exception);
+    }
+  }
+}
+#endif
+
+/***************************************************
+//convert source geometry to destination geometry;
+****************************************************/
+Void TGeometry::geoConvert(TGeometry *pGeoDst)
+{
+  //padding;
+  spherePadding();
 
   if(!pGeoDst->m_bGeometryMapping)
+  {
+#if SVIDEO_MT_GEOMAPPING
+    std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
     pGeoDst->geometryMapping(this);
+    pGeoDst->m_dMappingTime += std::chrono::duration<Double>(std::chrono::steady_clock::now() - tStart).count();
+#else
+    pGeoDst->geometryMapping(this);
+#endif
+  }
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  if(pGeoDst->m_bPackedMap)
+    initPackedWeightLut();
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+  if(pGeoDst->m_bSeparableMapped)
+    initSeparableWeightLut();
+#endif
 
   Int nFaces = pGeoDst->m_sVideoInfo.iNumFaces;
-  Int iBDPrecision = S_INTERPOLATE_PrecisionBD;
-  Int iWeightMapFaceMask = (1<<m_WeightMap_NumOfBits4Faces)-1;
-  Int iOffset = 1<<(iBDPrecision-1);
+#if SVIDEO_MT_GEOCONVERT
+  //every output row is written by exactly one band, so the bands are independent;
+  std::vector<GeoRowBand> bands;
+  for(Int fIdx=0; fIdx<nFaces; fIdx++)
+    for(Int ch=0; ch<pGeoDst->getNumChannels(); ch++)
+      pGeoDst->addRowBands(bands, fIdx, ch);
+  runRowBands(bands, [this, pGeoDst](const GeoRowBand& band) { geoConvertRows(pGeoDst, band.fIdx, band.ch, band.jStart, band.jEnd); });
+#else
   for(Int fIdx=0; fIdx<nFaces; fIdx++)
   {
     for(Int ch=0; ch<pGeoDst->getNumChannels(); ch++)
     {
       ComponentID chId = (ComponentID)ch;
-      Int nWidth = pGeoDst->m_sVideoInfo.iFaceWidth >> pGeoDst->getComponentScaleX(chId);
       Int nHeight = pGeoDst->m_sVideoInfo.iFaceHeight >> pGeoDst->getComponentScaleY(chId);
-
-      Int nMarginX = pGeoDst->m_iMarginX >> pGeoDst->getComponentScaleX(chId);
       Int nMarginY = pGeoDst->m_iMarginY >> pGeoDst->getComponentScaleY(chId);
-      Int iWidthPW = pGeoDst->getStride(chId);
-      Int mapIdx = (pGeoDst->m_chromaFormatIDC==CHROMA_444 && pGeoDst->m_InterpolationType[CHANNEL_TYPE_LUMA] == pGeoDst->m_InterpolationType[CHANNEL_TYPE_CHROMA])? 0 : (ch>0? 1: 0);
-      ChannelType chType = toChannelType(chId);
+      geoConvertRows(pGeoDst, fIdx, ch, -nMarginY, nHeight+nMarginY);
+    }
+  }
+#endif
+
+  pGeoDst->setPaddingFlag(pGeoDst->m_bConvOutputPaddingNeeded ? true : false); 
+}
 
-      for(Int j=-nMarginY; j<nHeight+nMarginY; j++) 
-        for(Int i=-nMarginX; i<nWidth+nMarginX; i++)  
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+/**
+ * \brief convert the source to several destination geometries; the destinations are mapped one after another, then the row bands
+ * of all destinations are converted in one pass;
+ */
+Void TGeometry::geoConvert(const std::vector<TGeometry*>& geoDsts)
+{
+  //padding;
+  spherePadding();
+
+  std::vector<GeoRowBand> bands;
+  std::vector<TGeometry*> bandDsts;
+  for(size_t k=0; k<geoDsts.size(); k++)
+  {
+    TGeometry *pGeoDst = geoDsts[k];
+    if(!pGeoDst->m_bGeometryMapping)
+    {
+#if SVIDEO_MT_GEOMAPPING
+      std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+      pGeoDst->geometryMapping(this);
+      pGeoDst->m_dMappingTime += std::chrono::duration<Double>(std::chrono::steady_clock::now() - tStart).count();
+#else
+      pGeoDst->geometryMapping(this);
+#endif
+    }
+#if SVIDEO_PACKED_RESAMPLE_MAP
+    if(pGeoDst->m_bPackedMap)
+      initPackedWeightLut();
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+    if(pGeoDst->m_bSeparableMapped)
+      initSeparableWeightLut();
+#endif
+    for(Int fIdx=0; fIdx<pGeoDst->m_sVideoInfo.iNumFaces; fIdx++)
+      for(Int ch=0; ch<pGeoDst->getNumChannels(); ch++)
+        pGeoDst->addRowBands(bands, fIdx, ch);
+    bandDsts.resize(bands.size(), pGeoDst);
+  }
+  runRowBands(bands, [this, &bands, &bandDsts](const GeoRowBand& band)
+  {
+    geoConvertRows(bandDsts[&band-&bands[0]], band.fIdx, band.ch, band.jStart, band.jEnd);
+  });
+
+  for(size_t k=0; k<geoDsts.size(); k++)
+    geoDsts[k]->setPaddingFlag(geoDsts[k]->m_bConvOutputPaddingNeeded ? true : false);
+}
+#endif
+
+/**
+ * \brief convert rows [jStart, jEnd) of one face channel of pGeoDst; rows are relative to the face origin and may be in the margin;
+ */
+Void TGeometry::geoConvertRows(TGeometry *pGeoDst, Int fIdx, Int ch, Int jStart, Int jEnd)
+{
+#if SVIDEO_SEPARABLE_RESAMPLE
+  if(pGeoDst->m_bSeparableMapped)
+  {
+    geoConvertSeparableRows(pGeoDst, fIdx, ch, jStart, jEnd);
+    return;
+  }
+#endif
+  Int iBDPrecision = S_INTERPOLATE_PrecisionBD;
+  Int iWeightMapFaceMask = (1<<m_WeightMap_NumOfBits4Faces)-1;
+  Int iOffset = 1<<(iBDPrecision-1);
+
+  ComponentID chId = (ComponentID)ch;
+  Int nWidth = pGeoDst->m_sVideoInfo.iFaceWidth >> pGeoDst->getComponentScaleX(chId);
+
+  Int nMarginX = pGeoDst->m_iMarginX >> pGeoDst->getComponentScaleX(chId);
+  Int nMarginY = pGeoDst->m_iMarginY >> pGeoDst->getComponentScaleY(chId);
+  Int iWidthPW = pGeoDst->getStride(chId);
+  Int mapIdx = (pGeoDst->m_chromaFormatIDC==CHROMA_444 && pGeoDst->m_InterpolationType[CHANNEL_TYPE_LUMA] == pGeoDst->m_InterpolationType[CHANNEL_TYPE_CHROMA])? 0 : (ch>0? 1: 0);
+  ChannelType chType = toChannelType(chId);
+#if SVIDEO_FILTER_GATHER_KERNEL
+  Int iStrideSrc = getStride(chId);
+  Int iWLutIdx = (m_chromaFormatIDC==CHROMA_400 || (m_InterpolationType[0]==m_InterpolationType[1]))? 0 : chType;
+  Int **pWeightLut = m_pWeightLut[iWLutIdx];
+  Int iTapOffset = ((m_iInterpFilterTaps[chType][1]-1)>>1)*iStrideSrc + ((m_iInterpFilterTaps[chType][0]-1)>>1);
+  FilterGatherFP filterGather = m_filterGather[chType];
+#endif
+
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  if(pGeoDst->m_bPackedMap)
+  {
+    //runs of output samples with the map read sequentially;
+    const PackedResampleMap& packedMap = pGeoDst->m_packedMap[fIdx][mapIdx];
+    const Short *pPackedWeight = m_pPackedWeightLut[iWLutIdx];
+    Int iFilterSize = m_iInterpFilterTaps[chType][0]*m_iInterpFilterTaps[chType][1];
+    PackedFilterGatherFP packedFilterGather = m_packedFilterGather[chType];
+    for(Int j=jStart; j<jEnd; j++)
+    {
+      Pel *pDstLine = pGeoDst->m_pFacesOrig[fIdx][ch] + j*pGeoDst->getStride(chId);
+      for(Int r=packedMap.rowRuns[j+nMarginY]; r<packedMap.rowRuns[j+nMarginY+1]; r++)
+      {
+        const PackedMapRun& run = packedMap.runs[r];
+        const Int *pFacePos = &packedMap.facePos[run.iIdx];
+        const UShort *pPhase = &packedMap.phase[run.iIdx];
+        Pel *pDst = pDstLine + run.x;
+        for(Int k=0; k<run.iNum; k++)
         {
-          if(!pGeoDst->m_bConvOutputPaddingNeeded && !pGeoDst->insideFace(fIdx, (i<<getComponentScaleX(chId)), (j<<getComponentScaleY(chId)), COMPONENT_Y, chId))
-            continue;
-          //Brave:add
-//          if (i < 0 || i > nWidth)
-//            continue;
-          //Brave:add end
-          Int x = i+nMarginX;
-          Int y = j+nMarginY;
-          Int sum =0;
-
-          PxlFltLut *pPelWeight = pGeoDst->m_pPixelWeight[fIdx][mapIdx] + y*iWidthPW + x;
-          Int face = (pPelWeight->facePos)&iWeightMapFaceMask;
-          Int iTLPos = (pPelWeight->facePos)>>m_WeightMap_NumOfBits4Faces;
-          Int iWLutIdx = (m_chromaFormatIDC==CHROMA_400 || (m_InterpolationType[0]==m_InterpolationType[1]))? 0 : chType;
-          Int *pWLut = m_pWeightLut[iWLutIdx][pPelWeight->weightIdx];
-          Pel *pPelLine = m_pFacesOrig[face][ch] +iTLPos -((m_iInterpFilterTaps[chType][1]-1)>>1)*getStride(chId) -((m_iInterpFilterTaps[chType][0]-1)>>1);
-          for(Int m=0; m<m_iInterpFilterTaps[chType][1]; m++)
-          {
-            for(Int n=0; n<m_iInterpFilterTaps[chType][0]; n++)
-              sum += pPelLine[n]*pWLut[n];
-            pPelLine += getStride(chId);
-            pWLut += m_iInterpFilterTaps[chType][0];
-          }
+          Int sum = packedFilterGather(m_pFacesOrig[pFacePos[k]&iWeightMapFaceMask][ch] + (pFacePos[k]>>m_WeightMap_NumOfBits4Faces), iStrideSrc, pPackedWeight + pPhase[k]*iFilterSize);
+          pDst[k] = (sum + iOffset)>>iBDPrecision;
+        }
+      }
+    }
+  }
+  else
+#endif
+  for(Int j=jStart; j<jEnd; j++) 
+    for(Int i=-nMarginX; i<nWidth+nMarginX; i++)  
+    {
+      if(!pGeoDst->m_bConvOutputPaddingNeeded && !pGeoDst->insideFace(fIdx, (i<<getComponentScaleX(chId)), (j<<getComponentScaleY(chId)), COMPONENT_Y, chId))
+        continue;
+      //Brave:add
+//      if (i < 0 || i > nWidth)
+//        continue;
+      //Brave:add end
+      Int x = i+nMarginX;
+      Int y = j+nMarginY;
+
+      PxlFltLut *pPelWeight = pGeoDst->m_pPixelWeight[fIdx][mapIdx] + y*iWidthPW + x;
+      Int face = (pPelWeight->facePos)&iWeightMapFaceMask;
+      Int iTLPos = (pPelWeight->facePos)>>m_WeightMap_NumOfBits4Faces;
+#if SVIDEO_FILTER_GATHER_KERNEL
+      Int sum = filterGather(m_pFacesOrig[face][ch] +iTLPos -iTapOffset, iStrideSrc, pWeightLut[pPelWeight->weightIdx]);
+#else
+      Int sum =0;
+      Int iWLutIdx = (m_chromaFormatIDC==CHROMA_400 || (m_InterpolationType[0]==m_InterpolationType[1]))? 0 : chType;
+      Int *pWLut = m_pWeightLut[iWLutIdx][pPelWeight->weightIdx];
+      Pel *pPelLine = m_pFacesOrig[face][ch] +iTLPos -((m_iInterpFilterTaps[chType][1]-1)>>1)*getStride(chId) -((m_iInterpFilterTaps[chType][0]-1)>>1);
+      for(Int m=0; m<m_iInterpFilterTaps[chType][1]; m++)
+      {
+        for(Int n=0; n<m_iInterpFilterTaps[chType][0]; n++)
+          sum += pPelLine[n]*pWLut[n];
+        pPelLine += getStride(chId);
+        pWLut += m_iInterpFilterTaps[chType][0];
+      }
+#endif
+
+      Int iPos = j*pGeoDst->getStride(chId) + i;
+      pGeoDst->m_pFacesOrig[fIdx][ch][iPos] = (sum + iOffset)>>iBDPrecision;
+    }
+  //Brave:add
+  pGeoDst->braveRows(fIdx, ch, pGeoDst->braveLocation[mapIdx], jStart, jEnd);
+}
+
+/**
+ * \brief Brave: fill rows [jStart, jEnd) of one face channel outside the span given by pBraveLocation periodically from the span;
+ */
+Void TGeometry::braveRows(Int fIdx, Int ch, const Pel *pBraveLocation, Int jStart, Int jEnd)
+{
+  ComponentID chId = (ComponentID)ch;
+  Int nWidth = m_sVideoInfo.iFaceWidth >> getComponentScaleX(chId);
+  Int nHeight = m_sVideoInfo.iFaceHeight >> getComponentScaleY(chId);
+  Int iStride = getStride(chId);
+  for(Int j=std::max(jStart, 0); j<std::min(jEnd, nHeight); j++) 
+  {
+    int braveWidth = 2 * (nWidth / 2 - pBraveLocation[j]);
+    for(Int i=0; i<nWidth; i++) 
+    {
+      if (i < pBraveLocation[j])
+      {
+        Int iDPos = j * iStride + i;
+        Int iSPos = j * iStride + pBraveLocation[j] + braveWidth - (pBraveLocation[j] - i) % braveWidth;
+        m_pFacesOrig[fIdx][ch][iDPos] = m_pFacesOrig[fIdx][ch][iSPos];
+      }
+      else if (i > pBraveLocation[j] + braveWidth)
+      {
+        Int iDPos = j * iStride + i;
+        Int iSPos = j * iStride + (i - pBraveLocation[j] - braveWidth) % braveWidth + pBraveLocation[j];
+        m_pFacesOrig[fIdx][ch][iDPos] = m_pFacesOrig[fIdx][ch][iSPos];
+      }
+    }
+  }
+  //Brave:add
+}
 
-          Int iPos = j*pGeoDst->getStride(chId) + i;
-          pGeoDst->m_pFacesOrig[fIdx][ch][iPos] = (sum + iOffset)>>iBDPrecision;
+#if SVIDEO_SEPARABLE_RESAMPLE
+/**
+ * \brief convert rows [jStart, jEnd) of one face channel of pGeoDst with the separable map: horizontal filtering of the source rows, 
+ * which are kept in a ring of one row per vertical tap, then vertical filtering; the exceptions are interpolated as in geoConvertRows;
+ */
+Void TGeometry::geoConvertSeparableRows(TGeometry *pGeoDst, Int fIdx, Int ch, Int jStart, Int jEnd)
+{
+  Int iBDPrecision = S_INTERPOLATE_PrecisionBD;
+  Int iWeightMapFaceMask = (1<<m_WeightMap_NumOfBits4Faces)-1;
+  Int iOffset = 1<<(iBDPrecision-1);
+  Int64 iSepOffset = (Int64)1<<((iBDPrecision<<1)-1);
+
+  ComponentID chId = (ComponentID)ch;
+  ChannelType chType = toChannelType(chId);
+  Int mapIdx = (pGeoDst->m_chromaFormatIDC==CHROMA_444 && pGeoDst->m_InterpolationType[CHANNEL_TYPE_LUMA] == pGeoDst->m_InterpolationType[CHANNEL_TYPE_CHROMA])? 0 : (ch>0? 1: 0);
+  const SeparableResampleMap& sepMap = pGeoDst->m_sepMap[fIdx][mapIdx];
+  Int iStrideSrc = getStride(chId);
+  Int iStrideDst = pGeoDst->getStride(chId);
+  Int iWLutIdx = (m_chromaFormatIDC==CHROMA_400 || (m_InterpolationType[0]==m_InterpolationType[1]))? 0 : chType;
+  const Int *pSepWeight = m_pSepWeightLut[iWLutIdx];
+  Int **pWeightLut = m_pWeightLut[iWLutIdx];
+  Int iTapOffset = ((m_iInterpFilterTaps[chType][1]-1)>>1)*iStrideSrc + ((m_iInterpFilterTaps[chType][0]-1)>>1);
+  FilterGatherFP filterGather = m_filterGather[chType];
+  Int iTapsX = m_iInterpFilterTaps[chType][0];
+  Int iTapsY = m_iInterpFilterTaps[chType][1];
+  Int iNumCols = sepMap.iColEnd - sepMap.iColStart;
+  const Pel *pSrcFace = m_pFacesOrig[0][ch];
+
+  std::vector<Int> hRows(iTapsY*iNumCols);
+  std::vector<Int> hRowIdx(iTapsY, std::numeric_limits<Int>::min());
+  std::vector<const Int*> pHRow(iTapsY);
+  std::vector<Int64> sum(iNumCols);
+  for(Int j=std::max(jStart, sepMap.iRowStart); j<std::min(jEnd, sepMap.iRowEnd); j++)
+  {
+    Int r = j - sepMap.iRowStart;
+    for(Int m=0; m<iTapsY; m++)
+    {
+      Int y = sepMap.rowPos[r] + m;
+      Int iSlot = ((y % iTapsY) + iTapsY) % iTapsY;
+      Int *pH = &hRows[iSlot*iNumCols];
+      if(hRowIdx[iSlot] != y)
+      {
+        const Pel *pSrcLine = pSrcFace + y*iStrideSrc;
+        for(Int k=0; k<iNumCols; k++)
+        {
+          const Pel *pSrc = pSrcLine + sepMap.colPos[k];
+          const Int *pW = pSepWeight + sepMap.colPhase[k]*iTapsX;
+          Int s = 0;
+          for(Int n=0; n<iTapsX; n++)
+            s += pSrc[n]*pW[n];
+          pH[k] = s;
         }
+        hRowIdx[iSlot] = y;
+      }
+      pHRow[m] = pH;
+    }
+
+    const Int *pWy = pSepWeight + sepMap.rowPhase[r]*iTapsY;
+    std::fill(sum.begin(), sum.end(), 0);
+    for(Int m=0; m<iTapsY; m++)
+    {
+      const Int *pH = pHRow[m];
+      Int64 w = pWy[m];
+      for(Int k=0; k<iNumCols; k++)
+        sum[k] += w*pH[k];
+    }
+    Pel *pDstLine = pGeoDst->m_pFacesOrig[fIdx][ch] + j*iStrideDst;
+    Pel *pDst = pDstLine + sepMap.iColStart;
+    for(Int k=0; k<iNumCols; k++)
+      pDst[k] = (Pel)((sum[k] + iSepOffset)>>(iBDPrecision<<1));
+
+    for(Int e=sepMap.rowExceptions[r]; e<sepMap.rowExceptions[r+1]; e++)
+    {
+      const SeparableMapException& exception = sepMap.exceptions[e];
+      Int face = (exception.wList.facePos)&iWeightMapFaceMask;
+      Int iTLPos = (exception.wList.facePos)>>m_WeightMap_NumOfBits4Faces;
+      Int s = filterGather(m_pFacesOrig[face][ch] +iTLPos -iTapOffset, iStrideSrc, pWeightLut[exception.wList.weightIdx]);
+      pDstLine[exception.x] = (s + iOffset)>>iBDPrecision;
+    }
+  }
+  //Brave:add; the locations of the map the channel is converted with, which with a single 4:4:4 map is the luma map;
+  pGeoDst->braveRows(fIdx, ch, pGeoDst->braveLocation[mapIdx], jStart, jEnd);
+}
+#endif
+
+#if SVIDEO_DIRECT_GEOCONVERT
+/***************************************************
+//convert source geometry to destination geometry without the mapping tables of the destination;
+//every sample is mapped when it is converted, which is cheaper than geoConvert when the destination changes often (e.g. viewport trajectories);
+****************************************************/
+Void TGeometry::geoConvertDirect(TGeometry *pGeoDst)
+{
+  //padding;
+  spherePadding();
+
+  Int iNumMaps = (pGeoDst->m_chromaFormatIDC==CHROMA_400 || (pGeoDst->m_chromaFormatIDC==CHROMA_444 && pGeoDst->m_InterpolationType[0]==pGeoDst->m_InterpolationType[1]))? 1 : 2;
+  if((pGeoDst->m_sVideoInfo.framePackStruct.chromaFormatIDC==CHROMA_420) && ( (pGeoDst->m_chromaFormatIDC == CHROMA_444) || (pGeoDst->m_chromaFormatIDC == CHROMA_420 && pGeoDst->m_bResampleChroma) ) )
+    pGeoDst->m_bConvOutputPaddingNeeded = true;
+  if(pGeoDst->m_sVideoInfo.geoType==SVIDEO_VIEWPORT)
+  {
+    ((TViewPort*)pGeoDst)->setRotMat();
+    ((TViewPort*)pGeoDst)->setInvK();
+  }
+  for(Int iMap=0; iMap<iNumMaps; iMap++)
+    pGeoDst->m_directBraveLocation[iMap].resize(pGeoDst->m_sVideoInfo.iFaceHeight >> pGeoDst->getComponentScaleY((ComponentID)iMap));
+
+  //Brave: all faces use the locations of the last face, so it is converted first;
+  Int nFaces = pGeoDst->m_sVideoInfo.iNumFaces;
+  std::vector<GeoRowBand> lastFaceBands, bands;
+  for(Int iMap=0; iMap<iNumMaps; iMap++)
+  {
+    pGeoDst->addRowBands(lastFaceBands, nFaces-1, iMap);
+    for(Int fIdx=0; fIdx<nFaces-1; fIdx++)
+      pGeoDst->addRowBands(bands, fIdx, iMap);
+  }
+  std::function<Void(const GeoRowBand&)> convertBand = [this, pGeoDst](const GeoRowBand& band) { geoConvertDirectRows(pGeoDst, band.fIdx, band.ch, band.jStart, band.jEnd); };
+  runRowBands(lastFaceBands, convertBand);
+  runRowBands(bands, convertBand);
+
+  pGeoDst->setPaddingFlag(pGeoDst->m_bConvOutputPaddingNeeded ? true : false); 
+}
+
+/**
+ * \brief map and convert rows [jStart, jEnd) of all channels of pGeoDst sharing map iMap, as geometryMappingRows and geoConvertRows do;
+ */
+Void TGeometry::geoConvertDirectRows(TGeometry *pGeoDst, Int fIdx, Int iMap, Int jStart, Int jEnd)
+{
+  Int iBDPrecision = S_INTERPOLATE_PrecisionBD;
+  Int iWeightMapFaceMask = (1<<m_WeightMap_NumOfBits4Faces)-1;
+  Int iOffset = 1<<(iBDPrecision-1);
+#if !SVIDEO_BATCH_MAPPING
+  Int *pRot = pGeoDst->m_sVideoInfo.sVideoRotation.degree;
+#endif
+
+  ComponentID mapId = (ComponentID)iMap;
+  Int nWidth = pGeoDst->m_sVideoInfo.iFaceWidth >> pGeoDst->getComponentScaleX(mapId);
+  Int nHeight = pGeoDst->m_sVideoInfo.iFaceHeight >> pGeoDst->getComponentScaleY(mapId);
+  Int nMarginX = pGeoDst->m_iMarginX >> pGeoDst->getComponentScaleX(mapId);
+  Bool bBraveFace = (fIdx == pGeoDst->m_sVideoInfo.iNumFaces-1);
+  Pel *pBraveLocation = &pGeoDst->m_directBraveLocation[iMap][0];
+  Bool bSingleMap = (pGeoDst->m_chromaFormatIDC==CHROMA_444 && pGeoDst->m_InterpolationType[CHANNEL_TYPE_LUMA] == pGeoDst->m_InterpolationType[CHANNEL_TYPE_CHROMA]);
+  Int chStart = (bSingleMap || iMap==0)? 0 : 1;
+  Int chEnd = (bSingleMap || iMap==1)? pGeoDst->getNumChannels() : 1;
+
+#if SVIDEO_BATCH_MAPPING
+  //weights of one row, margins included;
+  std::vector<Int> cols;
+  SPosArray rowPos;
+  std::vector<PxlFltLut> rowWeights(nWidth+(nMarginX<<1));
+  std::vector<UChar> rowMapped(nWidth+(nMarginX<<1));
+  for(Int j=jStart; j<jEnd; j++)
+  {
+    //Brave:add
+    if (bBraveFace && (j >= 0) && (j < nHeight))
+    {
+      pBraveLocation[j] = 0;
+    }
+    //Brave:add
+    cols.clear();
+    for(Int i=-nMarginX; i<nWidth+nMarginX; i++)
+    {
+      rowMapped[i+nMarginX] = pGeoDst->m_bConvOutputPaddingNeeded || pGeoDst->insideFace(fIdx, (i<<pGeoDst->getComponentScaleX(mapId)), (j<<pGeoDst->getComponentScaleY(mapId)), COMPONENT_Y, mapId);
+      if(rowMapped[i+nMarginX])
+        cols.push_back(i);
+    }
+    pGeoDst->mapRowToSource(this, fIdx, mapId, j, cols, rowPos, bBraveFace? pBraveLocation : NULL);
+    for(Int k=0; k<(Int)cols.size(); k++)
+    {
+      SPos pos2D = rowPos.get(k);
+      (this->*m_interpolateWeight[toChannelType(mapId)])(mapId, &pos2D, rowWeights[cols[k]+nMarginX]);
+    }
+#else
+  //positions and weights of one row, margins included;
+  Bool bViewPortRow = (pGeoDst->m_sVideoInfo.geoType == SVIDEO_VIEWPORT);
+  std::vector<SPos> rowPos(nWidth+(nMarginX<<1));
+  std::vector<PxlFltLut> rowWeights(nWidth+(nMarginX<<1));
+  std::vector<UChar> rowMapped(nWidth+(nMarginX<<1));
+  for(Int j=jStart; j<jEnd; j++)
+  {
+    if(bViewPortRow)
+      ((TViewPort*)pGeoDst)->map2DTo3DRow((POSType)(j * (1<<pGeoDst->getComponentScaleY(mapId))), -nMarginX, nWidth+(nMarginX<<1), 1<<pGeoDst->getComponentScaleX(mapId), &rowPos[0]);
+    //Brave:add
+    int braveCount = 0;
+    if (bBraveFace && (j >= 0) && (j < nHeight))
+    {
+      pBraveLocation[j] = 0;
+    }
+    //Brave:add
+    for(Int i=-nMarginX; i<nWidth+nMarginX; i++)
+    {
+      rowMapped[i+nMarginX] = pGeoDst->m_bConvOutputPaddingNeeded || pGeoDst->insideFace(fIdx, (i<<pGeoDst->getComponentScaleX(mapId)), (j<<pGeoDst->getComponentScaleY(mapId)), COMPONENT_Y, mapId);
+      if(!rowMapped[i+nMarginX])
+        continue;
+
+      SPos& pos3D = rowPos[i+nMarginX];
+      if(!bViewPortRow)
+      {
+        POSType x = (i) * (1<<pGeoDst->getComponentScaleX(mapId));
+        POSType y = (j) * (1<<pGeoDst->getComponentScaleY(mapId));
+        SPos in(fIdx, x, y, 0);
+        pos3D = SPos();
+        pGeoDst->map2DTo3D(in, &pos3D);
+      }
+      rotate3D(pos3D, pRot[0], pRot[1], pRot[2]);
       //Brave:add
-      for(Int j=0; j<nHeight; j++) 
+      if(bBraveFace && (pos3D.x == 1) && (pos3D.y == 0) && (pos3D.z == 0))
       {
-        int braveWidth = 2 * (nWidth / 2 - pGeoDst->braveLocation[chType][j]);
-        for(Int i=0; i<nWidth; i++) 
+        if (i <= nWidth / 2)
         {
-          if (i < pGeoDst->braveLocation[chType][j])
-          {
-            Int iDPos = j * pGeoDst->getStride(chId) + i;
-            Int iSPos = j * pGeoDst->getStride(chId) + pGeoDst->braveLocation[chType][j] + braveWidth - (pGeoDst->braveLocation[chType][j] - i) % braveWidth;
-            pGeoDst->m_pFacesOrig[fIdx][ch][iDPos] = pGeoDst->m_pFacesOrig[fIdx][ch][iSPos];
-          }
-          else if (i > pGeoDst->braveLocation[chType][j] + braveWidth)
-          {
-            Int iDPos = j * pGeoDst->getStride(chId) + i;
-            Int iSPos = j * pGeoDst->getStride(chId) + (i - pGeoDst->braveLocation[chType][j] - braveWidth) % braveWidth + pGeoDst->braveLocation[chType][j];
-            pGeoDst->m_pFacesOrig[fIdx][ch][iDPos] = pGeoDst->m_pFacesOrig[fIdx][ch][iSPos];
-          }
+          ++ braveCount;
+          pBraveLocation[j] = braveCount;
         }
       }
       //Brave:add
+      map3DTo2D(&pos3D, &pos3D);
+
+      pos3D.x = pos3D.x/POSType(1<<pGeoDst->getComponentScaleX(mapId));
+      pos3D.y = pos3D.y/POSType(1<<pGeoDst->getComponentScaleY(mapId));
+      (this->*m_interpolateWeight[toChannelType(mapId)])(mapId, &pos3D, rowWeights[i+nMarginX]);
+    }
+#endif
+
+    for(Int ch=chStart; ch<chEnd; ch++)
+    {
+      ComponentID chId = (ComponentID)ch;
+      ChannelType chType = toChannelType(chId);
+      Int iStrideSrc = getStride(chId);
+      Int iWLutIdx = (m_chromaFormatIDC==CHROMA_400 || (m_InterpolationType[0]==m_InterpolationType[1]))? 0 : chType;
+      Int **pWeightLut = m_pWeightLut[iWLutIdx];
+      Int iTapOffset = ((m_iInterpFilterTaps[chType][1]-1)>>1)*iStrideSrc + ((m_iInterpFilterTaps[chType][0]-1)>>1);
+      FilterGatherFP filterGather = m_filterGather[chType];
+      Pel *pDst = pGeoDst->m_pFacesOrig[fIdx][ch] + j*pGeoDst->getStride(chId);
+      for(Int i=-nMarginX; i<nWidth+nMarginX; i++)
+      {
+        if(!pGeoDst->m_bConvOutputPaddingNeeded && !pGeoDst->insideFace(fIdx, (i<<getComponentScaleX(chId)), (j<<getComponentScaleY(chId)), COMPONENT_Y, chId))
+          continue;
+        assert(rowMapped[i+nMarginX]);
+        const PxlFltLut& wList = rowWeights[i+nMarginX];
+        Int face = (wList.facePos)&iWeightMapFaceMask;
+        Int iTLPos = (wList.facePos)>>m_WeightMap_NumOfBits4Faces;
+        Int sum = filterGather(m_pFacesOrig[face][ch] +iTLPos -iTapOffset, iStrideSrc, pWeightLut[wList.weightIdx]);
+        pDst[i] = (sum + iOffset)>>iBDPrecision;
+      }
     }
   }
+  //Brave:add
+  for(Int ch=chStart; ch<chEnd; ch++)
+    pGeoDst->braveRows(fIdx, ch, pBraveLocation, jStart, jEnd);
+}
+#endif
 
-  pGeoDst->setPaddingFlag(pGeoDst->m_bConvOutputPaddingNeeded ? true : false); 
+#if SVIDEO_MT_GEOCONVERT
+/**
+ * \brief split the rows of one face channel (margins included) into bands of S_ROW_BAND_HEIGHT rows;
+ */
+Void TGeometry::addRowBands(std::vector<GeoRowBand>& bands, Int fIdx, Int ch)
+{
+  ComponentID chId = (ComponentID)ch;
+  Int nHeight = m_sVideoInfo.iFaceHeight >> getComponentScaleY(chId);
+  Int nMarginY = m_iMarginY >> getComponentScaleY(chId);
+  for(Int j=-nMarginY; j<nHeight+nMarginY; j+=S_ROW_BAND_HEIGHT)
+  {
+    GeoRowBand band;
+    band.fIdx = fIdx;
+    band.ch = ch;
+    band.jStart = j;
+    band.jEnd = std::min(j+S_ROW_BAND_HEIGHT, nHeight+nMarginY);
+    bands.push_back(band);
+  }
 }
 
+Void TGeometry::runRowBands(std::vector<GeoRowBand>& bands, const std::function<Void(const GeoRowBand&)>& func)
+{
+  if(m_pcThreadPool)
+    m_pcThreadPool->parallelFor((Int)bands.size(), [&bands, &func](Int i) { func(bands[i]); });
+  else
+  {
+    for(Int i=0; i<(Int)bands.size(); i++)
+      func(bands[i]);
+  }
+}
+#endif
+
 Void TGeometry::geoToFramePack(IPos* posIn, IPos2D* posOut)
 {
   Int xoffset=m_facePos[posIn->faceIdx][1]*m_sVideoInfo.iFaceWidth;//[face][0:row, 1:col];
@@ -1014,71 +2180,122 @@ Void TGeometry::spherePadding(Bool bEnforced)
 #endif
 
   if(!m_bGeometryMapping4SpherePadding)
+  {
+#if SVIDEO_MT_GEOMAPPING
+    std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
     geometryMapping4SpherePadding();
-
-  Int iBDPrecision = S_INTERPOLATE_PrecisionBD;
-  Int iWeightMapFaceMask = (1<<m_WeightMap_NumOfBits4Faces)-1;
-  Int iOffset = 1<<(iBDPrecision-1);
+    m_dMappingTime += std::chrono::duration<Double>(std::chrono::steady_clock::now() - tStart).count();
+#else
+    geometryMapping4SpherePadding();
+#endif
+  }
 
   for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
   {
-   for(Int ch=0; ch<getNumChannels(); ch++)
-   {
+#if SVIDEO_MT_GEOCONVERT
+    //the padding of a face may read the margins of the faces padded before it, so only the rows of one face run in parallel;
+    std::vector<GeoRowBand> bands;
+    for(Int ch=0; ch<getNumChannels(); ch++)
+      addRowBands(bands, fIdx, ch);
+    runRowBands(bands, [this](const GeoRowBand& band) { spherePaddingRows(band.fIdx, band.ch, band.jStart, band.jEnd); });
+#else
+    for(Int ch=0; ch<getNumChannels(); ch++)
+    {
       ComponentID chId = (ComponentID)ch;
-      Int nWidth = m_sVideoInfo.iFaceWidth >> getComponentScaleX(chId);
       Int nHeight = m_sVideoInfo.iFaceHeight >> getComponentScaleY(chId);
-      Int nMarginX = m_iMarginX >> getComponentScaleX(chId);
       Int nMarginY = m_iMarginY >> getComponentScaleY(chId);
-      Int mapIdx = (m_chromaFormatIDC==CHROMA_444 && m_InterpolationType[CHANNEL_TYPE_LUMA] == m_InterpolationType[CHANNEL_TYPE_CHROMA])? 0: (ch>0? 1: 0);
-      ChannelType chType = toChannelType(chId);
+      spherePaddingRows(fIdx, ch, -nMarginY, nHeight+nMarginY);
+    }
+#endif
+  }
+  m_bPadded = true;
 
-      for(Int j=-nMarginY; j<nHeight+nMarginY; j++)
-      {
-        for(Int i=-nMarginX; i<nWidth+nMarginX; i++)
-        {
-          if(insideFace(fIdx, (i<<getComponentScaleX(chId)), (j<<getComponentScaleY(chId)), COMPONENT_Y, chId))
-            continue;
+#if SVIDEO_DEBUG
+  //dump to file;
+  static Bool bFirstDumpAfterPading = true;
+  dumpAllFacesToFile("geometry_after_padding", true, !bFirstDumpAfterPading); 
+  bFirstDumpAfterPading = false;
+#endif
 
-          Int iLutIdx;
-          getSPLutIdx(ch, i, j, iLutIdx);
-          Int sum =0;
-
-          PxlFltLut *pPelWeight = m_pPixelWeight4SherePadding[fIdx][mapIdx] + iLutIdx;
-          Int face = (pPelWeight->facePos)&iWeightMapFaceMask;
-          Int iTLPos = (pPelWeight->facePos)>>m_WeightMap_NumOfBits4Faces;
-          Int iWLutIdx = (m_chromaFormatIDC==CHROMA_400 || (m_InterpolationType[0]==m_InterpolationType[1]))? 0 : chType;
-          Int *pWLut = m_pWeightLut[iWLutIdx][pPelWeight->weightIdx] ;
-          Pel *pPelLine = m_pFacesOrig[face][ch] +iTLPos -((m_iInterpFilterTaps[chType][1]-1)>>1)*getStride(chId) -((m_iInterpFilterTaps[chType][0]-1)>>1);
-          for(Int m=0; m<m_iInterpFilterTaps[chType][1]; m++)
-          {
-            for(Int n=0; n<m_iInterpFilterTaps[chType][0]; n++)
-              sum += pPelLine[n]*pWLut[n];
-            pPelLine += getStride(chId);
-            pWLut += m_iInterpFilterTaps[chType][0];
-          }
-          
-          m_pFacesOrig[fIdx][ch][j*getStride(chId)+i] = ClipBD((sum + iOffset)>>iBDPrecision, m_nBitDepth);
-        }
+}
+
+/**
+ * \brief fill the padding samples of rows [jStart, jEnd) of one face channel;
+ */
+Void TGeometry::spherePaddingRows(Int fIdx, Int ch, Int jStart, Int jEnd)
+{
+  Int iBDPrecision = S_INTERPOLATE_PrecisionBD;
+  Int iWeightMapFaceMask = (1<<m_WeightMap_NumOfBits4Faces)-1;
+  Int iOffset = 1<<(iBDPrecision-1);
+
+  ComponentID chId = (ComponentID)ch;
+  Int nWidth = m_sVideoInfo.iFaceWidth >> getComponentScaleX(chId);
+  Int nMarginX = m_iMarginX >> getComponentScaleX(chId);
+  Int mapIdx = (m_chromaFormatIDC==CHROMA_444 && m_InterpolationType[CHANNEL_TYPE_LUMA] == m_InterpolationType[CHANNEL_TYPE_CHROMA])? 0: (ch>0? 1: 0);
+  ChannelType chType = toChannelType(chId);
+#if SVIDEO_FILTER_GATHER_KERNEL
+  Int iStrideSrc = getStride(chId);
+  Int iWLutIdx = (m_chromaFormatIDC==CHROMA_400 || (m_InterpolationType[0]==m_InterpolationType[1]))? 0 : chType;
+  Int **pWeightLut = m_pWeightLut[iWLutIdx];
+  Int iTapOffset = ((m_iInterpFilterTaps[chType][1]-1)>>1)*iStrideSrc + ((m_iInterpFilterTaps[chType][0]-1)>>1);
+  FilterGatherFP filterGather = m_filterGather[chType];
+#endif
+
+  for(Int j=jStart; j<jEnd; j++)
+  {
+    for(Int i=-nMarginX; i<nWidth+nMarginX; i++)
+    {
+      if(insideFace(fIdx, (i<<getComponentScaleX(chId)), (j<<getComponentScaleY(chId)), COMPONENT_Y, chId))
+        continue;
+
+      Int iLutIdx;
+      getSPLutIdx(ch, i, j, iLutIdx);
+
+      PxlFltLut *pPelWeight = m_pPixelWeight4SherePadding[fIdx][mapIdx] + iLutIdx;
+      Int face = (pPelWeight->facePos)&iWeightMapFaceMask;
+      Int iTLPos = (pPelWeight->facePos)>>m_WeightMap_NumOfBits4Faces;
+#if SVIDEO_FILTER_GATHER_KERNEL
+      Int sum = filterGather(m_pFacesOrig[face][ch] +iTLPos -iTapOffset, iStrideSrc, pWeightLut[pPelWeight->weightIdx]);
+#else
+      Int sum =0;
+      Int iWLutIdx = (m_chromaFormatIDC==CHROMA_400 || (m_InterpolationType[0]==m_InterpolationType[1]))? 0 : chType;
+      Int *pWLut = m_pWeightLut[iWLutIdx][pPelWeight->weightIdx] ;
+      Pel *pPelLine = m_pFacesOrig[face][ch] +iTLPos -((m_iInterpFilterTaps[chType][1]-1)>>1)*getStride(chId) -((m_iInterpFilterTaps[chType][0]-1)>>1);
+      for(Int m=0; m<m_iInterpFilterTaps[chType][1]; m++)
+      {
+        for(Int n=0; n<m_iInterpFilterTaps[chType][0]; n++)
+          sum += pPelLine[n]*pWLut[n];
+        pPelLine += getStride(chId);
+        pWLut += m_iInterpFilterTaps[chType][0];
       }
+#endif
+      
+      m_pFacesOrig[fIdx][ch][j*getStride(chId)+i] = ClipBD((sum + iOffset)>>iBDPrecision, m_nBitDepth);
     }
   }
-  m_bPadded = true;
-
-#if SVIDEO_DEBUG
-  //dump to file;
-  static Bool bFirstDumpAfterPading = true;
-  dumpAllFacesToFile("geometry_after_padding", true, !bFirstDumpAfterPading); 
-  bFirstDumpAfterPading = false;
-#endif
-
 }
 
 Void TGeometry::geometryMapping4SpherePadding()
 {
   assert(!m_bGeometryMapping4SpherePadding);
 
-  Int iWidth = m_sVideoInfo.iFaceWidth;
-  Int iHeight = m_sVideoInfo.iFaceHeight;
+#if SVIDEO_GEOMAP_CACHE
+  Bool bWriteCache = false;
+  UInt64 uiCacheKey = 0;
+  if(!m_mapCacheDir.empty())
+  {
+    TGeoMapHash hash;
+    hash.add("pad", 3);
+    hashGeoParams(hash);
+    uiCacheKey = hash.get();
+    if(loadSPMappingCache(uiCacheKey))
+    {
+      m_bGeometryMapping4SpherePadding = true;
+      return;
+    }
+    bWriteCache = true;
+  }
+#endif
 
   //allocate the memory;
   Int iNumMaps = (m_chromaFormatIDC==CHROMA_400 || (m_chromaFormatIDC==CHROMA_444 && m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
@@ -1086,77 +2303,262 @@ Void TGeometry::geometryMapping4SpherePadding()
   {
     for(Int ch=0; ch<iNumMaps; ch++)
     {
-      ComponentID chId = (ComponentID)ch;
-      Int iWidthPW = getStride(chId);
-      Int iHeightPW = (m_sVideoInfo.iFaceHeight + (m_iMarginY<<1))>>getComponentScaleY(chId);
-
       if(!m_pPixelWeight4SherePadding[fIdx][ch])
       {
-        if(m_sVideoInfo.geoType == SVIDEO_CUBEMAP)
-        {
-          m_pPixelWeight4SherePadding[fIdx][ch] = new PxlFltLut[iWidthPW*iHeightPW - (iWidth>>getComponentScaleX(chId))*(iHeight>>getComponentScaleY(chId))];
-        }
-        else if(m_sVideoInfo.geoType == SVIDEO_OCTAHEDRON
-          || (m_sVideoInfo.geoType == SVIDEO_ICOSAHEDRON)
-          )
-        {
-          m_pPixelWeight4SherePadding[fIdx][ch] = new PxlFltLut[iWidthPW*iHeightPW];
-        }
-        else
-          assert(!"Not supported yet!");
+        m_pPixelWeight4SherePadding[fIdx][ch] = new PxlFltLut[getSPLutSize(ch)];
       }
     }
   }
 
   //generate the map;
-  Bool bPadded[SV_MAX_NUM_FACES];
-  memset(bPadded, 0, sizeof(bPadded));
+#if SVIDEO_MT_GEOMAPPING
+  std::vector<GeoRowBand> bands;
+  for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
+    for(Int ch=0; ch<iNumMaps; ch++)
+      addRowBands(bands, fIdx, ch);
+  runRowBands(bands, [this](const GeoRowBand& band) { geometryMapping4SpherePaddingRows(band.fIdx, band.ch, band.jStart, band.jEnd); });
+#else
   for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
   {
     for(Int ch=0; ch<iNumMaps; ch++)
     {
       ComponentID chId = (ComponentID)ch;
-      Int nWidth = iWidth >> getComponentScaleX(chId);
-      Int nHeight = iHeight >> getComponentScaleY(chId);
-      Int nMarginX = m_iMarginX >> getComponentScaleX(chId);
+      Int nHeight = m_sVideoInfo.iFaceHeight >> getComponentScaleY(chId);
       Int nMarginY = m_iMarginY >> getComponentScaleY(chId);
+      geometryMapping4SpherePaddingRows(fIdx, ch, -nMarginY, nHeight+nMarginY);
+    }
+  }
+#endif
 
-      for(Int j=-nMarginY; j<nHeight+nMarginY; j++)
-      {
-        for(Int i=-nMarginX; i<nWidth+nMarginX; i++)
-        {
-          if(insideFace(fIdx, (i<<getComponentScaleX(chId)), (j<<getComponentScaleY(chId)), COMPONENT_Y, chId))
-            continue;
+#if SVIDEO_GEOMAP_CACHE
+  if(bWriteCache)
+    writeSPMappingCache(uiCacheKey);
+#endif
+  m_bGeometryMapping4SpherePadding = true;
+}
 
-          Int iLutIdx;
-          getSPLutIdx(ch, i, j, iLutIdx);
-          
-          PxlFltLut& wList = m_pPixelWeight4SherePadding[fIdx][ch][iLutIdx];
-          POSType x = (i)*(1<<getComponentScaleX(chId));
-          POSType y = (j)*(1<<getComponentScaleY(chId));
-          SPos in(fIdx, x, y, 0), pos3D;
-          map2DTo3D(in, &pos3D);
-          map3DTo2D(&pos3D, &pos3D);
+/**
+ * \brief map the padding samples of rows [jStart, jEnd) of one face channel;
+ * faces are padded in index order, so positions in a face before fIdx may use the full filter support;
+ */
+Void TGeometry::geometryMapping4SpherePaddingRows(Int fIdx, Int ch, Int jStart, Int jEnd)
+{
+  ComponentID chId = (ComponentID)ch;
+  Int nWidth = m_sVideoInfo.iFaceWidth >> getComponentScaleX(chId);
+  Int nHeight = m_sVideoInfo.iFaceHeight >> getComponentScaleY(chId);
+  Int nMarginX = m_iMarginX >> getComponentScaleX(chId);
 
-          pos3D.x /= (1<<getComponentScaleX(chId));
-          pos3D.y /= (1<<getComponentScaleY(chId)); 
-          if( (bPadded[pos3D.faceIdx] || validPosition4Interp(chId, pos3D.x, pos3D.y)))
-            (this->*m_interpolateWeight[toChannelType(chId)])(chId, &pos3D, wList);
-          else
-          {
-            pos3D.x = Clip3((POSType)0.0, (POSType)(nWidth-1), pos3D.x);
-            pos3D.y = Clip3((POSType)0.0, (POSType)(nHeight-1), pos3D.y);
-            interpolate_nn_weight(chId, &pos3D, wList);
-          }
-        }
+  for(Int j=jStart; j<jEnd; j++)
+  {
+    for(Int i=-nMarginX; i<nWidth+nMarginX; i++)
+    {
+      if(insideFace(fIdx, (i<<getComponentScaleX(chId)), (j<<getComponentScaleY(chId)), COMPONENT_Y, chId))
+        continue;
+
+      Int iLutIdx;
+      getSPLutIdx(ch, i, j, iLutIdx);
+      
+      PxlFltLut& wList = m_pPixelWeight4SherePadding[fIdx][ch][iLutIdx];
+      POSType x = (i)*(1<<getComponentScaleX(chId));
+      POSType y = (j)*(1<<getComponentScaleY(chId));
+      SPos in(fIdx, x, y, 0), pos3D;
+      map2DTo3D(in, &pos3D);
+      map3DTo2D(&pos3D, &pos3D);
+
+      pos3D.x /= (1<<getComponentScaleX(chId));
+      pos3D.y /= (1<<getComponentScaleY(chId)); 
+      if( (pos3D.faceIdx < fIdx || validPosition4Interp(chId, pos3D.x, pos3D.y)))
+        (this->*m_interpolateWeight[toChannelType(chId)])(chId, &pos3D, wList);
+      else
+      {
+        pos3D.x = Clip3((POSType)0.0, (POSType)(nWidth-1), pos3D.x);
+        pos3D.y = Clip3((POSType)0.0, (POSType)(nHeight-1), pos3D.y);
+        interpolate_nn_weight(chId, &pos3D, wList);
       }
     }
+  }
+}
+
+//number of entries of m_pPixelWeight4SherePadding[face][ch];
+Int TGeometry::getSPLutSize(Int ch)
+{
+  ComponentID chId = (ComponentID)ch;
+  Int iWidthPW = getStride(chId);
+  Int iHeightPW = (m_sVideoInfo.iFaceHeight + (m_iMarginY<<1))>>getComponentScaleY(chId);
+  if(m_sVideoInfo.geoType == SVIDEO_CUBEMAP)
+    return iWidthPW*iHeightPW - (m_sVideoInfo.iFaceWidth>>getComponentScaleX(chId))*(m_sVideoInfo.iFaceHeight>>getComponentScaleY(chId));
+  else if(m_sVideoInfo.geoType == SVIDEO_OCTAHEDRON
+    || (m_sVideoInfo.geoType == SVIDEO_ICOSAHEDRON)
+    )
+    return iWidthPW*iHeightPW;
+  else
+    assert(!"Not supported yet!");
+  return 0;
+}
+
+#if SVIDEO_GEOMAP_CACHE
+/**
+ * \brief add the parameters of the projection and the frame packing;
+ */
+Void TGeometry::hashProjectionParams(TGeoMapHash& hash)
+{
+  hash.add(m_sVideoInfo.geoType);
+  hash.add((Int)m_sVideoInfo.framePackStruct.chromaFormatIDC);
+  hash.add(m_sVideoInfo.framePackStruct.rows);
+  hash.add(m_sVideoInfo.framePackStruct.cols);
+  for(Int j=0; j<m_sVideoInfo.framePackStruct.rows; j++)
+    for(Int i=0; i<m_sVideoInfo.framePackStruct.cols; i++)
+    {
+      FaceProperty& face = m_sVideoInfo.framePackStruct.faces[j][i];
+      hash.add(face.id);
+      hash.add(face.rot);
+      hash.add(face.width);
+      hash.add(face.height);
+    }
+  for(Int i=0; i<3; i++)
+    hash.add(m_sVideoInfo.sVideoRotation.degree[i]);
+  hash.add(m_sVideoInfo.iFaceWidth);
+  hash.add(m_sVideoInfo.iFaceHeight);
+  hash.add(m_sVideoInfo.iNumFaces);
+  hash.add(m_sVideoInfo.viewPort.hFOV);
+  hash.add(m_sVideoInfo.viewPort.vFOV);
+  hash.add(m_sVideoInfo.viewPort.fYaw);
+  hash.add(m_sVideoInfo.viewPort.fPitch);
+  hash.add(m_sVideoInfo.iCompactFPStructure);
+}
+
+/**
+ * \brief add every parameter the mapping tables of this geometry depend on;
+ */
+Void TGeometry::hashGeoParams(TGeoMapHash& hash)
+{
+  hashProjectionParams(hash);
+
+  hash.add((Int)m_chromaFormatIDC);
+  hash.add((Int)m_bResampleChroma);
+  hash.add(m_iChromaSampleLocType);
+  hash.add(m_iMarginX);
+  hash.add(m_iMarginY);
+  hash.add((Int)m_InterpolationType[CHANNEL_TYPE_LUMA]);
+  hash.add((Int)m_InterpolationType[CHANNEL_TYPE_CHROMA]);
+  hash.add(m_WeightMap_NumOfBits4Faces);
+  hash.add(S_LANCZOS_LUT_SCALE);
+  hash.add((Int)sizeof(Pel));
+  hash.add((Int)sizeof(PxlFltLut));
+#if SVIDEO_BATCH_MAPPING
+  //only added when set, so the keys of the exact maps are unchanged;
+  if(m_bFastProjectionMath)
+    hash.add((Int)m_bFastProjectionMath);
+#endif
+}
+
+//blocks: m_pPixelWeight[face][map], then braveLocation[map];
+Void TGeometry::getMappingCacheBlockSizes(std::vector<UInt64>& blockSizes)
+{
+  Int iNumMaps = (m_chromaFormatIDC==CHROMA_400 || (m_chromaFormatIDC==CHROMA_444 && m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
+  blockSizes.clear();
+  for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
+    for(Int ch=0; ch<iNumMaps; ch++)
+    {
+      ComponentID chId = (ComponentID)ch;
+      Int iHeightPW = (m_sVideoInfo.iFaceHeight+(m_iMarginY<<1))>>getComponentScaleY(chId);
+      blockSizes.push_back((UInt64)getStride(chId)*iHeightPW*sizeof(PxlFltLut));
+    }
+  for(Int ch=0; ch<iNumMaps; ch++)
+    blockSizes.push_back((UInt64)(m_sVideoInfo.iFaceHeight >> getComponentScaleY((ComponentID)ch))*sizeof(Pel));
+}
 
-    bPadded[fIdx] = true;
+Void TGeometry::getSPMappingCacheBlockSizes(std::vector<UInt64>& blockSizes)
+{
+  Int iNumMaps = (m_chromaFormatIDC==CHROMA_400 || (m_chromaFormatIDC==CHROMA_444 && m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
+  blockSizes.clear();
+  for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
+    for(Int ch=0; ch<iNumMaps; ch++)
+      blockSizes.push_back((UInt64)getSPLutSize(ch)*sizeof(PxlFltLut));
+}
+
+Bool TGeometry::loadMappingCache(UInt64 uiKey)
+{
+  Int iNumMaps = (m_chromaFormatIDC==CHROMA_400 || (m_chromaFormatIDC==CHROMA_444 && m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
+  std::vector<UInt64> blockSizes;
+  getMappingCacheBlockSizes(blockSizes);
+
+  //the tables of a previous load point into the mapping released by load();
+  if(m_mapCache.isLoaded())
+    memset(m_pPixelWeight, 0, sizeof(m_pPixelWeight));
+  if(!m_mapCache.load(TGeoMapCache::getFileName(m_mapCacheDir, "geomap", uiKey), uiKey, blockSizes))
+    return false;
+
+  Int k = 0;
+  for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
+    for(Int ch=0; ch<iNumMaps; ch++)
+    {
+      delete[] m_pPixelWeight[fIdx][ch];
+      m_pPixelWeight[fIdx][ch] = (PxlFltLut *)m_mapCache.getBlock(k++);
+    }
+  braveLocation = (Pel **)xMalloc(Pel*,iNumMaps);
+  for(Int ch=0; ch<iNumMaps; ch++)
+  {
+    braveLocation[ch] = (Pel *)xMalloc(Pel,m_sVideoInfo.iFaceHeight >> getComponentScaleY((ComponentID)ch));
+    memcpy(braveLocation[ch], m_mapCache.getBlock(k), (size_t)blockSizes[k]);
+    k++;
   }
+  return true;
+}
 
-  m_bGeometryMapping4SpherePadding = true;
+Void TGeometry::writeMappingCache(UInt64 uiKey)
+{
+  Int iNumMaps = (m_chromaFormatIDC==CHROMA_400 || (m_chromaFormatIDC==CHROMA_444 && m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
+  std::vector<UInt64> blockSizes;
+  std::vector<const Void*> blocks;
+  getMappingCacheBlockSizes(blockSizes);
+  for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
+    for(Int ch=0; ch<iNumMaps; ch++)
+      blocks.push_back(m_pPixelWeight[fIdx][ch]);
+  for(Int ch=0; ch<iNumMaps; ch++)
+    blocks.push_back(braveLocation[ch]);
+
+  std::string fileName = TGeoMapCache::getFileName(m_mapCacheDir, "geomap", uiKey);
+  if(!TGeoMapCache::write(fileName, uiKey, blocks, blockSizes))
+    printf("Warning: geometry mapping cache %s could not be written!\n", fileName.c_str());
+}
+
+Bool TGeometry::loadSPMappingCache(UInt64 uiKey)
+{
+  Int iNumMaps = (m_chromaFormatIDC==CHROMA_400 || (m_chromaFormatIDC==CHROMA_444 && m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
+  std::vector<UInt64> blockSizes;
+  getSPMappingCacheBlockSizes(blockSizes);
+
+  if(m_spMapCache.isLoaded())
+    memset(m_pPixelWeight4SherePadding, 0, sizeof(m_pPixelWeight4SherePadding));
+  if(!m_spMapCache.load(TGeoMapCache::getFileName(m_mapCacheDir, "geopad", uiKey), uiKey, blockSizes))
+    return false;
+
+  Int k = 0;
+  for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
+    for(Int ch=0; ch<iNumMaps; ch++)
+    {
+      delete[] m_pPixelWeight4SherePadding[fIdx][ch];
+      m_pPixelWeight4SherePadding[fIdx][ch] = (PxlFltLut *)m_spMapCache.getBlock(k++);
+    }
+  return true;
+}
+
+Void TGeometry::writeSPMappingCache(UInt64 uiKey)
+{
+  Int iNumMaps = (m_chromaFormatIDC==CHROMA_400 || (m_chromaFormatIDC==CHROMA_444 && m_InterpolationType[0]==m_InterpolationType[1]))? 1 : 2;
+  std::vector<UInt64> blockSizes;
+  std::vector<const Void*> blocks;
+  getSPMappingCacheBlockSizes(blockSizes);
+  for(Int fIdx=0; fIdx<m_sVideoInfo.iNumFaces; fIdx++)
+    for(Int ch=0; ch<iNumMaps; ch++)
+      blocks.push_back(m_pPixelWeight4SherePadding[fIdx][ch]);
+
+  std::string fileName = TGeoMapCache::getFileName(m_mapCacheDir, "geopad", uiKey);
+  if(!TGeoMapCache::write(fileName, uiKey, blocks, blockSizes))
+    printf("Warning: sphere padding mapping cache %s could not be written!\n", fileName.c_str());
 }
+#endif
 
 //the origin for (x, y) cooridates is the topleft of picture;
 Void TGeometry::getSPLutIdx(Int ch, Int x, Int y, Int& iIdx)
@@ -1407,6 +2809,117 @@ Void TGeometry::rotate3D(SPos& sPos, Int rx, Int ry, Int rz)
   sPos.z = z;
 }
 
+#if SVIDEO_BATCH_MAPPING
+/**
+ * \brief rotate3D of all positions; the rotation matrices are computed once;
+ */
+Void TGeometry::rotate3DBatch(SPosArray& pos, Int rx, Int ry, Int rz)
+{
+  Int iNum = pos.size();
+  if(rx)
+  {
+    POSType rcos = scos((POSType)(rx*S_PI/180.0));
+    POSType rsin = ssin((POSType)(rx*S_PI/180.0));
+    for(Int k=0; k<iNum; k++)
+    {
+      POSType t1 = rcos*pos.y[k] - rsin*pos.z[k];
+      POSType t2 = rsin*pos.y[k] + rcos*pos.z[k];
+      pos.y[k] = t1;
+      pos.z[k] = t2;
+    }
+  }
+  if(ry)
+  {
+    POSType rcos = scos((POSType)(ry*S_PI/180.0));
+    POSType rsin = ssin((POSType)(ry*S_PI/180.0));
+    for(Int k=0; k<iNum; k++)
+    {
+      POSType t1 = rcos*pos.x[k] + rsin*pos.z[k];
+      POSType t2 = -rsin*pos.x[k] + rcos*pos.z[k];
+      pos.x[k] = t1;
+      pos.z[k] = t2;
+    }
+  }
+  if(rz)
+  {
+    POSType rcos = scos((POSType)(rz*S_PI/180.0));
+    POSType rsin = ssin((POSType)(rz*S_PI/180.0));
+    for(Int k=0; k<iNum; k++)
+    {
+      POSType t1 = rcos*pos.x[k] - rsin*pos.y[k];
+      POSType t2 = rsin*pos.x[k] + rcos*pos.y[k];
+      pos.x[k] = t1;
+      pos.y[k] = t2;
+    }
+  }
+}
+
+Void TGeometry::map2DTo3DBatch(const SPosArray& in, SPosArray& out)
+{
+  Int iNum = in.size();
+  out.resize(iNum);
+  for(Int k=0; k<iNum; k++)
+  {
+    SPos pos2D = in.get(k), pos3D;
+    map2DTo3D(pos2D, &pos3D);
+    out.set(k, pos3D);
+  }
+}
+
+Void TGeometry::map3DTo2DBatch(const SPosArray& in, SPosArray& out)
+{
+  Int iNum = in.size();
+  out.resize(iNum);
+  for(Int k=0; k<iNum; k++)
+  {
+    SPos pos = in.get(k);
+    map3DTo2D(&pos, &pos);
+    out.set(k, pos);
+  }
+}
+
+/**
+ * \brief map the samples (cols[k], j) of face fIdx of this geometry to pGeoSrc, as geometryMappingRows does; the positions are in samples of chId;
+ * pBraveLocation: Brave locations of the face channel, NULL: not updated;
+ */
+Void TGeometry::mapRowToSource(TGeometry *pGeoSrc, Int fIdx, ComponentID chId, Int j, const std::vector<Int>& cols, SPosArray& pos, Pel *pBraveLocation)
+{
+  Int *pRot = m_sVideoInfo.sVideoRotation.degree;
+  Int iNum = (Int)cols.size();
+  Int iWidth = m_sVideoInfo.iFaceWidth >> getComponentScaleX(chId);
+  pos.resize(iNum);
+  for(Int k=0; k<iNum; k++)
+  {
+    pos.faceIdx[k] = fIdx;
+    pos.x[k] = (cols[k]) * (1<<getComponentScaleX(chId));
+    pos.y[k] = (j) * (1<<getComponentScaleY(chId));
+    pos.z[k] = 0;
+  }
+  map2DTo3DBatch(pos, pos);
+  rotate3DBatch(pos, pRot[0], pRot[1], pRot[2]);
+  //Brave:add
+  if(pBraveLocation)
+  {
+    int braveCount = 0;
+    for(Int k=0; k<iNum; k++)
+    {
+      if((pos.x[k] == 1) && (pos.y[k] == 0) && (pos.z[k] == 0) && (cols[k] <= iWidth / 2))
+      {
+        ++ braveCount;
+        pBraveLocation[j] = braveCount;
+      }
+    }
+  }
+  //Brave:add
+  pGeoSrc->map3DTo2DBatch(pos, pos);
+  for(Int k=0; k<iNum; k++)
+  {
+    pos.x[k] = pos.x[k]/POSType(1<<getComponentScaleX(chId));
+    pos.y[k] = pos.y[k]/POSType(1<<getComponentScaleY(chId));
+  }
+}
+#endif
+
 Void TGeometry::fillRegion(TComPicYuv *pDstYuv, Int x, Int y, Int rot, Int iFaceWidth, Int iFaceHeight)
 {
   Int iWidth, iHeight;
@@ -1441,6 +2954,64 @@ Void TGeometry::fillRegion(TComPicYuv *pDstYuv, Int x, Int y, Int rot, Int iFace
   }
 }
 
+#if SVIDEO_FILTER_GATHER_KERNEL
+FilterGatherFP TGeometry::getFilterGather(Int iTaps)
+{
+#if SVIDEO_SIMD_FILTER_GATHER
+  const SimdLevel simdLevel = getSimdLevel();
+  if(simdLevel >= SIMD_SSE41)
+  {
+    FilterGatherFP filterGatherSimd = NULL;
+    switch(iTaps)
+    {
+      case 4:  filterGatherSimd = (simdLevel >= SIMD_AVX2)? &filterGather_AVX2<4> : &filterGather_SSE41<4>; break;
+      case 6:  filterGatherSimd = (simdLevel >= SIMD_AVX2)? &filterGather_AVX2<6> : &filterGather_SSE41<6>; break;
+      default: break;
+    }
+    if(filterGatherSimd)
+      return filterGatherSimd;
+  }
+#endif
+  switch(iTaps)
+  {
+    case 1:  return &filterGather<Int, 1, 1>;
+    case 2:  return &filterGather<Int, 2, 2>;
+    case 4:  return &filterGather<Int, 4, 4>;
+    case 6:  return &filterGather<Int, 6, 6>;
+    default: assert(!"Not supported yet!"); return NULL;
+  }
+}
+#endif
+
+#if SVIDEO_PACKED_RESAMPLE_MAP
+PackedFilterGatherFP TGeometry::getPackedFilterGather(Int iTaps)
+{
+#if SVIDEO_SIMD_FILTER_GATHER
+  const SimdLevel simdLevel = getSimdLevel();
+  if(simdLevel >= SIMD_SSE41)
+  {
+    PackedFilterGatherFP filterGatherSimd = NULL;
+    switch(iTaps)
+    {
+      case 4:  filterGatherSimd = (simdLevel >= SIMD_AVX2)? &packedFilterGather_AVX2<4> : &packedFilterGather_SSE41<4>; break;
+      case 6:  filterGatherSimd = (simdLevel >= SIMD_AVX2)? &packedFilterGather_AVX2<6> : &packedFilterGather_SSE41<6>; break;
+      default: break;
+    }
+    if(filterGatherSimd)
+      return filterGatherSimd;
+  }
+#endif
+  switch(iTaps)
+  {
+    case 1:  return &filterGather<Short, 1, 1>;
+    case 2:  return &filterGather<Short, 2, 2>;
+    case 4:  return &filterGather<Short, 4, 4>;
+    case 6:  return &filterGather<Short, 6, 6>;
+    default: assert(!"Not supported yet!"); return NULL;
+  }
+}
+#endif
+
 Void TGeometry::initInterpolation(Int *pInterpolateType)
 {
   for(Int ch=CHANNEL_TYPE_LUMA; ch<MAX_NUM_CHANNEL_TYPE; ch++)
@@ -1451,14 +3022,32 @@ Void TGeometry::initInterpolation(Int *pInterpolateType)
       case SI_NN:
         m_interpolateWeight[ch] = &TGeometry::interpolate_nn_weight;
         m_iInterpFilterTaps[ch][0] = m_iInterpFilterTaps[ch][1] = 1;
+#if SVIDEO_FILTER_GATHER_KERNEL
+        m_filterGather[ch] = getFilterGather(1);
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+        m_packedFilterGather[ch] = getPackedFilterGather(1);
+#endif
         break;
       case SI_BILINEAR:
         m_interpolateWeight[ch] = &TGeometry::interpolate_bilinear_weight;
         m_iInterpFilterTaps[ch][0] = m_iInterpFilterTaps[ch][1] = 2;
+#if SVIDEO_FILTER_GATHER_KERNEL
+        m_filterGather[ch] = getFilterGather(2);
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+        m_packedFilterGather[ch] = getPackedFilterGather(2);
+#endif
         break;
       case SI_BICUBIC:
         m_interpolateWeight[ch] = &TGeometry::interpolate_bicubic_weight;
         m_iInterpFilterTaps[ch][0] = m_iInterpFilterTaps[ch][1] = 4;
+#if SVIDEO_FILTER_GATHER_KERNEL
+        m_filterGather[ch] = getFilterGather(4);
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+        m_packedFilterGather[ch] = getPackedFilterGather(4);
+#endif
         break;
       case SI_LANCZOS2:
       case SI_LANCZOS3:
@@ -1474,6 +3063,12 @@ Void TGeometry::initInterpolation(Int *pInterpolateType)
         }
         m_interpolateWeight[ch] = &TGeometry::interpolate_lanczos_weight;
         m_iInterpFilterTaps[ch][0] = m_iInterpFilterTaps[ch][1] = m_iLanczosParamA[ch]*2;
+#if SVIDEO_FILTER_GATHER_KERNEL
+        m_filterGather[ch] = getFilterGather(m_iLanczosParamA[ch]*2);
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+        m_packedFilterGather[ch] = getPackedFilterGather(m_iLanczosParamA[ch]*2);
+#endif
         break;
       default:
         assert(!"Not supported yet!");
@@ -1485,6 +3080,11 @@ Void TGeometry::initInterpolation(Int *pInterpolateType)
 #if SVIDEO_SPSNR_I
 Pel TGeometry::getPelValue(ComponentID chId, SPos inPos)
 {
+#if SVIDEO_SPSNR_I_TABLE
+  PxlFltLut wList;
+  (this->*m_interpolateWeight[toChannelType(chId)])(chId, &inPos, wList);
+  return getPelValue(chId, wList);
+#else
   Int sum =0;
   ChannelType chType = toChannelType(chId);
   Int iWidthPW = getStride(chId);
@@ -1503,6 +3103,9 @@ Pel TGeometry::getPelValue(ComponentID chId, SPos inPos)
   Int *pWLut = m_pWeightLut[iWLutIdx][wList.weightIdx];
   Pel *pPelLine = m_pFacesOrig[face][chId] +iTLPos -((m_iInterpFilterTaps[chType][1]-1)>>1)*iWidthPW -((m_iInterpFilterTaps[chType][0]-1)>>1);
 
+#if SVIDEO_FILTER_GATHER_KERNEL
+  sum = m_filterGather[chType](pPelLine, iWidthPW, pWLut);
+#else
   for(Int m=0; m<m_iInterpFilterTaps[chType][1]; m++)
   {
     for(Int n=0; n<m_iInterpFilterTaps[chType][0]; n++)
@@ -1510,13 +3113,49 @@ Pel TGeometry::getPelValue(ComponentID chId, SPos inPos)
     pPelLine += iWidthPW;
     pWLut += m_iInterpFilterTaps[chType][0];
   }
+#endif
   
   pVal = (sum + iOffset)>>iBDPrecision;
   
   
   return pVal;
+#endif
+}
+
+#if SVIDEO_SPSNR_I_TABLE
+/**
+ * \brief interpolated sample value for precomputed weights;
+ */
+Pel TGeometry::getPelValue(ComponentID chId, const PxlFltLut &wList)
+{
+  ChannelType chType = toChannelType(chId);
+  Int iWidthPW = getStride(chId);
+  Int iWeightMapFaceMask = (1<<m_WeightMap_NumOfBits4Faces)-1;
+  Int iBDPrecision = S_INTERPOLATE_PrecisionBD;
+  Int iOffset = 1<<(iBDPrecision-1);
+
+  Int face = (wList.facePos)&iWeightMapFaceMask;
+  Int iTLPos = (wList.facePos)>>m_WeightMap_NumOfBits4Faces;
+  Int iWLutIdx = (m_chromaFormatIDC==CHROMA_400 || (m_InterpolationType[0]==m_InterpolationType[1]))? 0 : chType;
+  Int *pWLut = m_pWeightLut[iWLutIdx][wList.weightIdx];
+  Pel *pPelLine = m_pFacesOrig[face][chId] +iTLPos -((m_iInterpFilterTaps[chType][1]-1)>>1)*iWidthPW -((m_iInterpFilterTaps[chType][0]-1)>>1);
+
+#if SVIDEO_FILTER_GATHER_KERNEL
+  Int sum = m_filterGather[chType](pPelLine, iWidthPW, pWLut);
+#else
+  Int sum = 0;
+  for(Int m=0; m<m_iInterpFilterTaps[chType][1]; m++)
+  {
+    for(Int n=0; n<m_iInterpFilterTaps[chType][0]; n++)
+      sum += pPelLine[n]*pWLut[n];
+    pPelLine += iWidthPW;
+    pWLut += m_iInterpFilterTaps[chType][0];
+  }
+#endif
+  return (sum + iOffset)>>iBDPrecision;
 }
 #endif
+#endif
 
 Void TGeometry::setChromaResamplingFilter(Int iChromaSampleLocType)
 {
@@ -1834,6 +3473,43 @@ Void TGeometry::dumpSpherePoints(Char *pFileName, Bool bAppended, SpherePoints *
       ComponentID chId = (ComponentID)ch;
       Int iWidth = m_sVideoInfo.iFaceWidth>>getComponentScaleX(chId);
       Int iHeight = m_sVideoInfo.iFaceHeight>>getComponentScaleY(chId);
+#if SVIDEO_BATCH_MAPPING
+      SPosArray rowPos;
+      for(Int j=0; j<iHeight; j++) 
+      {
+        rowPos.resize(0);
+        for(Int i=0; i<iWidth; i++)  
+        {
+          if(insideFace(fIdx, (i<<getComponentScaleX(chId)), (j<<getComponentScaleY(chId)), COMPONENT_Y, chId))
+          {
+            rowPos.resize(rowPos.size()+1);
+            rowPos.set(rowPos.size()-1, SPos(fIdx, i, j, 0));
+          }
+        }
+        map2DTo3DBatch(rowPos, rowPos);
+        rotate3DBatch(rowPos, pRot[0], pRot[1], pRot[2]);
+        for(Int k=0; k<rowPos.size(); k++)
+        {
+          Double x = rowPos.x[k];
+          Double y = rowPos.y[k];
+          Double z = rowPos.z[k];
+
+          //yaw;
+          Double yaw = (-(m_bFastProjectionMath? fastAtan2(z, x) : satan2(z, x)))*180.0/S_PI;
+          Double len = ssqrt(x*x + y*y + z*z);
+          //pitch;
+          Double pitch = 90.0 - (POSType)((len < S_EPS? 0.5 : (m_bFastProjectionMath? fastAcos(y/len) : sacos(y/len))/S_PI)*180.0);
+          if(fp)
+            fprintf(fp, "%.6lf %.6lf\n", pitch, yaw);
+          if(pPos)
+          {
+            pPos[iIdx][0] = pitch;
+            pPos[iIdx][1] = yaw;
+          }
+          iIdx++;
+        }
+      }
+#else
       for(Int j=0; j<iHeight; j++) 
         for(Int i=0; i<iWidth; i++)  
         {
@@ -1861,6 +3537,7 @@ Void TGeometry::dumpSpherePoints(Char *pFileName, Bool bAppended, SpherePoints *
           }
           iIdx++;
         }
+#endif
     }
   }
   if(fp)
@@ -40,6 +40,9 @@
 #include <math.h>
 #include "../TLibCommon/CommonDef.h"
 #include "../TLibCommon/TComPicYuv.h"
+#include "../TLibCommon/TComThreadPool.h"
+#include "TGeoMapCache.h"
+#include "TSphMath.h"
 
 
 // ====================================================================================================================
@@ -65,6 +68,58 @@
 #define SVIDEO_WSPSNR_E2E_REPORT_PER_FRAME               1
 #endif
 #define SVIDEO_SEC_ISP                                   1//Brave change it to 0
+#define SVIDEO_MT_GEOCONVERT                             1          //face/row-band parallel geoConvert and spherePadding;
+#define SVIDEO_FILTER_GATHER_KERNEL                      1          //fixed-tap interpolation kernels selected per interpolation type;
+#if SVIDEO_MT_GEOCONVERT
+#define SVIDEO_MT_GEOMAPPING                             1          //depends on SVIDEO_MT_GEOCONVERT; row-band parallel construction of the mapping tables;
+#endif
+#if SVIDEO_SPSNR_I
+#define SVIDEO_SPSNR_I_TABLE                             1          //depends on SVIDEO_SPSNR_I; geometries and interpolation weights of SPSNR-I are set up once;
+#endif
+#if SVIDEO_CPPPSNR
+#define SVIDEO_CPPPSNR_VALID_RUNS                        1          //depends on SVIDEO_CPPPSNR; persistent CPP pictures and precomputed runs of valid CPP samples;
+#endif
+#if SVIDEO_WSPSNR && SVIDEO_MT_GEOCONVERT
+#define SVIDEO_WSPSNR_SPANS                              1          //depends on SVIDEO_WSPSNR and SVIDEO_MT_GEOCONVERT; geometry-independent weighted spans, row-parallel WS-PSNR;
+#endif
+#define SVIDEO_GEOMAP_CACHE                              1          //on-disk cache of the geometry mapping and sphere padding tables;
+#if SVIDEO_VIEWPORT_PSNR && SVIDEO_MT_GEOCONVERT
+#define SVIDEO_VIEWPORT_PSNR_MT                          1          //depends on SVIDEO_VIEWPORT_PSNR and SVIDEO_MT_GEOCONVERT; viewports evaluated in parallel, PSNR read from the viewport faces;
+#endif
+#define SVIDEO_ASYNC_METRICS                             1          //spherical metrics of the encoder on a background thread;
+#if SVIDEO_FILTER_GATHER_KERNEL
+#define SVIDEO_PACKED_RESAMPLE_MAP                       1          //depends on SVIDEO_FILTER_GATHER_KERNEL; optional packed map with quantised phase for geoConvert;
+#endif
+#define SVIDEO_BATCH_MAPPING                             1          //map2DTo3D/map3DTo2D over arrays of positions, optionally with polynomial trigonometry;
+#if SVIDEO_MT_GEOCONVERT && SVIDEO_FILTER_GATHER_KERNEL
+#define SVIDEO_DIRECT_GEOCONVERT                         1          //depends on SVIDEO_MT_GEOCONVERT and SVIDEO_FILTER_GATHER_KERNEL; geoConvert without mapping tables, for fast changing viewports;
+#endif
+#define SVIDEO_CONVERT_PIPELINE                          1          //360 converter with read, conversion, write and metric stages on separate threads;
+#define SVIDEO_MMAP_YUV_READER                           1          //optional memory-mapped YUV input with random frame access;
+#define SVIDEO_FUSED_YUV_WRITE                           1          //YUV output packed and scaled into one frame buffer, optionally flushed on a background thread;
+#define SVIDEO_SPH_SAMPLE_POINTS                         1          //sphere sampling points of the S-PSNR metrics loaded once per process, binary and generated point sets;
+#if SVIDEO_SPH_SAMPLE_POINTS && SVIDEO_BATCH_MAPPING && SVIDEO_GEOMAP_CACHE
+#define SVIDEO_SPH_SAMPLE_INDEX                          1          //depends on SVIDEO_SPH_SAMPLE_POINTS, SVIDEO_BATCH_MAPPING and SVIDEO_GEOMAP_CACHE; sphere points projected once per geometry and shared by the S-PSNR metrics;
+#endif
+#if SVIDEO_SPSNR_NN && SVIDEO_WSPSNR_SPANS && SVIDEO_ASYNC_METRICS
+#define SVIDEO_FUSED_METRICS                             1          //depends on SVIDEO_SPSNR_NN, SVIDEO_WSPSNR_SPANS and SVIDEO_ASYNC_METRICS; PSNR, WS-PSNR and S-PSNR-NN in one pass over the samples;
+#endif
+#if SVIDEO_BATCH_MAPPING && SVIDEO_MT_GEOCONVERT && SVIDEO_FILTER_GATHER_KERNEL
+#define SVIDEO_SEPARABLE_RESAMPLE                        1          //depends on SVIDEO_BATCH_MAPPING, SVIDEO_MT_GEOCONVERT and SVIDEO_FILTER_GATHER_KERNEL; optional two-pass polyphase geoConvert between ERP or EAP geometries without rotation;
+#endif
+#if SVIDEO_MT_GEOCONVERT && SVIDEO_CONVERT_PIPELINE
+#define SVIDEO_MULTI_OUTPUT_CONVERT                      1          //depends on SVIDEO_MT_GEOCONVERT and SVIDEO_CONVERT_PIPELINE; one padded source converted to several output geometries in one run;
+#endif
+#define SVIDEO_FACE_TILES                                1          //optional tile grid of the coding picture derived from the coding frame packing structure, one tile per face;
+#if SVIDEO_FILTER_GATHER_KERNEL && (SIMD_DISTORTION || SIMD_INTERPOLATION_FILTER)
+#define SVIDEO_SIMD_FILTER_GATHER                        1          //depends on SVIDEO_FILTER_GATHER_KERNEL and TComSimd; SSE4.1/AVX2 gather kernels chosen at run time, bit-exact with the C kernels;
+#endif
+#if SVIDEO_WSPSNR_SPANS && (SIMD_DISTORTION || SIMD_INTERPOLATION_FILTER)
+#define SVIDEO_SIMD_WSPSNR                               1          //depends on SVIDEO_WSPSNR_SPANS and TComSimd; AVX2 weighted-span SSD chosen at run time, identical to the C kernels;
+#endif
+#if SVIDEO_BATCH_MAPPING && (SIMD_DISTORTION || SIMD_INTERPOLATION_FILTER)
+#define SVIDEO_SIMD_SPH_MATH                             1          //depends on SVIDEO_BATCH_MAPPING and TComSimd; AVX2 batch atan2/acos/asin/sincos of the fast projection math chosen at run time, identical to the C functions;
+#endif
 //~end;
 
 
@@ -102,6 +157,12 @@ static const Int   S_log2NumFaces[SV_MAX_NUM_FACES+1] = { 0,
                                                           4, 4, 4, 4, 4, 4, 4, 4, 
                                                           5, 5, 5, 5 };
 static const Int  S_LANCZOS_LUT_SCALE = 100;
+#if SVIDEO_MT_GEOCONVERT
+static const Int  S_ROW_BAND_HEIGHT = 16;     //rows per job for the parallel conversion;
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+static const Int  S_PACKED_MAP_PHASE_SCALE = 16;  //phase quantisation of the packed map; the Short weight table of 6x6 taps stays below 24KB;
+#endif
 
 enum GeometryType
 {
@@ -154,6 +215,21 @@ struct SPos
   SPos(Int f, POSType xIn, POSType yIn, POSType zIn ) : faceIdx(f), x(xIn), y(yIn), z(zIn) {};
 };
 
+#if SVIDEO_BATCH_MAPPING
+//positions as structure of arrays for the batch mapping functions;
+struct SPosArray
+{
+  std::vector<Int>     faceIdx;
+  std::vector<POSType> x;
+  std::vector<POSType> y;
+  std::vector<POSType> z;
+  Int  size() const { return (Int)x.size(); }
+  Void resize(Int iNum) { faceIdx.resize(iNum); x.resize(iNum); y.resize(iNum); z.resize(iNum); }
+  Void set(Int k, const SPos& pos) { faceIdx[k] = pos.faceIdx; x[k] = pos.x; y[k] = pos.y; z[k] = pos.z; }
+  SPos get(Int k) const { return SPos(faceIdx[k], x[k], y[k], z[k]); }
+};
+#endif
+
 struct CPos3D
 {
   POSType x;
@@ -242,6 +318,49 @@ struct PxlFltLut
   UShort weightIdx; 
 };
 typedef Void (TGeometry::*interpolateWeightFP)(ComponentID chId, SPos *pSPosIn, PxlFltLut &wlist);
+#if SVIDEO_FILTER_GATHER_KERNEL
+typedef Int (*FilterGatherFP)(const Pel *pSrc, Int iStride, const Int *pWeight);
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+typedef Int (*PackedFilterGatherFP)(const Pel *pSrc, Int iStride, const Short *pWeight);
+
+struct PackedMapRun
+{
+  Int x;                                //first output sample of the run;
+  Int iNum;                             //number of output samples;
+  Int iIdx;                             //index of the first sample in the per-sample arrays;
+};
+
+//structure-of-arrays map in the order the output samples are written; samples outside the face are not stored;
+struct PackedResampleMap
+{
+  std::vector<Int>          facePos;    //(position of the top-left filter tap<<m_WeightMap_NumOfBits4Faces) | faceIdx in the source geometry;
+  std::vector<UShort>       phase;      //phaseY*(S_PACKED_MAP_PHASE_SCALE+1) + phaseX;
+  std::vector<PackedMapRun> runs;
+  std::vector<Int>          rowRuns;    //[j+marginY]: first run of row j; the last entry is the total number of runs;
+};
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+struct SeparableMapException
+{
+  Int       x;                          //output sample;
+  PxlFltLut wList;
+};
+
+//output sample (x, y) is filtered from source column colPos[x] and row rowPos[y] with the 1D phases colPhase[x] and rowPhase[y];
+//samples whose 2D map entry differs are listed as exceptions and interpolated with the 2D weights;
+struct SeparableResampleMap
+{
+  Int iColStart, iColEnd;                             //mapped output columns, the margins are included when the output is padded;
+  Int iRowStart, iRowEnd;                             //mapped output rows;
+  std::vector<Int>                   colPos;          //[x-iColStart]: first source column of the filter taps;
+  std::vector<UShort>                colPhase;        //[x-iColStart]: phase in 1/S_LANCZOS_LUT_SCALE;
+  std::vector<Int>                   rowPos;          //[y-iRowStart]: first source row of the filter taps;
+  std::vector<UShort>                rowPhase;        //[y-iRowStart];
+  std::vector<SeparableMapException> exceptions;
+  std::vector<Int>                   rowExceptions;   //[y-iRowStart]: first exception of row y; the last entry is the total number of exceptions;
+};
+#endif
 
 
 struct InputGeoParam
@@ -254,6 +373,16 @@ struct InputGeoParam
   Int iChromaSampleLocType;
 };
 
+#if SVIDEO_MT_GEOCONVERT
+struct GeoRowBand
+{
+  Int fIdx;
+  Int ch;
+  Int jStart;   //first row, may be negative (margin);
+  Int jEnd;     //last row + 1;
+};
+#endif
+
 struct SpherePoints
 {
   Int iNumOfPoints;
@@ -311,6 +440,30 @@ protected:
   interpolateWeightFP m_interpolateWeight[MAX_NUM_CHANNEL_TYPE]; 
 
   Int m_iInterpFilterTaps[MAX_NUM_CHANNEL_TYPE][2];                                        //[channel][hor/ver];
+#if SVIDEO_FILTER_GATHER_KERNEL
+  FilterGatherFP m_filterGather[MAX_NUM_CHANNEL_TYPE];                                       //weighted sum over m_iInterpFilterTaps;
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  Bool m_bPackedMap;                                                                         //use m_packedMap instead of m_pPixelWeight for geoConvert;
+  PackedResampleMap m_packedMap[SV_MAX_NUM_FACES][2];
+  Short *m_pPackedWeightLut[2];                                                              //[phase*filterSize + tap], S_PACKED_MAP_PHASE_SCALE;
+  PackedFilterGatherFP m_packedFilterGather[MAX_NUM_CHANNEL_TYPE];
+  Void initPackedWeightLut();
+  Void getPackedMapEntry(ComponentID chId, SPos *pSPosIn, Int &facePos, UShort &phase);
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+  Bool m_bSeparableMap;                                                                      //use m_sepMap instead of m_pPixelWeight for geoConvert when the conversion is separable;
+  Bool m_bSeparableMapped;                                                                   //the current mapping is m_sepMap;
+  SeparableResampleMap m_sepMap[SV_MAX_NUM_FACES][2];
+  Int *m_pSepWeightLut[2];                                                                   //[phase*taps + tap], S_LANCZOS_LUT_SCALE; 1D weights;
+  Void initSeparableWeightLut();
+  Void calcSeparableWeights(Int iLutIdx, Int iPhaseScale, Int *pWeights);
+  Void getSeparableEntry(ChannelType chType, POSType p, Int iTaps, Int &iPos, UShort &phase);
+  Bool isSeparableMapping(TGeometry *pGeoSrc);
+  Void geometryMappingSeparable(TGeometry *pGeoSrc);
+  Void geometryMappingSeparableRows(TGeometry *pGeoSrc, Int fIdx, Int ch, Int jStart, Int jEnd, std::vector<SeparableMapException>& exceptions);
+  Void geoConvertSeparableRows(TGeometry *pGeoDst, Int fIdx, Int ch, Int jStart, Int jEnd);
+#endif
   Int **m_pWeightLut[2];
   PxlFltLut *m_pPixelWeight[SV_MAX_NUM_FACES][2];                   //[SV_MAX_NUM_FACES][2][pxl_idx];
 
@@ -322,7 +475,46 @@ protected:
   Bool m_bConvOutputPaddingNeeded;
 
   Void geometryMapping4SpherePadding();
+  Void geometryMapping4SpherePaddingRows(Int fIdx, Int ch, Int jStart, Int jEnd);
   Void getSPLutIdx(Int ch, Int x, Int y, Int& iIdx);
+  Int  getSPLutSize(Int ch);
+
+#if SVIDEO_GEOMAP_CACHE
+  std::string  m_mapCacheDir;      //empty: no cache;
+  TGeoMapCache m_mapCache;         //backs m_pPixelWeight and braveLocation when loaded;
+  TGeoMapCache m_spMapCache;       //backs m_pPixelWeight4SherePadding when loaded;
+  Void hashGeoParams(TGeoMapHash& hash);
+  Void getMappingCacheBlockSizes(std::vector<UInt64>& blockSizes);
+  Void getSPMappingCacheBlockSizes(std::vector<UInt64>& blockSizes);
+  Bool loadMappingCache(UInt64 uiKey);
+  Void writeMappingCache(UInt64 uiKey);
+  Bool loadSPMappingCache(UInt64 uiKey);
+  Void writeSPMappingCache(UInt64 uiKey);
+#endif
+
+#if SVIDEO_MT_GEOCONVERT
+  TComThreadPool *m_pcThreadPool;   //not owned; NULL: serial;
+  Void addRowBands(std::vector<GeoRowBand>& bands, Int fIdx, Int ch);
+  Void runRowBands(std::vector<GeoRowBand>& bands, const std::function<Void(const GeoRowBand&)>& func);
+#endif
+  Void geoConvertRows(TGeometry *pGeoDst, Int fIdx, Int ch, Int jStart, Int jEnd);
+  Void braveRows(Int fIdx, Int ch, const Pel *pBraveLocation, Int jStart, Int jEnd);
+#if SVIDEO_DIRECT_GEOCONVERT
+  std::vector<Pel> m_directBraveLocation[2];   //braveLocation of geoConvertDirect, [map][row];
+  Void geoConvertDirectRows(TGeometry *pGeoDst, Int fIdx, Int iMap, Int jStart, Int jEnd);
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  Void geometryMappingRows(TGeometry *pGeoSrc, Int fIdx, Int ch, Int jStart, Int jEnd, PackedResampleMap *pPackedMap);
+#else
+  Void geometryMappingRows(TGeometry *pGeoSrc, Int fIdx, Int ch, Int jStart, Int jEnd);
+#endif
+#if SVIDEO_MT_GEOMAPPING
+  Double m_dMappingTime;            //wall-clock seconds spent building the mapping tables;
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  Void appendPackedMapRows(const GeoRowBand& band, const PackedResampleMap& bandMap);
+#endif
+#endif
+  Void spherePaddingRows(Int fIdx, Int ch, Int jStart, Int jEnd);
 
   Void initInterpolation(Int *pInterpolateType);
   Void chromaUpsample(Pel *pSrcBuf, Int nWidthC, Int nHeightC, Int iStrideSrc, Int iFaceId, ComponentID chId);
@@ -332,9 +524,15 @@ protected:
   Void chromaDonwsampleV(Pel *pSrcBuf, Int iWidth, Int iHeight, Int iStrideSrc, Int iNumPels, Pel *pDstBuf, Int iStrideDst); //vertical 2:1 downsampling;
   inline Int round(POSType t) { return (Int)(t+ (t>=0? 0.5 :-0.5)); }; 
   Void rotate3D(SPos& sPos, Int rx, Int ry, Int rz);
+#if SVIDEO_BATCH_MAPPING
+  Bool m_bFastProjectionMath;       //batch mapping with the polynomial trigonometry of TSphMath.h;
+  Void rotate3DBatch(SPosArray& pos, Int rx, Int ry, Int rz);
+  Void mapRowToSource(TGeometry *pGeoSrc, Int fIdx, ComponentID chId, Int j, const std::vector<Int>& cols, SPosArray& pos, Pel *pBraveLocation);
+#endif
 
   Int getFilterSize(SInterpolationType filterType);
   Void initFilterWeightLut();
+  Void calcFilterWeights(Int iLutIdx, Int iPhaseScale, Int *pWeights);
   Void interpolate_nn_weight(ComponentID chId, SPos *pSPosIn, PxlFltLut &wlist);
   Void interpolate_bilinear_weight(ComponentID chId, SPos *pSPosIn, PxlFltLut &wlist);
   Void interpolate_bicubic_weight(ComponentID chId, SPos *pSPosIn, PxlFltLut &wlist);
@@ -372,14 +570,56 @@ public:
   Int getMarginSize(Int bY) { return (bY? m_iMarginY : m_iMarginX); }
   Void setPaddingFlag(Bool bFlag) { m_bPadded = bFlag; }
   Char* getGeoName() { return m_strGeoName[m_sVideoInfo.geoType]; };
+#if SVIDEO_MT_GEOCONVERT
+  Void setThreadPool(TComThreadPool *pcThreadPool) { m_pcThreadPool = pcThreadPool; }
+  TComThreadPool* getThreadPool() { return m_pcThreadPool; }
+#endif
+#if SVIDEO_MT_GEOMAPPING
+  Double getMappingTime() { return m_dMappingTime; }
+#endif
+#if SVIDEO_VIEWPORT_PSNR_MT
+  //framePack into a picture of chroma format fmt only copies face 0 with the bit depth adjustment below;
+  Bool isFramePackCopy(ChromaFormat fmt) { return m_sVideoInfo.geoType == SVIDEO_VIEWPORT && m_chromaFormatIDC == fmt && !(fmt == CHROMA_420 && m_bResampleChroma); }
+  Int  getFramePackBDAdjust() { return m_nBitDepth-m_nOutputBitDepth; }
+  Int  getOutputBitDepth() { return m_nOutputBitDepth; }
+#endif
+#if SVIDEO_GEOMAP_CACHE
+  Void setMapCacheDir(const std::string& dir) { m_mapCacheDir = dir; }
+  Void hashProjectionParams(TGeoMapHash& hash);     //parameters map2DTo3D/map3DTo2D depend on;
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  Void setPackedMap(Bool bPacked) { assert(!m_bGeometryMapping); m_bPackedMap = bPacked; }
+  Bool getPackedMap() { return m_bPackedMap; }
+  Int64 getMapMemorySize(Bool bPacked);             //map of this geometry as conversion destination;
+  Int64 getWeightLutMemorySize(Bool bPacked);       //weight tables of this geometry as conversion source;
+#endif
+#if SVIDEO_SEPARABLE_RESAMPLE
+  Void setSeparableMap(Bool bSeparable) { assert(!m_bGeometryMapping); m_bSeparableMap = bSeparable; }
+  Bool getSeparableMap() { return m_bSeparableMap; }
+  Bool isSeparableMapped() { return m_bSeparableMapped; }
+  Int64 getSeparableMapMemorySize();
+#endif
   //analysis;
   Void dumpSpherePoints(Char *pFileName, Bool bAppended=false, SpherePoints *pSphPoints=NULL);
 
   virtual Void clamp(IPos *pIPos);
   virtual Void map2DTo3D(SPos& IPosIn, SPos *pSPosOut) = 0; 
   virtual Void map3DTo2D(SPos *pSPosIn, SPos *pSPosOut) = 0; 
+#if SVIDEO_BATCH_MAPPING
+  //batch versions; out[k] is the result of map2DTo3D(in[k], &out[k]) or map3DTo2D(&pos, &pos) with pos=in[k]; out may be in;
+  virtual Void map2DTo3DBatch(const SPosArray& in, SPosArray& out);
+  virtual Void map3DTo2DBatch(const SPosArray& in, SPosArray& out);
+  Void setFastProjectionMath(Bool bFast) { assert(!m_bGeometryMapping); m_bFastProjectionMath = bFast; }
+  Bool getFastProjectionMath() { return m_bFastProjectionMath; }
+#endif
   virtual Void convertYuv(TComPicYuv *pSrcYuv);
   virtual Void geoConvert(TGeometry *pGeoDst);
+#if SVIDEO_MULTI_OUTPUT_CONVERT
+  Void geoConvert(const std::vector<TGeometry*>& geoDsts);  //same result as geoConvert for each destination, the source is padded once and the rows of all destinations share one parallel pass;
+#endif
+#if SVIDEO_DIRECT_GEOCONVERT
+  Void geoConvertDirect(TGeometry *pGeoDst);  //same result as geoConvert, the projection is evaluated per sample and no mapping of pGeoDst is built;
+#endif
   virtual Void framePack(TComPicYuv *pDstYuv);
 
   virtual Void compactFramePackConvertYuv(TComPicYuv * pSrcYuv);
@@ -389,6 +629,10 @@ public:
   virtual Void geoToFramePack(IPos* posIn, IPos2D* posOut);
 #if SVIDEO_SPSNR_I
   virtual Pel  getPelValue(ComponentID chId, SPos in);
+#endif
+#if SVIDEO_SPSNR_I_TABLE
+  Void getInterpolateWeight(ComponentID chId, SPos *pSPosIn, PxlFltLut &wList) { (this->*m_interpolateWeight[toChannelType(chId)])(chId, pSPosIn, wList); }
+  Pel  getPelValue(ComponentID chId, const PxlFltLut &wList);
 #endif
   virtual Void spherePadding(Bool bEnforced=false);
   virtual Bool insideFace(Int fId, Int x, Int y, ComponentID chId, ComponentID origchId) { return ( x>=0 && x<(m_sVideoInfo.iFaceWidth>>getComponentScaleX(chId)) && y>=0 && y<(m_sVideoInfo.iFaceHeight>>getComponentScaleY(chId)) ); }
@@ -396,6 +640,12 @@ public:
   virtual Void geometryMapping(TGeometry *pGeoSrc);
 
   static TGeometry* create(SVideoInfo& sVideoInfo, InputGeoParam *pInGeoParam);
+#if SVIDEO_FILTER_GATHER_KERNEL
+  static FilterGatherFP getFilterGather(Int iTaps);                        //iTaps x iTaps kernel for the current SIMD level;
+#endif
+#if SVIDEO_PACKED_RESAMPLE_MAP
+  static PackedFilterGatherFP getPackedFilterGather(Int iTaps);
+#endif
   
 };
 
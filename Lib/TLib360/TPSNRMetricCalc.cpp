@@ -108,4 +108,19 @@ Void TPSNRMetric::xCalculatePSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPicD )
     }
 }
 
+#if SVIDEO_FUSED_METRICS
+Void TPSNRMetric::setSSD(const Double *pSSD, TComPicYuv* pcPicD)
+{
+  memset(m_dPSNR, 0, sizeof(Double)*3);
+  for(Int chan=0; chan<pcPicD->getNumberValidComponents(); chan++)
+  {
+    const ComponentID ch=ComponentID(chan);
+    const Int iBitDepthForPSNRCalc = std::max(m_outputBitDepth[toChannelType(ch)], m_referenceBitDepth[toChannelType(ch)]);
+    const Int maxval = 255<<(iBitDepthForPSNRCalc-8) ;
+    const Double fRefValue = (Double) maxval * maxval * (pcPicD->getWidth(ch)*pcPicD->getHeight(ch));
+    m_dPSNR[ch] = ( pSSD[ch] ? 10.0 * log10( fRefValue / pSSD[ch] ) : 999.99 );
+  }
+}
+#endif
+
 #endif
\ No newline at end of file
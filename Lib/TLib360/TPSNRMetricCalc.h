@@ -59,6 +59,9 @@ public:
   Void    setReferenceBitDepth(Int iReferenceBitDepth[MAX_NUM_CHANNEL_TYPE]);
   Double* getPSNR() {return m_dPSNR;}
   Void xCalculatePSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPicD ); 
+#if SVIDEO_FUSED_METRICS
+  Void    setSSD(const Double *pSSD, TComPicYuv* pcPicD);   //PSNR from the SSD of a fused evaluation;
+#endif
 };
 
 #endif
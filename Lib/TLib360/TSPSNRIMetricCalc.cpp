@@ -41,19 +41,33 @@
 
 TSPSNRIMetric::TSPSNRIMetric()
 : m_bSPSNRIEnabled(false)
+#if SVIDEO_SPH_SAMPLE_POINTS
+, m_pcSphPoints(NULL)
+#else
 , m_pCart2D(NULL)
+#endif
 , m_fpDTable(NULL)
 , m_fpTable(NULL)
+#if SVIDEO_SPSNR_I_TABLE
+, m_pcCodingGeometry(NULL)
+, m_pcRefGeometry(NULL)
+#endif
 {
   m_dSPSNRI[0] = m_dSPSNRI[1] = m_dSPSNRI[2] = 0;
+#if SVIDEO_SPSNR_I_TABLE
+  memset(m_pCodingWeight, 0, sizeof(m_pCodingWeight));
+  memset(m_pRefWeight, 0, sizeof(m_pRefWeight));
+#endif
 }
 
 TSPSNRIMetric::~TSPSNRIMetric()
 {
+#if !SVIDEO_SPH_SAMPLE_POINTS
   if(m_pCart2D)
   {
     free(m_pCart2D); m_pCart2D = NULL;
   }
+#endif
   if(m_fpDTable)
   {
     free(m_fpDTable); m_fpDTable = NULL;
@@ -62,6 +76,27 @@ TSPSNRIMetric::~TSPSNRIMetric()
   {
     free(m_fpTable); m_fpTable = NULL;
   }
+#if SVIDEO_SPSNR_I_TABLE
+  for(Int i=0; i<MAX_NUM_CHANNEL_TYPE; i++)
+  {
+    if(m_pCodingWeight[i])
+    {
+      free(m_pCodingWeight[i]); m_pCodingWeight[i] = NULL;
+    }
+    if(m_pRefWeight[i])
+    {
+      free(m_pRefWeight[i]); m_pRefWeight[i] = NULL;
+    }
+  }
+  if(m_pcCodingGeometry)
+  {
+    delete m_pcCodingGeometry; m_pcCodingGeometry = NULL;
+  }
+  if(m_pcRefGeometry)
+  {
+    delete m_pcRefGeometry; m_pcRefGeometry = NULL;
+  }
+#endif
 }
 
 Void TSPSNRIMetric::setVideoInfo(SVideoInfo sCodingVideoInfo, SVideoInfo sRefVideoInfo)
@@ -84,6 +119,15 @@ Void TSPSNRIMetric::init(InputGeoParam sCodingParam, SVideoInfo codingvideoInfo,
   m_iOutputHeight = iCodingHeight;
   m_iRefWidth     = iRefWidth;
   m_iRefHeight    = iRefWidth;
+
+#if SVIDEO_SPSNR_I_TABLE
+  if(m_pcCodingGeometry)
+    delete m_pcCodingGeometry;
+  if(m_pcRefGeometry)
+    delete m_pcRefGeometry;
+  m_pcCodingGeometry = TGeometry::create(m_OutputVideoInfo, &m_GeoParam);
+  m_pcRefGeometry    = TGeometry::create(m_RefVideoInfo, &m_GeoParam);
+#endif
 }
 
 Void TSPSNRIMetric::setOutputBitDepth(Int iOutputBitDepth[MAX_NUM_CHANNEL_TYPE])
@@ -110,6 +154,16 @@ Void TSPSNRIMetric::sphSampoints(Char* cSphDataFile)
     return;
   }
 
+#if SVIDEO_SPH_SAMPLE_POINTS
+  m_pcSphPoints = TSphSamplePoints::get(cSphDataFile);
+  if(!m_pcSphPoints)
+  {
+    printf("SPSNR-I is disabled because metadata file (%s) cannot be opened!\n", cSphDataFile);
+    m_bSPSNRIEnabled = false;
+    return;
+  }
+  m_iSphNumPoints = m_pcSphPoints->getNumPoints();
+#else
   // read data
   FILE *fp = fopen(cSphDataFile,"r");
   if(!fp)
@@ -137,8 +191,10 @@ Void TSPSNRIMetric::sphSampoints(Char* cSphDataFile)
       exit(EXIT_FAILURE); 
     }
   }
+#endif
 }
 
+#if !SVIDEO_SPH_SAMPLE_POINTS
 void TSPSNRIMetric::sphToCart(CPos2D* sph, CPos3D* out)
 {
   POSType fLat = (POSType)(sph->x*S_PI/180.0);
@@ -148,6 +204,7 @@ void TSPSNRIMetric::sphToCart(CPos2D* sph, CPos3D* out)
   out->y =               ssin(fLat);
   out->z = -scos(fLon) * scos(fLat);
 }
+#endif
 
 void TSPSNRIMetric::createTable(TComPicYuv* pcPicD, TGeometry *pcCodingGeomtry)
 {
@@ -157,23 +214,97 @@ void TSPSNRIMetric::createTable(TComPicYuv* pcPicD, TGeometry *pcCodingGeomtry)
   }
 
   Int iNumPoints = m_iSphNumPoints;
+#if SVIDEO_SPH_SAMPLE_INDEX && SVIDEO_SPSNR_I_TABLE
+  m_pcSphCodingIndex = TSphSampleIndex::get(m_pcSphPoints, m_pcCodingGeometry);
+  m_pcSphRefIndex    = TSphSampleIndex::get(m_pcSphPoints, m_pcRefGeometry);
+  const SPosArray& codingPos = m_pcSphCodingIndex->getPos();
+  const SPosArray& refPos    = m_pcSphRefIndex->getPos();
+#else
+#if SVIDEO_SPH_SAMPLE_POINTS
+  const CPos3D *pSphCart = m_pcSphPoints->getCart();
+#else
   CPos2D In2d;
   CPos3D Out3d;
+#endif
   SPos posIn, posOut;
   m_fpDTable  = (SPos*)malloc(iNumPoints*sizeof(SPos));
 
   for (Int np=0; np < iNumPoints; np++)
   {
+#if SVIDEO_SPH_SAMPLE_POINTS
+    const CPos3D& Out3d = pSphCart[np];
+#else
     In2d.x=m_pCart2D[np].x;
     In2d.y=m_pCart2D[np].y;
 
     //get cartesian coordinates
     sphToCart(&In2d, &Out3d);
+#endif
     m_fpDTable[np].x = Out3d.x; 
     m_fpDTable[np].y = Out3d.y; 
     m_fpDTable[np].z = Out3d.z;
   }
+#endif
+
+#if SVIDEO_SPSNR_I_TABLE
+  //the sample positions only depend on the geometries, so the interpolation weights are computed once;
+  Int iNumChTypes = (pcPicD->getChromaFormat()==CHROMA_400)? 1 : MAX_NUM_CHANNEL_TYPE;
+#if SVIDEO_BATCH_MAPPING && !SVIDEO_SPH_SAMPLE_INDEX
+  SPosArray spherePos, codingPos, refPos;
+  spherePos.resize(iNumPoints);
+  for(Int np=0; np<iNumPoints; np++)
+    spherePos.set(np, m_fpDTable[np]);
+  m_pcCodingGeometry->map3DTo2DBatch(spherePos, codingPos);
+  m_pcRefGeometry->map3DTo2DBatch(spherePos, refPos);
+#endif
+  for(Int chType=0; chType<iNumChTypes; chType++)
+  {
+    ComponentID ch = (chType==CHANNEL_TYPE_LUMA)? COMPONENT_Y : COMPONENT_Cb;
+    if(!m_pCodingWeight[chType])
+      m_pCodingWeight[chType] = (PxlFltLut*)malloc(iNumPoints*sizeof(PxlFltLut));
+    if(!m_pRefWeight[chType])
+      m_pRefWeight[chType] = (PxlFltLut*)malloc(iNumPoints*sizeof(PxlFltLut));
+
+    for(Int np=0; np<iNumPoints; np++)
+    {
+#if SVIDEO_BATCH_MAPPING
+      SPos sCodingPos = codingPos.get(np), sRefPos = refPos.get(np);
+#else
+      SPos sCodingPos, sRefPos;
+      m_pcCodingGeometry->map3DTo2D(&m_fpDTable[np], &sCodingPos);
+      m_pcRefGeometry->map3DTo2D(&m_fpDTable[np], &sRefPos);
+#endif
+      if(chType != CHANNEL_TYPE_LUMA)
+      {
+        sCodingPos.x = sCodingPos.x/2;
+        sCodingPos.y = sCodingPos.y/2;
+        sCodingPos.z = sCodingPos.z/2;
+
+        sRefPos.x = sRefPos.x/2;
+        sRefPos.y = sRefPos.y/2;
+        sRefPos.z = sRefPos.z/2;
+      }
+      m_pcCodingGeometry->getInterpolateWeight(ch, &sCodingPos, m_pCodingWeight[chType][np]);
+      m_pcRefGeometry->getInterpolateWeight(ch, &sRefPos, m_pRefWeight[chType][np]);
+    }
+  }
+#endif
+}
+
+#if SVIDEO_SPSNR_I_TABLE
+Void TSPSNRIMetric::convertToGeometry(TGeometry *pcGeometry, TComPicYuv *pcPic)
+{
+  if((pcGeometry->getSVideoInfo()->geoType == SVIDEO_OCTAHEDRON || pcGeometry->getSVideoInfo()->geoType == SVIDEO_ICOSAHEDRON) && pcGeometry->getSVideoInfo()->iCompactFPStructure) 
+  {
+    pcGeometry->compactFramePackConvertYuv(pcPic);
+  }
+  else
+  {
+    pcGeometry->convertYuv(pcPic);
+  }
+  pcGeometry->spherePadding(true);
 }
+#endif
 
 Void TSPSNRIMetric::xCalculateSPSNRI( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPicD )
 {
@@ -181,12 +312,14 @@ Void TSPSNRIMetric::xCalculateSPSNRI( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPic
   Int iBitDepthForPSNRCalc[MAX_NUM_CHANNEL_TYPE];
   Int iReferenceBitShift[MAX_NUM_CHANNEL_TYPE];
   Int iOutputBitShift[MAX_NUM_CHANNEL_TYPE];
+  Pel   refPel, codingPel;
+#if !SVIDEO_SPSNR_I_TABLE
   SPos sCodingPos, sTempPos;
   SPos sRefPos;
-  Pel   refPel, codingPel;
 
   TGeometry  *pcCodingGeometry;
   TGeometry  *pcRefGeometry;
+#endif
   Double SSDspsnrI[3]={0, 0 ,0};
 
   iBitDepthForPSNRCalc[CHANNEL_TYPE_LUMA]   = std::max(m_outputBitDepth[CHANNEL_TYPE_LUMA], m_referenceBitDepth[CHANNEL_TYPE_LUMA]);
@@ -198,6 +331,28 @@ Void TSPSNRIMetric::xCalculateSPSNRI( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPic
 
   memset(m_dSPSNRI, 0, sizeof(Double)*3);
 
+#if SVIDEO_SPSNR_I_TABLE
+  convertToGeometry(m_pcCodingGeometry, pcPicD);
+  convertToGeometry(m_pcRefGeometry, pcOrgPicYuv);
+
+  for(Int chan=0; chan<pcPicD->getNumberValidComponents(); chan++)
+  {
+    const ComponentID ch = ComponentID(chan);
+    const ChannelType chType = toChannelType(ch);
+    const PxlFltLut *pCodingWeight = m_pCodingWeight[chType];
+    const PxlFltLut *pRefWeight = m_pRefWeight[chType];
+    Double dSSD = 0;
+
+    for (Int np = 0; np < iNumPoints; np++)
+    {
+      codingPel = m_pcCodingGeometry->getPelValue(ch, pCodingWeight[np]);
+      refPel    = m_pcRefGeometry->getPelValue(ch, pRefWeight[np]);
+      Intermediate_Int iDifflp=  (Intermediate_Int)((refPel<<iReferenceBitShift[chType]) - (codingPel<<iOutputBitShift[chType]) );
+      dSSD += iDifflp*iDifflp;
+    }
+    SSDspsnrI[chan] = dSSD/iNumPoints;
+  }
+#else
   pcCodingGeometry    = TGeometry::create(m_OutputVideoInfo, &m_GeoParam);
   pcRefGeometry       = TGeometry::create(m_RefVideoInfo, &m_GeoParam);
 
@@ -250,6 +405,7 @@ Void TSPSNRIMetric::xCalculateSPSNRI( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPic
     }
     SSDspsnrI[chan] = SSDspsnrI[chan]/iNumPoints;
   }
+#endif
 
   for (Int ch_indx = 0; ch_indx < pcPicD->getNumberValidComponents(); ch_indx++)
   {
@@ -260,9 +416,11 @@ Void TSPSNRIMetric::xCalculateSPSNRI( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPic
     m_dSPSNRI[ch_indx] = ( SSDspsnrI[ch_indx] ? 10.0 * log10( fReflpsnr / (Double)SSDspsnrI[ch_indx] ) : 999.99 );
   }
 
+#if !SVIDEO_SPSNR_I_TABLE
   if(pcCodingGeometry)
     delete pcCodingGeometry;
   if(pcRefGeometry)
     delete pcRefGeometry;
+#endif
 }
 #endif
\ No newline at end of file
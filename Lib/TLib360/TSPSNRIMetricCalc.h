@@ -38,6 +38,9 @@
 #ifndef __TSPSNRICALC__
 #define __TSPSNRICALC__
 #include "TGeometry.h"
+#if SVIDEO_SPH_SAMPLE_POINTS
+#include "TSphSamplePoints.h"
+#endif
 
 // ====================================================================================================================
 // Class definition
@@ -50,7 +53,11 @@ private:
   Bool      m_bSPSNRIEnabled;
   Double    m_dSPSNRI[3];
   
+#if SVIDEO_SPH_SAMPLE_POINTS
+  const TSphSamplePoints* m_pcSphPoints;          //shared, not owned;
+#else
   CPos2D*   m_pCart2D;
+#endif
   SPos*   m_fpDTable;
   IPos2D*   m_fpTable;
   
@@ -69,6 +76,18 @@ private:
   Int        m_iRefHeight;
   ChromaFormat  m_chromaFormatIDC;
 
+#if SVIDEO_SPSNR_I_TABLE
+  TGeometry *m_pcCodingGeometry;
+  TGeometry *m_pcRefGeometry;
+  PxlFltLut *m_pCodingWeight[MAX_NUM_CHANNEL_TYPE];   //[channel type][point]: interpolation weights in the coding geometry;
+  PxlFltLut *m_pRefWeight[MAX_NUM_CHANNEL_TYPE];      //[channel type][point]: interpolation weights in the reference geometry;
+#if SVIDEO_SPH_SAMPLE_INDEX
+  std::shared_ptr<const TSphSampleIndex> m_pcSphCodingIndex;   //points projected into the coding geometry;
+  std::shared_ptr<const TSphSampleIndex> m_pcSphRefIndex;      //points projected into the reference geometry;
+#endif
+  Void    convertToGeometry(TGeometry *pcGeometry, TComPicYuv *pcPic);
+#endif
+
 
 public:
   TSPSNRIMetric();
@@ -82,7 +101,9 @@ public:
   Void    setReferenceBitDepth(Int iReferenceBitDepth[MAX_NUM_CHANNEL_TYPE]);
   Double* getSPSNRI() {return m_dSPSNRI;}
   Void    sphSampoints(Char* cSphDataFile);
+#if !SVIDEO_SPH_SAMPLE_POINTS
   Void    sphToCart(CPos2D*, CPos3D*);
+#endif
   Void    createTable(TComPicYuv* pcPicD, TGeometry *pcCodingGeomtry);
   Void    xCalculateSPSNRI( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPicD );
 
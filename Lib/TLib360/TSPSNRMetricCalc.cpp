@@ -41,7 +41,11 @@
 
 TSPSNRMetric::TSPSNRMetric()
 : m_bSPSNREnabled(false)
+#if SVIDEO_SPH_SAMPLE_POINTS
+, m_pcSphPoints(NULL)
+#else
 , m_pCart2D(NULL)
+#endif
 , m_fpTable(NULL)
 {
   m_dSPSNR[0] = m_dSPSNR[1] = m_dSPSNR[2] = 0;
@@ -49,10 +53,12 @@ TSPSNRMetric::TSPSNRMetric()
 
 TSPSNRMetric::~TSPSNRMetric()
 {
+#if !SVIDEO_SPH_SAMPLE_POINTS
   if(m_pCart2D)
   {
     free(m_pCart2D); m_pCart2D = NULL;
   }
+#endif
   if (m_fpTable)
   {
     free(m_fpTable); m_fpTable = NULL;
@@ -83,6 +89,16 @@ Void TSPSNRMetric::sphSampoints(Char* cSphDataFile)
     return;
   }
 
+#if SVIDEO_SPH_SAMPLE_POINTS
+  m_pcSphPoints = TSphSamplePoints::get(cSphDataFile);
+  if(!m_pcSphPoints)
+  {
+    printf("SPSNR-NN is disabled because metadata file (%s) cannot be opened!\n", cSphDataFile);
+    m_bSPSNREnabled = false;
+    return;
+  }
+  m_iSphNumPoints = m_pcSphPoints->getNumPoints();
+#else
   // read data
   FILE *fp = fopen(cSphDataFile,"r");
   if(!fp)
@@ -110,8 +126,10 @@ Void TSPSNRMetric::sphSampoints(Char* cSphDataFile)
       exit(EXIT_FAILURE); 
     }
   }
+#endif
 }
 
+#if !SVIDEO_SPH_SAMPLE_POINTS
 void TSPSNRMetric::sphToCart(CPos2D* sph, CPos3D* out)
 {
   POSType fLat = (POSType)(sph->x*S_PI/180.0);
@@ -121,6 +139,7 @@ void TSPSNRMetric::sphToCart(CPos2D* sph, CPos3D* out)
   out->y =               ssin(fLat);
   out->z = -scos(fLon) * scos(fLat);
 }
+#endif
 
 void TSPSNRMetric::createTable(TComPicYuv* pcPicD, TGeometry *pcCodingGeomtry)
 {
@@ -130,18 +149,69 @@ void TSPSNRMetric::createTable(TComPicYuv* pcPicD, TGeometry *pcCodingGeomtry)
   }
 
   Int iNumPoints = m_iSphNumPoints;
+#if SVIDEO_SPH_SAMPLE_INDEX
+  m_fpTable  = (IPos2D*)malloc(iNumPoints*sizeof(IPos2D));
+
+  m_pcSphIndex = TSphSampleIndex::get(m_pcSphPoints, pcCodingGeomtry);
+  const SPosArray& pos = m_pcSphIndex->getPos();
+  for (Int np=0; np < iNumPoints; np++)
+  {
+    IPos tmpPos;
+    tmpPos.faceIdx = pos.faceIdx[np];
+    tmpPos.u = round(pos.x[np]);
+    tmpPos.v = round(pos.y[np]);
+    pcCodingGeomtry->clamp(&tmpPos);
+    pcCodingGeomtry->geoToFramePack(&tmpPos, &m_fpTable[np]);
+  }
+#else
+#if SVIDEO_SPH_SAMPLE_POINTS
+  const CPos3D *pSphCart = m_pcSphPoints->getCart();
+#else
   CPos2D In2d;
   CPos3D Out3d;
-  SPos posIn, posOut;
+#endif
   m_fpTable  = (IPos2D*)malloc(iNumPoints*sizeof(IPos2D));
 
+#if SVIDEO_BATCH_MAPPING
+  SPosArray pos;
+  pos.resize(iNumPoints);
   for (Int np=0; np < iNumPoints; np++)
   {
+#if SVIDEO_SPH_SAMPLE_POINTS
+    const CPos3D& Out3d = pSphCart[np];
+#else
     In2d.x=m_pCart2D[np].x;
     In2d.y=m_pCart2D[np].y;
 
     //get cartesian coordinates
     sphToCart(&In2d, &Out3d);
+#endif
+    pos.set(np, SPos(0, Out3d.x, Out3d.y, Out3d.z));
+  }
+  pcCodingGeomtry->map3DTo2DBatch(pos, pos);
+
+  for (Int np=0; np < iNumPoints; np++)
+  {
+    IPos tmpPos;
+    tmpPos.faceIdx = pos.faceIdx[np];
+    tmpPos.u = round(pos.x[np]);
+    tmpPos.v = round(pos.y[np]);
+    pcCodingGeomtry->clamp(&tmpPos);
+    pcCodingGeomtry->geoToFramePack(&tmpPos, &m_fpTable[np]);
+  }
+#else
+  SPos posIn, posOut;
+  for (Int np=0; np < iNumPoints; np++)
+  {
+#if SVIDEO_SPH_SAMPLE_POINTS
+    const CPos3D& Out3d = pSphCart[np];
+#else
+    In2d.x=m_pCart2D[np].x;
+    In2d.y=m_pCart2D[np].y;
+
+    //get cartesian coordinates
+    sphToCart(&In2d, &Out3d);
+#endif
     posIn.x = Out3d.x; posIn.y = Out3d.y; posIn.z = Out3d.z;
     pcCodingGeomtry->map3DTo2D(&posIn, &posOut);
 
@@ -154,6 +224,8 @@ void TSPSNRMetric::createTable(TComPicYuv* pcPicD, TGeometry *pcCodingGeomtry)
     pcCodingGeomtry->clamp(&tmpPos);
     pcCodingGeomtry->geoToFramePack(&tmpPos, &m_fpTable[np]);
   }
+#endif
+#endif
 }
 
 Void TSPSNRMetric::xCalculateSPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPicD )
@@ -210,4 +282,68 @@ Void TSPSNRMetric::xCalculateSPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPicD
   }
 }
 
+#if SVIDEO_FUSED_METRICS
+/**
+ * \brief group the sample positions of the points by row, points hitting the same sample share one entry with a count;
+ */
+Void TSPSNRMetric::initGatherRows(TComPicYuv* pcPicD)
+{
+  for(Int chan=0; chan<pcPicD->getNumberValidComponents(); chan++)
+  {
+    const ComponentID ch = ComponentID(chan);
+    const Int iWidth  = pcPicD->getWidth (ch);
+    const Int iHeight = pcPicD->getHeight(ch);
+    std::vector<Int> count(iWidth*iHeight, 0);
+    for(Int np = 0; np < m_iSphNumPoints; np++)
+    {
+      Int x_loc = chan? Int(m_fpTable[np].x/2) : (Int)(m_fpTable[np].x);
+      Int y_loc = chan? Int(m_fpTable[np].y/2) : (Int)(m_fpTable[np].y);
+      count[x_loc+y_loc*iWidth]++;
+    }
+    m_gather[chan].clear();
+    m_rowGather[chan].assign(iHeight+1, 0);
+    for(Int y = 0; y < iHeight; y++)
+    {
+      m_rowGather[chan][y] = (Int)m_gather[chan].size();
+      for(Int x = 0; x < iWidth; x++)
+      {
+        if(count[x+y*iWidth])
+        {
+          SPSNRGather g = { x, count[x+y*iWidth] };
+          m_gather[chan].push_back(g);
+        }
+      }
+    }
+    m_rowGather[chan][iHeight] = (Int)m_gather[chan].size();
+  }
+}
+
+Int64 TSPSNRMetric::xCalcRowGatherSSD(Int chan, Int y, const Intermediate_Int *pDiff2)
+{
+  Int64 iSSD = 0;
+  for(Int k = m_rowGather[chan][y]; k < m_rowGather[chan][y+1]; k++)
+  {
+    iSSD += m_gather[chan][k].iCount * (Int64)pDiff2[m_gather[chan][k].x];
+  }
+  return iSSD;
+}
+
+/**
+ * \brief the per-point sums of xCalculateSPSNR() are sums of integers, they are exact and equal to pSSD while below 2^53;
+ */
+Void TSPSNRMetric::setSSD(const Double *pSSD, Int iNumComp)
+{
+  memset(m_dSPSNR, 0, sizeof(Double)*3);
+  for (Int ch_indx = 0; ch_indx < iNumComp; ch_indx++)
+  {
+    const ComponentID ch=ComponentID(ch_indx);
+    const Int iBitDepthForPSNRCalc = std::max(m_outputBitDepth[toChannelType(ch)], m_referenceBitDepth[toChannelType(ch)]);
+    const Int maxval = 255<<(iBitDepthForPSNRCalc-8) ;
+
+    Double fReflpsnr = Double(m_iSphNumPoints)*maxval*maxval;
+    m_dSPSNR[ch_indx] = ( pSSD[ch_indx] ? 10.0 * log10( fReflpsnr / pSSD[ch_indx] ) : 999.99 );
+  }
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -38,6 +38,9 @@
 #ifndef __TSPSNRCALC__
 #define __TSPSNRCALC__
 #include "TGeometry.h"
+#if SVIDEO_SPH_SAMPLE_POINTS
+#include "TSphSamplePoints.h"
+#endif
 
 // ====================================================================================================================
 // Class definition
@@ -45,18 +48,38 @@
 
 #if SVIDEO_SPSNR_NN
 
+#if SVIDEO_FUSED_METRICS
+//sample of a row hit by iCount sphere points;
+struct SPSNRGather
+{
+  Int  x;
+  Int  iCount;
+};
+#endif
+
 class TSPSNRMetric
 {
 private:
   Bool      m_bSPSNREnabled;
   Double    m_dSPSNR[3];
   
+#if SVIDEO_SPH_SAMPLE_POINTS
+  const TSphSamplePoints* m_pcSphPoints;          //shared, not owned;
+#else
   CPos2D*   m_pCart2D;
+#endif
+#if SVIDEO_SPH_SAMPLE_INDEX
+  std::shared_ptr<const TSphSampleIndex> m_pcSphIndex;   //points projected into the coding geometry;
+#endif
   IPos2D*   m_fpTable;
   Int       m_iSphNumPoints;
 
   Int       m_outputBitDepth[MAX_NUM_CHANNEL_TYPE];         ///< bit-depth of output file
   Int       m_referenceBitDepth[MAX_NUM_CHANNEL_TYPE];      ///< bit-depth of reference file
+#if SVIDEO_FUSED_METRICS
+  std::vector<SPSNRGather> m_gather[MAX_NUM_COMPONENT];     //samples hit by the points, in raster order;
+  std::vector<Int>         m_rowGather[MAX_NUM_COMPONENT];  //[y]: first entry of row y; the last entry is the number of entries;
+#endif
 
 public:
   TSPSNRMetric();
@@ -67,9 +90,16 @@ public:
   Void    setReferenceBitDepth(Int iReferenceBitDepth[MAX_NUM_CHANNEL_TYPE]);
   Double* getSPSNR() {return m_dSPSNR;}
   Void    sphSampoints(Char* cSphDataFile);
+#if !SVIDEO_SPH_SAMPLE_POINTS
   Void    sphToCart(CPos2D*, CPos3D*);
+#endif
   Void    createTable(TComPicYuv* pcPicD, TGeometry *pcCodingGeomtry);
   Void    xCalculateSPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPicD );
+#if SVIDEO_FUSED_METRICS
+  Void    initGatherRows(TComPicYuv* pcPicD);
+  Int64   xCalcRowGatherSSD(Int chan, Int y, const Intermediate_Int *pDiff2);   //pDiff2: squared differences of row y;
+  Void    setSSD(const Double *pSSD, Int iNumComp);                            //S-PSNR from the SSD of a fused evaluation;
+#endif
 
   inline Int round(POSType t) { return (Int)(t+ (t>=0? 0.5 :-0.5)); }; 
 };
@@ -0,0 +1,209 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2015, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TSphMath.cpp
+    \brief    batch versions of the polynomial approximations of the trigonometric functions
+*/
+
+#include "TGeometry.h"
+#include "TSphMath.h"
+#if SVIDEO_SIMD_SPH_MATH
+#include "../TLibCommon/TComSimd.h"
+#endif
+
+#if SVIDEO_SIMD_SPH_MATH
+/**
+ * AVX2 kernels of 4 values; every operation of the scalar functions in TSphMath.h has its vector counterpart in the same
+ * order and the selections are blends of both results. No FMA is used, as in the C functions of the default build.
+ */
+SIMD_TARGET("avx2")
+static inline __m256d fastAtanReduced_AVX2(__m256d r)
+{
+  const __m256d u = _mm256_mul_pd(r, r);
+  __m256d p = _mm256_set1_pd(S_FAST_ATAN_POLY[0]);
+  for(Int i = 1; i <= S_FAST_ATAN_DEGREE; i++)
+    p = _mm256_add_pd(_mm256_mul_pd(p, u), _mm256_set1_pd(S_FAST_ATAN_POLY[i]));
+  return _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, u), p));
+}
+
+SIMD_TARGET("avx2")
+static inline __m256d fastAtan2_AVX2(__m256d y, __m256d x)
+{
+  const __m256d vSign = _mm256_set1_pd(-0.0);
+  const __m256d ax = _mm256_andnot_pd(vSign, x);
+  const __m256d ay = _mm256_andnot_pd(vSign, y);
+  const __m256d bXBig = _mm256_cmp_pd(ax, ay, _CMP_GT_OQ);
+  const __m256d mx = _mm256_blendv_pd(ay, ax, bXBig);
+  const __m256d mn = _mm256_blendv_pd(ax, ay, bXBig);
+  const __m256d t = _mm256_div_pd(mn, _mm256_blendv_pd(_mm256_set1_pd(1), mx, _mm256_cmp_pd(mx, _mm256_setzero_pd(), _CMP_GT_OQ)));
+  const __m256d tr = _mm256_div_pd(_mm256_sub_pd(t, _mm256_set1_pd(1)), _mm256_add_pd(t, _mm256_set1_pd(1)));
+  const __m256d bBig = _mm256_cmp_pd(t, _mm256_set1_pd(S_FAST_TAN_PI_8), _CMP_GT_OQ);
+  __m256d a = _mm256_add_pd(_mm256_and_pd(bBig, _mm256_set1_pd(S_FAST_PI_4)), fastAtanReduced_AVX2(_mm256_blendv_pd(t, tr, bBig)));
+  a = _mm256_blendv_pd(a, _mm256_sub_pd(_mm256_set1_pd(S_FAST_PI_2), a), _mm256_cmp_pd(ay, ax, _CMP_GT_OQ));
+  a = _mm256_blendv_pd(a, _mm256_sub_pd(_mm256_set1_pd(S_FAST_PI), a), _mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_LT_OQ));
+  return _mm256_xor_pd(a, _mm256_and_pd(y, vSign));
+}
+
+/// sqrt(1-v*v) as computed by fastAcos() and fastAsin()
+SIMD_TARGET("avx2")
+static inline __m256d fastCosOfSin_AVX2(__m256d v)
+{
+  const __m256d s = _mm256_mul_pd(_mm256_sub_pd(_mm256_set1_pd(1), v), _mm256_add_pd(_mm256_set1_pd(1), v));
+  return _mm256_sqrt_pd(_mm256_and_pd(s, _mm256_cmp_pd(s, _mm256_setzero_pd(), _CMP_GT_OQ)));
+}
+
+SIMD_TARGET("avx2")
+static inline Void fastSinCos_AVX2(__m256d x, __m256d &vSin, __m256d &vCos)
+{
+  const __m256d k = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(S_FAST_2_PI)), _MM_FROUND_CUR_DIRECTION);
+  const __m256d r = _mm256_sub_pd(_mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(S_FAST_PI_2_HI))), _mm256_mul_pd(k, _mm256_set1_pd(S_FAST_PI_2_LO)));
+  const __m256d u = _mm256_mul_pd(r, r);
+  __m256d s = _mm256_set1_pd(S_FAST_SIN_POLY[0]);
+  __m256d c = _mm256_set1_pd(S_FAST_COS_POLY[0]);
+  for(Int i = 1; i <= S_FAST_SINCOS_DEGREE; i++)
+  {
+    s = _mm256_add_pd(_mm256_mul_pd(s, u), _mm256_set1_pd(S_FAST_SIN_POLY[i]));
+    c = _mm256_add_pd(_mm256_mul_pd(c, u), _mm256_set1_pd(S_FAST_COS_POLY[i]));
+  }
+  s = _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, u), s));
+  c = _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(1), _mm256_mul_pd(_mm256_set1_pd(0.5), u)), _mm256_mul_pd(_mm256_mul_pd(u, u), c));
+  //quadrant q = (Int)k & 3: bit 0 swaps sin and cos, sin is negated in quadrants 2 and 3, cos in quadrants 1 and 2;
+  const __m256i q = _mm256_cvtepi32_epi64(_mm256_cvttpd_epi32(k));
+  const __m256d bSwap = _mm256_castsi256_pd(_mm256_slli_epi64(q, 63));
+  const __m256d vSinSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_srli_epi64(q, 1), 63));
+  const __m256d vCosSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_xor_si256(q, _mm256_srli_epi64(q, 1)), 63));
+  vSin = _mm256_xor_pd(_mm256_blendv_pd(s, c, bSwap), vSinSign);
+  vCos = _mm256_xor_pd(_mm256_blendv_pd(c, s, bSwap), vCosSign);
+}
+
+SIMD_TARGET("avx2")
+static Int fastAtan2Batch_AVX2(const Double *pY, const Double *pX, Double *pOut, Int iNum)
+{
+  Int k = 0;
+  for(; k+4 <= iNum; k += 4)
+    _mm256_storeu_pd(pOut+k, fastAtan2_AVX2(_mm256_loadu_pd(pY+k), _mm256_loadu_pd(pX+k)));
+  return k;
+}
+
+SIMD_TARGET("avx2")
+static Int fastAcosBatch_AVX2(const Double *pIn, Double *pOut, Int iNum)
+{
+  Int k = 0;
+  for(; k+4 <= iNum; k += 4)
+  {
+    const __m256d v = _mm256_loadu_pd(pIn+k);
+    _mm256_storeu_pd(pOut+k, fastAtan2_AVX2(fastCosOfSin_AVX2(v), v));
+  }
+  return k;
+}
+
+SIMD_TARGET("avx2")
+static Int fastAsinBatch_AVX2(const Double *pIn, Double *pOut, Int iNum)
+{
+  Int k = 0;
+  for(; k+4 <= iNum; k += 4)
+  {
+    const __m256d v = _mm256_loadu_pd(pIn+k);
+    _mm256_storeu_pd(pOut+k, fastAtan2_AVX2(v, fastCosOfSin_AVX2(v)));
+  }
+  return k;
+}
+
+SIMD_TARGET("avx2")
+static Int fastSinCosBatch_AVX2(const Double *pIn, Double *pSin, Double *pCos, Int iNum)
+{
+  Int k = 0;
+  for(; k+4 <= iNum; k += 4)
+  {
+    __m256d vSin, vCos;
+    fastSinCos_AVX2(_mm256_loadu_pd(pIn+k), vSin, vCos);
+    if(pSin)
+      _mm256_storeu_pd(pSin+k, vSin);
+    if(pCos)
+      _mm256_storeu_pd(pCos+k, vCos);
+  }
+  return k;
+}
+#endif
+
+//the SIMD kernels return the number of values done, the C functions do the rest;
+Void fastAtan2Batch(const Double *pY, const Double *pX, Double *pOut, Int iNum)
+{
+  Int k = 0;
+#if SVIDEO_SIMD_SPH_MATH
+  if(getSimdLevel() >= SIMD_AVX2)
+    k = fastAtan2Batch_AVX2(pY, pX, pOut, iNum);
+#endif
+  for(; k < iNum; k++)
+    pOut[k] = fastAtan2(pY[k], pX[k]);
+}
+
+Void fastAcosBatch(const Double *pIn, Double *pOut, Int iNum)
+{
+  Int k = 0;
+#if SVIDEO_SIMD_SPH_MATH
+  if(getSimdLevel() >= SIMD_AVX2)
+    k = fastAcosBatch_AVX2(pIn, pOut, iNum);
+#endif
+  for(; k < iNum; k++)
+    pOut[k] = fastAcos(pIn[k]);
+}
+
+Void fastAsinBatch(const Double *pIn, Double *pOut, Int iNum)
+{
+  Int k = 0;
+#if SVIDEO_SIMD_SPH_MATH
+  if(getSimdLevel() >= SIMD_AVX2)
+    k = fastAsinBatch_AVX2(pIn, pOut, iNum);
+#endif
+  for(; k < iNum; k++)
+    pOut[k] = fastAsin(pIn[k]);
+}
+
+Void fastSinCosBatch(const Double *pIn, Double *pSin, Double *pCos, Int iNum)
+{
+  Int k = 0;
+#if SVIDEO_SIMD_SPH_MATH
+  if(getSimdLevel() >= SIMD_AVX2)
+    k = fastSinCosBatch_AVX2(pIn, pSin, pCos, iNum);
+#endif
+  for(; k < iNum; k++)
+  {
+    Double dSin, dCos;
+    fastSinCos(pIn[k], dSin, dCos);
+    if(pSin)
+      pSin[k] = dSin;
+    if(pCos)
+      pCos[k] = dCos;
+  }
+}
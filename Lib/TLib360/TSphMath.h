@@ -0,0 +1,135 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2015, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TSphMath.h
+    \brief    polynomial approximations of the trigonometric functions of the projections (header)
+*/
+
+#ifndef __TSPHMATH__
+#define __TSPHMATH__
+#include <math.h>
+#include "../TLibCommon/CommonDef.h"
+
+// ====================================================================================================================
+// Functions
+// ====================================================================================================================
+
+// The functions have no calls and no data dependent loops, so loops over arrays of positions can be vectorised.
+// The absolute error against libm is a few ulp (below 1e-15 for atan2/asin/acos and sin/cos of |x| <= 4*pi);
+
+static const Double S_FAST_PI     = 3.14159265358979323846;
+static const Double S_FAST_PI_2   = 1.57079632679489661923;
+static const Double S_FAST_PI_4   = 0.78539816339744830962;
+static const Double S_FAST_2_PI   = 0.63661977236758134308;     //2/pi;
+static const Double S_FAST_PI_2_HI = 1.57079632679489655800;    //pi/2 = hi + lo;
+static const Double S_FAST_PI_2_LO = 6.12323399573676603587e-17;
+static const Double S_FAST_TAN_PI_8 = 0.41421356237309504880;
+
+//coefficients of the polynomials, highest degree first;
+static const Int    S_FAST_ATAN_DEGREE = 9;
+static const Double S_FAST_ATAN_POLY[S_FAST_ATAN_DEGREE+1] = { 2.11353731576932428e-02, -4.34805221571646222e-02, 5.68834922680901064e-02, -6.64023393042940807e-02, 7.68995349630685748e-02,
+                                                               -9.09077307480841423e-02, 1.11111061804559458e-01, -1.42857141809764665e-01, 1.99999999988551114e-01, -3.33333333333284410e-01 };
+static const Int    S_FAST_SINCOS_DEGREE = 6;
+static const Double S_FAST_SIN_POLY[S_FAST_SINCOS_DEGREE+1] = { -7.64716373181981647590e-13, 1.60590438368216145994e-10, -2.50521083854417187751e-08, 2.75573192239858906526e-06,
+                                                                -1.98412698412698412698e-04, 8.33333333333333333333e-03, -1.66666666666666666667e-01 };
+static const Double S_FAST_COS_POLY[S_FAST_SINCOS_DEGREE+1] = { 4.77947733238738529744e-14, -1.14707455977297247139e-11, 2.08767569878680989792e-09, -2.75573192239858906526e-07,
+                                                                2.48015873015873015873e-05, -1.38888888888888888889e-03, 4.16666666666666666667e-02 };
+
+//atan(r)/r for r*r in [0, tan(pi/8)^2], Chebyshev interpolant in r*r; relative error 3.5e-17;
+static inline Double fastAtanReduced(Double r)
+{
+  Double u = r*r;
+  Double p = S_FAST_ATAN_POLY[0];
+  for(Int i = 1; i <= S_FAST_ATAN_DEGREE; i++)
+    p = p*u + S_FAST_ATAN_POLY[i];
+  return r + r*u*p;
+}
+
+static inline Double fastAtan2(Double y, Double x)
+{
+  Double ax = fabs(x);
+  Double ay = fabs(y);
+  Double mx = ax > ay? ax : ay;
+  Double mn = ax > ay? ay : ax;
+  //both quotients are always computed, so the selections below need no branches;
+  Double t = mn/(mx > 0? mx : 1);
+  Double tr = (t-1)/(t+1);
+  Bool bBig = t > S_FAST_TAN_PI_8;
+  Double r = bBig? tr : t;
+  Double a = (bBig? S_FAST_PI_4 : 0) + fastAtanReduced(r);
+  a = ay > ax? S_FAST_PI_2 - a : a;
+  a = x < 0? S_FAST_PI - a : a;
+  return signbit(y)? -a : a;
+}
+
+static inline Double fastAcos(Double v)
+{
+  Double s = (1-v)*(1+v);
+  return fastAtan2(sqrt(s > 0? s : 0), v);
+}
+
+static inline Double fastAsin(Double v)
+{
+  Double s = (1-v)*(1+v);
+  return fastAtan2(v, sqrt(s > 0? s : 0));
+}
+
+//sin and cos of x; x is reduced to [-pi/4, pi/4] by multiples of pi/2 and the Taylor series are evaluated up to degree 15/16;
+static inline Void fastSinCos(Double x, Double &dSin, Double &dCos)
+{
+  Double k = nearbyint(x*S_FAST_2_PI);
+  Double r = (x - k*S_FAST_PI_2_HI) - k*S_FAST_PI_2_LO;
+  Double u = r*r;
+  Double s = S_FAST_SIN_POLY[0];
+  Double c = S_FAST_COS_POLY[0];
+  for(Int i = 1; i <= S_FAST_SINCOS_DEGREE; i++)
+  {
+    s = s*u + S_FAST_SIN_POLY[i];
+    c = c*u + S_FAST_COS_POLY[i];
+  }
+  s = r + r*u*s;
+  c = 1 - 0.5*u + u*u*c;
+  Int q = (Int)k & 3;
+  dSin = q==0? s : (q==1? c : (q==2? -s : -c));
+  dCos = q==0? c : (q==1? -s : (q==2? -c : s));
+}
+
+// The batch functions apply the functions above to arrays of iNum values, with AVX2 kernels when getSimdLevel() allows it.
+// The kernels do the same operations in the same order, so the results are identical; an output may be an input array;
+Void fastAtan2Batch(const Double *pY, const Double *pX, Double *pOut, Int iNum);
+Void fastAcosBatch(const Double *pIn, Double *pOut, Int iNum);
+Void fastAsinBatch(const Double *pIn, Double *pOut, Int iNum);
+Void fastSinCosBatch(const Double *pIn, Double *pSin, Double *pCos, Int iNum);   //pSin or pCos may be NULL;
+
+#endif // __TSPHMATH__
@@ -0,0 +1,309 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2015, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TSphSamplePoints.cpp
+    \brief    sphere sampling points of the S-PSNR metrics
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "TSphSamplePoints.h"
+
+#if SVIDEO_SPH_SAMPLE_POINTS
+
+static const Char   S_SPH_POINTS_MAGIC[8]   = { '3', '6', '0', 'S', 'P', 'H', 'P', 'T' };
+static const UInt   S_SPH_POINTS_VERSION    = 1;
+static const Char   S_SPH_POINTS_GENERATED[] = "fibonacci:";
+
+//followed by iNumPoints latitude/longitude pairs (CPos2D) and iNumPoints Cartesian positions (CPos3D);
+struct SphPointsHeader
+{
+  Char   magic[8];
+  UInt   uiVersion;
+  UInt   uiPosSize;                                //sizeof(POSType), the file is only read back by the same build type;
+  Int64  iNumPoints;
+};
+
+TSphSamplePoints::TSphSamplePoints()
+: m_iNumPoints(0)
+, m_pLatLon(NULL)
+, m_pCart(NULL)
+, m_pMapBase(NULL)
+, m_iMapSize(0)
+{
+}
+
+TSphSamplePoints::~TSphSamplePoints()
+{
+#ifndef _WIN32
+  if(m_pMapBase)
+  {
+    munmap(m_pMapBase, m_iMapSize);
+  }
+#endif
+}
+
+Bool TSphSamplePoints::isGenerated(const Char* cSphDataFile)
+{
+  return cSphDataFile && !strncmp(cSphDataFile, S_SPH_POINTS_GENERATED, strlen(S_SPH_POINTS_GENERATED));
+}
+
+const TSphSamplePoints* TSphSamplePoints::get(const Char* cSphDataFile)
+{
+  static std::mutex cMutex;
+  static std::map<std::string, std::unique_ptr<TSphSamplePoints> > cPointSets;
+
+  if(!cSphDataFile)
+  {
+    return NULL;
+  }
+  std::lock_guard<std::mutex> lock(cMutex);
+  std::unique_ptr<TSphSamplePoints>& pPoints = cPointSets[cSphDataFile];
+  if(!pPoints)
+  {
+    std::unique_ptr<TSphSamplePoints> pNew(new TSphSamplePoints);
+    if(isGenerated(cSphDataFile))
+    {
+      Int iNumPoints = atoi(cSphDataFile + strlen(S_SPH_POINTS_GENERATED));
+      if(iNumPoints <= 0)
+      {
+        printf("Invalid number of generated sphere points (%s).\n", cSphDataFile);
+        exit(EXIT_FAILURE);
+      }
+      pNew->generateFibonacci(iNumPoints);
+    }
+    else if(!pNew->loadBinary(cSphDataFile) && !pNew->loadText(cSphDataFile))
+    {
+      return NULL;
+    }
+    pPoints.swap(pNew);
+  }
+  return pPoints.get();
+}
+
+Bool TSphSamplePoints::loadText(const Char* fileName)
+{
+  FILE *fp = fopen(fileName, "rb");
+  if(!fp)
+  {
+    return false;
+  }
+  //the whole file is parsed from memory, strtod gives the same values as fscanf("%lf");
+  std::vector<Char> text;
+  Char buf[1<<16];
+  size_t iRead;
+  while((iRead = fread(buf, 1, sizeof(buf), fp)) > 0)
+  {
+    text.insert(text.end(), buf, buf+iRead);
+  }
+  fclose(fp);
+  text.push_back('\0');
+
+  Char *pCur = &text[0], *pEnd;
+  m_iNumPoints = (Int)strtol(pCur, &pEnd, 10);
+  if(pEnd == pCur || m_iNumPoints < 0)
+  {
+    printf("SphData file does not exist.\n");
+    exit(EXIT_FAILURE);
+  }
+  m_latLon.resize(m_iNumPoints);
+  for(Int z = 0; z < m_iNumPoints; z++)
+  {
+    pCur = pEnd;
+    m_latLon[z].x = strtod(pCur, &pEnd);
+    if(pEnd == pCur)
+    {
+      printf("Format error SphData in sphSampoints().\n");
+      exit(EXIT_FAILURE);
+    }
+    pCur = pEnd;
+    m_latLon[z].y = strtod(pCur, &pEnd);
+    if(pEnd == pCur)
+    {
+      printf("Format error SphData in sphSampoints().\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+  m_pLatLon = m_latLon.data();
+  computeCart();
+  return true;
+}
+
+Bool TSphSamplePoints::loadBinary(const Char* fileName)
+{
+  FILE *fp = fopen(fileName, "rb");
+  if(!fp)
+  {
+    return false;
+  }
+  SphPointsHeader header;
+  Bool bBinary = fread(&header, sizeof(header), 1, fp) == 1 && !memcmp(header.magic, S_SPH_POINTS_MAGIC, sizeof(header.magic));
+  if(!bBinary)
+  {
+    fclose(fp);
+    return false;
+  }
+  if(header.uiVersion != S_SPH_POINTS_VERSION || header.uiPosSize != sizeof(POSType) || header.iNumPoints < 0 || header.iNumPoints > MAX_INT)
+  {
+    printf("Format error SphData in sphSampoints().\n");
+    exit(EXIT_FAILURE);
+  }
+  m_iNumPoints = (Int)header.iNumPoints;
+  const size_t iDataSize = m_iNumPoints*(sizeof(CPos2D)+sizeof(CPos3D));
+
+#ifndef _WIN32
+  struct stat st;
+  if(!fstat(fileno(fp), &st) && (size_t)st.st_size >= sizeof(header)+iDataSize)
+  {
+    m_iMapSize = sizeof(header)+iDataSize;
+    Void *p = mmap(NULL, m_iMapSize, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+    if(p != MAP_FAILED)
+    {
+      fclose(fp);
+      m_pMapBase = p;
+      m_pLatLon = (const CPos2D*)((const UChar*)p + sizeof(header));
+      m_pCart   = (const CPos3D*)(m_pLatLon + m_iNumPoints);
+      return true;
+    }
+  }
+#endif
+  m_latLon.resize(m_iNumPoints);
+  m_cart.resize(m_iNumPoints);
+  if(fread(m_latLon.data(), sizeof(CPos2D), m_iNumPoints, fp) != (size_t)m_iNumPoints || fread(m_cart.data(), sizeof(CPos3D), m_iNumPoints, fp) != (size_t)m_iNumPoints)
+  {
+    printf("Format error SphData in sphSampoints().\n");
+    exit(EXIT_FAILURE);
+  }
+  fclose(fp);
+  m_pLatLon = m_latLon.data();
+  m_pCart = m_cart.data();
+  return true;
+}
+
+//spherical Fibonacci lattice: equal-area latitude bands, longitudes advanced by the golden angle;
+Void TSphSamplePoints::generateFibonacci(Int iNumPoints)
+{
+  const Double dGoldenAngle = 180.0*(3.0 - sqrt(5.0));
+  m_iNumPoints = iNumPoints;
+  m_latLon.resize(m_iNumPoints);
+  for(Int z = 0; z < m_iNumPoints; z++)
+  {
+    Double dLon = fmod(z*dGoldenAngle, 360.0);
+    m_latLon[z].x = asin(1.0 - 2.0*(z+0.5)/m_iNumPoints)*180.0/S_PI;
+    m_latLon[z].y = dLon >= 180.0? dLon - 360.0 : dLon;
+  }
+  m_pLatLon = m_latLon.data();
+  computeCart();
+}
+
+//same conversion as the former sphToCart() of the metrics;
+Void TSphSamplePoints::computeCart()
+{
+  m_cart.resize(m_iNumPoints);
+  for(Int z = 0; z < m_iNumPoints; z++)
+  {
+    POSType fLat = (POSType)(m_pLatLon[z].x*S_PI/180.0);
+    POSType fLon = (POSType)(m_pLatLon[z].y*S_PI/180.0);
+
+    m_cart[z].x =  ssin(fLon) * scos(fLat);
+    m_cart[z].y =               ssin(fLat);
+    m_cart[z].z = -scos(fLon) * scos(fLat);
+  }
+  m_pCart = m_cart.data();
+}
+
+Bool TSphSamplePoints::writeBinary(const Char* fileName) const
+{
+  FILE *fp = fopen(fileName, "wb");
+  if(!fp)
+  {
+    return false;
+  }
+  SphPointsHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, S_SPH_POINTS_MAGIC, sizeof(header.magic));
+  header.uiVersion = S_SPH_POINTS_VERSION;
+  header.uiPosSize = sizeof(POSType);
+  header.iNumPoints = m_iNumPoints;
+  Bool bOk = fwrite(&header, sizeof(header), 1, fp) == 1
+          && fwrite(m_pLatLon, sizeof(CPos2D), m_iNumPoints, fp) == (size_t)m_iNumPoints
+          && fwrite(m_pCart, sizeof(CPos3D), m_iNumPoints, fp) == (size_t)m_iNumPoints;
+  return (fclose(fp) == 0) && bOk;
+}
+
+#endif
+
+#if SVIDEO_SPH_SAMPLE_INDEX
+/**
+ * \brief projected positions of pcPoints in pcGeometry, built on the first request; the registry only keeps weak references,
+ *        so an index is freed when the last metric using it is destroyed;
+ */
+std::shared_ptr<const TSphSampleIndex> TSphSampleIndex::get(const TSphSamplePoints* pcPoints, TGeometry* pcGeometry)
+{
+  static std::mutex cMutex;
+  static std::map<std::pair<const TSphSamplePoints*, UInt64>, std::weak_ptr<const TSphSampleIndex> > cIndices;
+
+  TGeoMapHash hash;
+  pcGeometry->hashProjectionParams(hash);
+  hash.add((Int)pcGeometry->getFastProjectionMath());
+
+  std::lock_guard<std::mutex> lock(cMutex);
+  std::weak_ptr<const TSphSampleIndex>& pEntry = cIndices[std::make_pair(pcPoints, hash.get())];
+  std::shared_ptr<const TSphSampleIndex> pIndex = pEntry.lock();
+  if(!pIndex)
+  {
+    TSphSampleIndex *pNew = new TSphSampleIndex;
+    Int iNumPoints = pcPoints->getNumPoints();
+    const CPos3D *pSphCart = pcPoints->getCart();
+    pNew->m_pos.resize(iNumPoints);
+    for(Int np=0; np<iNumPoints; np++)
+    {
+      pNew->m_pos.set(np, SPos(0, pSphCart[np].x, pSphCart[np].y, pSphCart[np].z));
+    }
+    pcGeometry->map3DTo2DBatch(pNew->m_pos, pNew->m_pos);
+    pIndex.reset(pNew);
+    pEntry = pIndex;
+  }
+  return pIndex;
+}
+#endif
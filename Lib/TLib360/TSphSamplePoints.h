@@ -0,0 +1,105 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2015, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TSphSamplePoints.h
+    \brief    sphere sampling points of the S-PSNR metrics (header)
+*/
+
+#ifndef __TSPHSAMPLEPOINTS__
+#define __TSPHSAMPLEPOINTS__
+#include <string>
+#include <vector>
+#include "TGeometry.h"
+#if SVIDEO_SPH_SAMPLE_INDEX
+#include <memory>
+#endif
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+#if SVIDEO_SPH_SAMPLE_POINTS
+/// sphere sampling points shared by the S-PSNR metrics; each point set is read and converted once per process;
+/// sources: the text file (number of points, then latitude/longitude pairs in degrees), the binary file written by
+/// writeBinary() with the Cartesian coordinates precomputed, or "fibonacci:<N>" for a generated lattice of N points;
+class TSphSamplePoints
+{
+private:
+  Int                  m_iNumPoints;
+  const CPos2D*        m_pLatLon;                  ///< latitude/longitude in degrees
+  const CPos3D*        m_pCart;                    ///< Cartesian coordinates on the unit sphere
+  std::vector<CPos2D>  m_latLon;
+  std::vector<CPos3D>  m_cart;
+  Void*                m_pMapBase;                 ///< mapped binary file the points are used from in place
+  size_t               m_iMapSize;
+
+  TSphSamplePoints();
+  Bool  loadText(const Char* fileName);
+  Bool  loadBinary(const Char* fileName);
+  Void  generateFibonacci(Int iNumPoints);
+  Void  computeCart();
+
+public:
+  virtual ~TSphSamplePoints();
+
+  static const TSphSamplePoints* get(const Char* cSphDataFile);  ///< NULL if the file cannot be opened, exits on a format error;
+  static Bool  isGenerated(const Char* cSphDataFile);
+  Bool  writeBinary(const Char* fileName) const;
+
+  Int            getNumPoints() const { return m_iNumPoints; }
+  const CPos2D*  getLatLon()    const { return m_pLatLon;    }
+  const CPos3D*  getCart()      const { return m_pCart;      }
+};
+#endif
+
+#if SVIDEO_SPH_SAMPLE_INDEX
+/// positions of a sphere point set projected into a geometry (map3DTo2D); immutable once built, one instance per point set
+/// and projection is shared by all metrics of the process and released with its last user;
+class TSphSampleIndex
+{
+private:
+  SPosArray  m_pos;
+
+  TSphSampleIndex() {}
+
+public:
+  virtual ~TSphSampleIndex() {}
+
+  static std::shared_ptr<const TSphSampleIndex> get(const TSphSamplePoints* pcPoints, TGeometry* pcGeometry);
+
+  Int              getNumPoints() const { return m_pos.size(); }
+  const SPosArray& getPos()       const { return m_pos; }
+};
+#endif
+
+#endif // __TSPHSAMPLEPOINTS__
@@ -73,6 +73,66 @@ Void TViewPort::map2DTo3D(SPos& IPosIn, SPos *pSPosOut)
 
 }
 
+#if SVIDEO_BATCH_MAPPING
+Void TViewPort::map2DTo3DBatch(const SPosArray& in, SPosArray& out)
+{
+  //same operation order as map2DTo3D;
+  const POSType k[2][3] = { { m_matInvK[0][0], m_matInvK[0][1], m_matInvK[0][2] },
+                            { m_matInvK[1][0], m_matInvK[1][1], m_matInvK[1][2] } };
+  const POSType r[3][3] = { { m_matRotMatx[0][0], m_matRotMatx[0][1], m_matRotMatx[0][2] },
+                            { m_matRotMatx[1][0], m_matRotMatx[1][1], m_matRotMatx[1][2] },
+                            { m_matRotMatx[2][0], m_matRotMatx[2][1], m_matRotMatx[2][2] } };
+  Int iNum = in.size();
+  out.resize(iNum);
+  for(Int i=0; i<iNum; i++)
+  {
+    POSType u = in.x[i]+(POSType)(0.5);
+    POSType v = in.y[i]+(POSType)(0.5);
+    POSType x2 = k[0][0]*u + k[0][1]*v + k[0][2];
+    POSType y2 = k[1][0]*u + k[1][1]*v + k[1][2];
+
+    POSType z1 = 1/ssqrt(x2*x2+y2*y2+1);
+    POSType x1 = z1*x2;
+    POSType y1 = z1*y2;
+
+    out.faceIdx[i] = in.faceIdx[i];
+    out.x[i] = r[0][0]*x1 + r[0][1]*y1 + r[0][2]*z1;
+    out.y[i] = r[1][0]*x1 + r[1][1]*y1 + r[1][2]*z1;
+    out.z[i] = r[2][0]*x1 + r[2][1]*y1 + r[2][2]*z1;
+  }
+}
+#elif SVIDEO_DIRECT_GEOCONVERT
+/**
+ * \brief map2DTo3D of the samples x=(iStart+k)*iStep, k<iNum, of row y; the loop has no calls and only the column terms change, so it can be vectorised;
+ */
+Void TViewPort::map2DTo3DRow(POSType y, Int iStart, Int iNum, Int iStep, SPos *pSPosOut)
+{
+  //same operation order as map2DTo3D;
+  const POSType k00 = m_matInvK[0][0], k02 = m_matInvK[0][2], k10 = m_matInvK[1][0], k12 = m_matInvK[1][2];
+  const POSType r[3][3] = { { m_matRotMatx[0][0], m_matRotMatx[0][1], m_matRotMatx[0][2] },
+                            { m_matRotMatx[1][0], m_matRotMatx[1][1], m_matRotMatx[1][2] },
+                            { m_matRotMatx[2][0], m_matRotMatx[2][1], m_matRotMatx[2][2] } };
+  POSType v = y+(POSType)(0.5);
+  POSType x2v = m_matInvK[0][1]*v;
+  POSType y2v = m_matInvK[1][1]*v;
+  for(Int k=0; k<iNum; k++)
+  {
+    POSType u = (POSType)((iStart+k)*iStep)+(POSType)(0.5);
+    POSType x2 = k00*u + x2v + k02;
+    POSType y2 = k10*u + y2v + k12;
+
+    POSType z1 = 1/ssqrt(x2*x2+y2*y2+1);
+    POSType x1 = z1*x2;
+    POSType y1 = z1*y2;
+
+    pSPosOut[k].faceIdx = 0;
+    pSPosOut[k].x = r[0][0]*x1 + r[0][1]*y1 + r[0][2]*z1;
+    pSPosOut[k].y = r[1][0]*x1 + r[1][1]*y1 + r[1][2]*z1;
+    pSPosOut[k].z = r[2][0]*x1 + r[2][1]*y1 + r[2][2]*z1;
+  }
+}
+#endif
+
 Void TViewPort::setViewPort(Float fovx,Float fovy,Float yaw,Float pitch)
  {
    m_sVideoInfo.viewPort.hFOV= fovx;
@@ -60,6 +60,11 @@ public:
 
   //own methods;
   virtual Void map3DTo2D(SPos *pSPosIn, SPos *pSPosOut); 
+#if SVIDEO_BATCH_MAPPING
+  virtual Void map2DTo3DBatch(const SPosArray& in, SPosArray& out);
+#elif SVIDEO_DIRECT_GEOCONVERT
+  Void map2DTo3DRow(POSType y, Int iStart, Int iNum, Int iStep, SPos *pSPosOut);
+#endif
   Void setViewPort(Float, Float, Float, Float);
   Void setRotMat();
   Void setInvK();
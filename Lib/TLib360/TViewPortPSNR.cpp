@@ -53,6 +53,10 @@ TViewPortPSNR::TViewPortPSNR()
 , m_pcTVideoIOYuvInputFile(NULL)
 , m_iLastFrmPOC(0)
 , m_temporalSubsampleRatio(1)
+#if SVIDEO_VIEWPORT_PSNR_MT
+, m_pcThreadPool(NULL)
+, m_bFacePSNR(false)
+#endif
 {
   m_viewPortPSNRParam.bViewPortPSNREnabled = false;
   m_viewPortPSNRParam.viewPortSettingsList.clear();
@@ -111,6 +115,17 @@ TViewPortPSNR::~TViewPortPSNR()
     delete m_pRecViewPortYuv;
     m_pRecViewPortYuv = NULL;
   }
+#if SVIDEO_VIEWPORT_PSNR_MT
+  for(size_t i=0; i<m_refViewPortYuvs.size(); i++)
+  {
+    m_refViewPortYuvs[i]->destroy();
+    delete m_refViewPortYuvs[i];
+    m_recViewPortYuvs[i]->destroy();
+    delete m_recViewPortYuvs[i];
+  }
+  m_refViewPortYuvs.clear();
+  m_recViewPortYuvs.clear();
+#endif
 
   if(m_pdPSNRSum)
   {
@@ -154,10 +169,25 @@ Void TViewPortPSNR::init(SVideoInfo& sRefVideoInfo, SVideoInfo& sRecVideoInfo, I
     m_pdMSESum = new Double[iNumViewPorts][3];
     memset(m_pdMSESum[0], 0, sizeof(Double)*iNumViewPorts*3);
 
+#if SVIDEO_VIEWPORT_PSNR_MT
+    //every viewport has its own pictures, so that the viewports can be processed in parallel; none are needed when the faces are compared directly;
+    m_bFacePSNR = !SVIDEO_VIEWPORT_OUTPUT && iNumViewPorts > 0 && m_pRecViewPortList[0]->isFramePackCopy(sViewPortInfo.framePackStruct.chromaFormatIDC);
+    if(!m_bFacePSNR)
+    {
+      for(Int i=0; i<iNumViewPorts; i++)
+      {
+        m_refViewPortYuvs.push_back(new TComPicYuv);
+        m_refViewPortYuvs[i]->createWithoutCUInfo( m_viewPortPSNRParam.iViewPortWidth, m_viewPortPSNRParam.iViewPortHeight, sViewPortInfo.framePackStruct.chromaFormatIDC, true, S_PAD_MAX, S_PAD_MAX);
+        m_recViewPortYuvs.push_back(new TComPicYuv);
+        m_recViewPortYuvs[i]->createWithoutCUInfo( m_viewPortPSNRParam.iViewPortWidth, m_viewPortPSNRParam.iViewPortHeight, sViewPortInfo.framePackStruct.chromaFormatIDC, true, S_PAD_MAX, S_PAD_MAX);
+      }
+    }
+#else
     m_pRefViewPortYuv = new TComPicYuv;
     m_pRefViewPortYuv->createWithoutCUInfo( m_viewPortPSNRParam.iViewPortWidth, m_viewPortPSNRParam.iViewPortHeight, sViewPortInfo.framePackStruct.chromaFormatIDC, true, S_PAD_MAX, S_PAD_MAX);
     m_pRecViewPortYuv = new TComPicYuv;
     m_pRecViewPortYuv->createWithoutCUInfo( m_viewPortPSNRParam.iViewPortWidth, m_viewPortPSNRParam.iViewPortHeight, sViewPortInfo.framePackStruct.chromaFormatIDC, true, S_PAD_MAX, S_PAD_MAX);
+#endif
     
     m_iInputWidth = iInputWidth;
     m_iInputHeight = iInputHeight;
@@ -210,6 +240,138 @@ Void TViewPortPSNR::xCalculatePSNRInternal(TComPicYuv *pcOrgPicYuv, TComPicYuv *
   }
 }
 
+#if SVIDEO_VIEWPORT_PSNR_MT
+/**
+ * \brief PSNR of two viewports from their faces; the samples are adjusted as framePack would write them;
+ */
+Void TViewPortPSNR::xCalculateFacePSNR(TGeometry *pRefViewPort, TGeometry *pRecViewPort, Double *pdPSNR, Double *pdMSE)
+{
+  for(Int i=0; i<MAX_NUM_COMPONENT; i++)
+  {
+    pdPSNR[i] = pdMSE[i] = 0.0;
+  }
+  Int iBitDepthForPSNRCalc = std::max(m_iViewPortBitDepth, m_iRefBitDepth);
+  Int iReferenceBitShift = iBitDepthForPSNRCalc - m_iRefBitDepth;
+  Int iOutputBitShift = iBitDepthForPSNRCalc - m_iViewPortBitDepth;
+  Int iRefBDAdjust = pRefViewPort->getFramePackBDAdjust();
+  Int iRecBDAdjust = pRecViewPort->getFramePackBDAdjust();
+  Int iRefOffset = iRefBDAdjust>0? (1<<(iRefBDAdjust-1)) : 0;
+  Int iRecOffset = iRecBDAdjust>0? (1<<(iRecBDAdjust-1)) : 0;
+  ChromaFormat chFmt = pRecViewPort->getSVideoInfo()->framePackStruct.chromaFormatIDC;
+
+  for(Int chan=0; chan<getNumberValidComponents(chFmt); chan++)
+  {
+    const ComponentID ch=ComponentID(chan);
+    const Pel*  pOrg       = pRefViewPort->getAddr(0, chan);
+    const Int   iOrgStride = pRefViewPort->getStride(ch);
+    const Pel*  pRec       = pRecViewPort->getAddr(0, chan);
+    const Int   iRecStride = pRecViewPort->getStride(ch);
+    const Int   iWidth  = m_viewPortPSNRParam.iViewPortWidth >> getComponentScaleX(ch, chFmt);
+    const Int   iHeight = m_viewPortPSNRParam.iViewPortHeight >> getComponentScaleY(ch, chFmt);
+    Int   iSize   = iWidth*iHeight;
+
+    Double SSDpsnr=0;
+    for(Int y = 0; y < iHeight; y++ )
+    {
+      for(Int x = 0; x < iWidth; x++ )
+      {
+        Int iOrg = ClipBD((pOrg[x] + iRefOffset) >> iRefBDAdjust, pRefViewPort->getOutputBitDepth());
+        Int iRec = ClipBD((pRec[x] + iRecOffset) >> iRecBDAdjust, pRecViewPort->getOutputBitDepth());
+        Intermediate_Int iDiff = (Intermediate_Int)( (iOrg<<iReferenceBitShift) - (iRec<<iOutputBitShift) );
+        SSDpsnr += iDiff * iDiff;
+      }
+      pOrg += iOrgStride;
+      pRec += iRecStride;
+    }
+    const Int maxval = 255<<(iBitDepthForPSNRCalc - 8) ;
+    const Double fRefValue = (Double) maxval * maxval * iSize;
+    pdPSNR[ch] = ( SSDpsnr ? 10.0 * log10( fRefValue / (Double)SSDpsnr ) : 999.99 );
+    pdMSE[ch] = (Double)SSDpsnr/(iSize);
+  }
+}
+
+/**
+ * \brief PSNR of one viewport; the padded source faces are only read, so viewports can run in parallel;
+ */
+Void TViewPortPSNR::xCalculateViewPortPSNR(Int i, Double *pdPSNR, Double *pdMSE)
+{
+  m_pRefGeometry->geoConvert(m_pRefViewPortList[i]);
+  m_pRecGeometry->geoConvert(m_pRecViewPortList[i]);
+  if(m_bFacePSNR)
+  {
+    xCalculateFacePSNR(m_pRefViewPortList[i], m_pRecViewPortList[i], pdPSNR, pdMSE);
+    return;
+  }
+
+  TComPicYuv *pRefViewPortYuv = m_refViewPortYuvs[i];
+  TComPicYuv *pRecViewPortYuv = m_recViewPortYuvs[i];
+  if((m_pRefViewPortList[i]->getType() == SVIDEO_OCTAHEDRON || m_pRefViewPortList[i]->getType() == SVIDEO_ICOSAHEDRON) && m_pRefViewPortList[i]->getSVideoInfo()->iCompactFPStructure)
+    m_pRefViewPortList[i]->compactFramePack(pRefViewPortYuv);
+  else
+    m_pRefViewPortList[i]->framePack(pRefViewPortYuv);
+  if((m_pRecViewPortList[i]->getType() == SVIDEO_OCTAHEDRON || m_pRecViewPortList[i]->getType() == SVIDEO_ICOSAHEDRON) && m_pRecViewPortList[i]->getSVideoInfo()->iCompactFPStructure)
+    m_pRecViewPortList[i]->compactFramePack(pRecViewPortYuv);
+  else
+    m_pRecViewPortList[i]->framePack(pRecViewPortYuv);
+
+  xCalculatePSNRInternal(pRefViewPortYuv, pRecViewPortYuv, pdPSNR, pdMSE);
+}
+
+#if SVIDEO_VIEWPORT_OUTPUT
+/**
+ * \brief append the viewport pictures of the frame to their files, in encoding order; bAppend is false for the first frame;
+ */
+Void TViewPortPSNR::xDumpViewPorts(Bool bAppend)
+{
+  if(m_bFacePSNR)
+    return;
+  for(Int i=0; i<getNumViewPorts(); i++)
+  {
+    Char fileName[256];
+    BitDepths bd;
+    bd.recon[CHANNEL_TYPE_LUMA] =bd.recon[CHANNEL_TYPE_CHROMA] = m_iRefBitDepth;
+    sprintf(fileName, "ref_viewport%d_%dx%d_BD%d.yuv", i, m_viewPortPSNRParam.iViewPortWidth, m_viewPortPSNRParam.iViewPortHeight, m_iRefBitDepth);
+    m_refViewPortYuvs[i]->dump(fileName, bd, bAppend);
+
+    bd.recon[CHANNEL_TYPE_LUMA] =bd.recon[CHANNEL_TYPE_CHROMA] = m_iViewPortBitDepth;
+    sprintf(fileName, "rec_viewport%d_%dx%d_BD%d.yuv", i, m_viewPortPSNRParam.iViewPortWidth, m_viewPortPSNRParam.iViewPortHeight, m_iViewPortBitDepth);
+    m_recViewPortYuvs[i]->dump(fileName, bd, bAppend);
+  }
+}
+#endif
+
+/**
+ * \brief evaluate all viewports of the current source and reconstructed geometries and accumulate the results;
+ */
+Void TViewPortPSNR::xCalculateViewPorts(Double *pdFramePSNR, Double *pdFrameMSE)
+{
+  //pad the sources once; the viewport conversions then only read them;
+  m_pRefGeometry->spherePadding();
+  m_pRecGeometry->spherePadding();
+
+  std::function<Void(Int)> viewPortJob = [&](Int i)
+  {
+    Double *dPSNR = pdFramePSNR + i*MAX_NUM_COMPONENT;
+    Double *dMSE = pdFrameMSE + i*MAX_NUM_COMPONENT;
+    xCalculateViewPortPSNR(i, dPSNR, dMSE);
+    //added frame based metrics;
+    for(Int j=0; j<MAX_NUM_COMPONENT; j++)
+    {
+       m_pdPSNRSum[i][j] += dPSNR[j];
+       m_pdMSESum[i][j] += dMSE[j];
+    }
+  };
+  Int iNumOfViewPorts = getNumViewPorts();
+  if(m_pcThreadPool)
+    m_pcThreadPool->parallelFor(iNumOfViewPorts, viewPortJob);
+  else
+  {
+    for(Int i=0; i<iNumOfViewPorts; i++)
+      viewPortJob(i);
+  }
+}
+#endif
+
 Void TViewPortPSNR::calculateCombinedValues(Int vpIdx, UInt uiNumPics, Double &PSNRyuv, Double &MSEyuv)
 {
   MSEyuv    = 0;
@@ -237,6 +399,40 @@ Void TViewPortPSNR::calculateCombinedValues(Int vpIdx, UInt uiNumPics, Double &P
   PSNRyuv = (MSEyuv==0 ? 999.99 : 10*log10((maxval*maxval)/MSEyuv));
 }
 
+#if SVIDEO_ASYNC_METRICS
+Void TViewPortPSNR::xCalculatePSNR( TComPic* pcPic,  Double* pdPSNR)
+{
+  if(!m_viewPortPSNRParam.bViewPortPSNREnabled)
+    return;
+
+  std::vector<Double> dPSNR(getNumViewPorts()*MAX_NUM_COMPONENT), dMSE(getNumViewPorts()*MAX_NUM_COMPONENT);
+  xCalculatePSNR(pcPic->getPicYuvRec(), pcPic->getPOC(), &dPSNR[0], &dMSE[0]);
+  printFramePSNR(&dPSNR[0], &dMSE[0]);
+}
+
+Void TViewPortPSNR::printFramePSNR( const Double* pdPSNR, const Double* pdMSE)
+{
+#if SVIDEO_VIEWPORT_PSNR_REPORT_PER_FRAME
+  for(Int i=0; i<getNumViewPorts(); i++)
+  {
+    const Double *dPSNR = pdPSNR + i*MAX_NUM_COMPONENT;
+    const Double *dMSE = pdMSE + i*MAX_NUM_COMPONENT;
+    printf("\nVP%d_PSNR|MSE: %.4lf %.4lf %.4lf %.4lf %.4lf %.4lf", i, dPSNR[0], dPSNR[1], dPSNR[2], dMSE[0], dMSE[1], dMSE[2]);
+  }
+#endif
+}
+
+/**
+ * \brief calculate and accumulate the viewport metrics of one frame without printing; it touches no encoder state and may run on a metric thread;
+ */
+Void TViewPortPSNR::xCalculatePSNR( TComPicYuv* pRecPicYuv, Int iPOC, Double* pdFramePSNR, Double* pdFrameMSE)
+{
+  Int iDeltaFrames = iPOC*m_temporalSubsampleRatio - m_iLastFrmPOC;
+  Int aiPad[2]={0,0};
+  m_pcTVideoIOYuvInputFile->skipFrames(iDeltaFrames, m_iInputWidth, m_iInputHeight, m_inputChromaFomat);
+  m_pcTVideoIOYuvInputFile->read(NULL, m_pcOrgPicYuv, IPCOLOURSPACE_UNCHANGED, aiPad, m_inputChromaFomat, false );
+  m_iLastFrmPOC = iPOC*m_temporalSubsampleRatio+1;
+#else
 Void TViewPortPSNR::xCalculatePSNR( TComPic* pcPic,  Double* pdPSNR)
 {
   if(!m_viewPortPSNRParam.bViewPortPSNREnabled)
@@ -247,21 +443,44 @@ Void TViewPortPSNR::xCalculatePSNR( TComPic* pcPic,  Double* pdPSNR)
   m_pcTVideoIOYuvInputFile->skipFrames(iDeltaFrames, m_iInputWidth, m_iInputHeight, m_inputChromaFomat);
   m_pcTVideoIOYuvInputFile->read(NULL, m_pcOrgPicYuv, IPCOLOURSPACE_UNCHANGED, aiPad, m_inputChromaFomat, false );
   m_iLastFrmPOC = pcPic->getPOC()*m_temporalSubsampleRatio+1;
-
-  Int iNumOfViewPorts = (Int)m_viewPortPSNRParam.viewPortSettingsList.size(); 
+#endif
 
   if((m_pRefGeometry->getType() == SVIDEO_OCTAHEDRON || m_pRefGeometry->getType() == SVIDEO_ICOSAHEDRON) && m_pRefGeometry->getSVideoInfo()->iCompactFPStructure) 
     m_pRefGeometry->compactFramePackConvertYuv(m_pcOrgPicYuv);
   else
     m_pRefGeometry->convertYuv(m_pcOrgPicYuv);
 
+#if !SVIDEO_ASYNC_METRICS
   TComPicYuv *pRecPicYuv = pcPic->getPicYuvRec();
+#endif
   if((m_pRecGeometry->getType() == SVIDEO_OCTAHEDRON || m_pRecGeometry->getType() == SVIDEO_ICOSAHEDRON) && m_pRecGeometry->getSVideoInfo()->iCompactFPStructure) 
     m_pRecGeometry->compactFramePackConvertYuv(pRecPicYuv);
   else
     m_pRecGeometry->convertYuv(pRecPicYuv);
 
-  for(Int i=0; i<iNumOfViewPorts; i++)
+#if SVIDEO_VIEWPORT_PSNR_MT
+#if SVIDEO_ASYNC_METRICS
+  xCalculateViewPorts(pdFramePSNR, pdFrameMSE);
+#if SVIDEO_VIEWPORT_OUTPUT
+  xDumpViewPorts(iPOC!=0);
+#endif
+#else
+  std::vector<Double> dFramePSNR(getNumViewPorts()*MAX_NUM_COMPONENT), dFrameMSE(getNumViewPorts()*MAX_NUM_COMPONENT);
+  xCalculateViewPorts(&dFramePSNR[0], &dFrameMSE[0]);
+#if SVIDEO_VIEWPORT_OUTPUT
+  xDumpViewPorts(pcPic->getPOC()!=0);
+#endif
+#if SVIDEO_VIEWPORT_PSNR_REPORT_PER_FRAME
+  for(Int i=0; i<getNumViewPorts(); i++)
+  {
+    const Double *dPSNR = &dFramePSNR[i*MAX_NUM_COMPONENT];
+    const Double *dMSE = &dFrameMSE[i*MAX_NUM_COMPONENT];
+    printf("\nVP%d_PSNR|MSE: %.4lf %.4lf %.4lf %.4lf %.4lf %.4lf", i, dPSNR[0], dPSNR[1], dPSNR[2], dMSE[0], dMSE[1], dMSE[2]);
+  }
+#endif
+#endif
+#else
+  for(Int i=0; i<getNumViewPorts(); i++)
   {
     Double dPSNR[MAX_NUM_COMPONENT];
     Double dMSE[MAX_NUM_COMPONENT];
@@ -287,22 +506,35 @@ Void TViewPortPSNR::xCalculatePSNR( TComPic* pcPic,  Double* pdPSNR)
     {
        m_pdPSNRSum[i][j] += dPSNR[j];
        m_pdMSESum[i][j] += dMSE[j];
+#if SVIDEO_ASYNC_METRICS
+       pdFramePSNR[i*MAX_NUM_COMPONENT+j] = dPSNR[j];
+       pdFrameMSE[i*MAX_NUM_COMPONENT+j] = dMSE[j];
+#endif
     }
 #if SVIDEO_VIEWPORT_OUTPUT //the order is encoding order;
     Char fileName[256];
     BitDepths bd;
     bd.recon[CHANNEL_TYPE_LUMA] =bd.recon[CHANNEL_TYPE_CHROMA] = m_iRefBitDepth;
     sprintf(fileName, "ref_viewport%d_%dx%d_BD%d.yuv", i, m_viewPortPSNRParam.iViewPortWidth, m_viewPortPSNRParam.iViewPortHeight, m_iRefBitDepth);
+#if SVIDEO_ASYNC_METRICS
+    m_pRefViewPortYuv->dump(fileName, bd, iPOC!=0);
+#else
     m_pRefViewPortYuv->dump(fileName, bd, pcPic->getPOC()!=0);
+#endif
     
     bd.recon[CHANNEL_TYPE_LUMA] =bd.recon[CHANNEL_TYPE_CHROMA] = m_iViewPortBitDepth;
     sprintf(fileName, "rec_viewport%d_%dx%d_BD%d.yuv", i, m_viewPortPSNRParam.iViewPortWidth, m_viewPortPSNRParam.iViewPortHeight, m_iViewPortBitDepth);
+#if SVIDEO_ASYNC_METRICS
+    m_pRecViewPortYuv->dump(fileName, bd, iPOC!=0);
+#else
     m_pRecViewPortYuv->dump(fileName, bd, pcPic->getPOC()!=0);
 #endif
-#if SVIDEO_VIEWPORT_PSNR_REPORT_PER_FRAME
+#endif
+#if SVIDEO_VIEWPORT_PSNR_REPORT_PER_FRAME && !SVIDEO_ASYNC_METRICS
     printf("\nVP%d_PSNR|MSE: %.4lf %.4lf %.4lf %.4lf %.4lf %.4lf", i, dPSNR[0], dPSNR[1], dPSNR[2], dMSE[0], dMSE[1], dMSE[2]);
 #endif
   }
+#endif
 }
 
 Void TViewPortPSNR::printSummary(UInt uiNumPics)
@@ -72,14 +72,38 @@ private:
   Int          m_iLastFrmPOC;
   UInt         m_temporalSubsampleRatio;
 
+#if SVIDEO_VIEWPORT_PSNR_MT
+  TComThreadPool *m_pcThreadPool;             //not owned; NULL: serial;
+  Bool         m_bFacePSNR;                   //PSNR from the viewport faces, no viewport pictures;
+  std::vector<TComPicYuv*> m_refViewPortYuvs; //[viewport], only if !m_bFacePSNR;
+  std::vector<TComPicYuv*> m_recViewPortYuvs;
+#endif
+
   Void xCalculatePSNRInternal(TComPicYuv *pcOrgPicYuv, TComPicYuv *pcPicD, Double *pdPSNR, Double *pdMSE);
+#if SVIDEO_VIEWPORT_PSNR_MT
+  Void xCalculateFacePSNR(TGeometry *pRefViewPort, TGeometry *pRecViewPort, Double *pdPSNR, Double *pdMSE);
+  Void xCalculateViewPortPSNR(Int iViewPort, Double *pdPSNR, Double *pdMSE);
+  Void xCalculateViewPorts(Double *pdFramePSNR, Double *pdFrameMSE);
+#if SVIDEO_VIEWPORT_OUTPUT
+  Void xDumpViewPorts(Bool bAppend);
+#endif
+#endif
   Void calculateCombinedValues(Int vpIdx, UInt uiNumPics, Double &PSNRyuv, Double &MSEyuv);
 public:
   TViewPortPSNR();
   virtual ~TViewPortPSNR();
   Void init(SVideoInfo& sRefVideoInfo, SVideoInfo& sRecVideoInfo, InputGeoParam *pInGeoParam, ViewPortPSNRParam& param, TVideoIOYuv& yuvInputFile, Int iInputWidth, Int iInputHeight, UInt tempSubsampleRatio);  
   Void xCalculatePSNR( TComPic* pcPic,  Double* pdPSNR);
+#if SVIDEO_ASYNC_METRICS
+  //per-frame PSNR and MSE of every viewport, [viewport*MAX_NUM_COMPONENT+comp];
+  Void xCalculatePSNR( TComPicYuv* pRecPicYuv, Int iPOC, Double* pdPSNR, Double* pdMSE);
+  Void printFramePSNR( const Double* pdPSNR, const Double* pdMSE);
+  Int  getNumViewPorts() { return (Int)m_viewPortPSNRParam.viewPortSettingsList.size(); }
+#endif
   Bool isEnabled() { return m_viewPortPSNRParam.bViewPortPSNREnabled; }
+#if SVIDEO_VIEWPORT_PSNR_MT
+  Void setThreadPool(TComThreadPool *pcThreadPool) { m_pcThreadPool = pcThreadPool; }
+#endif
   Void printSummary(UInt uiNumPics);
 };
 
@@ -36,6 +36,9 @@
 */
 
 #include "TWSPSNRMetricCalc.h"
+#if SVIDEO_SIMD_WSPSNR
+#include "../TLibCommon/TComSimd.h"
+#endif
 
 #if SVIDEO_WSPSNR
 
@@ -56,6 +59,9 @@ TWSPSNRMetric::TWSPSNRMetric()
 , m_codingGeoType(0)
 , m_iCodingFaceWidth(0)
 , m_iCodingFaceHeight(0)
+#if SVIDEO_WSPSNR_SPANS
+, m_pcThreadPool(NULL)
+#endif
 #if SVIDEO_WSPSNR_E2E
 , m_pcTVideoIOYuvInputFile(NULL)
 , m_pRefGeometry(NULL)
@@ -67,6 +73,11 @@ TWSPSNRMetric::TWSPSNRMetric()
 #endif
 {
   m_dWSPSNR[0] = m_dWSPSNR[1] = m_dWSPSNR[2] = 0;
+#if SVIDEO_WSPSNR_SPANS
+  memset(m_dWeightSum, 0, sizeof(m_dWeightSum));
+  memset(m_iSpanWidth, 0, sizeof(m_iSpanWidth));
+  memset(m_iSpanHeight, 0, sizeof(m_iSpanHeight));
+#endif
 }
 
 TWSPSNRMetric::~TWSPSNRMetric()
@@ -855,8 +866,311 @@ void TWSPSNRMetric::createTable(TComPicYuv* pcPicD, TGeometry *pcCodingGeomtry)
     printf("WS-PSNR is not support for this format: GeoType:%d, FramePackingType:%d!\n", pcCodingGeomtry->getType(), pCodingSVideoInfo->iCompactFPStructure); 
     assert(!"Checking configruation parameters!\n");
   }
+#if SVIDEO_WSPSNR_SPANS
+  initSpans(pcPicD);
+#endif
+}
+
+#if SVIDEO_WSPSNR_SPANS
+/**
+ * \brief append the runs of non-zero weight of [x, x+iNum) of the current row;
+ */
+Void TWSPSNRMetric::addSpans(Int chan, Int x, Int iNum, const Double *pWeight)
+{
+  Int k = 0;
+  while(k < iNum)
+  {
+    if(pWeight[k] == 0)
+    {
+      k++;
+      continue;
+    }
+    WSPSNRSpan span = { x+k, 0, 0, pWeight+k };
+    while(k < iNum && pWeight[k] != 0)
+    {
+      span.iNum++;
+      k++;
+    }
+    m_spans[chan].push_back(span);
+  }
+}
+
+/**
+ * \brief describe the weight of every sample of the packed frame by spans, so that the per-frame kernel does not depend on the geometry;
+ */
+Void TWSPSNRMetric::initSpans(TComPicYuv* pcPicD)
+{
+  for(Int chan=0; chan<pcPicD->getNumberValidComponents(); chan++)
+  {
+    const ComponentID ch = ComponentID(chan);
+    const Int iWidth  = pcPicD->getWidth (ch);
+    const Int iHeight = pcPicD->getHeight(ch);
+    const Int iFaceWidth  = m_iCodingFaceWidth >> pcPicD->getComponentScaleX(ch);
+    const Int iFaceHeight = m_iCodingFaceHeight >> pcPicD->getComponentScaleY(ch);
+
+    m_iSpanWidth[chan] = iWidth;
+    m_iSpanHeight[chan] = iHeight;
+    m_spans[chan].clear();
+    m_rowSpans[chan].assign(iHeight+1, 0);
+    m_rowSSD[chan].assign(iHeight, 0);
+
+    for(Int y = 0; y < iHeight; y++)
+    {
+      m_rowSpans[chan][y] = (Int)m_spans[chan].size();
+      if(m_codingGeoType == SVIDEO_EQUIRECT)
+      {
+        Double fWeight = chan? m_fErpWeight_C[y] : m_fErpWeight_Y[y];
+        if(fWeight != 0)
+        {
+          WSPSNRSpan span = { 0, iWidth, fWeight, NULL };
+          m_spans[chan].push_back(span);
+        }
+      }
+      else if(m_codingGeoType == SVIDEO_CUBEMAP)
+      {
+        //the 4x3 packing has no faces right of the first column in the top and bottom rows;
+        Int xEnd = (iWidth/4 == iHeight/3 && (y < iHeight/3 || y >= 2*iHeight/3))? iWidth/4 : iWidth;
+        const Double *pFaceRow = (chan? m_fCubeWeight_C : m_fCubeWeight_Y) + iFaceWidth*(y%iFaceHeight);
+        for(Int x = 0; x < xEnd; )
+        {
+          Int iNum = std::min(xEnd, (x/iFaceWidth+1)*iFaceWidth) - x;
+          addSpans(chan, x, iNum, pFaceRow + (x%iFaceWidth));
+          x += iNum;
+        }
+      }
+      else if(m_codingGeoType == SVIDEO_EQUALAREA)
+        addSpans(chan, 0, iWidth, (chan? m_fEapWeight_C : m_fEapWeight_Y) + y*iWidth);
+      else if(m_codingGeoType == SVIDEO_OCTAHEDRON)
+        addSpans(chan, 0, iWidth, (chan? m_fOctaWeight_C : m_fOctaWeight_Y) + y*iWidth);
+      else if(m_codingGeoType == SVIDEO_ICOSAHEDRON)
+        addSpans(chan, 0, iWidth, (chan? m_fIcoWeight_C : m_fIcoWeight_Y) + y*iWidth);
+      else
+      {
+        WSPSNRSpan span = { 0, iWidth, 1.0, NULL };
+        m_spans[chan].push_back(span);
+      }
+    }
+    m_rowSpans[chan][iHeight] = (Int)m_spans[chan].size();
+
+    //the weight sum does not depend on the pictures;
+    m_dWeightSum[chan] = 0;
+    for(Int r = 0; r < (Int)m_spans[chan].size(); r++)
+    {
+      const WSPSNRSpan& span = m_spans[chan][r];
+      for(Int k = 0; k < span.iNum; k++)
+      {
+        Double fWeight = span.pWeight? span.pWeight[k] : span.dWeight;
+        if(fWeight > 0)
+          m_dWeightSum[chan] += fWeight;
+      }
+    }
+  }
+}
+
+/**
+ * Weighted SSD of a span with a weight per sample: lane k%8 of every 8 samples accumulates in sample order, the lanes are
+ * summed as ((l0+l4)+(l2+l6))+((l1+l5)+(l3+l7)) and the last iNum%8 samples are added one by one. The AVX2 kernels keep
+ * this order, so they return the same Double as the C kernels; the SSD of a span with a constant weight is an exact integer.
+ */
+static inline Double sumWSSDLanes(const Double *dLane)
+{
+  return ((dLane[0]+dLane[4]) + (dLane[2]+dLane[6])) + ((dLane[1]+dLane[5]) + (dLane[3]+dLane[7]));
+}
+
+static inline Double weightedSSDTail(Double dSSD, const Pel *pO, const Pel *pR, const Double *pW, Int k, Int iNum, Int iOrgShift, Int iRecShift)
+{
+  for(; k < iNum; k++)
+  {
+    Intermediate_Int iDiff = (Intermediate_Int)( (pO[k]<<iOrgShift) - (pR[k]<<iRecShift) );
+    dSSD += iDiff * iDiff * pW[k];
+  }
+  return dSSD;
+}
+
+static Double weightedSSD(const Pel *pO, const Pel *pR, const Double *pW, Int iNum, Int iOrgShift, Int iRecShift)
+{
+  Double dLane[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  Int k = 0;
+  for(; k+8 <= iNum; k += 8)
+  {
+    for(Int j = 0; j < 8; j++)
+    {
+      Intermediate_Int iDiff = (Intermediate_Int)( (pO[k+j]<<iOrgShift) - (pR[k+j]<<iRecShift) );
+      dLane[j] += iDiff * iDiff * pW[k+j];
+    }
+  }
+  return weightedSSDTail(sumWSSDLanes(dLane), pO, pR, pW, k, iNum, iOrgShift, iRecShift);
+}
+
+static Int64 spanSSD(const Pel *pO, const Pel *pR, Int iNum, Int iOrgShift, Int iRecShift)
+{
+  Int64 iSSD = 0;
+  for(Int k = 0; k < iNum; k++)
+  {
+    Intermediate_Int iDiff = (Intermediate_Int)( (pO[k]<<iOrgShift) - (pR[k]<<iRecShift) );
+    iSSD += iDiff * iDiff;
+  }
+  return iSSD;
 }
 
+#if SVIDEO_FUSED_METRICS
+static Double weightedSum(const Intermediate_Int *pD, const Double *pW, Int iNum)
+{
+  Double dLane[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  Int k = 0;
+  for(; k+8 <= iNum; k += 8)
+  {
+    for(Int j = 0; j < 8; j++)
+      dLane[j] += pD[k+j] * pW[k+j];
+  }
+  Double dSum = sumWSSDLanes(dLane);
+  for(; k < iNum; k++)
+    dSum += pD[k] * pW[k];
+  return dSum;
+}
+#endif
+
+#if SVIDEO_SIMD_WSPSNR
+/// lanes 0-3 in vLo and 4-7 in vHi, summed in the order of sumWSSDLanes()
+SIMD_TARGET("avx2")
+static inline Double sumWSSDLanes_AVX2(__m256d vLo, __m256d vHi)
+{
+  const __m256d vSum = _mm256_add_pd(vLo, vHi);
+  const __m128d vHalf = _mm_add_pd(_mm256_castpd256_pd128(vSum), _mm256_extractf128_pd(vSum, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(vHalf, _mm_unpackhi_pd(vHalf, vHalf)));
+}
+
+/// squared differences of 8 samples as 32-bit integers
+SIMD_TARGET("avx2")
+static inline __m256i loadDiff2_AVX2(const Pel *pO, const Pel *pR, __m128i vOrgShift, __m128i vRecShift)
+{
+  const __m256i vDiff = _mm256_sub_epi32(_mm256_sll_epi32(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)pO)), vOrgShift),
+                                         _mm256_sll_epi32(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)pR)), vRecShift));
+  return _mm256_mullo_epi32(vDiff, vDiff);
+}
+
+SIMD_TARGET("avx2")
+static Double weightedSSD_AVX2(const Pel *pO, const Pel *pR, const Double *pW, Int iNum, Int iOrgShift, Int iRecShift)
+{
+  const __m128i vOrgShift = _mm_cvtsi32_si128(iOrgShift);
+  const __m128i vRecShift = _mm_cvtsi32_si128(iRecShift);
+  __m256d vLo = _mm256_setzero_pd();
+  __m256d vHi = _mm256_setzero_pd();
+  Int k = 0;
+  for(; k+8 <= iNum; k += 8)
+  {
+    const __m256i vDiff2 = loadDiff2_AVX2(pO+k, pR+k, vOrgShift, vRecShift);
+    vLo = _mm256_add_pd(vLo, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(vDiff2)), _mm256_loadu_pd(pW+k)));
+    vHi = _mm256_add_pd(vHi, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(vDiff2, 1)), _mm256_loadu_pd(pW+k+4)));
+  }
+  return weightedSSDTail(sumWSSDLanes_AVX2(vLo, vHi), pO, pR, pW, k, iNum, iOrgShift, iRecShift);
+}
+
+SIMD_TARGET("avx2")
+static Int64 spanSSD_AVX2(const Pel *pO, const Pel *pR, Int iNum, Int iOrgShift, Int iRecShift)
+{
+  const __m128i vOrgShift = _mm_cvtsi32_si128(iOrgShift);
+  const __m128i vRecShift = _mm_cvtsi32_si128(iRecShift);
+  __m256i vSum = _mm256_setzero_si256();
+  Int k = 0;
+  for(; k+8 <= iNum; k += 8)
+  {
+    const __m256i vDiff2 = loadDiff2_AVX2(pO+k, pR+k, vOrgShift, vRecShift);
+    vSum = _mm256_add_epi64(vSum, _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(vDiff2)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(vDiff2, 1))));
+  }
+  Int64 iSum[4];
+  _mm256_storeu_si256((__m256i*)iSum, vSum);
+  return (iSum[0] + iSum[1]) + (iSum[2] + iSum[3]) + spanSSD(pO+k, pR+k, iNum-k, iOrgShift, iRecShift);
+}
+
+#if SVIDEO_FUSED_METRICS
+SIMD_TARGET("avx2")
+static Double weightedSum_AVX2(const Intermediate_Int *pD, const Double *pW, Int iNum)
+{
+  __m256d vLo = _mm256_setzero_pd();
+  __m256d vHi = _mm256_setzero_pd();
+  Int k = 0;
+  for(; k+8 <= iNum; k += 8)
+  {
+    vLo = _mm256_add_pd(vLo, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(pD+k))), _mm256_loadu_pd(pW+k)));
+    vHi = _mm256_add_pd(vHi, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(pD+k+4))), _mm256_loadu_pd(pW+k+4)));
+  }
+  Double dSum = sumWSSDLanes_AVX2(vLo, vHi);
+  for(; k < iNum; k++)
+    dSum += pD[k] * pW[k];
+  return dSum;
+}
+#endif
+#endif
+
+Double TWSPSNRMetric::calcSpanWSSD(const WSPSNRSpan& span, const Pel *pOrg, const Pel *pRec, Int iOrgShift, Int iRecShift)
+{
+  const Pel *pO = pOrg + span.x;
+  const Pel *pR = pRec + span.x;
+#if SVIDEO_SIMD_WSPSNR
+  if(getSimdLevel() >= SIMD_AVX2)
+    return span.pWeight? weightedSSD_AVX2(pO, pR, span.pWeight, span.iNum, iOrgShift, iRecShift) : spanSSD_AVX2(pO, pR, span.iNum, iOrgShift, iRecShift) * span.dWeight;
+#endif
+  //constant weight: integer SSD of the span, weighted once;
+  return span.pWeight? weightedSSD(pO, pR, span.pWeight, span.iNum, iOrgShift, iRecShift) : spanSSD(pO, pR, span.iNum, iOrgShift, iRecShift) * span.dWeight;
+}
+
+Double TWSPSNRMetric::xCalcRowWSSD(Int chan, Int y, const Pel *pOrg, const Pel *pRec, Int iOrgShift, Int iRecShift)
+{
+  Double dSSD = 0;
+  for(Int r = m_rowSpans[chan][y]; r < m_rowSpans[chan][y+1]; r++)
+    dSSD += calcSpanWSSD(m_spans[chan][r], pOrg, pRec, iOrgShift, iRecShift);
+  return dSSD;
+}
+#endif
+
+#if SVIDEO_FUSED_METRICS
+/**
+ * \brief same accumulation as calcSpanWSSD(), the span is given by its squared differences;
+ */
+Double TWSPSNRMetric::calcSpanWSSD(const WSPSNRSpan& span, const Intermediate_Int *pDiff2)
+{
+  const Intermediate_Int *pD = pDiff2 + span.x;
+  if(span.pWeight)
+  {
+#if SVIDEO_SIMD_WSPSNR
+    if(getSimdLevel() >= SIMD_AVX2)
+      return weightedSum_AVX2(pD, span.pWeight, span.iNum);
+#endif
+    return weightedSum(pD, span.pWeight, span.iNum);
+  }
+  Int64 iSSD = 0;
+  for(Int k = 0; k < span.iNum; k++)
+  {
+    iSSD += pD[k];
+  }
+  return iSSD * span.dWeight;
+}
+
+Void TWSPSNRMetric::xAddRowSSD(Int chan, Int y, const Intermediate_Int *pDiff2)
+{
+  Double dSSD = 0;
+  for(Int r = m_rowSpans[chan][y]; r < m_rowSpans[chan][y+1]; r++)
+    dSSD += calcSpanWSSD(m_spans[chan][r], pDiff2);
+  m_rowSSD[chan][y] = dSSD;
+}
+
+Void TWSPSNRMetric::xSetWSPSNR(Int iNumComp)
+{
+  memset(m_dWSPSNR, 0, sizeof(Double)*3);
+  for(Int chan=0; chan<iNumComp; chan++)
+  {
+    const ComponentID ch = ComponentID(chan);
+    Double SSDwpsnr = 0;
+    for(Int y = 0; y < m_iSpanHeight[chan]; y++)
+      SSDwpsnr += m_rowSSD[chan][y];
+    const Int iBitDepthForPSNRCalc = std::max(m_outputBitDepth[toChannelType(ch)], m_referenceBitDepth[toChannelType(ch)]);
+    const Int maxval = 255<<(iBitDepthForPSNRCalc-8) ;
+    m_dWSPSNR[ch] = ( SSDwpsnr ? 10.0 * log10( (maxval * maxval*m_dWeightSum[chan]) / (Double)SSDwpsnr ) : 999.99 );
+  }
+}
+#endif
+
 Void TWSPSNRMetric::xCalculateWSPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPicD )
 {
   Int iBitDepthForPSNRCalc[MAX_NUM_CHANNEL_TYPE];
@@ -870,6 +1184,47 @@ Void TWSPSNRMetric::xCalculateWSPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPic
   iOutputBitShift[CHANNEL_TYPE_CHROMA] = iBitDepthForPSNRCalc[CHANNEL_TYPE_CHROMA] - m_outputBitDepth[CHANNEL_TYPE_CHROMA];
 
   memset(m_dWSPSNR, 0, sizeof(Double)*3);
+#if SVIDEO_WSPSNR_SPANS
+  Int iNumComp = pcPicD->getNumberValidComponents();
+  for(Int chan=0; chan<iNumComp; chan++)
+  {
+    assert(pcPicD->getWidth(ComponentID(chan)) == m_iSpanWidth[chan] && pcPicD->getHeight(ComponentID(chan)) == m_iSpanHeight[chan]);
+  }
+  //row bands of all components; every row writes its own m_rowSSD entry, the rows are summed in order below;
+  std::vector<Int> bandStart(1, 0);
+  for(Int chan=0; chan<iNumComp; chan++)
+    bandStart.push_back(bandStart.back() + (m_iSpanHeight[chan]+S_ROW_BAND_HEIGHT-1)/S_ROW_BAND_HEIGHT);
+  std::function<Void(Int)> rowBand = [&](Int iBand)
+  {
+    Int chan = 0;
+    while(iBand >= bandStart[chan+1])
+      chan++;
+    const ComponentID ch = ComponentID(chan);
+    const Int iOrgStride = pcOrgPicYuv->getStride(ch);
+    const Int iRecStride = pcPicD->getStride(ch);
+    Int yStart = (iBand-bandStart[chan])*S_ROW_BAND_HEIGHT;
+    Int yEnd = std::min(yStart+S_ROW_BAND_HEIGHT, m_iSpanHeight[chan]);
+    for(Int y = yStart; y < yEnd; y++)
+      m_rowSSD[chan][y] = xCalcRowWSSD(chan, y, pcOrgPicYuv->getAddr(ch) + y*iOrgStride, pcPicD->getAddr(ch) + y*iRecStride, iReferenceBitShift[toChannelType(ch)], iOutputBitShift[toChannelType(ch)]);
+  };
+  if(m_pcThreadPool)
+    m_pcThreadPool->parallelFor(bandStart.back(), rowBand);
+  else
+  {
+    for(Int i=0; i<bandStart.back(); i++)
+      rowBand(i);
+  }
+
+  for(Int chan=0; chan<iNumComp; chan++)
+  {
+    const ComponentID ch = ComponentID(chan);
+    Double SSDwpsnr = 0;
+    for(Int y = 0; y < m_iSpanHeight[chan]; y++)
+      SSDwpsnr += m_rowSSD[chan][y];
+    const Int maxval = 255<<(iBitDepthForPSNRCalc[toChannelType(ch)]-8) ;
+    m_dWSPSNR[ch] = ( SSDwpsnr ? 10.0 * log10( (maxval * maxval*m_dWeightSum[chan]) / (Double)SSDwpsnr ) : 999.99 );
+  }
+#else
   TComPicYuv &picd=*pcPicD;
   //Double SSDspsnr[3]={0, 0 ,0};
   //ChromaFormat chromaFormat = pcPicD->getChromaFormat();
@@ -981,6 +1336,7 @@ Void TWSPSNRMetric::xCalculateWSPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPic
 
     m_dWSPSNR[ch]         = ( SSDwpsnr ? 10.0 * log10( (maxval * maxval*fWeightSum) / (Double)SSDwpsnr ) : 999.99 );
   }
+#endif
 
 }
 
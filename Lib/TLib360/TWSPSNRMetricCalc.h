@@ -45,6 +45,17 @@
 
 #if SVIDEO_WSPSNR
 
+#if SVIDEO_WSPSNR_SPANS
+//horizontal run of samples with non-zero weight;
+struct WSPSNRSpan
+{
+  Int           x;
+  Int           iNum;
+  Double        dWeight;      //weight of every sample if pWeight is NULL;
+  const Double *pWeight;      //weights of the samples, owned by the weight tables;
+};
+#endif
+
 class TWSPSNRMetric
 {
 private:
@@ -69,6 +80,18 @@ private:
   Int     m_iCodingFaceWidth;
   Int     m_iCodingFaceHeight;
   Int     m_iChromaSampleLocType;
+#if SVIDEO_WSPSNR_SPANS
+  std::vector<WSPSNRSpan> m_spans[MAX_NUM_COMPONENT];
+  std::vector<Int>        m_rowSpans[MAX_NUM_COMPONENT];   //[y]: first span of row y; the last entry is the number of spans;
+  std::vector<Double>     m_rowSSD[MAX_NUM_COMPONENT];     //[y]: weighted SSD of row y;
+  Double                  m_dWeightSum[MAX_NUM_COMPONENT];
+  Int                     m_iSpanWidth[MAX_NUM_COMPONENT];
+  Int                     m_iSpanHeight[MAX_NUM_COMPONENT];
+  TComThreadPool         *m_pcThreadPool;                  //not owned; NULL: serial;
+  Void    initSpans(TComPicYuv* pcPicD);
+  Void    addSpans(Int chan, Int x, Int iNum, const Double *pWeight);
+  Double  xCalcRowWSSD(Int chan, Int y, const Pel *pOrg, const Pel *pRec, Int iOrgShift, Int iRecShift);
+#endif
 #if SVIDEO_WSPSNR_E2E
   //for E2E WS-PSNR calculation;
   TVideoIOYuv *m_pcTVideoIOYuvInputFile;  //note: reference;
@@ -95,8 +118,19 @@ public:
   Void    xCalculateE2EWSPSNR(TComPicYuv *pcPicD, Int iPOC);
 #endif
   Double* getWSPSNR() {return m_dWSPSNR;}
+#if SVIDEO_WSPSNR_SPANS
+  Void    setThreadPool(TComThreadPool *pcThreadPool) { m_pcThreadPool = pcThreadPool; }
+  static Double calcSpanWSSD(const WSPSNRSpan& span, const Pel *pOrg, const Pel *pRec, Int iOrgShift, Int iRecShift);   //weighted SSD of a span of the row, at the current SIMD level;
+#endif
+#if SVIDEO_FUSED_METRICS
+  static Double calcSpanWSSD(const WSPSNRSpan& span, const Intermediate_Int *pDiff2);   //same from the squared differences of the row;
+#endif
   Void    createTable(TComPicYuv* pcPicD, TGeometry *pcCodingGeomtry);
   Void    xCalculateWSPSNR( TComPicYuv* pcOrgPicYuv, TComPicYuv* pcPicD );
+#if SVIDEO_FUSED_METRICS
+  Void    xAddRowSSD(Int chan, Int y, const Intermediate_Int *pDiff2);   //weighted SSD of row y from its squared differences;
+  Void    xSetWSPSNR(Int iNumComp);                                   //WS-PSNR once every row was added;
+#endif
 
   //inline Int round(POSType t) { return (Int)(t+ (t>=0? 0.5 :-0.5)); }; 
 };
@@ -45,6 +45,9 @@
 #include <assert.h>
 
 #include "TComChromaFormat.h"
+#if SIMD_INTERPOLATION_FILTER
+#include "TComSimd.h"
+#endif
 
 
 //! \ingroup TLibCommon
@@ -153,6 +156,129 @@ Void TComInterpolationFilter::filterCopy(Int bitDepth, const Pel *src, Int srcSt
   }
 }
 
+#if SIMD_INTERPOLATION_FILTER
+// ====================================================================================================================
+// SIMD filters
+// ====================================================================================================================
+
+// The taps are applied in pairs with madd on interleaved samples, which gives the exact 32-bit sums of the C code.
+// For the horizontal filter the samples of tap k are the row loaded at offset k, for the vertical one the row k
+// lines below. The results are truncated to 16 bits like the Pel conversion of the C code before clipping.
+
+SIMD_TARGET("sse4.1")
+static inline __m128i xFilterTaps_SSE41( const __m128i vSum, const __m128i vShift )
+{
+  const __m128i vVal = _mm_sra_epi32( vSum, vShift );
+  return _mm_srai_epi32( _mm_slli_epi32( vVal, 16 ), 16 );
+}
+
+/// filters the first width & ~7 columns, returns their number
+template<Int N, Bool isVertical, Bool isLast>
+SIMD_TARGET("sse4.1")
+static Int xFilter_SSE41( const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, TFilterCoeff const *coeff, Int offset, Int shift, Pel maxVal )
+{
+  const Int cStride   = ( isVertical ) ? srcStride : 1;
+  const Int simdWidth = width & ~7;
+  if ( simdWidth == 0 )
+  {
+    return 0;
+  }
+
+  __m128i vCoeff[N/2];
+  for ( Int k = 0; k < N; k += 2 )
+  {
+    vCoeff[k>>1] = _mm_set1_epi32( Int( UInt( UShort( coeff[k] ) ) | ( UInt( UShort( coeff[k+1] ) ) << 16 ) ) );
+  }
+  const __m128i vOffset = _mm_set1_epi32( offset );
+  const __m128i vShift  = _mm_cvtsi32_si128( shift );
+  const __m128i vMax    = _mm_set1_epi16( maxVal );
+
+  for ( Int row = 0; row < height; row++ )
+  {
+    for ( Int col = 0; col < simdWidth; col += 8 )
+    {
+      __m128i vSumLo = vOffset;
+      __m128i vSumHi = vOffset;
+      for ( Int k = 0; k < N; k += 2 )
+      {
+        const __m128i vSrc0 = _mm_loadu_si128( (const __m128i*)&src[col +  k      * cStride] );
+        const __m128i vSrc1 = _mm_loadu_si128( (const __m128i*)&src[col + ( k+1 ) * cStride] );
+        vSumLo = _mm_add_epi32( vSumLo, _mm_madd_epi16( _mm_unpacklo_epi16( vSrc0, vSrc1 ), vCoeff[k>>1] ) );
+        vSumHi = _mm_add_epi32( vSumHi, _mm_madd_epi16( _mm_unpackhi_epi16( vSrc0, vSrc1 ), vCoeff[k>>1] ) );
+      }
+      __m128i vVal = _mm_packs_epi32( xFilterTaps_SSE41( vSumLo, vShift ), xFilterTaps_SSE41( vSumHi, vShift ) );
+      if ( isLast )
+      {
+        vVal = _mm_min_epi16( _mm_max_epi16( vVal, _mm_setzero_si128() ), vMax );
+      }
+      _mm_storeu_si128( (__m128i*)&dst[col], vVal );
+    }
+
+    src += srcStride;
+    dst += dstStride;
+  }
+
+  return simdWidth;
+}
+
+SIMD_TARGET("avx2")
+static inline __m256i xFilterTaps_AVX2( const __m256i vSum, const __m128i vShift )
+{
+  const __m256i vVal = _mm256_sra_epi32( vSum, vShift );
+  return _mm256_srai_epi32( _mm256_slli_epi32( vVal, 16 ), 16 );
+}
+
+/// filters the first width & ~15 columns, returns their number
+template<Int N, Bool isVertical, Bool isLast>
+SIMD_TARGET("avx2")
+static Int xFilter_AVX2( const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, TFilterCoeff const *coeff, Int offset, Int shift, Pel maxVal )
+{
+  const Int cStride   = ( isVertical ) ? srcStride : 1;
+  const Int simdWidth = width & ~15;
+  if ( simdWidth == 0 )
+  {
+    return 0;
+  }
+
+  __m256i vCoeff[N/2];
+  for ( Int k = 0; k < N; k += 2 )
+  {
+    vCoeff[k>>1] = _mm256_set1_epi32( Int( UInt( UShort( coeff[k] ) ) | ( UInt( UShort( coeff[k+1] ) ) << 16 ) ) );
+  }
+  const __m256i vOffset = _mm256_set1_epi32( offset );
+  const __m128i vShift  = _mm_cvtsi32_si128( shift );
+  const __m256i vMax    = _mm256_set1_epi16( maxVal );
+
+  for ( Int row = 0; row < height; row++ )
+  {
+    for ( Int col = 0; col < simdWidth; col += 16 )
+    {
+      // the in-lane unpacks and packs keep the column order
+      __m256i vSumLo = vOffset;
+      __m256i vSumHi = vOffset;
+      for ( Int k = 0; k < N; k += 2 )
+      {
+        const __m256i vSrc0 = _mm256_loadu_si256( (const __m256i*)&src[col +  k      * cStride] );
+        const __m256i vSrc1 = _mm256_loadu_si256( (const __m256i*)&src[col + ( k+1 ) * cStride] );
+        vSumLo = _mm256_add_epi32( vSumLo, _mm256_madd_epi16( _mm256_unpacklo_epi16( vSrc0, vSrc1 ), vCoeff[k>>1] ) );
+        vSumHi = _mm256_add_epi32( vSumHi, _mm256_madd_epi16( _mm256_unpackhi_epi16( vSrc0, vSrc1 ), vCoeff[k>>1] ) );
+      }
+      __m256i vVal = _mm256_packs_epi32( xFilterTaps_AVX2( vSumLo, vShift ), xFilterTaps_AVX2( vSumHi, vShift ) );
+      if ( isLast )
+      {
+        vVal = _mm256_min_epi16( _mm256_max_epi16( vVal, _mm256_setzero_si256() ), vMax );
+      }
+      _mm256_storeu_si256( (__m256i*)&dst[col], vVal );
+    }
+
+    src += srcStride;
+    dst += dstStride;
+  }
+
+  return simdWidth;
+}
+#endif
+
 /**
  * \brief Apply FIR filter to a block of samples
  *
@@ -218,6 +344,23 @@ Void TComInterpolationFilter::filter(Int bitDepth, Pel const *src, Int srcStride
     maxVal = 0;
   }
 
+#if SIMD_INTERPOLATION_FILTER
+  // the columns left over by the SIMD filters are done below
+  const SimdLevel simdLevel = getSimdLevel();
+  Int simdWidth = 0;
+  if ( simdLevel >= SIMD_AVX2 )
+  {
+    simdWidth = xFilter_AVX2<N, isVertical, isLast>( src, srcStride, dst, dstStride, width, height, coeff, offset, shift, maxVal );
+  }
+  if ( simdLevel >= SIMD_SSE41 )
+  {
+    simdWidth += xFilter_SSE41<N, isVertical, isLast>( src + simdWidth, srcStride, dst + simdWidth, dstStride, width - simdWidth, height, coeff, offset, shift, maxVal );
+  }
+  src   += simdWidth;
+  dst   += simdWidth;
+  width -= simdWidth;
+#endif
+
   for (row = 0; row < height; row++)
   {
     for (col = 0; col < width; col++)
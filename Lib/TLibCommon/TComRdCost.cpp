@@ -162,6 +162,82 @@ Void TComRdCost::init()
   m_afpDistortFunc[DF_HADS64 ] = TComRdCost::xGetHADs;
   m_afpDistortFunc[DF_HADS16N] = TComRdCost::xGetHADs;
 
+#if SIMD_DISTORTION
+  m_fpDistortFunc4             = NULL;
+
+  const SimdLevel simdLevel    = getSimdLevel();
+  if ( simdLevel >= SIMD_SSE41 )
+  {
+    m_afpDistortFunc[DF_SSE4   ] = TComRdCost::xGetSSE_SSE41<4>;
+    m_afpDistortFunc[DF_SSE8   ] = TComRdCost::xGetSSE_SSE41<8>;
+    m_afpDistortFunc[DF_SSE16  ] = TComRdCost::xGetSSE_SSE41<16>;
+    m_afpDistortFunc[DF_SSE32  ] = TComRdCost::xGetSSE_SSE41<32>;
+    m_afpDistortFunc[DF_SSE64  ] = TComRdCost::xGetSSE_SSE41<64>;
+    m_afpDistortFunc[DF_SSE16N ] = TComRdCost::xGetSSE_SSE41<0>;
+
+    m_afpDistortFunc[DF_SAD4   ] = TComRdCost::xGetSAD_SSE41<4>;
+    m_afpDistortFunc[DF_SAD8   ] = TComRdCost::xGetSAD_SSE41<8>;
+    m_afpDistortFunc[DF_SAD16  ] = TComRdCost::xGetSAD_SSE41<16>;
+    m_afpDistortFunc[DF_SAD32  ] = TComRdCost::xGetSAD_SSE41<32>;
+    m_afpDistortFunc[DF_SAD64  ] = TComRdCost::xGetSAD_SSE41<64>;
+    m_afpDistortFunc[DF_SAD16N ] = TComRdCost::xGetSAD_SSE41<0>;
+    m_afpDistortFunc[DF_SAD12  ] = TComRdCost::xGetSAD_SSE41<12>;
+    m_afpDistortFunc[DF_SAD24  ] = TComRdCost::xGetSAD_SSE41<24>;
+    m_afpDistortFunc[DF_SAD48  ] = TComRdCost::xGetSAD_SSE41<48>;
+
+    m_afpDistortFunc[DF_HADS4  ] = TComRdCost::xGetHADs_SSE41;
+    m_afpDistortFunc[DF_HADS8  ] = TComRdCost::xGetHADs_SSE41;
+    m_afpDistortFunc[DF_HADS16 ] = TComRdCost::xGetHADs_SSE41;
+    m_afpDistortFunc[DF_HADS32 ] = TComRdCost::xGetHADs_SSE41;
+    m_afpDistortFunc[DF_HADS64 ] = TComRdCost::xGetHADs_SSE41;
+    m_afpDistortFunc[DF_HADS16N] = TComRdCost::xGetHADs_SSE41;
+
+    m_fpDistortFunc4             = TComRdCost::xGetSAD4Cand_SSE41;
+  }
+  if ( simdLevel >= SIMD_AVX2 )
+  {
+    m_afpDistortFunc[DF_SSE16  ] = TComRdCost::xGetSSE_AVX2<16>;
+    m_afpDistortFunc[DF_SSE32  ] = TComRdCost::xGetSSE_AVX2<32>;
+    m_afpDistortFunc[DF_SSE64  ] = TComRdCost::xGetSSE_AVX2<64>;
+    m_afpDistortFunc[DF_SSE16N ] = TComRdCost::xGetSSE_AVX2<0>;
+
+    m_afpDistortFunc[DF_SAD16  ] = TComRdCost::xGetSAD_AVX2<16>;
+    m_afpDistortFunc[DF_SAD32  ] = TComRdCost::xGetSAD_AVX2<32>;
+    m_afpDistortFunc[DF_SAD64  ] = TComRdCost::xGetSAD_AVX2<64>;
+    m_afpDistortFunc[DF_SAD16N ] = TComRdCost::xGetSAD_AVX2<0>;
+    m_afpDistortFunc[DF_SAD24  ] = TComRdCost::xGetSAD_AVX2<24>;
+    m_afpDistortFunc[DF_SAD48  ] = TComRdCost::xGetSAD_AVX2<48>;
+
+    m_afpDistortFunc[DF_HADS8  ] = TComRdCost::xGetHADs_AVX2;
+    m_afpDistortFunc[DF_HADS16 ] = TComRdCost::xGetHADs_AVX2;
+    m_afpDistortFunc[DF_HADS32 ] = TComRdCost::xGetHADs_AVX2;
+    m_afpDistortFunc[DF_HADS64 ] = TComRdCost::xGetHADs_AVX2;
+    m_afpDistortFunc[DF_HADS16N] = TComRdCost::xGetHADs_AVX2;
+
+    m_fpDistortFunc4             = TComRdCost::xGetSAD4Cand_AVX2;
+  }
+  if ( simdLevel >= SIMD_AVX512 )
+  {
+    m_afpDistortFunc[DF_SSE32  ] = TComRdCost::xGetSSE_AVX512<32>;
+    m_afpDistortFunc[DF_SSE64  ] = TComRdCost::xGetSSE_AVX512<64>;
+    m_afpDistortFunc[DF_SSE16N ] = TComRdCost::xGetSSE_AVX512<0>;
+
+    m_afpDistortFunc[DF_SAD32  ] = TComRdCost::xGetSAD_AVX512<32>;
+    m_afpDistortFunc[DF_SAD64  ] = TComRdCost::xGetSAD_AVX512<64>;
+    m_afpDistortFunc[DF_SAD16N ] = TComRdCost::xGetSAD_AVX512<0>;
+    m_afpDistortFunc[DF_SAD48  ] = TComRdCost::xGetSAD_AVX512<48>;
+  }
+
+  // the SAD functions with step are the same as without
+  for ( Int i = DF_SAD4; i <= DF_SAD16N; i++ )
+  {
+    m_afpDistortFunc[DF_SADS + i - DF_SAD] = m_afpDistortFunc[i];
+  }
+  m_afpDistortFunc[DF_SADS12 ] = m_afpDistortFunc[DF_SAD12];
+  m_afpDistortFunc[DF_SADS24 ] = m_afpDistortFunc[DF_SAD24];
+  m_afpDistortFunc[DF_SADS48 ] = m_afpDistortFunc[DF_SAD48];
+#endif
+
   m_costMode                   = COST_STANDARD_LOSSY;
 
   m_motionLambda               = 0;
@@ -224,6 +300,9 @@ Void TComRdCost::setDistParam( const TComPattern* const pcPatternKey, const Pel*
   {
     rcDistParam.DistFunc = m_afpDistortFunc[DF_SAD48];
   }
+#if SIMD_DISTORTION
+  rcDistParam.DistFunc4 = rcDistParam.DistFunc != m_afpDistortFunc[DF_SAD] ? m_fpDistortFunc4 : NULL;
+#endif
 
   // initialize
   rcDistParam.iSubShift  = 0;
@@ -1494,4 +1573,779 @@ Distortion TComRdCost::xGetHADs( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
 }
 
+// ====================================================================================================================
+// SIMD distortion functions
+// ====================================================================================================================
+
+#if SIMD_DISTORTION
+
+// the differences are taken in 16 bits, which holds for sample, residual and bi-prediction search
+// target differences up to this bit depth
+static const Int SIMD_DISTORTION_MAX_BIT_DEPTH = 12;
+
+Distortion TComRdCost::xGetSADC( Int iWidth, DistParam* pcDtParam )
+{
+  switch ( iWidth )
+  {
+    case 4:  return xGetSAD4  ( pcDtParam );
+    case 8:  return xGetSAD8  ( pcDtParam );
+    case 12: return xGetSAD12 ( pcDtParam );
+    case 16: return xGetSAD16 ( pcDtParam );
+    case 24: return xGetSAD24 ( pcDtParam );
+    case 32: return xGetSAD32 ( pcDtParam );
+    case 48: return xGetSAD48 ( pcDtParam );
+    case 64: return xGetSAD64 ( pcDtParam );
+    default: return xGetSAD16N( pcDtParam );
+  }
+}
+
+Distortion TComRdCost::xGetSSEC( Int iWidth, DistParam* pcDtParam )
+{
+  switch ( iWidth )
+  {
+    case 4:  return xGetSSE4  ( pcDtParam );
+    case 8:  return xGetSSE8  ( pcDtParam );
+    case 16: return xGetSSE16 ( pcDtParam );
+    case 32: return xGetSSE32 ( pcDtParam );
+    case 64: return xGetSSE64 ( pcDtParam );
+    default: return xGetSSE16N( pcDtParam );
+  }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// row helpers, iCols is a multiple of 4; each level passes the columns it cannot fill to the level below
+// --------------------------------------------------------------------------------------------------------------------
+
+SIMD_TARGET("sse4.1")
+static inline UInt xHorSum_SSE41( __m128i vSum )
+{
+  vSum = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0x4e ) );
+  vSum = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0xb1 ) );
+  return UInt( _mm_cvtsi128_si32( vSum ) );
+}
+
+SIMD_TARGET("avx2")
+static inline UInt xHorSum_AVX2( __m256i vSum )
+{
+  return xHorSum_SSE41( _mm_add_epi32( _mm256_castsi256_si128( vSum ), _mm256_extracti128_si256( vSum, 1 ) ) );
+}
+
+SIMD_TARGET("avx512f,avx512bw")
+static inline UInt xHorSum_AVX512( __m512i vSum )
+{
+  // the zero-masked forms avoid the undefined pass-through operand of the unmasked intrinsics (-Wmaybe-uninitialized)
+  return xHorSum_AVX2( _mm256_add_epi32( _mm512_maskz_extracti64x4_epi64( 0xFF, vSum, 0 ), _mm512_maskz_extracti64x4_epi64( 0xFF, vSum, 1 ) ) );
+}
+
+SIMD_TARGET("sse4.1")
+static inline Void xSADRow_SSE41( const Pel* piOrg, const Pel* piCur, Int iCols, __m128i& vSum )
+{
+  const __m128i vOne = _mm_set1_epi16( 1 );
+  Int n = 0;
+  for ( ; n + 8 <= iCols; n += 8 )
+  {
+    const __m128i vDiff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)&piOrg[n] ), _mm_loadu_si128( (const __m128i*)&piCur[n] ) );
+    vSum = _mm_add_epi32( vSum, _mm_madd_epi16( _mm_abs_epi16( vDiff ), vOne ) );
+  }
+  if ( n < iCols )
+  {
+    const __m128i vDiff = _mm_sub_epi16( _mm_loadl_epi64( (const __m128i*)&piOrg[n] ), _mm_loadl_epi64( (const __m128i*)&piCur[n] ) );
+    vSum = _mm_add_epi32( vSum, _mm_madd_epi16( _mm_abs_epi16( vDiff ), vOne ) );
+  }
+}
+
+SIMD_TARGET("avx2")
+static inline Void xSADRow_AVX2( const Pel* piOrg, const Pel* piCur, Int iCols, __m256i& vSum, __m128i& vSumTail )
+{
+  const __m256i vOne = _mm256_set1_epi16( 1 );
+  Int n = 0;
+  for ( ; n + 16 <= iCols; n += 16 )
+  {
+    const __m256i vDiff = _mm256_sub_epi16( _mm256_loadu_si256( (const __m256i*)&piOrg[n] ), _mm256_loadu_si256( (const __m256i*)&piCur[n] ) );
+    vSum = _mm256_add_epi32( vSum, _mm256_madd_epi16( _mm256_abs_epi16( vDiff ), vOne ) );
+  }
+  if ( n < iCols )
+  {
+    xSADRow_SSE41( &piOrg[n], &piCur[n], iCols - n, vSumTail );
+  }
+}
+
+SIMD_TARGET("avx512f,avx512bw")
+static inline Void xSADRow_AVX512( const Pel* piOrg, const Pel* piCur, Int iCols, __m512i& vSum, __m256i& vSumTail, __m128i& vSumTail2 )
+{
+  const __m512i vOne = _mm512_set1_epi16( 1 );
+  Int n = 0;
+  for ( ; n + 32 <= iCols; n += 32 )
+  {
+    const __m512i vDiff = _mm512_sub_epi16( _mm512_loadu_si512( &piOrg[n] ), _mm512_loadu_si512( &piCur[n] ) );
+    vSum = _mm512_add_epi32( vSum, _mm512_madd_epi16( _mm512_abs_epi16( vDiff ), vOne ) );
+  }
+  if ( n < iCols )
+  {
+    xSADRow_AVX2( &piOrg[n], &piCur[n], iCols - n, vSumTail, vSumTail2 );
+  }
+}
+
+// squared differences, shifted one by one as in the C functions when bShift is set
+template<Bool bShift>
+SIMD_TARGET("sse4.1")
+static inline __m128i xSquare_SSE41( const __m128i vDiff, const __m128i vShift )
+{
+  if ( !bShift )
+  {
+    return _mm_madd_epi16( vDiff, vDiff );
+  }
+  const __m128i vLo = _mm_unpacklo_epi16( vDiff, _mm_setzero_si128() );
+  const __m128i vHi = _mm_unpackhi_epi16( vDiff, _mm_setzero_si128() );
+  return _mm_add_epi32( _mm_srl_epi32( _mm_madd_epi16( vLo, vLo ), vShift ), _mm_srl_epi32( _mm_madd_epi16( vHi, vHi ), vShift ) );
+}
+
+template<Bool bShift>
+SIMD_TARGET("avx2")
+static inline __m256i xSquare_AVX2( const __m256i vDiff, const __m128i vShift )
+{
+  if ( !bShift )
+  {
+    return _mm256_madd_epi16( vDiff, vDiff );
+  }
+  const __m256i vLo = _mm256_unpacklo_epi16( vDiff, _mm256_setzero_si256() );
+  const __m256i vHi = _mm256_unpackhi_epi16( vDiff, _mm256_setzero_si256() );
+  return _mm256_add_epi32( _mm256_srl_epi32( _mm256_madd_epi16( vLo, vLo ), vShift ), _mm256_srl_epi32( _mm256_madd_epi16( vHi, vHi ), vShift ) );
+}
+
+template<Bool bShift>
+SIMD_TARGET("avx512f,avx512bw")
+static inline __m512i xSquare_AVX512( const __m512i vDiff, const __m128i vShift )
+{
+  if ( !bShift )
+  {
+    return _mm512_madd_epi16( vDiff, vDiff );
+  }
+  const __m512i vLo = _mm512_unpacklo_epi16( vDiff, _mm512_setzero_si512() );
+  const __m512i vHi = _mm512_unpackhi_epi16( vDiff, _mm512_setzero_si512() );
+  return _mm512_add_epi32( _mm512_maskz_srl_epi32( 0xFFFF, _mm512_madd_epi16( vLo, vLo ), vShift ), _mm512_maskz_srl_epi32( 0xFFFF, _mm512_madd_epi16( vHi, vHi ), vShift ) );
+}
+
+template<Bool bShift>
+SIMD_TARGET("sse4.1")
+static inline Void xSSERow_SSE41( const Pel* piOrg, const Pel* piCur, Int iCols, const __m128i vShift, __m128i& vSum )
+{
+  Int n = 0;
+  for ( ; n + 8 <= iCols; n += 8 )
+  {
+    const __m128i vDiff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)&piOrg[n] ), _mm_loadu_si128( (const __m128i*)&piCur[n] ) );
+    vSum = _mm_add_epi32( vSum, xSquare_SSE41<bShift>( vDiff, vShift ) );
+  }
+  if ( n < iCols )
+  {
+    const __m128i vDiff = _mm_sub_epi16( _mm_loadl_epi64( (const __m128i*)&piOrg[n] ), _mm_loadl_epi64( (const __m128i*)&piCur[n] ) );
+    vSum = _mm_add_epi32( vSum, xSquare_SSE41<bShift>( vDiff, vShift ) );
+  }
+}
+
+template<Bool bShift>
+SIMD_TARGET("avx2")
+static inline Void xSSERow_AVX2( const Pel* piOrg, const Pel* piCur, Int iCols, const __m128i vShift, __m256i& vSum, __m128i& vSumTail )
+{
+  Int n = 0;
+  for ( ; n + 16 <= iCols; n += 16 )
+  {
+    const __m256i vDiff = _mm256_sub_epi16( _mm256_loadu_si256( (const __m256i*)&piOrg[n] ), _mm256_loadu_si256( (const __m256i*)&piCur[n] ) );
+    vSum = _mm256_add_epi32( vSum, xSquare_AVX2<bShift>( vDiff, vShift ) );
+  }
+  if ( n < iCols )
+  {
+    xSSERow_SSE41<bShift>( &piOrg[n], &piCur[n], iCols - n, vShift, vSumTail );
+  }
+}
+
+template<Bool bShift>
+SIMD_TARGET("avx512f,avx512bw")
+static inline Void xSSERow_AVX512( const Pel* piOrg, const Pel* piCur, Int iCols, const __m128i vShift, __m512i& vSum, __m256i& vSumTail, __m128i& vSumTail2 )
+{
+  Int n = 0;
+  for ( ; n + 32 <= iCols; n += 32 )
+  {
+    const __m512i vDiff = _mm512_sub_epi16( _mm512_loadu_si512( &piOrg[n] ), _mm512_loadu_si512( &piCur[n] ) );
+    vSum = _mm512_add_epi32( vSum, xSquare_AVX512<bShift>( vDiff, vShift ) );
+  }
+  if ( n < iCols )
+  {
+    xSSERow_AVX2<bShift>( &piOrg[n], &piCur[n], iCols - n, vShift, vSumTail, vSumTail2 );
+  }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// SAD
+// --------------------------------------------------------------------------------------------------------------------
+
+template<Int iWidth>
+SIMD_TARGET("sse4.1")
+Distortion TComRdCost::xGetSAD_SSE41( DistParam* pcDtParam )
+{
+  // the C 16N function does not support weighted prediction either
+  if ( ( iWidth != 0 && pcDtParam->bApplyWeight ) || pcDtParam->bitDepth > SIMD_DISTORTION_MAX_BIT_DEPTH )
+  {
+    return xGetSADC( iWidth, pcDtParam );
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iCols      = iWidth != 0 ? iWidth : pcDtParam->iCols;
+  Int        iRows      = pcDtParam->iRows;
+  const Int  iSubShift  = pcDtParam->iSubShift;
+  const Int  iSubStep   = ( 1 << iSubShift );
+  const Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+
+  __m128i vSum = _mm_setzero_si128();
+
+  for( ; iRows != 0; iRows-=iSubStep )
+  {
+    xSADRow_SSE41( piOrg, piCur, iCols, vSum );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  Distortion uiSum = xHorSum_SSE41( vSum );
+  uiSum <<= iSubShift;
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+}
+
+template<Int iWidth>
+SIMD_TARGET("avx2")
+Distortion TComRdCost::xGetSAD_AVX2( DistParam* pcDtParam )
+{
+  if ( ( iWidth != 0 && pcDtParam->bApplyWeight ) || pcDtParam->bitDepth > SIMD_DISTORTION_MAX_BIT_DEPTH )
+  {
+    return xGetSADC( iWidth, pcDtParam );
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iCols      = iWidth != 0 ? iWidth : pcDtParam->iCols;
+  Int        iRows      = pcDtParam->iRows;
+  const Int  iSubShift  = pcDtParam->iSubShift;
+  const Int  iSubStep   = ( 1 << iSubShift );
+  const Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+
+  __m256i vSum     = _mm256_setzero_si256();
+  __m128i vSumTail = _mm_setzero_si128();
+
+  for( ; iRows != 0; iRows-=iSubStep )
+  {
+    xSADRow_AVX2( piOrg, piCur, iCols, vSum, vSumTail );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  Distortion uiSum = xHorSum_AVX2( vSum ) + xHorSum_SSE41( vSumTail );
+  uiSum <<= iSubShift;
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+}
+
+template<Int iWidth>
+SIMD_TARGET("avx512f,avx512bw")
+Distortion TComRdCost::xGetSAD_AVX512( DistParam* pcDtParam )
+{
+  if ( ( iWidth != 0 && pcDtParam->bApplyWeight ) || pcDtParam->bitDepth > SIMD_DISTORTION_MAX_BIT_DEPTH )
+  {
+    return xGetSADC( iWidth, pcDtParam );
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iCols      = iWidth != 0 ? iWidth : pcDtParam->iCols;
+  Int        iRows      = pcDtParam->iRows;
+  const Int  iSubShift  = pcDtParam->iSubShift;
+  const Int  iSubStep   = ( 1 << iSubShift );
+  const Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+
+  __m512i vSum      = _mm512_setzero_si512();
+  __m256i vSumTail  = _mm256_setzero_si256();
+  __m128i vSumTail2 = _mm_setzero_si128();
+
+  for( ; iRows != 0; iRows-=iSubStep )
+  {
+    xSADRow_AVX512( piOrg, piCur, iCols, vSum, vSumTail, vSumTail2 );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  Distortion uiSum = xHorSum_AVX512( vSum ) + xHorSum_AVX2( vSumTail ) + xHorSum_SSE41( vSumTail2 );
+  uiSum <<= iSubShift;
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+}
+
+// SAD of one block against 4 candidates of integer ME, loading each original row once
+SIMD_TARGET("sse4.1")
+Void TComRdCost::xGetSAD4Cand_SSE41( DistParam* pcDtParam, const Pel* const* ppCur, Distortion* puiSum )
+{
+  if ( pcDtParam->bApplyWeight || pcDtParam->bitDepth > SIMD_DISTORTION_MAX_BIT_DEPTH || ( pcDtParam->iCols & 3 ) != 0 )
+  {
+    const Pel* piCur = pcDtParam->pCur;
+    for ( Int k = 0; k < 4; k++ )
+    {
+      pcDtParam->pCur = ppCur[k];
+      puiSum[k] = pcDtParam->DistFunc( pcDtParam );
+    }
+    pcDtParam->pCur = piCur;
+    return;
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Int  iCols      = pcDtParam->iCols;
+  Int        iRows      = pcDtParam->iRows;
+  const Int  iSubShift  = pcDtParam->iSubShift;
+  const Int  iSubStep   = ( 1 << iSubShift );
+  const Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+  const __m128i vOne    = _mm_set1_epi16( 1 );
+
+  __m128i vSum[4] = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+
+  for( Int iOffset = 0; iRows != 0; iRows-=iSubStep, iOffset += iStrideCur )
+  {
+    Int n = 0;
+    for ( ; n + 8 <= iCols; n += 8 )
+    {
+      const __m128i vOrg = _mm_loadu_si128( (const __m128i*)&piOrg[n] );
+      for ( Int k = 0; k < 4; k++ )
+      {
+        const __m128i vDiff = _mm_sub_epi16( vOrg, _mm_loadu_si128( (const __m128i*)&ppCur[k][iOffset + n] ) );
+        vSum[k] = _mm_add_epi32( vSum[k], _mm_madd_epi16( _mm_abs_epi16( vDiff ), vOne ) );
+      }
+    }
+    if ( n < iCols )
+    {
+      const __m128i vOrg = _mm_loadl_epi64( (const __m128i*)&piOrg[n] );
+      for ( Int k = 0; k < 4; k++ )
+      {
+        const __m128i vDiff = _mm_sub_epi16( vOrg, _mm_loadl_epi64( (const __m128i*)&ppCur[k][iOffset + n] ) );
+        vSum[k] = _mm_add_epi32( vSum[k], _mm_madd_epi16( _mm_abs_epi16( vDiff ), vOne ) );
+      }
+    }
+    piOrg += iStrideOrg;
+  }
+
+  for ( Int k = 0; k < 4; k++ )
+  {
+    puiSum[k] = ( Distortion( xHorSum_SSE41( vSum[k] ) ) << iSubShift ) >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8);
+  }
+}
+
+SIMD_TARGET("avx2")
+Void TComRdCost::xGetSAD4Cand_AVX2( DistParam* pcDtParam, const Pel* const* ppCur, Distortion* puiSum )
+{
+  if ( pcDtParam->iCols < 16 || pcDtParam->bApplyWeight || pcDtParam->bitDepth > SIMD_DISTORTION_MAX_BIT_DEPTH || ( pcDtParam->iCols & 3 ) != 0 )
+  {
+    xGetSAD4Cand_SSE41( pcDtParam, ppCur, puiSum );
+    return;
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Int  iCols      = pcDtParam->iCols;
+  Int        iRows      = pcDtParam->iRows;
+  const Int  iSubShift  = pcDtParam->iSubShift;
+  const Int  iSubStep   = ( 1 << iSubShift );
+  const Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+  const __m256i vOne    = _mm256_set1_epi16( 1 );
+
+  __m256i vSum[4]     = { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+  __m128i vSumTail[4] = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+
+  for( Int iOffset = 0; iRows != 0; iRows-=iSubStep, iOffset += iStrideCur )
+  {
+    Int n = 0;
+    for ( ; n + 16 <= iCols; n += 16 )
+    {
+      const __m256i vOrg = _mm256_loadu_si256( (const __m256i*)&piOrg[n] );
+      for ( Int k = 0; k < 4; k++ )
+      {
+        const __m256i vDiff = _mm256_sub_epi16( vOrg, _mm256_loadu_si256( (const __m256i*)&ppCur[k][iOffset + n] ) );
+        vSum[k] = _mm256_add_epi32( vSum[k], _mm256_madd_epi16( _mm256_abs_epi16( vDiff ), vOne ) );
+      }
+    }
+    if ( n < iCols )
+    {
+      for ( Int k = 0; k < 4; k++ )
+      {
+        xSADRow_SSE41( &piOrg[n], &ppCur[k][iOffset + n], iCols - n, vSumTail[k] );
+      }
+    }
+    piOrg += iStrideOrg;
+  }
+
+  for ( Int k = 0; k < 4; k++ )
+  {
+    puiSum[k] = ( Distortion( xHorSum_AVX2( vSum[k] ) + xHorSum_SSE41( vSumTail[k] ) ) << iSubShift ) >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8);
+  }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// SSE
+// --------------------------------------------------------------------------------------------------------------------
+
+template<Int iWidth, Bool bShift>
+SIMD_TARGET("sse4.1")
+static Distortion xGetSSESimd_SSE41( const DistParam* pcDtParam, const UInt uiShift )
+{
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iCols      = iWidth != 0 ? iWidth : pcDtParam->iCols;
+  Int        iRows      = pcDtParam->iRows;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg;
+  const Int  iStrideCur = pcDtParam->iStrideCur;
+  const __m128i vShift  = _mm_cvtsi32_si128( uiShift );
+
+  __m128i vSum = _mm_setzero_si128();
+
+  for( ; iRows != 0; iRows-- )
+  {
+    xSSERow_SSE41<bShift>( piOrg, piCur, iCols, vShift, vSum );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  return xHorSum_SSE41( vSum );
+}
+
+template<Int iWidth, Bool bShift>
+SIMD_TARGET("avx2")
+static Distortion xGetSSESimd_AVX2( const DistParam* pcDtParam, const UInt uiShift )
+{
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iCols      = iWidth != 0 ? iWidth : pcDtParam->iCols;
+  Int        iRows      = pcDtParam->iRows;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg;
+  const Int  iStrideCur = pcDtParam->iStrideCur;
+  const __m128i vShift  = _mm_cvtsi32_si128( uiShift );
+
+  __m256i vSum     = _mm256_setzero_si256();
+  __m128i vSumTail = _mm_setzero_si128();
+
+  for( ; iRows != 0; iRows-- )
+  {
+    xSSERow_AVX2<bShift>( piOrg, piCur, iCols, vShift, vSum, vSumTail );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  return xHorSum_AVX2( vSum ) + xHorSum_SSE41( vSumTail );
+}
+
+template<Int iWidth, Bool bShift>
+SIMD_TARGET("avx512f,avx512bw")
+static Distortion xGetSSESimd_AVX512( const DistParam* pcDtParam, const UInt uiShift )
+{
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iCols      = iWidth != 0 ? iWidth : pcDtParam->iCols;
+  Int        iRows      = pcDtParam->iRows;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg;
+  const Int  iStrideCur = pcDtParam->iStrideCur;
+  const __m128i vShift  = _mm_cvtsi32_si128( uiShift );
+
+  __m512i vSum      = _mm512_setzero_si512();
+  __m256i vSumTail  = _mm256_setzero_si256();
+  __m128i vSumTail2 = _mm_setzero_si128();
+
+  for( ; iRows != 0; iRows-- )
+  {
+    xSSERow_AVX512<bShift>( piOrg, piCur, iCols, vShift, vSum, vSumTail, vSumTail2 );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  return xHorSum_AVX512( vSum ) + xHorSum_AVX2( vSumTail ) + xHorSum_SSE41( vSumTail2 );
+}
+
+// the sums wrap around in 32 bits like the Distortion sums of the C functions
+template<Int iWidth>
+SIMD_TARGET("sse4.1")
+Distortion TComRdCost::xGetSSE_SSE41( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight || pcDtParam->bitDepth > SIMD_DISTORTION_MAX_BIT_DEPTH )
+  {
+    return xGetSSEC( iWidth, pcDtParam );
+  }
+  const UInt uiShift = DISTORTION_PRECISION_ADJUSTMENT((pcDtParam->bitDepth-8) << 1);
+  return uiShift != 0 ? xGetSSESimd_SSE41<iWidth, true>( pcDtParam, uiShift ) : xGetSSESimd_SSE41<iWidth, false>( pcDtParam, uiShift );
+}
+
+template<Int iWidth>
+SIMD_TARGET("avx2")
+Distortion TComRdCost::xGetSSE_AVX2( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight || pcDtParam->bitDepth > SIMD_DISTORTION_MAX_BIT_DEPTH )
+  {
+    return xGetSSEC( iWidth, pcDtParam );
+  }
+  const UInt uiShift = DISTORTION_PRECISION_ADJUSTMENT((pcDtParam->bitDepth-8) << 1);
+  return uiShift != 0 ? xGetSSESimd_AVX2<iWidth, true>( pcDtParam, uiShift ) : xGetSSESimd_AVX2<iWidth, false>( pcDtParam, uiShift );
+}
+
+template<Int iWidth>
+SIMD_TARGET("avx512f,avx512bw")
+Distortion TComRdCost::xGetSSE_AVX512( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight || pcDtParam->bitDepth > SIMD_DISTORTION_MAX_BIT_DEPTH )
+  {
+    return xGetSSEC( iWidth, pcDtParam );
+  }
+  const UInt uiShift = DISTORTION_PRECISION_ADJUSTMENT((pcDtParam->bitDepth-8) << 1);
+  return uiShift != 0 ? xGetSSESimd_AVX512<iWidth, true>( pcDtParam, uiShift ) : xGetSSESimd_AVX512<iWidth, false>( pcDtParam, uiShift );
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// HADAMARD
+// --------------------------------------------------------------------------------------------------------------------
+
+// the sums of the absolute coefficients do not depend on the order of the Hadamard basis functions, so the
+// butterflies below give the same results as xCalcHADs4x4 and xCalcHADs8x8
+
+SIMD_TARGET("sse4.1")
+static inline Void xHad4_SSE41( __m128i* m )
+{
+  const __m128i a0 = _mm_add_epi32( m[0], m[1] );
+  const __m128i a1 = _mm_sub_epi32( m[0], m[1] );
+  const __m128i a2 = _mm_add_epi32( m[2], m[3] );
+  const __m128i a3 = _mm_sub_epi32( m[2], m[3] );
+  m[0] = _mm_add_epi32( a0, a2 );
+  m[1] = _mm_add_epi32( a1, a3 );
+  m[2] = _mm_sub_epi32( a0, a2 );
+  m[3] = _mm_sub_epi32( a1, a3 );
+}
+
+SIMD_TARGET("sse4.1")
+static inline Void xTranspose4x4_SSE41( __m128i* m )
+{
+  const __m128i t0 = _mm_unpacklo_epi32( m[0], m[1] );
+  const __m128i t1 = _mm_unpacklo_epi32( m[2], m[3] );
+  const __m128i t2 = _mm_unpackhi_epi32( m[0], m[1] );
+  const __m128i t3 = _mm_unpackhi_epi32( m[2], m[3] );
+  m[0] = _mm_unpacklo_epi64( t0, t1 );
+  m[1] = _mm_unpackhi_epi64( t0, t1 );
+  m[2] = _mm_unpacklo_epi64( t2, t3 );
+  m[3] = _mm_unpackhi_epi64( t2, t3 );
+}
+
+SIMD_TARGET("sse4.1")
+static inline UInt xAbsSum4_SSE41( const __m128i* m )
+{
+  const __m128i vSum = _mm_add_epi32( _mm_add_epi32( _mm_abs_epi32( m[0] ), _mm_abs_epi32( m[1] ) ),
+                                      _mm_add_epi32( _mm_abs_epi32( m[2] ), _mm_abs_epi32( m[3] ) ) );
+  return xHorSum_SSE41( vSum );
+}
+
+SIMD_TARGET("sse4.1")
+static Distortion xCalcHADs4x4_SSE41( const Pel *piOrg, const Pel *piCur, Int iStrideOrg, Int iStrideCur )
+{
+  __m128i m[4];
+  for ( Int k = 0; k < 4; k++ )
+  {
+    m[k] = _mm_cvtepi16_epi32( _mm_sub_epi16( _mm_loadl_epi64( (const __m128i*)&piOrg[k*iStrideOrg] ), _mm_loadl_epi64( (const __m128i*)&piCur[k*iStrideCur] ) ) );
+  }
+  xHad4_SSE41( m );
+  xTranspose4x4_SSE41( m );
+  xHad4_SSE41( m );
+
+  Distortion satd = xAbsSum4_SSE41( m );
+  satd = ((satd+1)>>1);
+
+  return satd;
+}
+
+SIMD_TARGET("sse4.1")
+static inline Void xHad8_SSE41( __m128i* m )
+{
+  for ( Int k = 0; k < 4; k++ )
+  {
+    const __m128i a = m[k];
+    m[k  ] = _mm_add_epi32( a, m[k+4] );
+    m[k+4] = _mm_sub_epi32( a, m[k+4] );
+  }
+  xHad4_SSE41( m );
+  xHad4_SSE41( m + 4 );
+}
+
+// rows as two halves of 4 columns
+SIMD_TARGET("sse4.1")
+static Distortion xCalcHADs8x8_SSE41( const Pel *piOrg, const Pel *piCur, Int iStrideOrg, Int iStrideCur )
+{
+  __m128i mLeft[8], mRight[8];
+  for ( Int k = 0; k < 8; k++ )
+  {
+    const __m128i vDiff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)&piOrg[k*iStrideOrg] ), _mm_loadu_si128( (const __m128i*)&piCur[k*iStrideCur] ) );
+    mLeft [k] = _mm_cvtepi16_epi32( vDiff );
+    mRight[k] = _mm_cvtepi16_epi32( _mm_unpackhi_epi64( vDiff, vDiff ) );
+  }
+  xHad8_SSE41( mLeft );
+  xHad8_SSE41( mRight );
+
+  // transpose: the left columns become the top rows and the right columns the bottom rows
+  __m128i mTop[8], mBottom[8];
+  for ( Int k = 0; k < 8; k += 4 )
+  {
+    xTranspose4x4_SSE41( mLeft  + k );
+    xTranspose4x4_SSE41( mRight + k );
+  }
+  for ( Int k = 0; k < 4; k++ )
+  {
+    mTop   [k  ] = mLeft [k];
+    mTop   [k+4] = mRight[k];
+    mBottom[k  ] = mLeft [k+4];
+    mBottom[k+4] = mRight[k+4];
+  }
+  xHad8_SSE41( mTop );
+  xHad8_SSE41( mBottom );
+
+  Distortion sad = xAbsSum4_SSE41( mTop ) + xAbsSum4_SSE41( mTop + 4 ) + xAbsSum4_SSE41( mBottom ) + xAbsSum4_SSE41( mBottom + 4 );
+  sad=((sad+2)>>2);
+
+  return sad;
+}
+
+SIMD_TARGET("avx2")
+static Distortion xCalcHADs8x8_AVX2( const Pel *piOrg, const Pel *piCur, Int iStrideOrg, Int iStrideCur )
+{
+  __m256i m[8];
+  for ( Int k = 0; k < 8; k++ )
+  {
+    m[k] = _mm256_cvtepi16_epi32( _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)&piOrg[k*iStrideOrg] ), _mm_loadu_si128( (const __m128i*)&piCur[k*iStrideCur] ) ) );
+  }
+
+  for ( Int iPass = 0; iPass < 2; iPass++ )
+  {
+    for ( Int iDist = 4; iDist > 0; iDist >>= 1 )
+    {
+      for ( Int k = 0; k < 8; k++ )
+      {
+        if ( ( k & iDist ) == 0 )
+        {
+          const __m256i a = m[k];
+          m[k      ] = _mm256_add_epi32( a, m[k+iDist] );
+          m[k+iDist] = _mm256_sub_epi32( a, m[k+iDist] );
+        }
+      }
+    }
+    if ( iPass == 0 )
+    {
+      __m256i t[8], u[8];
+      for ( Int k = 0; k < 8; k += 2 )
+      {
+        t[k  ] = _mm256_unpacklo_epi32( m[k], m[k+1] );
+        t[k+1] = _mm256_unpackhi_epi32( m[k], m[k+1] );
+      }
+      for ( Int k = 0; k < 8; k += 4 )
+      {
+        u[k  ] = _mm256_unpacklo_epi64( t[k  ], t[k+2] );
+        u[k+1] = _mm256_unpackhi_epi64( t[k  ], t[k+2] );
+        u[k+2] = _mm256_unpacklo_epi64( t[k+1], t[k+3] );
+        u[k+3] = _mm256_unpackhi_epi64( t[k+1], t[k+3] );
+      }
+      for ( Int k = 0; k < 4; k++ )
+      {
+        m[k  ] = _mm256_permute2x128_si256( u[k], u[k+4], 0x20 );
+        m[k+4] = _mm256_permute2x128_si256( u[k], u[k+4], 0x31 );
+      }
+    }
+  }
+
+  __m256i vSum = _mm256_abs_epi32( m[0] );
+  for ( Int k = 1; k < 8; k++ )
+  {
+    vSum = _mm256_add_epi32( vSum, _mm256_abs_epi32( m[k] ) );
+  }
+  Distortion sad = xHorSum_AVX2( vSum );
+  sad=((sad+2)>>2);
+
+  return sad;
+}
+
+SIMD_TARGET("sse4.1")
+Distortion TComRdCost::xGetHADs_SSE41( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight || pcDtParam->bitDepth > SIMD_DISTORTION_MAX_BIT_DEPTH )
+  {
+    return xGetHADs( pcDtParam );
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iRows      = pcDtParam->iRows;
+  const Int  iCols      = pcDtParam->iCols;
+  const Int  iStrideCur = pcDtParam->iStrideCur;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg;
+  const Int  iStep      = pcDtParam->iStep;
+
+  Int  x, y;
+
+  Distortion uiSum = 0;
+
+  if( ( iRows % 8 == 0) && (iCols % 8 == 0) )
+  {
+    assert( iStep == 1 );
+    for ( y=0; y<iRows; y+= 8 )
+    {
+      for ( x=0; x<iCols; x+= 8 )
+      {
+        uiSum += xCalcHADs8x8_SSE41( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur );
+      }
+      piOrg += iStrideOrg<<3;
+      piCur += iStrideCur<<3;
+    }
+  }
+  else if( ( iRows % 4 == 0) && (iCols % 4 == 0) )
+  {
+    assert( iStep == 1 );
+    for ( y=0; y<iRows; y+= 4 )
+    {
+      for ( x=0; x<iCols; x+= 4 )
+      {
+        uiSum += xCalcHADs4x4_SSE41( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur );
+      }
+      piOrg += iStrideOrg<<2;
+      piCur += iStrideCur<<2;
+    }
+  }
+  else
+  {
+    return xGetHADs( pcDtParam );
+  }
+
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+}
+
+SIMD_TARGET("avx2")
+Distortion TComRdCost::xGetHADs_AVX2( DistParam* pcDtParam )
+{
+  if ( ( pcDtParam->iRows % 8 ) != 0 || ( pcDtParam->iCols % 8 ) != 0 || pcDtParam->bApplyWeight || pcDtParam->bitDepth > SIMD_DISTORTION_MAX_BIT_DEPTH )
+  {
+    return xGetHADs_SSE41( pcDtParam );
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iRows      = pcDtParam->iRows;
+  const Int  iCols      = pcDtParam->iCols;
+  const Int  iStrideCur = pcDtParam->iStrideCur;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg;
+  const Int  iStep      = pcDtParam->iStep;
+
+  Distortion uiSum = 0;
+
+  assert( iStep == 1 );
+  for ( Int y=0; y<iRows; y+= 8 )
+  {
+    for ( Int x=0; x<iCols; x+= 8 )
+    {
+      uiSum += xCalcHADs8x8_AVX2( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur );
+    }
+    piOrg += iStrideOrg<<3;
+    piCur += iStrideCur<<3;
+  }
+
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+}
+
+#endif // SIMD_DISTORTION
+
 //! \}
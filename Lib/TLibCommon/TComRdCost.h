@@ -45,6 +45,9 @@
 
 #include "TComSlice.h"
 #include "TComRdCostWeightPrediction.h"
+#if SIMD_DISTORTION
+#include "TComSimd.h"
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -58,6 +61,9 @@ class TComPattern;
 
 // for function pointer
 typedef Distortion (*FpDistFunc) (DistParam*); // TODO: can this pointer be replaced with a reference? - there are no NULL checks on pointer.
+#if SIMD_DISTORTION
+typedef Void       (*FpDistFunc4) (DistParam*, const Pel* const*, Distortion*); // distortion of pOrg against 4 candidates, each equal to DistFunc
+#endif
 
 // ====================================================================================================================
 // Class definition
@@ -75,6 +81,9 @@ public:
   Int                   iCols;
   Int                   iStep;
   FpDistFunc            DistFunc;
+#if SIMD_DISTORTION
+  FpDistFunc4           DistFunc4;        // NULL when there is no 4-candidate version of DistFunc
+#endif
   Int                   bitDepth;
 
   Bool                  bApplyWeight;     // whether weighted prediction is used or not
@@ -97,6 +106,9 @@ public:
      iCols(0),
      iStep(1),
      DistFunc(NULL),
+#if SIMD_DISTORTION
+     DistFunc4(NULL),
+#endif
      bitDepth(0),
      bApplyWeight(false),
      bIsBiPred(false),
@@ -114,6 +126,9 @@ private:
   // for distortion
 
   FpDistFunc              m_afpDistortFunc[DF_TOTAL_FUNCTIONS]; // [eDFunc]
+#if SIMD_DISTORTION
+  FpDistFunc4             m_fpDistortFunc4;                     // 4-candidate SAD for integer ME
+#endif
   CostMode                m_costMode;
   Double                  m_distortionWeight[MAX_NUM_COMPONENT]; // only chroma values are used.
   Double                  m_dLambda;
@@ -200,6 +215,25 @@ private:
   static Distortion xCalcHADs4x4      ( const Pel *piOrg, const Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep );
   static Distortion xCalcHADs8x8      ( const Pel *piOrg, const Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep );
 
+#if SIMD_DISTORTION
+  // SIMD versions, iWidth = 0 stands for 16N; the C functions are used for weighted prediction and bit depths above 12
+  static Distortion xGetSADC          ( Int iWidth, DistParam* pcDtParam );
+  static Distortion xGetSSEC          ( Int iWidth, DistParam* pcDtParam );
+
+  template<Int iWidth> static Distortion xGetSAD_SSE41   ( DistParam* pcDtParam ) SIMD_TARGET("sse4.1");
+  template<Int iWidth> static Distortion xGetSAD_AVX2    ( DistParam* pcDtParam ) SIMD_TARGET("avx2");
+  template<Int iWidth> static Distortion xGetSAD_AVX512  ( DistParam* pcDtParam ) SIMD_TARGET("avx512f,avx512bw");
+  template<Int iWidth> static Distortion xGetSSE_SSE41   ( DistParam* pcDtParam ) SIMD_TARGET("sse4.1");
+  template<Int iWidth> static Distortion xGetSSE_AVX2    ( DistParam* pcDtParam ) SIMD_TARGET("avx2");
+  template<Int iWidth> static Distortion xGetSSE_AVX512  ( DistParam* pcDtParam ) SIMD_TARGET("avx512f,avx512bw");
+
+  static Distortion xGetHADs_SSE41    ( DistParam* pcDtParam ) SIMD_TARGET("sse4.1");
+  static Distortion xGetHADs_AVX2     ( DistParam* pcDtParam ) SIMD_TARGET("avx2");
+
+  static Void       xGetSAD4Cand_SSE41( DistParam* pcDtParam, const Pel* const* ppCur, Distortion* puiSum ) SIMD_TARGET("sse4.1");
+  static Void       xGetSAD4Cand_AVX2 ( DistParam* pcDtParam, const Pel* const* ppCur, Distortion* puiSum ) SIMD_TARGET("avx2");
+#endif
+
 
 public:
 
@@ -0,0 +1,111 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2016, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TComSimd.cpp
+    \brief    run-time CPU feature detection for the SIMD functions
+*/
+
+#include "TComSimd.h"
+
+#if SIMD_DISTORTION || SIMD_INTERPOLATION_FILTER
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//! \ingroup TLibCommon
+//! \{
+
+static SimdLevel xDetectSimdLevel()
+{
+#if defined(_MSC_VER)
+  Int info[4];
+  __cpuid( info, 0 );
+  const Int maxLeaf = info[0];
+
+  __cpuid( info, 1 );
+  if ( !( info[2] & ( 1 << 19 ) ) )
+  {
+    return SIMD_NONE;
+  }
+  // AVX needs OSXSAVE and the OS saving the SSE and AVX registers
+  if ( maxLeaf < 7 || !( info[2] & ( 1 << 27 ) ) || ( _xgetbv( 0 ) & 0x06 ) != 0x06 )
+  {
+    return SIMD_SSE41;
+  }
+  __cpuidex( info, 7, 0 );
+  if ( !( info[1] & ( 1 << 5 ) ) )
+  {
+    return SIMD_SSE41;
+  }
+  if ( ( info[1] & ( 1 << 16 ) ) && ( info[1] & ( 1 << 30 ) ) && ( _xgetbv( 0 ) & 0xE6 ) == 0xE6 )
+  {
+    return SIMD_AVX512;
+  }
+  return SIMD_AVX2;
+#else
+  // the GCC/Clang built-ins include the operating system support check
+  __builtin_cpu_init();
+  if ( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" ) )
+  {
+    return SIMD_AVX512;
+  }
+  if ( __builtin_cpu_supports( "avx2" ) )
+  {
+    return SIMD_AVX2;
+  }
+  if ( __builtin_cpu_supports( "sse4.1" ) )
+  {
+    return SIMD_SSE41;
+  }
+  return SIMD_NONE;
+#endif
+}
+
+static SimdLevel s_simdLevelLimit = SIMD_AVX512;
+
+SimdLevel getSimdLevel()
+{
+  static const SimdLevel level = xDetectSimdLevel();
+  return std::min( level, s_simdLevelLimit );
+}
+
+Void setSimdLevel( SimdLevel level )
+{
+  s_simdLevelLimit = level;
+}
+
+//! \}
+
+#endif // SIMD_DISTORTION || SIMD_INTERPOLATION_FILTER
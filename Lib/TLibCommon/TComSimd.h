@@ -0,0 +1,89 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2016, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TComSimd.h
+    \brief    run-time CPU feature detection for the SIMD functions (header)
+*/
+
+#ifndef __TCOMSIMD__
+#define __TCOMSIMD__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "CommonDef.h"
+
+#if SIMD_DISTORTION || SIMD_INTERPOLATION_FILTER
+
+#include <immintrin.h>
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Type definition
+// ====================================================================================================================
+
+/// instruction set extensions used by the SIMD functions, each level includes the previous ones
+enum SimdLevel
+{
+  SIMD_NONE   = 0,
+  SIMD_SSE41  = 1,
+  SIMD_AVX2   = 2,
+  SIMD_AVX512 = 3,  ///< AVX-512F and AVX-512BW
+};
+
+/// compiles a function for the given instruction set without enabling it for the whole translation unit
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET(isa)  __attribute__((target(isa)))
+#else
+#define SIMD_TARGET(isa)
+#endif
+
+// ====================================================================================================================
+// Function declarations
+// ====================================================================================================================
+
+/// highest level supported by the CPU and the operating system, detected on the first call, and not above the limit of setSimdLevel()
+SimdLevel getSimdLevel();
+
+/// limits the level used by the SIMD functions, SIMD_NONE selects the C functions; TComRdCost::init() must be called again afterwards
+Void setSimdLevel( SimdLevel level );
+
+//! \}
+
+#endif // SIMD_DISTORTION || SIMD_INTERPOLATION_FILTER
+
+#endif // __TCOMSIMD__
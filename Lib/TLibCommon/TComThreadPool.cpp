@@ -0,0 +1,164 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2016, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThreadPool.cpp
+    \brief    fixed-size worker thread pool
+*/
+
+#include "TComThreadPool.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+TComThreadPool::TComThreadPool()
+: m_iNumThreads  (1)
+, m_pJob         (NULL)
+, m_iNumJobs     (0)
+, m_iNextJob     (0)
+, m_iNumJobsDone (0)
+, m_iNumActive   (0)
+, m_uiGeneration (0)
+, m_bBusy        (false)
+, m_bExit        (false)
+{
+}
+
+TComThreadPool::~TComThreadPool()
+{
+  destroy();
+}
+
+Void TComThreadPool::create( Int iNumThreads )
+{
+  destroy();
+  m_iNumThreads = iNumThreads > 1 ? iNumThreads : 1;
+  m_bExit       = false;
+  for(Int i=1; i<m_iNumThreads; i++)
+  {
+    m_workers.push_back(std::thread(&TComThreadPool::xWorkerLoop, this));
+  }
+}
+
+Void TComThreadPool::destroy()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bExit = true;
+  }
+  m_cvStart.notify_all();
+  for(size_t i=0; i<m_workers.size(); i++)
+  {
+    m_workers[i].join();
+  }
+  m_workers.clear();
+  m_iNumThreads = 1;
+}
+
+Void TComThreadPool::parallelFor( Int iNumJobs, const JobFunc& job )
+{
+  if(iNumJobs <= 0)
+  {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if(m_workers.empty() || iNumJobs == 1 || m_bBusy)
+  {
+    lock.unlock();
+    for(Int i=0; i<iNumJobs; i++)
+    {
+      job(i);
+    }
+    return;
+  }
+
+  m_bBusy        = true;
+  m_pJob         = &job;
+  m_iNumJobs     = iNumJobs;
+  m_iNumJobsDone = 0;
+  m_iNextJob     = 0;
+  m_uiGeneration++;
+  lock.unlock();
+  m_cvStart.notify_all();
+
+  Int iDone = xRunJobs();
+
+  lock.lock();
+  m_iNumJobsDone += iDone;
+  m_cvDone.wait(lock, [this]{ return m_iNumJobsDone == m_iNumJobs && m_iNumActive == 0; });
+  m_pJob  = NULL;
+  m_bBusy = false;
+}
+
+Int TComThreadPool::xRunJobs()
+{
+  Int iDone = 0;
+  for(Int i = m_iNextJob++; i < m_iNumJobs; i = m_iNextJob++)
+  {
+    (*m_pJob)(i);
+    iDone++;
+  }
+  return iDone;
+}
+
+Void TComThreadPool::xWorkerLoop()
+{
+  UInt uiGeneration = 0;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while(true)
+  {
+    m_cvStart.wait(lock, [&]{ return m_bExit || m_uiGeneration != uiGeneration; });
+    if(m_bExit)
+    {
+      return;
+    }
+    uiGeneration = m_uiGeneration;
+    if(m_pJob == NULL)
+    {
+      continue;
+    }
+
+    m_iNumActive++;
+    lock.unlock();
+    Int iDone = xRunJobs();
+    lock.lock();
+    m_iNumActive--;
+    m_iNumJobsDone += iDone;
+    if(m_iNumJobsDone == m_iNumJobs && m_iNumActive == 0)
+    {
+      m_cvDone.notify_all();
+    }
+  }
+}
+
+//! \}
@@ -0,0 +1,100 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2016, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThreadPool.h
+    \brief    fixed-size worker thread pool (header)
+*/
+
+#ifndef __TCOMTHREADPOOL__
+#define __TCOMTHREADPOOL__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+#include "CommonDef.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// worker thread pool; the calling thread takes part in the work, so a pool of N threads creates N-1 workers
+class TComThreadPool
+{
+public:
+  typedef std::function<Void(Int)> JobFunc;
+
+  TComThreadPool();
+  virtual ~TComThreadPool();
+
+  Void  create        ( Int iNumThreads );
+  Void  destroy       ();
+  Int   getNumThreads () const { return m_iNumThreads; }
+
+  /// run job(0) ... job(iNumJobs-1) and return when all of them are finished;
+  /// runs serially on the calling thread if the pool has a single thread or is already busy (nested or concurrent call)
+  Void  parallelFor   ( Int iNumJobs, const JobFunc& job );
+
+private:
+  Void  xWorkerLoop   ();
+  Int   xRunJobs      ();
+
+  Int                       m_iNumThreads;
+  std::vector<std::thread>  m_workers;
+
+  std::mutex                m_mutex;
+  std::condition_variable   m_cvStart;
+  std::condition_variable   m_cvDone;
+  const JobFunc*            m_pJob;          ///< current job, NULL when no parallelFor is open
+  Int                       m_iNumJobs;
+  std::atomic<Int>          m_iNextJob;
+  Int                       m_iNumJobsDone;
+  Int                       m_iNumActive;    ///< workers currently inside xRunJobs
+  UInt                      m_uiGeneration;
+  Bool                      m_bBusy;
+  Bool                      m_bExit;
+};
+
+//! \}
+
+#endif // __TCOMTHREADPOOL__
@@ -125,11 +125,27 @@
 #endif
 #define W0038_DB_OPT                                      1 ///< adaptive DB parameter selection, LoopFilterOffsetInPPS and LoopFilterDisable are set to 0 and DeblockingFilterMetric=2;
 #define W0038_CQP_ADJ                                     1 ///< chroma QP adjustment based on TL, CQPTLAdjustEnabled is set to 1;
+#define WPP_PARALLEL_ENCODING                             1 ///< encoder only: CTU rows of wavefront slices are compressed on parallel threads, WaveFrontThreads sets the number of threads;
+#if WPP_PARALLEL_ENCODING
+#define TILE_PARALLEL_ENCODING                            1 ///< encoder only, depends on WPP_PARALLEL_ENCODING: tiles of a slice are compressed and entropy coded on parallel threads, TileThreads sets the number of threads;
+#define FRAME_PARALLEL_ENCODING                           1 ///< encoder only, depends on WPP_PARALLEL_ENCODING: consecutive pictures that do not reference each other are compressed on parallel threads, FrameThreads sets the number of threads;
+#endif
+#define SIMD_DISTORTION                                   1 ///< SSE4.1/AVX2/AVX-512 versions of the SAD, SSE and Hadamard functions of TComRdCost, chosen at run time from the CPU features; results are identical to the C functions
+#define SIMD_INTERPOLATION_FILTER                         1 ///< SSE4.1/AVX2 versions of the luma and chroma interpolation filters, chosen at run time from the CPU features; results are identical to the C functions
 
 // ====================================================================================================================
 // Derived macros
 // ====================================================================================================================
 
+#if SIMD_DISTORTION && (RExt__HIGH_BIT_DEPTH_SUPPORT || !(defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)))
+#undef  SIMD_DISTORTION
+#define SIMD_DISTORTION                                   0 ///< the SIMD functions need x86 and 16-bit Pel
+#endif
+#if SIMD_INTERPOLATION_FILTER && (RExt__HIGH_BIT_DEPTH_SUPPORT || !(defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)))
+#undef  SIMD_INTERPOLATION_FILTER
+#define SIMD_INTERPOLATION_FILTER                         0 ///< the SIMD functions need x86 and 16-bit Pel
+#endif
+
 #if RExt__HIGH_BIT_DEPTH_SUPPORT
 #define FULL_NBIT                                         1 ///< When enabled, use distortion measure derived from all bits of source data, otherwise discard (bitDepth - 8) least-significant bits of distortion
 #define RExt__HIGH_PRECISION_FORWARD_TRANSFORM            1 ///< 0 use original 6-bit transform matrices for both forward and inverse transform, 1 (default) = use original matrices for inverse transform and high precision matrices for forward transform
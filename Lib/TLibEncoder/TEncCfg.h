@@ -281,6 +281,15 @@ protected:
   std::vector<Int> m_tileRowHeight;
 
   Bool      m_entropyCodingSyncEnabledFlag;
+#if WPP_PARALLEL_ENCODING
+  Int       m_iWaveFrontThreads;                              ///< threads compressing the CTU rows of a wavefront slice, 1: serial
+#endif
+#if TILE_PARALLEL_ENCODING
+  Int       m_iTileThreads;                                   ///< threads coding the tiles of a slice, 1: serial
+#endif
+#if FRAME_PARALLEL_ENCODING
+  Int       m_iFrameThreads;                                  ///< threads compressing pictures that do not reference each other, 1: serial
+#endif
 
   HashType  m_decodedPictureHashSEIType;
   Bool      m_bufferingPeriodSEIEnabled;
@@ -425,11 +434,26 @@ protected:
 #if SVIDEO_EXT && SVIDEO_VIEWPORT_PSNR
   ViewPortPSNRParam m_viewPortPSNRParam;
 #endif
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+  Int       m_iSphMetricThreads;                              ///< threads for the spherical metrics, 0: computed on the encoding thread
+#endif
 
 public:
   TEncCfg()
   : m_tileColumnWidth()
   , m_tileRowHeight()
+#if WPP_PARALLEL_ENCODING
+  , m_iWaveFrontThreads(1)
+#endif
+#if TILE_PARALLEL_ENCODING
+  , m_iTileThreads(1)
+#endif
+#if FRAME_PARALLEL_ENCODING
+  , m_iFrameThreads(1)
+#endif
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+  , m_iSphMetricThreads(0)
+#endif
   {
     m_PCMBitDepth[CHANNEL_TYPE_LUMA]=8;
     m_PCMBitDepth[CHANNEL_TYPE_CHROMA]=8;
@@ -736,6 +760,18 @@ public:
   Void  xCheckGSParameters();
   Void  setEntropyCodingSyncEnabledFlag(Bool b)                      { m_entropyCodingSyncEnabledFlag = b; }
   Bool  getEntropyCodingSyncEnabledFlag() const                      { return m_entropyCodingSyncEnabledFlag; }
+#if WPP_PARALLEL_ENCODING
+  Void  setWaveFrontThreads(Int i)                                   { m_iWaveFrontThreads = i; }
+  Int   getWaveFrontThreads() const                                  { return m_iWaveFrontThreads; }
+#endif
+#if TILE_PARALLEL_ENCODING
+  Void  setTileThreads(Int i)                                        { m_iTileThreads = i; }
+  Int   getTileThreads() const                                       { return m_iTileThreads; }
+#endif
+#if FRAME_PARALLEL_ENCODING
+  Void  setFrameThreads(Int i)                                       { m_iFrameThreads = i; }
+  Int   getFrameThreads() const                                      { return m_iFrameThreads; }
+#endif
   Void  setDecodedPictureHashSEIType(HashType m)                     { m_decodedPictureHashSEIType = m; }
   HashType getDecodedPictureHashSEIType() const                      { return m_decodedPictureHashSEIType; }
   Void  setBufferingPeriodSEIEnabled(Bool b)                         { m_bufferingPeriodSEIEnabled = b; }
@@ -1039,6 +1075,10 @@ public:
 #if SVIDEO_EXT && SVIDEO_VIEWPORT_PSNR
   Void      setViewPortPSNRParam(ViewPortPSNRParam& viewPortPSNRParam)   {m_viewPortPSNRParam = viewPortPSNRParam;}
 #endif
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+  Void      setSphMetricThreads(Int i)                               { m_iSphMetricThreads = i; }
+  Int       getSphMetricThreads() const                              { return m_iSphMetricThreads; }
+#endif
 };
 
 //! \}
@@ -219,6 +219,26 @@ Void TEncCu::init( TEncTop* pcEncTop )
   m_pcRateCtrl         = pcEncTop->getRateCtrl();
 }
 
+#if WPP_PARALLEL_ENCODING
+/** \param    pcEncTop      pointer of encoder class
+ *  \param    pcPredSearch  encoder search used by this CU encoder, likewise for the other coders
+ */
+Void TEncCu::init( TEncTop* pcEncTop, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComRdCost* pcRdCost,
+                   TEncEntropy* pcEntropyCoder, TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder )
+{
+  init( pcEncTop );
+
+  m_pcPredSearch       = pcPredSearch;
+  m_pcTrQuant          = pcTrQuant;
+  m_pcRdCost           = pcRdCost;
+
+  m_pcEntropyCoder     = pcEntropyCoder;
+
+  m_pppcRDSbacCoder    = pppcRDSbacCoder;
+  m_pcRDGoOnSbacCoder  = pcRDGoOnSbacCoder;
+}
+#endif
+
 // ====================================================================================================================
 // Public member functions
 // ====================================================================================================================
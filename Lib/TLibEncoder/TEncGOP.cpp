@@ -52,6 +52,10 @@
 #include <deque>
 using namespace std;
 
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+static const size_t S_MAX_PENDING_SPH_METRICS = 8;   ///< pictures the encoder may run ahead of the metric thread
+#endif
+
 //! \ingroup TLibEncoder
 //! \{
 
@@ -96,16 +100,28 @@ TEncGOP::TEncGOP()
   ::memset(m_ltRefPicUsedByCurrPicFlag, 0, sizeof(m_ltRefPicUsedByCurrPicFlag));
   m_lastBPSEI         = 0;
   m_bufferingPeriodSEIPresentInAU = false;
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+  m_bSphMetricExit    = false;
+#endif
   m_associatedIRAPType = NAL_UNIT_CODED_SLICE_IDR_N_LP;
   m_associatedIRAPPOC  = 0;
 #if W0038_DB_OPT
   m_pcDeblockingTempPicYuv = NULL;
+#endif
+#if FRAME_PARALLEL_ENCODING
+  for ( Int i = 0; i < MAX_TLAYER; i++ )
+  {
+    m_lastEncCABACTableIdx[i] = I_SLICE;
+  }
 #endif
   return;
 }
 
 TEncGOP::~TEncGOP()
 {
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+  xStopSphMetrics();
+#endif
 }
 
 /** Create list to contain pointers to CTU start addresses of slice.
@@ -118,6 +134,9 @@ Void  TEncGOP::create()
 
 Void  TEncGOP::destroy()
 {
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+  xStopSphMetrics();
+#endif
 #if W0038_DB_OPT
   if (m_pcDeblockingTempPicYuv)
   {
@@ -1039,6 +1058,19 @@ static UInt calculateCollocatedFromL1Flag(TEncCfg *pCfg, const Int GOPid, const
 }
 
 
+#if FRAME_PARALLEL_ENCODING
+/// slice type whose contexts the CABAC of pcSlice is initialised with for the CABAC table index, as in TEncSbac::resetEntropy
+static SliceType getCabacInitSliceType(const TComSlice* pcSlice, const SliceType encCABACTableIdx)
+{
+  if (!pcSlice->isIntra() && (encCABACTableIdx==B_SLICE || encCABACTableIdx==P_SLICE) && pcSlice->getPPS()->getCabacInitPresentFlag())
+  {
+    return encCABACTableIdx;
+  }
+  return pcSlice->getSliceType();
+}
+#endif
+
+
 static Void
 printHash(const HashType hashType, const std::string &digestStr)
 {
@@ -1102,6 +1134,9 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
   {
     effFieldIRAPMap.initialize(isField, m_iGopSize, iPOCLast, iNumPicRcvd, m_iLastIDR, this, m_pcCfg);
   }
+#if FRAME_PARALLEL_ENCODING
+  std::deque<FramePicture> framePictures;
+#endif
 
   // reset flag indicating whether pictures have been encoded
   for ( Int iGOPid=0; iGOPid < m_iGopSize; iGOPid++ )
@@ -1119,422 +1154,62 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     //-- For time output for each slice
     clock_t iBeforeTime = clock();
 
-    UInt uiColDir = calculateCollocatedFromL1Flag(m_pcCfg, iGOPid, m_iGopSize);
-
-    /////////////////////////////////////////////////////////////////////////////////////////////////// Initial to start encoding
-    Int iTimeOffset;
-    Int pocCurr;
-
-    if(iPOCLast == 0) //case first frame or first top field
-    {
-      pocCurr=0;
-      iTimeOffset = 1;
-    }
-    else if(iPOCLast == 1 && isField) //case first bottom field, just like the first frame, the poc computation is not right anymore, we set the right value
-    {
-      pocCurr = 1;
-      iTimeOffset = 1;
-    }
-    else
-    {
-      pocCurr = iPOCLast - iNumPicRcvd + m_pcCfg->getGOPEntry(iGOPid).m_POC - ((isField && m_iGopSize>1) ? 1:0);
-      iTimeOffset = m_pcCfg->getGOPEntry(iGOPid).m_POC;
-    }
-
-    if(pocCurr>=m_pcCfg->getFramesToBeEncoded())
-    {
-      if (m_pcCfg->getEfficientFieldIRAPEnabled())
-      {
-        iGOPid=effFieldIRAPMap.restoreGOPid(iGOPid);
-      }
-      continue;
-    }
-
-    if( getNalUnitType(pocCurr, m_iLastIDR, isField) == NAL_UNIT_CODED_SLICE_IDR_W_RADL || getNalUnitType(pocCurr, m_iLastIDR, isField) == NAL_UNIT_CODED_SLICE_IDR_N_LP )
-    {
-      m_iLastIDR = pocCurr;
-    }
-    // start a new access unit: create an entry in the list of output access units
-    accessUnitsInGOP.push_back(AccessUnit());
-    AccessUnit& accessUnit = accessUnitsInGOP.back();
-    xGetBuffer( rcListPic, rcListPicYuvRecOut, iNumPicRcvd, iTimeOffset, pcPic, pcPicYuvRecOut, pocCurr, isField );
-
-    //  Slice data initialization
-    pcPic->clearSliceBuffer();
-    pcPic->allocateNewSlice();
-    m_pcSliceEncoder->setSliceIdx(0);
-    pcPic->setCurrSliceIdx(0);
-
-    m_pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, pocCurr, iGOPid, pcSlice, isField );
-
-    //Set Frame/Field coding
-    pcSlice->getPic()->setField(isField);
-
-    pcSlice->setLastIDR(m_iLastIDR);
-    pcSlice->setSliceIdx(0);
-    //set default slice level flag to the same as SPS level flag
-    pcSlice->setLFCrossSliceBoundaryFlag(  pcSlice->getPPS()->getLoopFilterAcrossSlicesEnabledFlag()  );
-
-    if(pcSlice->getSliceType()==B_SLICE&&m_pcCfg->getGOPEntry(iGOPid).m_sliceType=='P')
-    {
-      pcSlice->setSliceType(P_SLICE);
-    }
-    if(pcSlice->getSliceType()==B_SLICE&&m_pcCfg->getGOPEntry(iGOPid).m_sliceType=='I')
-    {
-      pcSlice->setSliceType(I_SLICE);
-    }
-    
-    // Set the nal unit type
-    pcSlice->setNalUnitType(getNalUnitType(pocCurr, m_iLastIDR, isField));
-    if(pcSlice->getTemporalLayerNonReferenceFlag())
-    {
-      if (pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_TRAIL_R &&
-          !(m_iGopSize == 1 && pcSlice->getSliceType() == I_SLICE))
-        // Add this condition to avoid POC issues with encoder_intra_main.cfg configuration (see #1127 in bug tracker)
-      {
-        pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_TRAIL_N);
-      }
-      if(pcSlice->getNalUnitType()==NAL_UNIT_CODED_SLICE_RADL_R)
-      {
-        pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_RADL_N);
-      }
-      if(pcSlice->getNalUnitType()==NAL_UNIT_CODED_SLICE_RASL_R)
-      {
-        pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_RASL_N);
-      }
-    }
-
-    if (m_pcCfg->getEfficientFieldIRAPEnabled())
-    {
-      if ( pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_LP
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_RADL
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_N_LP
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_W_RADL
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_N_LP
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA )  // IRAP picture
-      {
-        m_associatedIRAPType = pcSlice->getNalUnitType();
-        m_associatedIRAPPOC = pocCurr;
-      }
-      pcSlice->setAssociatedIRAPType(m_associatedIRAPType);
-      pcSlice->setAssociatedIRAPPOC(m_associatedIRAPPOC);
-    }
-    // Do decoding refresh marking if any
-    pcSlice->decodingRefreshMarking(m_pocCRA, m_bRefreshPending, rcListPic, m_pcCfg->getEfficientFieldIRAPEnabled());
-    m_pcEncTop->selectReferencePictureSet(pcSlice, pocCurr, iGOPid);
-    if (!m_pcCfg->getEfficientFieldIRAPEnabled())
-    {
-      if ( pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_LP
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_RADL
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_N_LP
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_W_RADL
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_N_LP
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA )  // IRAP picture
-      {
-        m_associatedIRAPType = pcSlice->getNalUnitType();
-        m_associatedIRAPPOC = pocCurr;
-      }
-      pcSlice->setAssociatedIRAPType(m_associatedIRAPType);
-      pcSlice->setAssociatedIRAPPOC(m_associatedIRAPPOC);
-    }
-
-    if ((pcSlice->checkThatAllRefPicsAreAvailable(rcListPic, pcSlice->getRPS(), false, m_iLastRecoveryPicPOC, m_pcCfg->getDecodingRefreshType() == 3) != 0) || (pcSlice->isIRAP()) 
-      || (m_pcCfg->getEfficientFieldIRAPEnabled() && isField && pcSlice->getAssociatedIRAPType() >= NAL_UNIT_CODED_SLICE_BLA_W_LP && pcSlice->getAssociatedIRAPType() <= NAL_UNIT_CODED_SLICE_CRA && pcSlice->getAssociatedIRAPPOC() == pcSlice->getPOC()+1)
-      )
-    {
-      pcSlice->createExplicitReferencePictureSetFromReference(rcListPic, pcSlice->getRPS(), pcSlice->isIRAP(), m_iLastRecoveryPicPOC, m_pcCfg->getDecodingRefreshType() == 3, m_pcCfg->getEfficientFieldIRAPEnabled());
-    }
-
-    pcSlice->applyReferencePictureSet(rcListPic, pcSlice->getRPS());
-
-    if(pcSlice->getTLayer() > 0 
-      &&  !( pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RADL_N     // Check if not a leading picture
-          || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RADL_R
-          || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RASL_N
-          || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RASL_R )
-        )
-    {
-      if(pcSlice->isTemporalLayerSwitchingPoint(rcListPic) || pcSlice->getSPS()->getTemporalIdNestingFlag())
-      {
-        if(pcSlice->getTemporalLayerNonReferenceFlag())
-        {
-          pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_TSA_N);
-        }
-        else
-        {
-          pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_TSA_R);
-        }
-      }
-      else if(pcSlice->isStepwiseTemporalLayerSwitchingPointCandidate(rcListPic))
-      {
-        Bool isSTSA=true;
-        for(Int ii=iGOPid+1;(ii<m_pcCfg->getGOPSize() && isSTSA==true);ii++)
-        {
-          Int lTid= m_pcCfg->getGOPEntry(ii).m_temporalId;
-          if(lTid==pcSlice->getTLayer())
-          {
-            const TComReferencePictureSet* nRPS = pcSlice->getSPS()->getRPSList()->getReferencePictureSet(ii);
-            for(Int jj=0;jj<nRPS->getNumberOfPictures();jj++)
-            {
-              if(nRPS->getUsed(jj))
-              {
-                Int tPoc=m_pcCfg->getGOPEntry(ii).m_POC+nRPS->getDeltaPOC(jj);
-                Int kk=0;
-                for(kk=0;kk<m_pcCfg->getGOPSize();kk++)
-                {
-                  if(m_pcCfg->getGOPEntry(kk).m_POC==tPoc)
-                  {
-                    break;
-                  }
-                }
-                Int tTid=m_pcCfg->getGOPEntry(kk).m_temporalId;
-                if(tTid >= pcSlice->getTLayer())
-                {
-                  isSTSA=false;
-                  break;
-                }
-              }
-            }
-          }
-        }
-        if(isSTSA==true)
-        {
-          if(pcSlice->getTemporalLayerNonReferenceFlag())
-          {
-            pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_STSA_N);
-          }
-          else
-          {
-            pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_STSA_R);
-          }
-        }
-      }
-    }
-    arrangeLongtermPicturesInRPS(pcSlice, rcListPic);
-    TComRefPicListModification* refPicListModification = pcSlice->getRefPicListModification();
-    refPicListModification->setRefPicListModificationFlagL0(0);
-    refPicListModification->setRefPicListModificationFlagL1(0);
-    pcSlice->setNumRefIdx(REF_PIC_LIST_0,min(m_pcCfg->getGOPEntry(iGOPid).m_numRefPicsActive,pcSlice->getRPS()->getNumberOfPictures()));
-    pcSlice->setNumRefIdx(REF_PIC_LIST_1,min(m_pcCfg->getGOPEntry(iGOPid).m_numRefPicsActive,pcSlice->getRPS()->getNumberOfPictures()));
-
-    //  Set reference list
-    pcSlice->setRefPicList ( rcListPic );
-
-    //  Slice info. refinement
-    if ( (pcSlice->getSliceType() == B_SLICE) && (pcSlice->getNumRefIdx(REF_PIC_LIST_1) == 0) )
-    {
-      pcSlice->setSliceType ( P_SLICE );
-    }
-    pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
-
-    if (pcSlice->getSliceType() == B_SLICE)
-    {
-      pcSlice->setColFromL0Flag(1-uiColDir);
-      Bool bLowDelay = true;
-      Int  iCurrPOC  = pcSlice->getPOC();
-      Int iRefIdx = 0;
-
-      for (iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx(REF_PIC_LIST_0) && bLowDelay; iRefIdx++)
-      {
-        if ( pcSlice->getRefPic(REF_PIC_LIST_0, iRefIdx)->getPOC() > iCurrPOC )
-        {
-          bLowDelay = false;
-        }
-      }
-      for (iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx(REF_PIC_LIST_1) && bLowDelay; iRefIdx++)
-      {
-        if ( pcSlice->getRefPic(REF_PIC_LIST_1, iRefIdx)->getPOC() > iCurrPOC )
-        {
-          bLowDelay = false;
-        }
-      }
-
-      pcSlice->setCheckLDC(bLowDelay);
-    }
-    else
-    {
-      pcSlice->setCheckLDC(true);
-    }
-
-    uiColDir = 1-uiColDir;
-
-    //-------------------------------------------------------------
-    pcSlice->setRefPOCList();
-
-    pcSlice->setList1IdxToList0Idx();
-
-    if (m_pcEncTop->getTMVPModeId() == 2)
-    {
-      if (iGOPid == 0) // first picture in SOP (i.e. forward B)
-      {
-        pcSlice->setEnableTMVPFlag(0);
-      }
-      else
-      {
-        // Note: pcSlice->getColFromL0Flag() is assumed to be always 0 and getcolRefIdx() is always 0.
-        pcSlice->setEnableTMVPFlag(1);
-      }
-    }
-    else if (m_pcEncTop->getTMVPModeId() == 1)
-    {
-      pcSlice->setEnableTMVPFlag(1);
-    }
-    else
-    {
-      pcSlice->setEnableTMVPFlag(0);
-    }
-    
-    // set adaptive search range for non-intra-slices
-    if (m_pcCfg->getUseASR() && pcSlice->getSliceType()!=I_SLICE)
-    {
-      m_pcSliceEncoder->setSearchRange(pcSlice);
-    }
-
-    Bool bGPBcheck=false;
-    if ( pcSlice->getSliceType() == B_SLICE)
-    {
-      if ( pcSlice->getNumRefIdx(RefPicList( 0 ) ) == pcSlice->getNumRefIdx(RefPicList( 1 ) ) )
-      {
-        bGPBcheck=true;
-        Int i;
-        for ( i=0; i < pcSlice->getNumRefIdx(RefPicList( 1 ) ); i++ )
-        {
-          if ( pcSlice->getRefPOC(RefPicList(1), i) != pcSlice->getRefPOC(RefPicList(0), i) )
-          {
-            bGPBcheck=false;
-            break;
-          }
-        }
-      }
-    }
-    if(bGPBcheck)
-    {
-      pcSlice->setMvdL1ZeroFlag(true);
-    }
-    else
-    {
-      pcSlice->setMvdL1ZeroFlag(false);
-    }
-    pcPic->getSlice(pcSlice->getSliceIdx())->setMvdL1ZeroFlag(pcSlice->getMvdL1ZeroFlag());
-
-
     Double lambda            = 0.0;
     Int actualHeadBits       = 0;
     Int actualTotalBits      = 0;
     Int estimatedBits        = 0;
     Int tmpBitsBeforeWriting = 0;
-    if ( m_pcCfg->getUseRateCtrl() ) // TODO: does this work with multiple slices and slice-segments?
+    UInt uiNumSliceSegments  = 1;
+    AccessUnit* pcAccessUnit = NULL;
+
+#if FRAME_PARALLEL_ENCODING
+    if ( !framePictures.empty() && framePictures.front().iGOPid == iGOPid )
     {
-      Int frameLevel = m_pcRateCtrl->getRCSeq()->getGOPID2Level( iGOPid );
-      if ( pcPic->getSlice(0)->getSliceType() == I_SLICE )
+      // already compressed by a frame thread
+      const FramePicture framePicture = framePictures.front();
+      framePictures.pop_front();
+      pcPic              = framePicture.pcPic;
+      pcPicYuvRecOut     = framePicture.pcPicYuvRecOut;
+      pcAccessUnit       = framePicture.pcAccessUnit;
+      iBeforeTime        = framePicture.iBeforeTime;
+      uiNumSliceSegments = framePicture.uiNumSliceSegments;
+
+      // compress again if the CABAC table was guessed wrong
+      pcSlice = pcPic->getSlice(0);
+      if ( getCabacInitSliceType( pcSlice, pcSlice->getEncCABACTableIdx() ) != getCabacInitSliceType( pcSlice, m_pcSliceEncoder->getEncCABACTableIdx() ) )
       {
-        frameLevel = 0;
+        pcSlice->setEncCABACTableIdx( m_pcSliceEncoder->getEncCABACTableIdx() );
+        uiNumSliceSegments = xCompressPicture( pcPic, framePicture.pcSliceEncoder );
       }
-      m_pcRateCtrl->initRCPic( frameLevel );
-      estimatedBits = m_pcRateCtrl->getRCPic()->getTargetBits();
-
-#if U0132_TARGET_BITS_SATURATION
-      if (m_pcRateCtrl->getCpbSaturationEnabled() && frameLevel != 0)
+    }
+    else
+#endif
+    {
+      if ( !xInitPicture( iGOPid, iPOCLast, iNumPicRcvd, rcListPic, rcListPicYuvRecOut, accessUnitsInGOP, isField, m_pcSliceEncoder, pcPic, pcPicYuvRecOut, lambda, estimatedBits ) )
       {
-        Int estimatedCpbFullness = m_pcRateCtrl->getCpbState() + m_pcRateCtrl->getBufferingRate();
-
-        // prevent overflow
-        if (estimatedCpbFullness - estimatedBits > (Int)(m_pcRateCtrl->getCpbSize()*0.9f))
-        {
-          estimatedBits = estimatedCpbFullness - (Int)(m_pcRateCtrl->getCpbSize()*0.9f);
-        }
-
-        estimatedCpbFullness -= m_pcRateCtrl->getBufferingRate();
-        // prevent underflow
-#if V0078_ADAPTIVE_LOWER_BOUND
-        if (estimatedCpbFullness - estimatedBits < m_pcRateCtrl->getRCPic()->getLowerBound())
-        {
-          estimatedBits = max(200, estimatedCpbFullness - m_pcRateCtrl->getRCPic()->getLowerBound());
-        }
-#else
-        if (estimatedCpbFullness - estimatedBits < (Int)(m_pcRateCtrl->getCpbSize()*0.1f))
+        if (m_pcCfg->getEfficientFieldIRAPEnabled())
         {
-          estimatedBits = max(200, estimatedCpbFullness - (Int)(m_pcRateCtrl->getCpbSize()*0.1f));
+          iGOPid=effFieldIRAPMap.restoreGOPid(iGOPid);
         }
-#endif
-
-        m_pcRateCtrl->getRCPic()->setTargetBits(estimatedBits);
+        continue;
       }
-#endif
+      pcAccessUnit = &accessUnitsInGOP.back();
 
-      Int sliceQP = m_pcCfg->getInitialQP();
-      if ( ( pcSlice->getPOC() == 0 && m_pcCfg->getInitialQP() > 0 ) || ( frameLevel == 0 && m_pcCfg->getForceIntraQP() ) ) // QP is specified
+#if FRAME_PARALLEL_ENCODING
+      if ( xUseFrameThreads( isField ) )
       {
-        Int    NumberBFrames = ( m_pcCfg->getGOPSize() - 1 );
-        Double dLambda_scale = 1.0 - Clip3( 0.0, 0.5, 0.05*(Double)NumberBFrames );
-        Double dQPFactor     = 0.57*dLambda_scale;
-        Int    SHIFT_QP      = 12;
-        Int    bitdepth_luma_qp_scale = 0;
-        Double qp_temp = (Double) sliceQP + bitdepth_luma_qp_scale - SHIFT_QP;
-        lambda = dQPFactor*pow( 2.0, qp_temp/3.0 );
+        uiNumSliceSegments = xCompressFramePictures( iGOPid, iPOCLast, iNumPicRcvd, rcListPic, rcListPicYuvRecOut, accessUnitsInGOP, pcPic, framePictures );
       }
-      else if ( frameLevel == 0 )   // intra case, but use the model
-      {
-        m_pcSliceEncoder->calCostSliceI(pcPic); // TODO: This only analyses the first slice segment - what about the others?
-
-        if ( m_pcCfg->getIntraPeriod() != 1 )   // do not refine allocated bits for all intra case
-        {
-          Int bits = m_pcRateCtrl->getRCSeq()->getLeftAverageBits();
-          bits = m_pcRateCtrl->getRCPic()->getRefineBitsForIntra( bits );
-
-#if U0132_TARGET_BITS_SATURATION
-          if (m_pcRateCtrl->getCpbSaturationEnabled() )
-          {
-            Int estimatedCpbFullness = m_pcRateCtrl->getCpbState() + m_pcRateCtrl->getBufferingRate();
-
-            // prevent overflow
-            if (estimatedCpbFullness - bits > (Int)(m_pcRateCtrl->getCpbSize()*0.9f))
-            {
-              bits = estimatedCpbFullness - (Int)(m_pcRateCtrl->getCpbSize()*0.9f);
-            }
-
-            estimatedCpbFullness -= m_pcRateCtrl->getBufferingRate();
-            // prevent underflow
-#if V0078_ADAPTIVE_LOWER_BOUND
-            if (estimatedCpbFullness - bits < m_pcRateCtrl->getRCPic()->getLowerBound())
-            {
-              bits = estimatedCpbFullness - m_pcRateCtrl->getRCPic()->getLowerBound();
-            }
-#else
-            if (estimatedCpbFullness - bits < (Int)(m_pcRateCtrl->getCpbSize()*0.1f))
-            {
-              bits = estimatedCpbFullness - (Int)(m_pcRateCtrl->getCpbSize()*0.1f);
-            }
-#endif
-          }
+      else
 #endif
-
-          if ( bits < 200 )
-          {
-            bits = 200;
-          }
-          m_pcRateCtrl->getRCPic()->setTargetBits( bits );
-        }
-
-        list<TEncRCPic*> listPreviousPicture = m_pcRateCtrl->getPicList();
-        m_pcRateCtrl->getRCPic()->getLCUInitTargetBits();
-        lambda  = m_pcRateCtrl->getRCPic()->estimatePicLambda( listPreviousPicture, pcSlice->getSliceType());
-        sliceQP = m_pcRateCtrl->getRCPic()->estimatePicQP( lambda, listPreviousPicture );
-      }
-      else    // normal case
       {
-        list<TEncRCPic*> listPreviousPicture = m_pcRateCtrl->getPicList();
-        lambda  = m_pcRateCtrl->getRCPic()->estimatePicLambda( listPreviousPicture, pcSlice->getSliceType());
-        sliceQP = m_pcRateCtrl->getRCPic()->estimatePicQP( lambda, listPreviousPicture );
+        uiNumSliceSegments = xCompressPicture( pcPic, m_pcSliceEncoder );
       }
-
-      sliceQP = Clip3( -pcSlice->getSPS()->getQpBDOffset(CHANNEL_TYPE_LUMA), MAX_QP, sliceQP );
-      m_pcRateCtrl->getRCPic()->setPicEstQP( sliceQP );
-
-      m_pcSliceEncoder->resetQP( pcPic, sliceQP, lambda );
     }
+    AccessUnit& accessUnit = *pcAccessUnit;
 
-    UInt uiNumSliceSegments = 1;
+    duData.clear();
+    pcSlice = pcPic->getSlice(0);
 
     // Allocate some coders, now the number of tiles are known.
     const Int numSubstreamsColumns = (pcSlice->getPPS()->getNumTileColumnsMinus1() + 1);
@@ -1542,52 +1217,6 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     const Int numSubstreams        = numSubstreamRows * numSubstreamsColumns;
     std::vector<TComOutputBitstream> substreamsOut(numSubstreams);
 
-    // now compress (trial encode) the various slice segments (slices, and dependent slices)
-    {
-      const UInt numberOfCtusInFrame=pcPic->getPicSym()->getNumberOfCtusInFrame();
-      pcSlice->setSliceCurStartCtuTsAddr( 0 );
-      pcSlice->setSliceSegmentCurStartCtuTsAddr( 0 );
-
-      for(UInt nextCtuTsAddr = 0; nextCtuTsAddr < numberOfCtusInFrame; )
-      {
-        m_pcSliceEncoder->precompressSlice( pcPic );
-        m_pcSliceEncoder->compressSlice   ( pcPic, false, false );
-
-        const UInt curSliceSegmentEnd = pcSlice->getSliceSegmentCurEndCtuTsAddr();
-        if (curSliceSegmentEnd < numberOfCtusInFrame)
-        {
-          const Bool bNextSegmentIsDependentSlice=curSliceSegmentEnd<pcSlice->getSliceCurEndCtuTsAddr();
-          const UInt sliceBits=pcSlice->getSliceBits();
-          pcPic->allocateNewSlice();
-          // prepare for next slice
-          pcPic->setCurrSliceIdx                    ( uiNumSliceSegments );
-          m_pcSliceEncoder->setSliceIdx             ( uiNumSliceSegments   );
-          pcSlice = pcPic->getSlice                 ( uiNumSliceSegments   );
-          assert(pcSlice->getPPS()!=0);
-          pcSlice->copySliceInfo                    ( pcPic->getSlice(uiNumSliceSegments-1)  );
-          pcSlice->setSliceIdx                      ( uiNumSliceSegments   );
-          if (bNextSegmentIsDependentSlice)
-          {
-            pcSlice->setSliceBits(sliceBits);
-          }
-          else
-          {
-            pcSlice->setSliceCurStartCtuTsAddr      ( curSliceSegmentEnd );
-            pcSlice->setSliceBits(0);
-          }
-          pcSlice->setDependentSliceSegmentFlag(bNextSegmentIsDependentSlice);
-          pcSlice->setSliceSegmentCurStartCtuTsAddr ( curSliceSegmentEnd );
-          // TODO: optimise cabac_init during compress slice to improve multi-slice operation
-          // pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
-          uiNumSliceSegments ++;
-        }
-        nextCtuTsAddr = curSliceSegmentEnd;
-      }
-    }
-
-    duData.clear();
-    pcSlice = pcPic->getSlice(0);
-
     // SAO parameter estimation using non-deblocked pixels for CTU bottom and right boundary areas
     if( pcSlice->getSPS()->getUseSAO() && m_pcCfg->getSaoCtuBoundary() )
     {
@@ -1809,6 +1438,10 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     // cabac_zero_words processing
     cabac_zero_word_padding(pcSlice, pcPic, binCountsInNalUnits, numBytesInVclNalUnits, accessUnit.back()->m_nalUnitData, m_pcCfg->getCabacZeroWordPaddingEnabled());
 
+#if FRAME_PARALLEL_ENCODING
+    m_lastEncCABACTableIdx[pcSlice->getTLayer()] = m_pcSliceEncoder->getEncCABACTableIdx();
+#endif
+
     pcPic->compressMotion();
 
     //-- For time output for each slice
@@ -1829,6 +1462,9 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
 
     printHash(m_pcCfg->getDecodedPictureHashSEIType(), digestStr);
 #if SVIDEO_EXT && SVIDEO_VIEWPORT_PSNR
+#if SVIDEO_ASYNC_METRICS
+    if(!xIsAsyncSphMetrics())
+#endif
     m_pcEncTop->xCalculateViewPortPSNR(pcPic, NULL);
 #endif
 
@@ -1879,6 +1515,12 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     /* logging: insert a newline at end of picture period */
     printf("\n");
     fflush(stdout);
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+    if(xIsAsyncSphMetrics())
+    {
+      xFlushSphMetrics(false);
+    }
+#endif
 
     if (m_pcCfg->getEfficientFieldIRAPEnabled())
     {
@@ -1891,41 +1533,609 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
   assert ( (m_iNumPicCoded == iNumPicRcvd) );
 }
 
-Void TEncGOP::printOutSummary(UInt uiNumAllPicCoded, Bool isField, const Bool printMSEBasedSNR, const Bool printSequenceMSE, const BitDepths &bitDepths)
+/** set up the slice of the picture at GOP position iGOPid: picture type, reference picture set, reference lists and QP
+ * \returns false if the picture is beyond the end of the sequence
+ */
+Bool TEncGOP::xInitPicture( Int iGOPid, Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsInGOP,
+                            Bool isField, TEncSlice* pcSliceEncoder, TComPic*& rpcPic, TComPicYuv*& rpcPicYuvRecOut, Double& lambda, Int& estimatedBits )
 {
-  assert (uiNumAllPicCoded == m_gcAnalyzeAll.getNumPic());
-
-
-  //--CFG_KDY
-  const Int rateMultiplier=(isField?2:1);
-  m_gcAnalyzeAll.setFrmRate( m_pcCfg->getFrameRate()*rateMultiplier / (Double)m_pcCfg->getTemporalSubsampleRatio());
-  m_gcAnalyzeI.setFrmRate( m_pcCfg->getFrameRate()*rateMultiplier / (Double)m_pcCfg->getTemporalSubsampleRatio());
-  m_gcAnalyzeP.setFrmRate( m_pcCfg->getFrameRate()*rateMultiplier / (Double)m_pcCfg->getTemporalSubsampleRatio());
-  m_gcAnalyzeB.setFrmRate( m_pcCfg->getFrameRate()*rateMultiplier / (Double)m_pcCfg->getTemporalSubsampleRatio());
-  const ChromaFormat chFmt = m_pcCfg->getChromaFormatIdc();
-
-  //-- all
-  printf( "\n\nSUMMARY --------------------------------------------------------\n" );
-  m_gcAnalyzeAll.printOut('a', chFmt, printMSEBasedSNR, printSequenceMSE, bitDepths);
-
-  printf( "\n\nI Slices--------------------------------------------------------\n" );
-  m_gcAnalyzeI.printOut('i', chFmt, printMSEBasedSNR, printSequenceMSE, bitDepths);
+  TComSlice* pcSlice;
 
-  printf( "\n\nP Slices--------------------------------------------------------\n" );
-  m_gcAnalyzeP.printOut('p', chFmt, printMSEBasedSNR, printSequenceMSE, bitDepths);
+  UInt uiColDir = calculateCollocatedFromL1Flag(m_pcCfg, iGOPid, m_iGopSize);
 
-  printf( "\n\nB Slices--------------------------------------------------------\n" );
-  m_gcAnalyzeB.printOut('b', chFmt, printMSEBasedSNR, printSequenceMSE, bitDepths);
+  /////////////////////////////////////////////////////////////////////////////////////////////////// Initial to start encoding
+  Int iTimeOffset;
+  Int pocCurr;
 
-  if (!m_pcCfg->getSummaryOutFilename().empty())
+  if(iPOCLast == 0) //case first frame or first top field
   {
-    m_gcAnalyzeAll.printSummary(chFmt, printSequenceMSE, bitDepths, m_pcCfg->getSummaryOutFilename());
+    pocCurr=0;
+    iTimeOffset = 1;
   }
-
-  if (!m_pcCfg->getSummaryPicFilenameBase().empty())
+  else if(iPOCLast == 1 && isField) //case first bottom field, just like the first frame, the poc computation is not right anymore, we set the right value
   {
-    m_gcAnalyzeI.printSummary(chFmt, printSequenceMSE, bitDepths, m_pcCfg->getSummaryPicFilenameBase()+"I.txt");
-    m_gcAnalyzeP.printSummary(chFmt, printSequenceMSE, bitDepths, m_pcCfg->getSummaryPicFilenameBase()+"P.txt");
+    pocCurr = 1;
+    iTimeOffset = 1;
+  }
+  else
+  {
+    pocCurr = iPOCLast - iNumPicRcvd + m_pcCfg->getGOPEntry(iGOPid).m_POC - ((isField && m_iGopSize>1) ? 1:0);
+    iTimeOffset = m_pcCfg->getGOPEntry(iGOPid).m_POC;
+  }
+
+  if(pocCurr>=m_pcCfg->getFramesToBeEncoded())
+  {
+    return false;
+  }
+
+  if( getNalUnitType(pocCurr, m_iLastIDR, isField) == NAL_UNIT_CODED_SLICE_IDR_W_RADL || getNalUnitType(pocCurr, m_iLastIDR, isField) == NAL_UNIT_CODED_SLICE_IDR_N_LP )
+  {
+    m_iLastIDR = pocCurr;
+  }
+  // start a new access unit: create an entry in the list of output access units
+  accessUnitsInGOP.push_back(AccessUnit());
+  xGetBuffer( rcListPic, rcListPicYuvRecOut, iNumPicRcvd, iTimeOffset, rpcPic, rpcPicYuvRecOut, pocCurr, isField );
+
+  //  Slice data initialization
+  rpcPic->clearSliceBuffer();
+  rpcPic->allocateNewSlice();
+  pcSliceEncoder->setSliceIdx(0);
+  rpcPic->setCurrSliceIdx(0);
+
+  pcSliceEncoder->initEncSlice ( rpcPic, iPOCLast, pocCurr, iGOPid, pcSlice, isField );
+
+  //Set Frame/Field coding
+  pcSlice->getPic()->setField(isField);
+
+  pcSlice->setLastIDR(m_iLastIDR);
+  pcSlice->setSliceIdx(0);
+  //set default slice level flag to the same as SPS level flag
+  pcSlice->setLFCrossSliceBoundaryFlag(  pcSlice->getPPS()->getLoopFilterAcrossSlicesEnabledFlag()  );
+
+  if(pcSlice->getSliceType()==B_SLICE&&m_pcCfg->getGOPEntry(iGOPid).m_sliceType=='P')
+  {
+    pcSlice->setSliceType(P_SLICE);
+  }
+  if(pcSlice->getSliceType()==B_SLICE&&m_pcCfg->getGOPEntry(iGOPid).m_sliceType=='I')
+  {
+    pcSlice->setSliceType(I_SLICE);
+  }
+  
+  // Set the nal unit type
+  pcSlice->setNalUnitType(getNalUnitType(pocCurr, m_iLastIDR, isField));
+  if(pcSlice->getTemporalLayerNonReferenceFlag())
+  {
+    if (pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_TRAIL_R &&
+        !(m_iGopSize == 1 && pcSlice->getSliceType() == I_SLICE))
+      // Add this condition to avoid POC issues with encoder_intra_main.cfg configuration (see #1127 in bug tracker)
+    {
+      pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_TRAIL_N);
+    }
+    if(pcSlice->getNalUnitType()==NAL_UNIT_CODED_SLICE_RADL_R)
+    {
+      pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_RADL_N);
+    }
+    if(pcSlice->getNalUnitType()==NAL_UNIT_CODED_SLICE_RASL_R)
+    {
+      pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_RASL_N);
+    }
+  }
+
+  if (m_pcCfg->getEfficientFieldIRAPEnabled())
+  {
+    if ( pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_LP
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_RADL
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_N_LP
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_W_RADL
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_N_LP
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA )  // IRAP picture
+    {
+      m_associatedIRAPType = pcSlice->getNalUnitType();
+      m_associatedIRAPPOC = pocCurr;
+    }
+    pcSlice->setAssociatedIRAPType(m_associatedIRAPType);
+    pcSlice->setAssociatedIRAPPOC(m_associatedIRAPPOC);
+  }
+  // Do decoding refresh marking if any
+  pcSlice->decodingRefreshMarking(m_pocCRA, m_bRefreshPending, rcListPic, m_pcCfg->getEfficientFieldIRAPEnabled());
+  m_pcEncTop->selectReferencePictureSet(pcSlice, pocCurr, iGOPid);
+  if (!m_pcCfg->getEfficientFieldIRAPEnabled())
+  {
+    if ( pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_LP
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_RADL
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_N_LP
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_W_RADL
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_N_LP
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA )  // IRAP picture
+    {
+      m_associatedIRAPType = pcSlice->getNalUnitType();
+      m_associatedIRAPPOC = pocCurr;
+    }
+    pcSlice->setAssociatedIRAPType(m_associatedIRAPType);
+    pcSlice->setAssociatedIRAPPOC(m_associatedIRAPPOC);
+  }
+
+  if ((pcSlice->checkThatAllRefPicsAreAvailable(rcListPic, pcSlice->getRPS(), false, m_iLastRecoveryPicPOC, m_pcCfg->getDecodingRefreshType() == 3) != 0) || (pcSlice->isIRAP()) 
+    || (m_pcCfg->getEfficientFieldIRAPEnabled() && isField && pcSlice->getAssociatedIRAPType() >= NAL_UNIT_CODED_SLICE_BLA_W_LP && pcSlice->getAssociatedIRAPType() <= NAL_UNIT_CODED_SLICE_CRA && pcSlice->getAssociatedIRAPPOC() == pcSlice->getPOC()+1)
+    )
+  {
+    pcSlice->createExplicitReferencePictureSetFromReference(rcListPic, pcSlice->getRPS(), pcSlice->isIRAP(), m_iLastRecoveryPicPOC, m_pcCfg->getDecodingRefreshType() == 3, m_pcCfg->getEfficientFieldIRAPEnabled());
+  }
+
+  pcSlice->applyReferencePictureSet(rcListPic, pcSlice->getRPS());
+
+  if(pcSlice->getTLayer() > 0 
+    &&  !( pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RADL_N     // Check if not a leading picture
+        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RADL_R
+        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RASL_N
+        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RASL_R )
+      )
+  {
+    if(pcSlice->isTemporalLayerSwitchingPoint(rcListPic) || pcSlice->getSPS()->getTemporalIdNestingFlag())
+    {
+      if(pcSlice->getTemporalLayerNonReferenceFlag())
+      {
+        pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_TSA_N);
+      }
+      else
+      {
+        pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_TSA_R);
+      }
+    }
+    else if(pcSlice->isStepwiseTemporalLayerSwitchingPointCandidate(rcListPic))
+    {
+      Bool isSTSA=true;
+      for(Int ii=iGOPid+1;(ii<m_pcCfg->getGOPSize() && isSTSA==true);ii++)
+      {
+        Int lTid= m_pcCfg->getGOPEntry(ii).m_temporalId;
+        if(lTid==pcSlice->getTLayer())
+        {
+          const TComReferencePictureSet* nRPS = pcSlice->getSPS()->getRPSList()->getReferencePictureSet(ii);
+          for(Int jj=0;jj<nRPS->getNumberOfPictures();jj++)
+          {
+            if(nRPS->getUsed(jj))
+            {
+              Int tPoc=m_pcCfg->getGOPEntry(ii).m_POC+nRPS->getDeltaPOC(jj);
+              Int kk=0;
+              for(kk=0;kk<m_pcCfg->getGOPSize();kk++)
+              {
+                if(m_pcCfg->getGOPEntry(kk).m_POC==tPoc)
+                {
+                  break;
+                }
+              }
+              Int tTid=m_pcCfg->getGOPEntry(kk).m_temporalId;
+              if(tTid >= pcSlice->getTLayer())
+              {
+                isSTSA=false;
+                break;
+              }
+            }
+          }
+        }
+      }
+      if(isSTSA==true)
+      {
+        if(pcSlice->getTemporalLayerNonReferenceFlag())
+        {
+          pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_STSA_N);
+        }
+        else
+        {
+          pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_STSA_R);
+        }
+      }
+    }
+  }
+  arrangeLongtermPicturesInRPS(pcSlice, rcListPic);
+  TComRefPicListModification* refPicListModification = pcSlice->getRefPicListModification();
+  refPicListModification->setRefPicListModificationFlagL0(0);
+  refPicListModification->setRefPicListModificationFlagL1(0);
+  pcSlice->setNumRefIdx(REF_PIC_LIST_0,min(m_pcCfg->getGOPEntry(iGOPid).m_numRefPicsActive,pcSlice->getRPS()->getNumberOfPictures()));
+  pcSlice->setNumRefIdx(REF_PIC_LIST_1,min(m_pcCfg->getGOPEntry(iGOPid).m_numRefPicsActive,pcSlice->getRPS()->getNumberOfPictures()));
+
+  //  Set reference list
+  pcSlice->setRefPicList ( rcListPic );
+
+  //  Slice info. refinement
+  if ( (pcSlice->getSliceType() == B_SLICE) && (pcSlice->getNumRefIdx(REF_PIC_LIST_1) == 0) )
+  {
+    pcSlice->setSliceType ( P_SLICE );
+  }
+  pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
+
+  if (pcSlice->getSliceType() == B_SLICE)
+  {
+    pcSlice->setColFromL0Flag(1-uiColDir);
+    Bool bLowDelay = true;
+    Int  iCurrPOC  = pcSlice->getPOC();
+    Int iRefIdx = 0;
+
+    for (iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx(REF_PIC_LIST_0) && bLowDelay; iRefIdx++)
+    {
+      if ( pcSlice->getRefPic(REF_PIC_LIST_0, iRefIdx)->getPOC() > iCurrPOC )
+      {
+        bLowDelay = false;
+      }
+    }
+    for (iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx(REF_PIC_LIST_1) && bLowDelay; iRefIdx++)
+    {
+      if ( pcSlice->getRefPic(REF_PIC_LIST_1, iRefIdx)->getPOC() > iCurrPOC )
+      {
+        bLowDelay = false;
+      }
+    }
+
+    pcSlice->setCheckLDC(bLowDelay);
+  }
+  else
+  {
+    pcSlice->setCheckLDC(true);
+  }
+
+  uiColDir = 1-uiColDir;
+
+  //-------------------------------------------------------------
+  pcSlice->setRefPOCList();
+
+  pcSlice->setList1IdxToList0Idx();
+
+  if (m_pcEncTop->getTMVPModeId() == 2)
+  {
+    if (iGOPid == 0) // first picture in SOP (i.e. forward B)
+    {
+      pcSlice->setEnableTMVPFlag(0);
+    }
+    else
+    {
+      // Note: pcSlice->getColFromL0Flag() is assumed to be always 0 and getcolRefIdx() is always 0.
+      pcSlice->setEnableTMVPFlag(1);
+    }
+  }
+  else if (m_pcEncTop->getTMVPModeId() == 1)
+  {
+    pcSlice->setEnableTMVPFlag(1);
+  }
+  else
+  {
+    pcSlice->setEnableTMVPFlag(0);
+  }
+  
+  // set adaptive search range for non-intra-slices
+  if (m_pcCfg->getUseASR() && pcSlice->getSliceType()!=I_SLICE)
+  {
+    pcSliceEncoder->setSearchRange(pcSlice);
+  }
+
+  Bool bGPBcheck=false;
+  if ( pcSlice->getSliceType() == B_SLICE)
+  {
+    if ( pcSlice->getNumRefIdx(RefPicList( 0 ) ) == pcSlice->getNumRefIdx(RefPicList( 1 ) ) )
+    {
+      bGPBcheck=true;
+      Int i;
+      for ( i=0; i < pcSlice->getNumRefIdx(RefPicList( 1 ) ); i++ )
+      {
+        if ( pcSlice->getRefPOC(RefPicList(1), i) != pcSlice->getRefPOC(RefPicList(0), i) )
+        {
+          bGPBcheck=false;
+          break;
+        }
+      }
+    }
+  }
+  if(bGPBcheck)
+  {
+    pcSlice->setMvdL1ZeroFlag(true);
+  }
+  else
+  {
+    pcSlice->setMvdL1ZeroFlag(false);
+  }
+  rpcPic->getSlice(pcSlice->getSliceIdx())->setMvdL1ZeroFlag(pcSlice->getMvdL1ZeroFlag());
+
+
+  if ( m_pcCfg->getUseRateCtrl() ) // TODO: does this work with multiple slices and slice-segments?
+  {
+    Int frameLevel = m_pcRateCtrl->getRCSeq()->getGOPID2Level( iGOPid );
+    if ( rpcPic->getSlice(0)->getSliceType() == I_SLICE )
+    {
+      frameLevel = 0;
+    }
+    m_pcRateCtrl->initRCPic( frameLevel );
+    estimatedBits = m_pcRateCtrl->getRCPic()->getTargetBits();
+
+#if U0132_TARGET_BITS_SATURATION
+    if (m_pcRateCtrl->getCpbSaturationEnabled() && frameLevel != 0)
+    {
+      Int estimatedCpbFullness = m_pcRateCtrl->getCpbState() + m_pcRateCtrl->getBufferingRate();
+
+      // prevent overflow
+      if (estimatedCpbFullness - estimatedBits > (Int)(m_pcRateCtrl->getCpbSize()*0.9f))
+      {
+        estimatedBits = estimatedCpbFullness - (Int)(m_pcRateCtrl->getCpbSize()*0.9f);
+      }
+
+      estimatedCpbFullness -= m_pcRateCtrl->getBufferingRate();
+      // prevent underflow
+#if V0078_ADAPTIVE_LOWER_BOUND
+      if (estimatedCpbFullness - estimatedBits < m_pcRateCtrl->getRCPic()->getLowerBound())
+      {
+        estimatedBits = max(200, estimatedCpbFullness - m_pcRateCtrl->getRCPic()->getLowerBound());
+      }
+#else
+      if (estimatedCpbFullness - estimatedBits < (Int)(m_pcRateCtrl->getCpbSize()*0.1f))
+      {
+        estimatedBits = max(200, estimatedCpbFullness - (Int)(m_pcRateCtrl->getCpbSize()*0.1f));
+      }
+#endif
+
+      m_pcRateCtrl->getRCPic()->setTargetBits(estimatedBits);
+    }
+#endif
+
+    Int sliceQP = m_pcCfg->getInitialQP();
+    if ( ( pcSlice->getPOC() == 0 && m_pcCfg->getInitialQP() > 0 ) || ( frameLevel == 0 && m_pcCfg->getForceIntraQP() ) ) // QP is specified
+    {
+      Int    NumberBFrames = ( m_pcCfg->getGOPSize() - 1 );
+      Double dLambda_scale = 1.0 - Clip3( 0.0, 0.5, 0.05*(Double)NumberBFrames );
+      Double dQPFactor     = 0.57*dLambda_scale;
+      Int    SHIFT_QP      = 12;
+      Int    bitdepth_luma_qp_scale = 0;
+      Double qp_temp = (Double) sliceQP + bitdepth_luma_qp_scale - SHIFT_QP;
+      lambda = dQPFactor*pow( 2.0, qp_temp/3.0 );
+    }
+    else if ( frameLevel == 0 )   // intra case, but use the model
+    {
+      pcSliceEncoder->calCostSliceI(rpcPic); // TODO: This only analyses the first slice segment - what about the others?
+
+      if ( m_pcCfg->getIntraPeriod() != 1 )   // do not refine allocated bits for all intra case
+      {
+        Int bits = m_pcRateCtrl->getRCSeq()->getLeftAverageBits();
+        bits = m_pcRateCtrl->getRCPic()->getRefineBitsForIntra( bits );
+
+#if U0132_TARGET_BITS_SATURATION
+        if (m_pcRateCtrl->getCpbSaturationEnabled() )
+        {
+          Int estimatedCpbFullness = m_pcRateCtrl->getCpbState() + m_pcRateCtrl->getBufferingRate();
+
+          // prevent overflow
+          if (estimatedCpbFullness - bits > (Int)(m_pcRateCtrl->getCpbSize()*0.9f))
+          {
+            bits = estimatedCpbFullness - (Int)(m_pcRateCtrl->getCpbSize()*0.9f);
+          }
+
+          estimatedCpbFullness -= m_pcRateCtrl->getBufferingRate();
+          // prevent underflow
+#if V0078_ADAPTIVE_LOWER_BOUND
+          if (estimatedCpbFullness - bits < m_pcRateCtrl->getRCPic()->getLowerBound())
+          {
+            bits = estimatedCpbFullness - m_pcRateCtrl->getRCPic()->getLowerBound();
+          }
+#else
+          if (estimatedCpbFullness - bits < (Int)(m_pcRateCtrl->getCpbSize()*0.1f))
+          {
+            bits = estimatedCpbFullness - (Int)(m_pcRateCtrl->getCpbSize()*0.1f);
+          }
+#endif
+        }
+#endif
+
+        if ( bits < 200 )
+        {
+          bits = 200;
+        }
+        m_pcRateCtrl->getRCPic()->setTargetBits( bits );
+      }
+
+      list<TEncRCPic*> listPreviousPicture = m_pcRateCtrl->getPicList();
+      m_pcRateCtrl->getRCPic()->getLCUInitTargetBits();
+      lambda  = m_pcRateCtrl->getRCPic()->estimatePicLambda( listPreviousPicture, pcSlice->getSliceType());
+      sliceQP = m_pcRateCtrl->getRCPic()->estimatePicQP( lambda, listPreviousPicture );
+    }
+    else    // normal case
+    {
+      list<TEncRCPic*> listPreviousPicture = m_pcRateCtrl->getPicList();
+      lambda  = m_pcRateCtrl->getRCPic()->estimatePicLambda( listPreviousPicture, pcSlice->getSliceType());
+      sliceQP = m_pcRateCtrl->getRCPic()->estimatePicQP( lambda, listPreviousPicture );
+    }
+
+    sliceQP = Clip3( -pcSlice->getSPS()->getQpBDOffset(CHANNEL_TYPE_LUMA), MAX_QP, sliceQP );
+    m_pcRateCtrl->getRCPic()->setPicEstQP( sliceQP );
+
+    pcSliceEncoder->resetQP( rpcPic, sliceQP, lambda );
+  }
+
+  return true;
+}
+
+/** compress (trial encode) the slice segments of a picture set up by xInitPicture
+ * \returns number of slice segments
+ */
+UInt TEncGOP::xCompressPicture( TComPic* pcPic, TEncSlice* pcSliceEncoder )
+{
+  TComSlice* pcSlice = pcPic->getSlice(0);
+  UInt uiNumSliceSegments = 1;
+
+  // now compress (trial encode) the various slice segments (slices, and dependent slices)
+  const UInt numberOfCtusInFrame=pcPic->getPicSym()->getNumberOfCtusInFrame();
+  pcPic->setCurrSliceIdx( 0 );
+  pcSliceEncoder->setSliceIdx( 0 );
+  pcSlice->setSliceCurStartCtuTsAddr( 0 );
+  pcSlice->setSliceSegmentCurStartCtuTsAddr( 0 );
+
+  for(UInt nextCtuTsAddr = 0; nextCtuTsAddr < numberOfCtusInFrame; )
+  {
+    pcSliceEncoder->precompressSlice( pcPic );
+    pcSliceEncoder->compressSlice   ( pcPic, false, false );
+
+    const UInt curSliceSegmentEnd = pcSlice->getSliceSegmentCurEndCtuTsAddr();
+    if (curSliceSegmentEnd < numberOfCtusInFrame)
+    {
+      const Bool bNextSegmentIsDependentSlice=curSliceSegmentEnd<pcSlice->getSliceCurEndCtuTsAddr();
+      const UInt sliceBits=pcSlice->getSliceBits();
+      pcPic->allocateNewSlice();
+      // prepare for next slice
+      pcPic->setCurrSliceIdx                    ( uiNumSliceSegments );
+      pcSliceEncoder->setSliceIdx               ( uiNumSliceSegments   );
+      pcSlice = pcPic->getSlice                 ( uiNumSliceSegments   );
+      assert(pcSlice->getPPS()!=0);
+      pcSlice->copySliceInfo                    ( pcPic->getSlice(uiNumSliceSegments-1)  );
+      pcSlice->setSliceIdx                      ( uiNumSliceSegments   );
+      if (bNextSegmentIsDependentSlice)
+      {
+        pcSlice->setSliceBits(sliceBits);
+      }
+      else
+      {
+        pcSlice->setSliceCurStartCtuTsAddr      ( curSliceSegmentEnd );
+        pcSlice->setSliceBits(0);
+      }
+      pcSlice->setDependentSliceSegmentFlag(bNextSegmentIsDependentSlice);
+      pcSlice->setSliceSegmentCurStartCtuTsAddr ( curSliceSegmentEnd );
+      // TODO: optimise cabac_init during compress slice to improve multi-slice operation
+      // pcSlice->setEncCABACTableIdx(pcSliceEncoder->getEncCABACTableIdx());
+      uiNumSliceSegments ++;
+    }
+    nextCtuTsAddr = curSliceSegmentEnd;
+  }
+
+  return uiNumSliceSegments;
+}
+
+#if FRAME_PARALLEL_ENCODING
+/** pictures can only be compressed ahead of their turn if their setup does not depend on how the previous picture was compressed
+ */
+Bool TEncGOP::xUseFrameThreads( Bool isField ) const
+{
+  if ( m_pcEncTop->getNumFrameSliceEncoders() == 0 || isField )
+  {
+    return false;
+  }
+  // rate control and adaptive QP selection carry statistics from one picture to the next
+  if ( m_pcCfg->getUseRateCtrl() )
+  {
+    return false;
+  }
+#if ADAPTIVE_QP_SELECTION
+  if ( m_pcCfg->getUseAdaptQpSelect() )
+  {
+    return false;
+  }
+#endif
+  // a picture compressed again after a wrong CABAC table guess must consist of a single slice segment
+  return m_pcCfg->getSliceMode() == NO_SLICES && m_pcCfg->getSliceSegmentMode() == NO_SLICES;
+}
+
+/** set up the pictures following pcPic in the GOP that reference neither pcPic nor each other, one per frame thread,
+ *  and compress them together with pcPic; the frame pictures are returned in framePictures
+ * \returns number of slice segments of pcPic
+ */
+UInt TEncGOP::xCompressFramePictures( Int iGOPid, Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsInGOP,
+                                      TComPic* pcPic, std::deque<FramePicture>& framePictures )
+{
+  std::vector<Int> compressedPOCs( 1, pcPic->getPOC() );
+
+  for ( Int iNextGOPid = iGOPid + 1; iNextGOPid < m_iGopSize && (Int)framePictures.size() < m_pcEncTop->getNumFrameSliceEncoders(); iNextGOPid++ )
+  {
+    const Int pocNext = iPOCLast - iNumPicRcvd + m_pcCfg->getGOPEntry(iNextGOPid).m_POC;
+    if ( pocNext >= m_pcCfg->getFramesToBeEncoded() )
+    {
+      break;
+    }
+    const NalUnitType nalUnitType = getNalUnitType( pocNext, m_iLastIDR, false );
+    if ( nalUnitType >= NAL_UNIT_CODED_SLICE_BLA_W_LP && nalUnitType <= NAL_UNIT_RESERVED_IRAP_VCL23 )
+    {
+      break;
+    }
+    const GOPEntry& rpsEntry = m_pcCfg->getGOPEntry( m_pcEncTop->getReferencePictureSetIdxForSOP( pocNext, iNextGOPid ) );
+    Bool bIndependent = true;
+    for ( Int i = 0; i < rpsEntry.m_numRefPics && bIndependent; i++ )
+    {
+      // pictures only kept for later pictures are not used to compress this one
+      bIndependent = !rpsEntry.m_usedByCurrPic[i] || std::find( compressedPOCs.begin(), compressedPOCs.end(), pocNext + rpsEntry.m_referencePics[i] ) == compressedPOCs.end();
+    }
+    if ( !bIndependent )
+    {
+      break;
+    }
+
+    FramePicture framePicture;
+    framePicture.iGOPid             = iNextGOPid;
+    framePicture.pcSliceEncoder     = m_pcEncTop->getFrameSliceEncoder( (Int)framePictures.size() );
+    framePicture.iBeforeTime        = clock();
+    framePicture.uiNumSliceSegments = 1;
+
+    Double lambda      = 0.0;
+    Int estimatedBits  = 0;
+    xInitPicture( iNextGOPid, iPOCLast, iNumPicRcvd, rcListPic, rcListPicYuvRecOut, accessUnitsInGOP, false, framePicture.pcSliceEncoder,
+                  framePicture.pcPic, framePicture.pcPicYuvRecOut, lambda, estimatedBits );
+    framePicture.pcAccessUnit       = &accessUnitsInGOP.back();
+
+    // the CABAC table is chosen when the previous picture is written, guess it from the last picture of the same temporal layer as that one
+    const TComPic* pcPrevPic = framePictures.empty() ? pcPic : framePictures.back().pcPic;
+    framePicture.pcPic->getSlice(0)->setEncCABACTableIdx( m_lastEncCABACTableIdx[pcPrevPic->getSlice(0)->getTLayer()] );
+
+    framePictures.push_back( framePicture );
+    compressedPOCs.push_back( pocNext );
+  }
+
+  UInt uiNumSliceSegments = 1;
+  m_pcEncTop->getWppThreadPool()->parallelFor( (Int)framePictures.size() + 1, [&]( Int job )
+  {
+    if ( job == 0 )
+    {
+      uiNumSliceSegments = xCompressPicture( pcPic, m_pcSliceEncoder );
+    }
+    else
+    {
+      FramePicture& framePicture = framePictures[job - 1];
+      framePicture.uiNumSliceSegments = xCompressPicture( framePicture.pcPic, framePicture.pcSliceEncoder );
+    }
+  } );
+
+  return uiNumSliceSegments;
+}
+#endif
+
+Void TEncGOP::printOutSummary(UInt uiNumAllPicCoded, Bool isField, const Bool printMSEBasedSNR, const Bool printSequenceMSE, const BitDepths &bitDepths)
+{
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+  xFlushSphMetrics(true);
+#endif
+  assert (uiNumAllPicCoded == m_gcAnalyzeAll.getNumPic());
+
+
+  //--CFG_KDY
+  const Int rateMultiplier=(isField?2:1);
+  m_gcAnalyzeAll.setFrmRate( m_pcCfg->getFrameRate()*rateMultiplier / (Double)m_pcCfg->getTemporalSubsampleRatio());
+  m_gcAnalyzeI.setFrmRate( m_pcCfg->getFrameRate()*rateMultiplier / (Double)m_pcCfg->getTemporalSubsampleRatio());
+  m_gcAnalyzeP.setFrmRate( m_pcCfg->getFrameRate()*rateMultiplier / (Double)m_pcCfg->getTemporalSubsampleRatio());
+  m_gcAnalyzeB.setFrmRate( m_pcCfg->getFrameRate()*rateMultiplier / (Double)m_pcCfg->getTemporalSubsampleRatio());
+  const ChromaFormat chFmt = m_pcCfg->getChromaFormatIdc();
+
+  //-- all
+  printf( "\n\nSUMMARY --------------------------------------------------------\n" );
+  m_gcAnalyzeAll.printOut('a', chFmt, printMSEBasedSNR, printSequenceMSE, bitDepths);
+
+  printf( "\n\nI Slices--------------------------------------------------------\n" );
+  m_gcAnalyzeI.printOut('i', chFmt, printMSEBasedSNR, printSequenceMSE, bitDepths);
+
+  printf( "\n\nP Slices--------------------------------------------------------\n" );
+  m_gcAnalyzeP.printOut('p', chFmt, printMSEBasedSNR, printSequenceMSE, bitDepths);
+
+  printf( "\n\nB Slices--------------------------------------------------------\n" );
+  m_gcAnalyzeB.printOut('b', chFmt, printMSEBasedSNR, printSequenceMSE, bitDepths);
+
+  if (!m_pcCfg->getSummaryOutFilename().empty())
+  {
+    m_gcAnalyzeAll.printSummary(chFmt, printSequenceMSE, bitDepths, m_pcCfg->getSummaryOutFilename());
+  }
+
+  if (!m_pcCfg->getSummaryPicFilenameBase().empty())
+  {
+    m_gcAnalyzeI.printSummary(chFmt, printSequenceMSE, bitDepths, m_pcCfg->getSummaryPicFilenameBase()+"I.txt");
+    m_gcAnalyzeP.printSummary(chFmt, printSequenceMSE, bitDepths, m_pcCfg->getSummaryPicFilenameBase()+"P.txt");
     m_gcAnalyzeB.printSummary(chFmt, printSequenceMSE, bitDepths, m_pcCfg->getSummaryPicFilenameBase()+"B.txt");
   }
 
@@ -2147,6 +2357,14 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
 
   //===== calculate PSNR =====
   Double MSEyuvframe[MAX_NUM_COMPONENT] = {0, 0, 0};
+#if SVIDEO_EXT && SVIDEO_FUSED_METRICS
+  //S-PSNR and WS-PSNR share the pass over the samples with the PSNR, unless they are computed on the metric thread;
+  const Bool bFusedMetrics = m_cFusedMetricCalc.isEnabled() && !xIsAsyncSphMetrics() && conversion==IPCOLOURSPACE_UNCHANGED && pcPicD==pcPic->getPicYuvRec() && !pcPic->isField();
+  if(bFusedMetrics)
+  {
+    m_cFusedMetricCalc.calculate(pcPic->getPicYuvOrg(), pcPicD, true);
+  }
+#endif
 
   for(Int chan=0; chan<pcPicD->getNumberValidComponents(); chan++)
   {
@@ -2162,6 +2380,13 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
     Int   iSize   = iWidth*iHeight;
 
     UInt64 uiSSDtemp=0;
+#if SVIDEO_EXT && SVIDEO_FUSED_METRICS
+    if(bFusedMetrics)
+    {
+      uiSSDtemp = m_cFusedMetricCalc.getSSD(ch);
+    }
+    else
+#endif
     for(Int y = 0; y < iHeight; y++ )
     {
       for(Int x = 0; x < iWidth; x++ )
@@ -2177,7 +2402,21 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
     dPSNR[ch]         = ( uiSSDtemp ? 10.0 * log10( fRefValue / (Double)uiSSDtemp ) : 999.99 );
     MSEyuvframe[ch]   = (Double)uiSSDtemp/(iSize);
   }
-#if SVIDEO_EXT
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+  SphMetricResult sphMetrics;
+  sphMetrics.iPOC = pcPic->getPOC();
+#if SVIDEO_FUSED_METRICS
+  sphMetrics.bFusedDone = bFusedMetrics;
+#endif
+  if(xIsAsyncSphMetrics())
+  {
+    xSubmitSphMetrics(pcPic);
+  }
+  else
+  {
+    xCalculateSphMetrics(sphMetrics, pcPic->getPicYuvOrg(), pcPic->getPicYuvRec(), false);
+  }
+#elif SVIDEO_EXT
 #if SVIDEO_SPSNR_NN
   if(getSPSNRMetric()->getSPSNREnabled())
   { 
@@ -2233,7 +2472,7 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
 
   //===== add PSNR =====
   m_gcAnalyzeAll.addResult (dPSNR, (Double)uibits, MSEyuvframe);
-#if SVIDEO_EXT
+#if SVIDEO_EXT && !SVIDEO_ASYNC_METRICS
 #if SVIDEO_SPSNR_NN
   if(getSPSNRMetric()->getSPSNREnabled())
   {
@@ -2271,10 +2510,19 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
 #endif
 #endif
   TComSlice*  pcSlice = pcPic->getSlice(0);
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+  if(!xIsAsyncSphMetrics())
+  {
+    sphMetrics.bIntra  = pcSlice->isIntra();
+    sphMetrics.bInterP = pcSlice->isInterP();
+    sphMetrics.bInterB = pcSlice->isInterB();
+    xAddSphMetrics(sphMetrics);
+  }
+#endif
   if (pcSlice->isIntra())
   {
     m_gcAnalyzeI.addResult (dPSNR, (Double)uibits, MSEyuvframe);
-#if SVIDEO_EXT
+#if SVIDEO_EXT && !SVIDEO_ASYNC_METRICS
 #if SVIDEO_SPSNR_NN
     if(getSPSNRMetric()->getSPSNREnabled())
     {
@@ -2315,7 +2563,7 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
   if (pcSlice->isInterP())
   {
     m_gcAnalyzeP.addResult (dPSNR, (Double)uibits, MSEyuvframe);
-#if SVIDEO_EXT
+#if SVIDEO_EXT && !SVIDEO_ASYNC_METRICS
 #if SVIDEO_SPSNR_NN
     if(getSPSNRMetric()->getSPSNREnabled())
     {
@@ -2356,7 +2604,7 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
   if (pcSlice->isInterB())
   {
     m_gcAnalyzeB.addResult (dPSNR, (Double)uibits, MSEyuvframe);
-#if SVIDEO_EXT
+#if SVIDEO_EXT && !SVIDEO_ASYNC_METRICS
 #if SVIDEO_SPSNR_NN
     if(getSPSNRMetric()->getSPSNREnabled())
     {
@@ -2423,7 +2671,12 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
   {
     printf(" [Y MSE %6.4lf  U MSE %6.4lf  V MSE %6.4lf]", MSEyuvframe[COMPONENT_Y], MSEyuvframe[COMPONENT_Cb], MSEyuvframe[COMPONENT_Cr] );
   }
-#if SVIDEO_EXT
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+  if(!xIsAsyncSphMetrics())
+  {
+    xPrintSphMetrics(sphMetrics);
+  }
+#elif SVIDEO_EXT
 #if SVIDEO_SPSNR_NN && SVIDEO_SPSNR_NN_REPORT_PER_FRAME
   if(getSPSNRMetric()->getSPSNREnabled())
   {
@@ -2472,6 +2725,352 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
   cscd.destroy();
 }
 
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+/** \brief calculate the enabled spherical metrics of one picture;
+ * every metric keeps its own state, so a metric runs for one picture at a time, different metrics run in parallel;
+ */
+Void TEncGOP::xCalculateSphMetrics( SphMetricResult& result, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvRec, Bool bViewPort )
+{
+  std::vector<std::function<Void()> > metrics;
+#if SVIDEO_FUSED_METRICS
+  TSPSNRMetric  *pcFusedSPSNR  = m_cFusedMetricCalc.getSPSNRMetric();
+  TWSPSNRMetric *pcFusedWSPSNR = m_cFusedMetricCalc.getWSPSNRMetric();
+  if(m_cFusedMetricCalc.isEnabled())
+  {
+    metrics.push_back([&]()
+    {
+      if(!result.bFusedDone)
+      {
+        m_cFusedMetricCalc.calculate(pcPicYuvOrg, pcPicYuvRec, false);
+      }
+      if(pcFusedSPSNR)
+      {
+        memcpy(result.dSPSNR, pcFusedSPSNR->getSPSNR(), sizeof(result.dSPSNR));
+      }
+      if(pcFusedWSPSNR)
+      {
+        memcpy(result.dWSPSNR, pcFusedWSPSNR->getWSPSNR(), sizeof(result.dWSPSNR));
+      }
+    });
+  }
+#endif
+#if SVIDEO_SPSNR_NN
+#if SVIDEO_FUSED_METRICS
+  if(getSPSNRMetric()->getSPSNREnabled() && !pcFusedSPSNR)
+#else
+  if(getSPSNRMetric()->getSPSNREnabled())
+#endif
+  {
+    metrics.push_back([&]()
+    {
+      getSPSNRMetric()->xCalculateSPSNR(pcPicYuvOrg, pcPicYuvRec);
+      memcpy(result.dSPSNR, getSPSNRMetric()->getSPSNR(), sizeof(result.dSPSNR));
+    });
+  }
+#endif
+#if SVIDEO_WSPSNR
+#if SVIDEO_FUSED_METRICS
+  if(getWSPSNRMetric()->getWSPSNREnabled() && !pcFusedWSPSNR)
+#else
+  if(getWSPSNRMetric()->getWSPSNREnabled())
+#endif
+  {
+    metrics.push_back([&]()
+    {
+      getWSPSNRMetric()->xCalculateWSPSNR(pcPicYuvOrg, pcPicYuvRec);
+      memcpy(result.dWSPSNR, getWSPSNRMetric()->getWSPSNR(), sizeof(result.dWSPSNR));
+    });
+  }
+#if SVIDEO_WSPSNR_E2E
+  if(getE2EWSPSNRMetric()->getWSPSNREnabled())
+  {
+    metrics.push_back([&]()
+    {
+      getE2EWSPSNRMetric()->xCalculateE2EWSPSNR(pcPicYuvRec, result.iPOC);
+      memcpy(result.dE2EWSPSNR, getE2EWSPSNRMetric()->getWSPSNR(), sizeof(result.dE2EWSPSNR));
+    });
+  }
+#endif
+#endif
+#if SVIDEO_SPSNR_I
+  if(getSPSNRIMetric()->getSPSNRIEnabled())
+  {
+    metrics.push_back([&]()
+    {
+      getSPSNRIMetric()->xCalculateSPSNRI(pcPicYuvOrg, pcPicYuvRec);
+      memcpy(result.dSPSNRI, getSPSNRIMetric()->getSPSNRI(), sizeof(result.dSPSNRI));
+    });
+  }
+#endif
+#if SVIDEO_CPPPSNR
+  if(getCPPPSNRMetric()->getCPPPSNREnabled())
+  {
+    metrics.push_back([&]()
+    {
+      getCPPPSNRMetric()->xCalculateCPPPSNR(pcPicYuvOrg, pcPicYuvRec);
+      memcpy(result.dCPPPSNR, getCPPPSNRMetric()->getCPPPSNR(), sizeof(result.dCPPPSNR));
+    });
+  }
+#endif
+#if SVIDEO_VIEWPORT_PSNR
+  TViewPortPSNR *pcViewPortPSNR = m_pcEncTop->getViewPortPSNR();
+  if(bViewPort && pcViewPortPSNR->isEnabled())
+  {
+    result.vpPSNR.resize(pcViewPortPSNR->getNumViewPorts()*MAX_NUM_COMPONENT);
+    result.vpMSE.resize(pcViewPortPSNR->getNumViewPorts()*MAX_NUM_COMPONENT);
+    metrics.push_back([&]()
+    {
+      pcViewPortPSNR->xCalculatePSNR(pcPicYuvRec, result.iPOC, &result.vpPSNR[0], &result.vpMSE[0]);
+    });
+  }
+#endif
+  m_sphMetricPool.parallelFor((Int)metrics.size(), [&](Int i) { metrics[i](); });
+}
+
+Void TEncGOP::xAddSphMetrics( SphMetricResult& result )
+{
+  TEncAnalyze *apcAnalyze[4] = { &m_gcAnalyzeAll, result.bIntra? &m_gcAnalyzeI : NULL, result.bInterP? &m_gcAnalyzeP : NULL, result.bInterB? &m_gcAnalyzeB : NULL };
+  for(Int i=0; i<4; i++)
+  {
+    TEncAnalyze *pcAnalyze = apcAnalyze[i];
+    if(pcAnalyze == NULL)
+    {
+      continue;
+    }
+#if SVIDEO_SPSNR_NN
+    if(getSPSNRMetric()->getSPSNREnabled())
+    {
+      pcAnalyze->setSPSNREnabled(true);
+      pcAnalyze->addSPSNR(result.dSPSNR);
+    }
+#endif
+#if SVIDEO_WSPSNR
+    if(getWSPSNRMetric()->getWSPSNREnabled())
+    {
+      pcAnalyze->setWSPSNREnabled(true);
+      pcAnalyze->addWSPSNR(result.dWSPSNR);
+    }
+#if SVIDEO_WSPSNR_E2E
+    if(getE2EWSPSNRMetric()->getWSPSNREnabled())
+    {
+      pcAnalyze->setE2EWSPSNREnabled(true);
+      pcAnalyze->addE2EWSPSNR(result.dE2EWSPSNR);
+    }
+#endif
+#endif
+#if SVIDEO_SPSNR_I
+    if(getSPSNRIMetric()->getSPSNRIEnabled())
+    {
+      pcAnalyze->setSPSNRIEnabled(true);
+      pcAnalyze->addSPSNRI(result.dSPSNRI);
+    }
+#endif
+#if SVIDEO_CPPPSNR
+    if(getCPPPSNRMetric()->getCPPPSNREnabled())
+    {
+      pcAnalyze->setCPPPSNREnabled(true);
+      pcAnalyze->addCPPPSNR(result.dCPPPSNR);
+    }
+#endif
+  }
+}
+
+Void TEncGOP::xPrintSphMetrics( const SphMetricResult& result )
+{
+#if SVIDEO_SPSNR_NN && SVIDEO_SPSNR_NN_REPORT_PER_FRAME
+  if(getSPSNRMetric()->getSPSNREnabled())
+  {
+    printf(" [Y-SPSNR_NN %6.4lf dB    U-SPSNR_NN %6.4lf dB    V-SPSNR_NN %6.4lf dB]", result.dSPSNR[COMPONENT_Y], result.dSPSNR[COMPONENT_Cb], result.dSPSNR[COMPONENT_Cr] );
+  }
+#endif
+#if SVIDEO_WSPSNR && SVIDEO_WSPSNR_REPORT_PER_FRAME
+  if(getWSPSNRMetric()->getWSPSNREnabled())
+  {
+    printf(" [Y-WSPSNR %6.4lf dB   U-WSPSNR %6.4lf dB   V-WSPSNR %6.4lf dB]", result.dWSPSNR[COMPONENT_Y], result.dWSPSNR[COMPONENT_Cb], result.dWSPSNR[COMPONENT_Cr] );
+  }
+#endif
+#if SVIDEO_SPSNR_I && SVIDEO_SPSNR_I_REPORT_PER_FRAME
+  if(getSPSNRIMetric()->getSPSNRIEnabled())
+  {
+    printf(" [Y-SPSNR_I %6.4lf dB    U-SPSNR_I %6.4lf dB    V-SPSNR_I %6.4lf dB]", result.dSPSNRI[COMPONENT_Y], result.dSPSNRI[COMPONENT_Cb], result.dSPSNRI[COMPONENT_Cr] );
+  }
+#endif
+#if SVIDEO_CPPPSNR && SVIDEO_CPPPSNR_REPORT_PER_FRAME
+  if(getCPPPSNRMetric()->getCPPPSNREnabled())
+  {
+    printf(" [Y-CPPPSNR %6.4lf dB   U-CPPPSNR %6.4lf dB   V-CPPPSNR %6.4lf dB]", result.dCPPPSNR[COMPONENT_Y], result.dCPPPSNR[COMPONENT_Cb], result.dCPPPSNR[COMPONENT_Cr] );
+  }
+#endif
+#if SVIDEO_WSPSNR_E2E && SVIDEO_WSPSNR_E2E_REPORT_PER_FRAME
+  if(getE2EWSPSNRMetric()->getWSPSNREnabled())
+  {
+    printf(" [Y-E2EWSPSNR %6.4lf dB   U-E2EWSPSNR %6.4lf dB   V-E2EWSPSNR %6.4lf dB]", result.dE2EWSPSNR[COMPONENT_Y], result.dE2EWSPSNR[COMPONENT_Cb], result.dE2EWSPSNR[COMPONENT_Cr] );
+  }
+#endif
+}
+
+/** \brief copy a picture for the metric thread; the copy goes back to the free list when its last reference is released;
+ */
+std::shared_ptr<TComPicYuv> TEncGOP::xCreateSphMetricSnapshot( const TComPicYuv* pcPicYuv )
+{
+  const Int iWidth  = pcPicYuv->getWidth(COMPONENT_Y);
+  const Int iHeight = pcPicYuv->getHeight(COMPONENT_Y);
+  TComPicYuv *pcSnapshot = NULL;
+  {
+    std::lock_guard<std::mutex> lock(m_sphMetricMutex);
+    if(!m_sphMetricFreePics.empty())
+    {
+      pcSnapshot = m_sphMetricFreePics.back();
+      m_sphMetricFreePics.pop_back();
+    }
+  }
+  if(pcSnapshot && (pcSnapshot->getWidth(COMPONENT_Y) != iWidth || pcSnapshot->getHeight(COMPONENT_Y) != iHeight || pcSnapshot->getChromaFormat() != pcPicYuv->getChromaFormat()))
+  {
+    pcSnapshot->destroy();
+    delete pcSnapshot;
+    pcSnapshot = NULL;
+  }
+  if(pcSnapshot == NULL)
+  {
+    //same margins as the source, so that the copy is a single memcpy per component;
+    const Int iMarginX = pcPicYuv->getMarginX(COMPONENT_Y);
+    const Int iMarginY = pcPicYuv->getMarginY(COMPONENT_Y);
+    pcSnapshot = new TComPicYuv;
+    if(iMarginX >= 16 && iMarginY >= 16)
+    {
+      pcSnapshot->createWithoutCUInfo(iWidth, iHeight, pcPicYuv->getChromaFormat(), true, iMarginX-16, iMarginY-16);
+    }
+    else
+    {
+      pcSnapshot->createWithoutCUInfo(iWidth, iHeight, pcPicYuv->getChromaFormat());
+    }
+  }
+  pcPicYuv->copyToPic(pcSnapshot);
+  return std::shared_ptr<TComPicYuv>(pcSnapshot, [this](TComPicYuv *pcPic)
+  {
+    std::lock_guard<std::mutex> lock(m_sphMetricMutex);
+    m_sphMetricFreePics.push_back(pcPic);
+  });
+}
+
+Void TEncGOP::xSubmitSphMetrics( TComPic* pcPic )
+{
+  std::shared_ptr<SphMetricResult> result(new SphMetricResult);
+  TComSlice *pcSlice = pcPic->getSlice(0);
+  result->iPOC    = pcPic->getPOC();
+  result->bIntra  = pcSlice->isIntra();
+  result->bInterP = pcSlice->isInterP();
+  result->bInterB = pcSlice->isInterB();
+  result->pcPicYuvOrg = xCreateSphMetricSnapshot(pcPic->getPicYuvOrg());
+  result->pcPicYuvRec = xCreateSphMetricSnapshot(pcPic->getPicYuvRec());
+#if SVIDEO_FUSED_METRICS
+  result->bFusedDone = false;
+#endif
+  result->bDone   = false;
+
+  if(!m_sphMetricThread.joinable())
+  {
+    m_sphMetricPool.create(m_pcCfg->getSphMetricThreads());
+    m_bSphMetricExit = false;
+    m_sphMetricThread = std::thread(&TEncGOP::xSphMetricThreadLoop, this);
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_sphMetricMutex);
+    m_sphMetricResults.push_back(result);
+    m_sphMetricJobs.push_back(result);
+  }
+  m_sphMetricJobCV.notify_one();
+}
+
+/** \brief print and accumulate the finished metrics in coding order;
+ * the frame summary line is already printed, so the metrics of a picture go on their own "POC n" line;
+ * \param bWait wait for all pending pictures, otherwise only for those beyond S_MAX_PENDING_SPH_METRICS
+ */
+Void TEncGOP::xFlushSphMetrics( Bool bWait )
+{
+  while(true)
+  {
+    std::shared_ptr<SphMetricResult> result;
+    {
+      std::unique_lock<std::mutex> lock(m_sphMetricMutex);
+      if(m_sphMetricResults.empty())
+      {
+        break;
+      }
+      if(bWait || m_sphMetricResults.size() > S_MAX_PENDING_SPH_METRICS)
+      {
+        m_sphMetricDoneCV.wait(lock, [this]{ return m_sphMetricResults.front()->bDone; });
+      }
+      else if(!m_sphMetricResults.front()->bDone)
+      {
+        break;
+      }
+      result = m_sphMetricResults.front();
+      m_sphMetricResults.pop_front();
+    }
+    printf("POC %4d", result->iPOC);
+    xPrintSphMetrics(*result);
+#if SVIDEO_VIEWPORT_PSNR
+    if(!result->vpPSNR.empty())
+    {
+      m_pcEncTop->getViewPortPSNR()->printFramePSNR(&result->vpPSNR[0], &result->vpMSE[0]);
+    }
+#endif
+    printf("\n");
+    xAddSphMetrics(*result);
+  }
+  fflush(stdout);
+}
+
+Void TEncGOP::xSphMetricThreadLoop()
+{
+  while(true)
+  {
+    std::shared_ptr<SphMetricResult> result;
+    {
+      std::unique_lock<std::mutex> lock(m_sphMetricMutex);
+      m_sphMetricJobCV.wait(lock, [this]{ return m_bSphMetricExit || !m_sphMetricJobs.empty(); });
+      if(m_sphMetricJobs.empty())
+      {
+        return;
+      }
+      result = m_sphMetricJobs.front();
+      m_sphMetricJobs.pop_front();
+    }
+    xCalculateSphMetrics(*result, result->pcPicYuvOrg.get(), result->pcPicYuvRec.get(), true);
+    result->pcPicYuvOrg.reset();
+    result->pcPicYuvRec.reset();
+    {
+      std::lock_guard<std::mutex> lock(m_sphMetricMutex);
+      result->bDone = true;
+    }
+    m_sphMetricDoneCV.notify_all();
+  }
+}
+
+Void TEncGOP::xStopSphMetrics()
+{
+  if(m_sphMetricThread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_sphMetricMutex);
+      m_bSphMetricExit = true;
+    }
+    m_sphMetricJobCV.notify_all();
+    m_sphMetricThread.join();
+    m_sphMetricPool.destroy();
+  }
+  m_sphMetricJobs.clear();
+  m_sphMetricResults.clear();
+  for(size_t i=0; i<m_sphMetricFreePics.size(); i++)
+  {
+    m_sphMetricFreePics[i]->destroy();
+    delete m_sphMetricFreePics[i];
+  }
+  m_sphMetricFreePics.clear();
+}
+#endif
+
 Void TEncGOP::xCalculateInterlacedAddPSNR( TComPic* pcPicOrgFirstField, TComPic* pcPicOrgSecondField,
                                            TComPicYuv* pcPicRecFirstField, TComPicYuv* pcPicRecSecondField,
                                            const InputColourSpaceConversion conversion, const Bool printFrameMSE )
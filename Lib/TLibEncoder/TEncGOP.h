@@ -67,16 +67,51 @@
 #if SVIDEO_CPPPSNR
 #include "TLib360/TCPPPSNRMetricCalc.h"
 #endif
+#if SVIDEO_FUSED_METRICS
+#include "TLib360/TFusedMetricCalc.h"
+#endif
 #endif
 #include "TEncAnalyze.h"
 #include "TEncRateCtrl.h"
 #include <vector>
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+#include <deque>
+#include <memory>
+#include "TLibCommon/TComThreadPool.h"
+#endif
+#if FRAME_PARALLEL_ENCODING
+#include <time.h>
+#endif
 
 //! \ingroup TLibEncoder
 //! \{
 
 class TEncTop;
 
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+/// spherical metrics of one coded picture
+struct SphMetricResult
+{
+  Int     iPOC;
+  Bool    bIntra;
+  Bool    bInterP;
+  Bool    bInterB;
+  std::shared_ptr<TComPicYuv> pcPicYuvOrg;    ///< snapshots used by the metric thread, released when the result is flushed
+  std::shared_ptr<TComPicYuv> pcPicYuvRec;
+  Double  dSPSNR[MAX_NUM_COMPONENT];
+  Double  dWSPSNR[MAX_NUM_COMPONENT];
+  Double  dE2EWSPSNR[MAX_NUM_COMPONENT];
+  Double  dSPSNRI[MAX_NUM_COMPONENT];
+  Double  dCPPPSNR[MAX_NUM_COMPONENT];
+  std::vector<Double> vpPSNR;                 ///< [viewport*MAX_NUM_COMPONENT+comp]
+  std::vector<Double> vpMSE;
+#if SVIDEO_FUSED_METRICS
+  Bool    bFusedDone;                         ///< S-PSNR and WS-PSNR were computed together with the PSNR
+#endif
+  Bool    bDone;
+};
+#endif
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -93,6 +128,21 @@ class TEncGOP
     Int accumBitsDU;
     Int accumNalsDU;
   };
+#if FRAME_PARALLEL_ENCODING
+
+  /// picture compressed by a frame thread together with an earlier picture of the GOP, written when its turn comes
+  class FramePicture
+  {
+  public:
+    Int          iGOPid;
+    TComPic*     pcPic;
+    TComPicYuv*  pcPicYuvRecOut;
+    AccessUnit*  pcAccessUnit;
+    TEncSlice*   pcSliceEncoder;
+    clock_t      iBeforeTime;
+    UInt         uiNumSliceSegments;
+  };
+#endif
 
 private:
 
@@ -118,6 +168,20 @@ private:
 #if SVIDEO_CPPPSNR
   TCPPPSNRMetric          m_cCPPPSNRMetric;
 #endif
+#if SVIDEO_FUSED_METRICS
+  TFusedMetricCalc        m_cFusedMetricCalc;
+#endif
+#if SVIDEO_ASYNC_METRICS
+  std::deque<std::shared_ptr<SphMetricResult> > m_sphMetricResults;   ///< coding order, flushed by the encoding thread
+  std::deque<std::shared_ptr<SphMetricResult> > m_sphMetricJobs;      ///< not yet started by the metric thread
+  std::vector<TComPicYuv*> m_sphMetricFreePics;                       ///< released snapshots for reuse
+  std::thread             m_sphMetricThread;
+  std::mutex              m_sphMetricMutex;
+  std::condition_variable m_sphMetricJobCV;
+  std::condition_variable m_sphMetricDoneCV;
+  Bool                    m_bSphMetricExit;
+  TComThreadPool          m_sphMetricPool;                            ///< runs the metrics of one picture in parallel
+#endif
 #endif
   //  Data
   Bool                    m_bLongtermTestPictureHasBeenCoded;
@@ -130,6 +194,9 @@ private:
   Int                     m_iNumPicCoded;
   Bool                    m_bFirst;
   Int                     m_iLastRecoveryPicPOC;
+#if FRAME_PARALLEL_ENCODING
+  SliceType               m_lastEncCABACTableIdx[MAX_TLAYER];   ///< CABAC table chosen after the last picture of each temporal layer
+#endif
 
   //  Access channel
   TEncTop*                m_pcEncTop;
@@ -206,6 +273,9 @@ public:
 #if SVIDEO_CPPPSNR
   TCPPPSNRMetric* getCPPPSNRMetric()  {return &m_cCPPPSNRMetric;}
 #endif
+#if SVIDEO_FUSED_METRICS
+  TFusedMetricCalc* getFusedMetricCalc()  {return &m_cFusedMetricCalc;}
+#endif
 #endif
 protected:
   TEncRateCtrl* getRateCtrl()       { return m_pcRateCtrl;  }
@@ -214,6 +284,14 @@ protected:
 
   Void  xInitGOP          ( Int iPOCLast, Int iNumPicRcvd, Bool isField );
   Void  xGetBuffer        ( TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, Int iNumPicRcvd, Int iTimeOffset, TComPic*& rpcPic, TComPicYuv*& rpcPicYuvRecOut, Int pocCurr, Bool isField );
+  Bool  xInitPicture      ( Int iGOPid, Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsInGOP,
+                            Bool isField, TEncSlice* pcSliceEncoder, TComPic*& rpcPic, TComPicYuv*& rpcPicYuvRecOut, Double& lambda, Int& estimatedBits );
+  UInt  xCompressPicture  ( TComPic* pcPic, TEncSlice* pcSliceEncoder );
+#if FRAME_PARALLEL_ENCODING
+  Bool  xUseFrameThreads  ( Bool isField ) const;
+  UInt  xCompressFramePictures( Int iGOPid, Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsInGOP,
+                                TComPic* pcPic, std::deque<FramePicture>& framePictures );
+#endif
 
   Void  xCalculateAddPSNRs         ( const Bool isField, const Bool isFieldTopFieldFirst, const Int iGOPid, TComPic* pcPic, const AccessUnit&accessUnit, TComList<TComPic*> &rcListPic, Double dEncTime, const InputColourSpaceConversion snr_conversion, const Bool printFrameMSE );
   Void  xCalculateAddPSNR          ( TComPic* pcPic, TComPicYuv* pcPicD, const AccessUnit&, Double dEncTime, const InputColourSpaceConversion snr_conversion, const Bool printFrameMSE );
@@ -224,6 +302,17 @@ protected:
   UInt64 xFindDistortionFrame (TComPicYuv* pcPic0, TComPicYuv* pcPic1, const BitDepths &bitDepths);
 
   Double xCalculateRVM();
+#if SVIDEO_EXT && SVIDEO_ASYNC_METRICS
+  Bool  xIsAsyncSphMetrics         () { return m_pcCfg->getSphMetricThreads() > 0; }
+  Void  xCalculateSphMetrics       ( SphMetricResult& result, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvRec, Bool bViewPort );
+  Void  xAddSphMetrics             ( SphMetricResult& result );
+  Void  xPrintSphMetrics           ( const SphMetricResult& result );
+  std::shared_ptr<TComPicYuv> xCreateSphMetricSnapshot( const TComPicYuv* pcPicYuv );
+  Void  xSubmitSphMetrics          ( TComPic* pcPic );
+  Void  xFlushSphMetrics           ( Bool bWait );
+  Void  xSphMetricThreadLoop       ();
+  Void  xStopSphMetrics            ();
+#endif
 
   Void xWriteAccessUnitDelimiter (AccessUnit &accessUnit, TComSlice *slice);
 
@@ -419,6 +419,87 @@ __inline Void TEncSearch::xTZSearchHelp( const TComPattern* const pcPatternKey,
   }
 }
 
+// same as xTZSearchHelp for the 4 points in this order, with the SADs of the 4 points computed together
+__inline Void TEncSearch::xTZSearchHelp4( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const Int* piSearchX, const Int* piSearchY, const UChar* pucPointNr, const UInt* puiDistance )
+{
+#if SIMD_DISTORTION
+  const Pel* apiRefSrch[4];
+  for ( Int k = 0; k < 4; k++ )
+  {
+    apiRefSrch[k] = rcStruct.piRefY + piSearchY[k] * rcStruct.iYStride + piSearchX[k];
+  }
+
+  m_pcRdCost->setDistParam( pcPatternKey, apiRefSrch[0], rcStruct.iYStride, m_cDistParam );
+
+  // the selective search checks the motion cost first and refines subsampled SADs
+  if ( m_cDistParam.DistFunc4 != NULL && !( ( m_pcEncCfg->getRestrictMESampling() == false ) && m_pcEncCfg->getMotionEstimationSearchMethod() == MESEARCH_SELECTIVE ) )
+  {
+    setDistParamComp(COMPONENT_Y);
+
+    m_cDistParam.bitDepth = pcPatternKey->getBitDepthY();
+    m_cDistParam.m_maximumDistortionForEarlyExit = rcStruct.uiBestSad;
+
+    // fast encoder decision: use subsampled SAD when rows > 8 for integer ME
+    if ( m_pcEncCfg->getFastInterSearchMode()==FASTINTERSEARCH_MODE1 || m_pcEncCfg->getFastInterSearchMode()==FASTINTERSEARCH_MODE3 )
+    {
+      if ( m_cDistParam.iRows > 8 )
+      {
+        m_cDistParam.iSubShift = 1;
+      }
+    }
+
+    Distortion auiSad[4];
+    m_cDistParam.DistFunc4( &m_cDistParam, apiRefSrch, auiSad );
+    m_cDistParam.pCur = apiRefSrch[3];
+
+    for ( Int k = 0; k < 4; k++ )
+    {
+      Distortion uiSad = auiSad[k];
+      if( uiSad < rcStruct.uiBestSad )
+      {
+        uiSad += m_pcRdCost->getCostOfVectorWithPredictor( piSearchX[k], piSearchY[k] );
+
+        if( uiSad < rcStruct.uiBestSad )
+        {
+          rcStruct.uiBestSad      = uiSad;
+          rcStruct.iBestX         = piSearchX[k];
+          rcStruct.iBestY         = piSearchY[k];
+          rcStruct.uiBestDistance = puiDistance[k];
+          rcStruct.uiBestRound    = 0;
+          rcStruct.ucPointNr      = pucPointNr[k];
+          m_cDistParam.m_maximumDistortionForEarlyExit = uiSad;
+        }
+      }
+    }
+    return;
+  }
+#endif
+
+  for ( Int k = 0; k < 4; k++ )
+  {
+    xTZSearchHelp( pcPatternKey, rcStruct, piSearchX[k], piSearchY[k], pucPointNr[k], puiDistance[k] );
+  }
+}
+
+// raster of points from iLeft to iRight on row iSearchY
+__inline Void TEncSearch::xTZSearchHelpRow( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchY, const Int iLeft, const Int iRight, const Int iStep, const UInt uiDistance )
+{
+  const Int   aiSearchY[4]  = { iSearchY, iSearchY, iSearchY, iSearchY };
+  const UChar aucPointNr[4] = { 0, 0, 0, 0 };
+  const UInt  auiDistance[4] = { uiDistance, uiDistance, uiDistance, uiDistance };
+
+  Int iSearchX = iLeft;
+  for ( ; iSearchX + 3 * iStep <= iRight; iSearchX += 4 * iStep )
+  {
+    const Int aiSearchX[4] = { iSearchX, iSearchX + iStep, iSearchX + 2 * iStep, iSearchX + 3 * iStep };
+    xTZSearchHelp4( pcPatternKey, rcStruct, aiSearchX, aiSearchY, aucPointNr, auiDistance );
+  }
+  for ( ; iSearchX <= iRight; iSearchX += iStep )
+  {
+    xTZSearchHelp( pcPatternKey, rcStruct, iSearchX, iSearchY, 0, uiDistance );
+  }
+}
+
 __inline Void TEncSearch::xTZ2PointSearch( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const TComMv* const pcMvSrchRngLT, const TComMv* const pcMvSrchRngRB )
 {
   Int   iSrchRngHorLeft   = pcMvSrchRngLT->getHor();
@@ -569,6 +650,18 @@ __inline Void TEncSearch::xTZ8PointSquareSearch( const TComPattern* const pcPatt
   const Int iRight      = iStartX + iDist;
   rcStruct.uiBestRound += 1;
 
+  if (  iTop >= iSrchRngVerTop && iLeft >= iSrchRngHorLeft &&
+      iRight <= iSrchRngHorRight && iBottom <= iSrchRngVerBottom ) // check border
+  {
+    const Int   aiSearchX[8]  = { iLeft, iStartX, iRight, iLeft,   iRight,  iLeft,   iStartX, iRight  };
+    const Int   aiSearchY[8]  = { iTop,  iTop,    iTop,   iStartY, iStartY, iBottom, iBottom, iBottom };
+    const UChar aucPointNr[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    const UInt  auiDistance[8] = { UInt(iDist), UInt(iDist), UInt(iDist), UInt(iDist), UInt(iDist), UInt(iDist), UInt(iDist), UInt(iDist) };
+    xTZSearchHelp4( pcPatternKey, rcStruct, aiSearchX,     aiSearchY,     aucPointNr,     auiDistance     );
+    xTZSearchHelp4( pcPatternKey, rcStruct, aiSearchX + 4, aiSearchY + 4, aucPointNr + 4, auiDistance + 4 );
+    return;
+  }
+
   if ( iTop >= iSrchRngVerTop ) // check top
   {
     if ( iLeft >= iSrchRngHorLeft ) // check top left
@@ -634,7 +727,27 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( const TComPattern*const  pcPat
   const Int iRight      = iStartX + iDist;
   rcStruct.uiBestRound += 1;
 
-  if ( iDist == 1 )
+  if ( iDist == 1 && iTop >= iSrchRngVerTop && iLeft >= iSrchRngHorLeft &&
+      iRight <= iSrchRngHorRight && iBottom <= iSrchRngVerBottom ) // check border
+  {
+    const UInt auiDistance[8] = { 1, 1, 1, 1, 1, 1, 1, 1 };
+    if (bCheckCornersAtDist1)
+    {
+      const Int   aiSearchX[8]  = { iLeft, iStartX, iRight, iLeft,   iRight,  iLeft,   iStartX, iRight  };
+      const Int   aiSearchY[8]  = { iTop,  iTop,    iTop,   iStartY, iStartY, iBottom, iBottom, iBottom };
+      const UChar aucPointNr[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+      xTZSearchHelp4( pcPatternKey, rcStruct, aiSearchX,     aiSearchY,     aucPointNr,     auiDistance );
+      xTZSearchHelp4( pcPatternKey, rcStruct, aiSearchX + 4, aiSearchY + 4, aucPointNr + 4, auiDistance );
+    }
+    else
+    {
+      const Int   aiSearchX[4]  = { iStartX, iLeft,   iRight,  iStartX };
+      const Int   aiSearchY[4]  = { iTop,    iStartY, iStartY, iBottom };
+      const UChar aucPointNr[4] = { 2, 4, 5, 7 };
+      xTZSearchHelp4( pcPatternKey, rcStruct, aiSearchX, aiSearchY, aucPointNr, auiDistance );
+    }
+  }
+  else if ( iDist == 1 )
   {
     if ( iTop >= iSrchRngVerTop ) // check top
     {
@@ -695,14 +808,12 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( const TComPattern*const  pcPat
       if (  iTop >= iSrchRngVerTop && iLeft >= iSrchRngHorLeft &&
           iRight <= iSrchRngHorRight && iBottom <= iSrchRngVerBottom ) // check border
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX,  iTop,      2, iDist    );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2,  iTop_2,    1, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iTop_2,    3, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft,    iStartY,   4, iDist    );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight,   iStartY,   5, iDist    );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2,  iBottom_2, 6, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX,  iBottom,   7, iDist    );
+        const Int   aiSearchX[8]  = { iStartX, iLeft_2, iRight_2, iLeft,   iRight,  iLeft_2,   iRight_2,  iStartX };
+        const Int   aiSearchY[8]  = { iTop,    iTop_2,  iTop_2,   iStartY, iStartY, iBottom_2, iBottom_2, iBottom };
+        const UChar aucPointNr[8] = { 2, 1, 3, 4, 5, 6, 8, 7 };
+        const UInt  auiDistance[8] = { UInt(iDist), UInt(iDist>>1), UInt(iDist>>1), UInt(iDist), UInt(iDist), UInt(iDist>>1), UInt(iDist>>1), UInt(iDist) };
+        xTZSearchHelp4( pcPatternKey, rcStruct, aiSearchX,     aiSearchY,     aucPointNr,     auiDistance     );
+        xTZSearchHelp4( pcPatternKey, rcStruct, aiSearchX + 4, aiSearchY + 4, aucPointNr + 4, auiDistance + 4 );
       }
       else // check border
       {
@@ -751,20 +862,20 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( const TComPattern*const  pcPat
       if ( iTop >= iSrchRngVerTop && iLeft >= iSrchRngHorLeft &&
           iRight <= iSrchRngHorRight && iBottom <= iSrchRngVerBottom ) // check border
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop,    0, iDist );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft,   iStartY, 0, iDist );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight,  iStartY, 0, iDist );
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
+        const UChar aucPointNr[4] = { 0, 0, 0, 0 };
+        const UInt  auiDistance[4] = { UInt(iDist), UInt(iDist), UInt(iDist), UInt(iDist) };
+        const Int   aiSearchX[4]  = { iStartX, iLeft,   iRight,  iStartX };
+        const Int   aiSearchY[4]  = { iTop,    iStartY, iStartY, iBottom };
+        xTZSearchHelp4( pcPatternKey, rcStruct, aiSearchX, aiSearchY, aucPointNr, auiDistance );
         for ( Int index = 1; index < 4; index++ )
         {
           const Int iPosYT = iTop    + ((iDist>>2) * index);
           const Int iPosYB = iBottom - ((iDist>>2) * index);
           const Int iPosXL = iStartX - ((iDist>>2) * index);
           const Int iPosXR = iStartX + ((iDist>>2) * index);
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
+          const Int aiPosX[4] = { iPosXL, iPosXR, iPosXL, iPosXR };
+          const Int aiPosY[4] = { iPosYT, iPosYT, iPosYB, iPosYB };
+          xTZSearchHelp4( pcPatternKey, rcStruct, aiPosX, aiPosY, aucPointNr, auiDistance );
         }
       }
       else // check border
@@ -4091,10 +4202,7 @@ Void TEncSearch::xTZSearch( const TComDataCU* const pcCU,
     cStruct.uiBestDistance = iWindowSize;
     for ( iStartY = iSrchRngRasterTop; iStartY <= iSrchRngRasterBottom; iStartY += iWindowSize )
     {
-      for ( iStartX = iSrchRngRasterLeft; iStartX <= iSrchRngRasterRight; iStartX += iWindowSize )
-      {
-        xTZSearchHelp( pcPatternKey, cStruct, iStartX, iStartY, 0, iWindowSize );
-      }
+      xTZSearchHelpRow( pcPatternKey, cStruct, iStartY, iSrchRngRasterLeft, iSrchRngRasterRight, iWindowSize, iWindowSize );
     }
   }
   else
@@ -4104,10 +4212,7 @@ Void TEncSearch::xTZSearch( const TComDataCU* const pcCU,
       cStruct.uiBestDistance = iRaster;
       for ( iStartY = iSrchRngVerTop; iStartY <= iSrchRngVerBottom; iStartY += iRaster )
       {
-        for ( iStartX = iSrchRngHorLeft; iStartX <= iSrchRngHorRight; iStartX += iRaster )
-        {
-          xTZSearchHelp( pcPatternKey, cStruct, iStartX, iStartY, 0, iRaster );
-        }
+        xTZSearchHelpRow( pcPatternKey, cStruct, iStartY, iSrchRngHorLeft, iSrchRngHorRight, iRaster, iRaster );
       }
     }
   }
@@ -4315,10 +4420,7 @@ Void TEncSearch::xTZSearchSelective( const TComDataCU* const   pcCU,
   {
     for ( iStartY = iSrchRngVerTop; iStartY <= iSrchRngVerBottom; iStartY += 1 )
     {
-      for ( iStartX = iSrchRngHorLeft; iStartX <= iSrchRngHorRight; iStartX += 1 )
-      {
-        xTZSearchHelp( pcPatternKey, cStruct, iStartX, iStartY, 0, 1 );
-      }
+      xTZSearchHelpRow( pcPatternKey, cStruct, iStartY, iSrchRngHorLeft, iSrchRngHorRight, 1, 1 );
     }
   }
   //Smaller MV, refine around predictor
@@ -159,6 +159,8 @@ protected:
 
   // sub-functions for ME
   __inline Void xTZSearchHelp         ( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance );
+  __inline Void xTZSearchHelp4        ( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const Int* piSearchX, const Int* piSearchY, const UChar* pucPointNr, const UInt* puiDistance );
+  __inline Void xTZSearchHelpRow      ( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchY, const Int iLeft, const Int iRight, const Int iStep, const UInt uiDistance );
   __inline Void xTZ2PointSearch       ( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const TComMv* const pcMvSrchRngLT, const TComMv* const pcMvSrchRngRB );
   __inline Void xTZ8PointSquareSearch ( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const TComMv* const pcMvSrchRngLT, const TComMv* const pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist );
   __inline Void xTZ8PointDiamondSearch( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const TComMv* const pcMvSrchRngLT, const TComMv* const pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist, const Bool bCheckCornersAtDist1 );
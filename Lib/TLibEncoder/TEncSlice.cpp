@@ -48,6 +48,14 @@
 
 TEncSlice::TEncSlice()
  : m_encCABACTableIdx(I_SLICE)
+#if WPP_PARALLEL_ENCODING
+ , m_pcEncTop(NULL)
+ , m_pcWppRowContextStates(NULL)
+ , m_uiNumWppRows(0)
+#endif
+#if FRAME_PARALLEL_ENCODING
+ , m_bFrameThread(false)
+#endif
 {
 }
 
@@ -63,6 +71,11 @@ Void TEncSlice::create( Int iWidth, Int iHeight, ChromaFormat chromaFormat, UInt
 
   // create residual picture
   m_picYuvResi.create( iWidth, iHeight, chromaFormat, iMaxCUWidth, iMaxCUHeight, uhTotalDepth, true );
+
+#if WPP_PARALLEL_ENCODING
+  m_uiNumWppRows          = (iHeight + iMaxCUHeight - 1) / iMaxCUHeight;
+  m_pcWppRowContextStates = new TEncSbac[m_uiNumWppRows];
+#endif
 }
 
 Void TEncSlice::destroy()
@@ -74,6 +87,12 @@ Void TEncSlice::destroy()
   m_vdRdPicLambda.clear();
   m_vdRdPicQp.clear();
   m_viRdPicQp.clear();
+
+#if WPP_PARALLEL_ENCODING
+  delete [] m_pcWppRowContextStates;
+  m_pcWppRowContextStates = NULL;
+  m_uiNumWppRows          = 0;
+#endif
 }
 
 Void TEncSlice::init( TEncTop* pcEncTop )
@@ -99,8 +118,32 @@ Void TEncSlice::init( TEncTop* pcEncTop )
   m_vdRdPicQp.resize(    m_pcCfg->getDeltaQpRD() * 2 + 1 );
   m_viRdPicQp.resize(    m_pcCfg->getDeltaQpRD() * 2 + 1 );
   m_pcRateCtrl        = pcEncTop->getRateCtrl();
+
+#if WPP_PARALLEL_ENCODING
+  m_pcEncTop          = pcEncTop;
+#endif
 }
 
+#if FRAME_PARALLEL_ENCODING
+/** \param pcEncTop      encoder class
+ *  \param pcFrameCoder  coders of the frame thread this slice encoder compresses its pictures with
+ */
+Void TEncSlice::init( TEncTop* pcEncTop, TEncWppCoder* pcFrameCoder )
+{
+  init( pcEncTop );
+
+  m_pcCuEncoder       = pcFrameCoder->getCuEncoder();
+  m_pcPredSearch      = pcFrameCoder->getPredSearch();
+  m_pcEntropyCoder    = pcFrameCoder->getEntropyCoder();
+  m_pcTrQuant         = pcFrameCoder->getTrQuant();
+  m_pcRdCost          = pcFrameCoder->getRdCost();
+  m_pppcRDSbacCoder   = pcFrameCoder->getRDSbacCoder();
+  m_pcRDGoOnSbacCoder = pcFrameCoder->getRDGoOnSbacCoder();
+
+  m_bFrameThread      = true;
+}
+#endif
+
 
 
 Void
@@ -503,6 +546,18 @@ Void TEncSlice::setSearchRange( TComSlice* pcSlice )
       iRefPOC = pcSlice->getRefPic(e, iRefIdx)->getPOC();
       Int newSearchRange = Clip3(m_pcCfg->getMinSearchWindow(), iMaxSR, (iMaxSR*ADAPT_SR_SCALE*abs(iCurrPOC - iRefPOC)+iOffset)/iGOPSize);
       m_pcPredSearch->setAdaptiveSearchRange(iDir, iRefIdx, newSearchRange);
+#if WPP_PARALLEL_ENCODING
+#if FRAME_PARALLEL_ENCODING
+      if ( m_bFrameThread )
+      {
+        continue;
+      }
+#endif
+      for ( Int i = 0; i < m_pcEncTop->getNumWppCoders(); i++ )
+      {
+        m_pcEncTop->getWppCoder(i)->getPredSearch()->setAdaptiveSearchRange(iDir, iRefIdx, newSearchRange);
+      }
+#endif
     }
   }
 }
@@ -732,6 +787,13 @@ Void TEncSlice::compressSlice( TComPic* pcPic, const Bool bCompressEntireSlice,
 
   // for every CTU in the slice segment (may terminate sooner if there is a byte limit on the slice-segment)
 
+#if WPP_PARALLEL_ENCODING
+  if ( xUseParallelCompress( pcPic, startCtuTsAddr, boundingCtuTsAddr ) )
+  {
+    xCompressSliceParallel( pcPic, startCtuTsAddr, boundingCtuTsAddr, bFastDeltaQP );
+  }
+  else
+#endif
   for( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ++ctuTsAddr )
   {
     const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
@@ -925,6 +987,365 @@ Void TEncSlice::compressSlice( TComPic* pcPic, const Bool bCompressEntireSlice,
   //}
 }
 
+#if WPP_PARALLEL_ENCODING
+/** check if the CTU rows of the slice segment can be compressed on the wavefront threads:
+ *  a single tile and no dependent slice segments
+ */
+Bool TEncSlice::xUseWppThreads( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr )
+{
+  const TComSlice* pcSlice          = pcPic->getSlice(getSliceIdx());
+  const UInt       frameWidthInCtus = pcPic->getPicSym()->getFrameWidthInCtus();
+
+  if ( m_pcEncTop->getNumWppCoders() == 0 || !pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() )
+  {
+    return false;
+  }
+  if ( pcPic->getPicSym()->getNumTiles() != 1 || pcSlice->getPPS()->getDependentSliceSegmentsEnabledFlag() )
+  {
+    return false;
+  }
+  return startCtuTsAddr / frameWidthInCtus != (boundingCtuTsAddr - 1) / frameWidthInCtus;
+}
+
+#if TILE_PARALLEL_ENCODING
+/** check if the tiles of the slice segment can be coded on parallel threads:
+ *  no wavefronts, no dependent slice segments and more than one tile in the slice segment
+ */
+Bool TEncSlice::xUseTileThreads( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr )
+{
+  const TComSlice*  pcSlice = pcPic->getSlice(getSliceIdx());
+  const TComPicSym* pcPicSym = pcPic->getPicSym();
+
+  if ( m_pcEncTop->getNumWppCoders() == 0 || pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() )
+  {
+    return false;
+  }
+  if ( pcPicSym->getNumTiles() == 1 || pcSlice->getPPS()->getDependentSliceSegmentsEnabledFlag() )
+  {
+    return false;
+  }
+  return pcPicSym->getTileIdxMap( pcPicSym->getCtuTsToRsAddrMap(startCtuTsAddr) ) != pcPicSym->getTileIdxMap( pcPicSym->getCtuTsToRsAddrMap(boundingCtuTsAddr - 1) );
+}
+
+/** split the slice segment into the CTU ranges (in TS order) of its tiles
+ */
+Void TEncSlice::xGetTileCtuRanges( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr, std::vector<UInt>& ctuTsAddrRanges )
+{
+  const TComPicSym* pcPicSym = pcPic->getPicSym();
+
+  ctuTsAddrRanges.clear();
+  for ( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; )
+  {
+    const TComTile* pcTile             = pcPicSym->getTComTile( pcPicSym->getTileIdxMap( pcPicSym->getCtuTsToRsAddrMap(ctuTsAddr) ) );
+    const UInt      boundingCtuTsOfTile = pcPicSym->getCtuRsToTsAddrMap( pcTile->getFirstCtuRsAddr() ) + pcTile->getTileWidthInCtus() * pcTile->getTileHeightInCtus();
+
+    ctuTsAddrRanges.push_back( ctuTsAddr );
+    ctuTsAddr = std::min( boundingCtuTsOfTile, boundingCtuTsAddr );
+  }
+  ctuTsAddrRanges.push_back( boundingCtuTsAddr );
+}
+#endif
+
+/** check if the slice segment can be compressed on parallel threads: CTU rows of a wavefront slice or tiles,
+ *  no byte limit and no CTU-level rate control
+ */
+Bool TEncSlice::xUseParallelCompress( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr )
+{
+  const TComSlice* pcSlice = pcPic->getSlice(getSliceIdx());
+
+#if FRAME_PARALLEL_ENCODING
+  // the coders of the wavefront threads belong to the encoder's own slice encoder
+  if ( m_bFrameThread )
+  {
+    return false;
+  }
+#endif
+  if ( pcSlice->getSliceMode() == FIXED_NUMBER_OF_BYTES || pcSlice->getSliceSegmentMode() == FIXED_NUMBER_OF_BYTES )
+  {
+    return false;
+  }
+  if ( m_pcCfg->getUseRateCtrl() && m_pcCfg->getLCULevelRC() )
+  {
+    return false;
+  }
+#if TILE_PARALLEL_ENCODING
+  if ( xUseTileThreads( pcPic, startCtuTsAddr, boundingCtuTsAddr ) )
+  {
+    return true;
+  }
+#endif
+  return xUseWppThreads( pcPic, startCtuTsAddr, boundingCtuTsAddr );
+}
+
+/** compress the CTU rows of a wavefront slice segment (or its tiles) in parallel; a wavefront CTU is compressed once the CTU
+ *  above-right of it is done, the per-CTU bits, rate control and picture statistics are then accumulated in CTU order as in the serial loop
+ */
+Void TEncSlice::xCompressSliceParallel( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr, const Bool bFastDeltaQP )
+{
+  TComSlice* const pcSlice           = pcPic->getSlice(getSliceIdx());
+  const UInt       frameWidthInCtus  = pcPic->getPicSym()->getFrameWidthInCtus();
+  const Bool       wavefrontsEnabled = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag();
+
+  // CTU ranges (in TS order) compressed by one thread: the CTU rows of a wavefront slice, otherwise the tiles
+  std::vector<UInt> ctuTsAddrRanges;
+#if TILE_PARALLEL_ENCODING
+  if ( !wavefrontsEnabled )
+  {
+    xGetTileCtuRanges( pcPic, startCtuTsAddr, boundingCtuTsAddr, ctuTsAddrRanges );
+  }
+  else
+#endif
+  {
+    ctuTsAddrRanges.push_back( startCtuTsAddr ); // single tile, so TS and RS addresses are the same
+    for ( UInt ctuTsAddr = (startCtuTsAddr / frameWidthInCtus + 1) * frameWidthInCtus; ctuTsAddr < boundingCtuTsAddr; ctuTsAddr += frameWidthInCtus )
+    {
+      ctuTsAddrRanges.push_back( ctuTsAddr );
+    }
+    ctuTsAddrRanges.push_back( boundingCtuTsAddr );
+  }
+  const Int numRanges = Int(ctuTsAddrRanges.size()) - 1;
+
+  // coders of each thread, index 0 are the encoder's own ones
+  struct WppCoders
+  {
+    TEncCu*         pcCuEncoder;
+    TEncEntropy*    pcEntropyCoder;
+    TEncSbac*       pcCurrBestCoder;
+    TEncSbac*       pcGoOnCoder;
+    TComBitCounter* pcBitCounter;
+  };
+  TComBitCounter         tempBitCounter;
+  std::vector<WppCoders> coders(1);
+  coders[0].pcCuEncoder     = m_pcCuEncoder;
+  coders[0].pcEntropyCoder  = m_pcEntropyCoder;
+  coders[0].pcCurrBestCoder = m_pppcRDSbacCoder[0][CI_CURR_BEST];
+  coders[0].pcGoOnCoder     = m_pcRDGoOnSbacCoder;
+  coders[0].pcBitCounter    = &tempBitCounter;
+
+  for ( Int i = 0; i < m_pcEncTop->getNumWppCoders(); i++ )
+  {
+    TEncWppCoder* pcWppCoder = m_pcEncTop->getWppCoder(i);
+
+    // the lambdas and distortion weights set up for this slice
+    *pcWppCoder->getRdCost() = *m_pcRdCost;
+#if RDOQ_CHROMA_LAMBDA
+    pcWppCoder->getTrQuant()->setLambdas( pcSlice->getLambdas() );
+#else
+    pcWppCoder->getTrQuant()->setLambda( m_pcRdCost->getLambda() );
+#endif
+#if ADAPTIVE_QP_SELECTION
+    pcWppCoder->getTrQuant()->clearSliceARLCnt();
+#endif
+    pcWppCoder->getCuEncoder()->setFastDeltaQp( bFastDeltaQP );
+
+    WppCoders wppCoders;
+    wppCoders.pcCuEncoder     = pcWppCoder->getCuEncoder();
+    wppCoders.pcEntropyCoder  = pcWppCoder->getEntropyCoder();
+    wppCoders.pcCurrBestCoder = pcWppCoder->getRDSbacCoder()[0][CI_CURR_BEST];
+    wppCoders.pcGoOnCoder     = pcWppCoder->getRDGoOnSbacCoder();
+    wppCoders.pcBitCounter    = pcWppCoder->getBitCounter();
+    coders.push_back( wppCoders );
+  }
+
+  // without CTU-level rate control every CTU uses the slice QP
+  if ( m_pcCfg->getUseRateCtrl() )
+  {
+    m_pcRateCtrl->setRCQP( pcSlice->getSliceQp() );
+#if ADAPTIVE_QP_SELECTION
+    pcSlice->setSliceQpBase( pcSlice->getSliceQp() );
+#endif
+  }
+
+  // tiles look at the CTUs of their neighbouring tiles (to find them unavailable) before those are
+  // compressed, so all CTUs of the slice segment are initialised up front
+  if ( !wavefrontsEnabled )
+  {
+    for ( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ctuTsAddr++ )
+    {
+      const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
+      pcPic->getCtu( ctuRsAddr )->initCtu( pcPic, ctuRsAddr );
+    }
+  }
+
+  std::vector<Int>        freeCoders;
+  std::vector<UInt>       numCtusDone( numRanges, 0 );
+  std::vector<Bool>       rowContextStored( numRanges, false );
+  std::vector<Int>        ctuBits( boundingCtuTsAddr - startCtuTsAddr, 0 );
+  std::mutex              mutex;
+  std::condition_variable cvCtuDone;
+  for ( Int i = (Int)coders.size() - 1; i >= 0; i-- )
+  {
+    freeCoders.push_back( i );
+  }
+  numCtusDone[0] = startCtuTsAddr % frameWidthInCtus; // the CTUs before the slice start are already coded
+
+  m_pcEncTop->getWppThreadPool()->parallelFor( numRanges, [&]( Int range )
+  {
+    Int coderIdx;
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      coderIdx = freeCoders.back();
+      freeCoders.pop_back();
+    }
+    const WppCoders&    cWpp         = coders[coderIdx];
+    TEncBinCABAC* const pRDSbacCoder = (TEncBinCABAC *) cWpp.pcCurrBestCoder->getEncBinIf();
+
+    cWpp.pcCurrBestCoder->resetEntropy( pcSlice );
+    pRDSbacCoder->setBinCountingEnableFlag( false );
+    pRDSbacCoder->setBinsCoded( 0 );
+
+    for ( UInt ctuTsAddr = ctuTsAddrRanges[range]; ctuTsAddr < ctuTsAddrRanges[range + 1]; ctuTsAddr++ )
+    {
+      const UInt ctuRsAddr            = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
+      const UInt firstCtuRsAddrOfTile = pcPic->getPicSym()->getTComTile(pcPic->getPicSym()->getTileIdxMap(ctuRsAddr))->getFirstCtuRsAddr();
+      const UInt ctuXPosInCtus        = ctuRsAddr % frameWidthInCtus;
+
+      // wait for the CTU above-right (or the end of the row above)
+      if ( wavefrontsEnabled && range > 0 )
+      {
+        const UInt numCtusNeeded = std::min( ctuXPosInCtus + 2, frameWidthInCtus );
+        std::unique_lock<std::mutex> lock( mutex );
+        cvCtuDone.wait( lock, [&]() { return numCtusDone[range - 1] >= numCtusNeeded; } );
+      }
+
+      TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
+      if ( wavefrontsEnabled )
+      {
+        pCtu->initCtu( pcPic, ctuRsAddr );
+      }
+
+      // update CABAC state
+      if ( ctuRsAddr == firstCtuRsAddrOfTile )
+      {
+        cWpp.pcCurrBestCoder->resetEntropy( pcSlice );
+      }
+      else if ( ctuXPosInCtus == 0 && wavefrontsEnabled )
+      {
+        cWpp.pcCurrBestCoder->resetEntropy( pcSlice );
+        TComDataCU *pCtuUp = pCtu->getCtuAbove();
+        if ( pCtuUp && (ctuXPosInCtus + 1) < frameWidthInCtus )
+        {
+          TComDataCU *pCtuTR = pcPic->getCtu( ctuRsAddr - frameWidthInCtus + 1 );
+          if ( pCtu->CUIsFromSameSliceAndTile(pCtuTR) )
+          {
+            const UInt ctuRow = ctuRsAddr / frameWidthInCtus;
+            cWpp.pcCurrBestCoder->loadContexts( range > 0 ? &m_pcWppRowContextStates[ctuRow - 1] : &m_entropyCodingSyncContextState );
+          }
+        }
+      }
+
+      // run CTU trial encoder
+      cWpp.pcEntropyCoder->setEntropyCoder ( cWpp.pcGoOnCoder );
+      cWpp.pcEntropyCoder->setBitstream( cWpp.pcBitCounter );
+      cWpp.pcBitCounter->resetBits();
+      cWpp.pcGoOnCoder->load( cWpp.pcCurrBestCoder );
+      ((TEncBinCABAC*)cWpp.pcGoOnCoder->getEncBinIf())->setBinCountingEnableFlag(true);
+
+      cWpp.pcCuEncoder->compressCtu( pCtu );
+
+      // encode CTU and calculate the true bit counters.
+      cWpp.pcEntropyCoder->setEntropyCoder ( cWpp.pcCurrBestCoder );
+      cWpp.pcEntropyCoder->setBitstream( cWpp.pcBitCounter );
+      pRDSbacCoder->setBinCountingEnableFlag( true );
+      cWpp.pcCurrBestCoder->resetBits();
+      pRDSbacCoder->setBinsCoded( 0 );
+
+      cWpp.pcCuEncoder->encodeCtu( pCtu );
+
+      pRDSbacCoder->setBinCountingEnableFlag( false );
+      ctuBits[ctuTsAddr - startCtuTsAddr] = cWpp.pcEntropyCoder->getNumberOfWrittenBits();
+
+      if ( wavefrontsEnabled )
+      {
+        // Store probabilities of second CTU in line into buffer
+        if ( ctuXPosInCtus == 1 )
+        {
+          m_pcWppRowContextStates[ctuRsAddr / frameWidthInCtus].loadContexts( cWpp.pcCurrBestCoder );
+          rowContextStored[range] = true;
+        }
+        {
+          std::lock_guard<std::mutex> lock( mutex );
+          numCtusDone[range] = ctuXPosInCtus + 1;
+        }
+        cvCtuDone.notify_all();
+      }
+    }
+
+    // stop use of temporary bit counter object.
+    cWpp.pcCurrBestCoder->setBitstream(NULL);
+    cWpp.pcGoOnCoder->setBitstream(NULL);
+
+    std::lock_guard<std::mutex> lock( mutex );
+    freeCoders.push_back( coderIdx );
+  } );
+
+  // the context state of the last second CTU of a row is used by the rows of the next slice segment
+  for ( Int range = numRanges - 1; range >= 0; range-- )
+  {
+    if ( rowContextStored[range] )
+    {
+      m_entropyCodingSyncContextState.loadContexts( &m_pcWppRowContextStates[ctuTsAddrRanges[range] / frameWidthInCtus] );
+      break;
+    }
+  }
+
+#if ADAPTIVE_QP_SELECTION
+  if ( m_pcCfg->getUseAdaptQpSelect() )
+  {
+    for ( Int i = 0; i < m_pcEncTop->getNumWppCoders(); i++ )
+    {
+      TComTrQuant* pcTrQuant = m_pcEncTop->getWppCoder(i)->getTrQuant();
+      for ( Int level = 0; level <= LEVEL_RANGE; level++ )
+      {
+        m_pcTrQuant->getSliceNSamples()[level] += pcTrQuant->getSliceNSamples()[level];
+        m_pcTrQuant->getSliceSumC()[level]     += pcTrQuant->getSliceSumC()[level];
+      }
+    }
+  }
+#endif
+
+  for ( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ctuTsAddr++ )
+  {
+    TComDataCU* pCtu                = pcPic->getCtu( pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr) );
+    const Int   numberOfWrittenBits = ctuBits[ctuTsAddr - startCtuTsAddr];
+
+    pcSlice->setSliceBits( (UInt)(pcSlice->getSliceBits() + numberOfWrittenBits) );
+    pcSlice->setSliceSegmentBits(pcSlice->getSliceSegmentBits()+numberOfWrittenBits);
+
+    if ( m_pcCfg->getUseRateCtrl() )
+    {
+      Int actualQP        = g_RCInvalidQPValue;
+      Double actualLambda = m_pcRdCost->getLambda();
+      Int actualBits      = pCtu->getTotalBits();
+      Int numberOfEffectivePixels    = 0;
+      for ( Int idx = 0; idx < pcPic->getNumPartitionsInCtu(); idx++ )
+      {
+        if ( pCtu->getPredictionMode( idx ) != NUMBER_OF_PREDICTION_MODES && ( !pCtu->isSkipped( idx ) ) )
+        {
+          numberOfEffectivePixels = numberOfEffectivePixels + 16;
+          break;
+        }
+      }
+
+      if ( numberOfEffectivePixels == 0 )
+      {
+        actualQP = g_RCInvalidQPValue;
+      }
+      else
+      {
+        actualQP = pCtu->getQP( 0 );
+      }
+      m_pcRateCtrl->getRCPic()->updateAfterCTU( m_pcRateCtrl->getRCPic()->getLCUCoded(), actualBits, actualQP, actualLambda,
+                                                pCtu->getSlice()->getSliceType() == I_SLICE ? 0 : m_pcCfg->getLCULevelRC() );
+    }
+
+    m_uiPicTotalBits += pCtu->getTotalBits();
+    m_dPicRdCost     += pCtu->getTotalCost();
+    m_uiPicDist      += pCtu->getTotalDistortion();
+  }
+}
+#endif
+
 Void TEncSlice::encodeSlice   ( TComPic* pcPic, TComOutputBitstream* pcSubstreams, UInt &numBinsCoded )
 {
   TComSlice *const pcSlice           = pcPic->getSlice(getSliceIdx());
@@ -976,6 +1397,13 @@ Void TEncSlice::encodeSlice   ( TComPic* pcPic, TComOutputBitstream* pcSubstream
 
   // for every CTU in the slice segment...
 
+#if TILE_PARALLEL_ENCODING && !ENC_DEC_TRACE
+  if ( xUseTileThreads( pcPic, startCtuTsAddr, boundingCtuTsAddr ) )
+  {
+    xEncodeSliceTiles( pcPic, pcSubstreams, startCtuTsAddr, boundingCtuTsAddr );
+  }
+  else
+#endif
   for( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ++ctuTsAddr )
   {
     const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
@@ -1018,42 +1446,7 @@ Void TEncSlice::encodeSlice   ( TComPic* pcPic, TComOutputBitstream* pcSubstream
     }
 
 
-    if ( pcSlice->getSPS()->getUseSAO() )
-    {
-      Bool bIsSAOSliceEnabled = false;
-      Bool sliceEnabled[MAX_NUM_COMPONENT];
-      for(Int comp=0; comp < MAX_NUM_COMPONENT; comp++)
-      {
-        ComponentID compId=ComponentID(comp);
-        sliceEnabled[compId] = pcSlice->getSaoEnabledFlag(toChannelType(compId)) && (comp < pcPic->getNumberValidComponents());
-        if (sliceEnabled[compId])
-        {
-          bIsSAOSliceEnabled=true;
-        }
-      }
-      if (bIsSAOSliceEnabled)
-      {
-        SAOBlkParam& saoblkParam = (pcPic->getPicSym()->getSAOBlkParam())[ctuRsAddr];
-
-        Bool leftMergeAvail = false;
-        Bool aboveMergeAvail= false;
-        //merge left condition
-        Int rx = (ctuRsAddr % frameWidthInCtus);
-        if(rx > 0)
-        {
-          leftMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-1);
-        }
-
-        //merge up condition
-        Int ry = (ctuRsAddr / frameWidthInCtus);
-        if(ry > 0)
-        {
-          aboveMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-frameWidthInCtus);
-        }
-
-        m_pcEntropyCoder->encodeSAOBlkParam(saoblkParam, pcPic->getPicSym()->getSPS().getBitDepths(), sliceEnabled, leftMergeAvail, aboveMergeAvail);
-      }
-    }
+    xEncodeSAOBlkParam( pcPic, m_pcEntropyCoder, ctuRsAddr );
 
 #if ENC_DEC_TRACE
     g_bJustDoIt = g_bEncDecTraceEnable;
@@ -1113,6 +1506,152 @@ Void TEncSlice::encodeSlice   ( TComPic* pcPic, TComOutputBitstream* pcSubstream
   numBinsCoded = m_pcBinCABAC->getBinsCoded();
 }
 
+/** encode the SAO parameters of a CTU, if SAO is enabled for the slice
+ */
+Void TEncSlice::xEncodeSAOBlkParam( TComPic* pcPic, TEncEntropy* pcEntropyCoder, const UInt ctuRsAddr )
+{
+  TComSlice *const pcSlice    = pcPic->getSlice(getSliceIdx());
+  const UInt frameWidthInCtus = pcPic->getPicSym()->getFrameWidthInCtus();
+
+  if ( pcSlice->getSPS()->getUseSAO() )
+  {
+    Bool bIsSAOSliceEnabled = false;
+    Bool sliceEnabled[MAX_NUM_COMPONENT];
+    for(Int comp=0; comp < MAX_NUM_COMPONENT; comp++)
+    {
+      ComponentID compId=ComponentID(comp);
+      sliceEnabled[compId] = pcSlice->getSaoEnabledFlag(toChannelType(compId)) && (comp < pcPic->getNumberValidComponents());
+      if (sliceEnabled[compId])
+      {
+        bIsSAOSliceEnabled=true;
+      }
+    }
+    if (bIsSAOSliceEnabled)
+    {
+      SAOBlkParam& saoblkParam = (pcPic->getPicSym()->getSAOBlkParam())[ctuRsAddr];
+
+      Bool leftMergeAvail = false;
+      Bool aboveMergeAvail= false;
+      //merge left condition
+      Int rx = (ctuRsAddr % frameWidthInCtus);
+      if(rx > 0)
+      {
+        leftMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-1);
+      }
+
+      //merge up condition
+      Int ry = (ctuRsAddr / frameWidthInCtus);
+      if(ry > 0)
+      {
+        aboveMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-frameWidthInCtus);
+      }
+
+      pcEntropyCoder->encodeSAOBlkParam(saoblkParam, pcPic->getPicSym()->getSPS().getBitDepths(), sliceEnabled, leftMergeAvail, aboveMergeAvail);
+    }
+  }
+}
+
+#if TILE_PARALLEL_ENCODING
+/** entropy code the tiles of a slice segment in parallel, each tile into its own substream;
+ *  the substream sizes and bin counts are collected in tile order, and the contexts at the end of the last tile are kept for the CABAC init decision
+ */
+Void TEncSlice::xEncodeSliceTiles( TComPic* pcPic, TComOutputBitstream* pcSubstreams, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr )
+{
+  TComSlice *const pcSlice = pcPic->getSlice(getSliceIdx());
+
+  std::vector<UInt> ctuTsAddrRanges;
+  xGetTileCtuRanges( pcPic, startCtuTsAddr, boundingCtuTsAddr, ctuTsAddrRanges );
+  const Int numRanges = Int(ctuTsAddrRanges.size()) - 1;
+
+  // coders of each thread, index 0 are the encoder's own ones
+  std::vector<TEncCu*>       cuEncoders     ( 1, m_pcCuEncoder );
+  std::vector<TEncEntropy*>  entropyCoders  ( 1, m_pcEntropyCoder );
+  std::vector<TEncSbac*>     sbacCoders     ( 1, m_pcSbacCoder );
+  std::vector<TEncBinCABAC*> binCoders      ( 1, m_pcBinCABAC );
+  for ( Int i = 0; i < m_pcEncTop->getNumWppCoders(); i++ )
+  {
+    TEncWppCoder* pcWppCoder = m_pcEncTop->getWppCoder(i);
+    cuEncoders   .push_back( pcWppCoder->getCuEncoder() );
+    entropyCoders.push_back( pcWppCoder->getEntropyCoder() );
+    sbacCoders   .push_back( pcWppCoder->getSbacCoder() );
+    binCoders    .push_back( pcWppCoder->getBinCABAC() );
+  }
+
+  std::vector<Int>  freeCoders;
+  std::vector<Int>  rangeCoder( numRanges, 0 );
+  std::vector<UInt> rangeBinsCoded( numRanges, 0 );
+  std::vector<UInt> rangeSubstreamSize( numRanges, 0 );
+  std::mutex        mutex;
+  for ( Int i = (Int)cuEncoders.size() - 1; i >= 0; i-- )
+  {
+    freeCoders.push_back( i );
+  }
+
+  m_pcEncTop->getWppThreadPool()->parallelFor( numRanges, [&]( Int range )
+  {
+    Int coderIdx;
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      coderIdx = freeCoders.back();
+      freeCoders.pop_back();
+    }
+    TEncEntropy*  pcEntropyCoder = entropyCoders[coderIdx];
+    TEncBinCABAC* pcBinCABAC     = binCoders[coderIdx];
+
+    // every tile starts with initialised contexts
+    sbacCoders[coderIdx]->init( (TEncBinIf*)pcBinCABAC );
+    pcEntropyCoder->setEntropyCoder( sbacCoders[coderIdx] );
+    pcEntropyCoder->resetEntropy( pcSlice );
+    pcBinCABAC->setBinCountingEnableFlag( true );
+    pcBinCABAC->setBinsCoded( 0 );
+
+    const UInt boundingCtuTsAddrOfRange = ctuTsAddrRanges[range + 1];
+    for ( UInt ctuTsAddr = ctuTsAddrRanges[range]; ctuTsAddr < boundingCtuTsAddrOfRange; ctuTsAddr++ )
+    {
+      const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
+      const UInt uiSubStrm = pcPic->getSubstreamForCtuAddr(ctuRsAddr, true, pcSlice);
+
+      pcEntropyCoder->setBitstream( &pcSubstreams[uiSubStrm] );
+      xEncodeSAOBlkParam( pcPic, pcEntropyCoder, ctuRsAddr );
+      cuEncoders[coderIdx]->encodeCtu( pcPic->getCtu( ctuRsAddr ) );
+
+      // terminate the sub-stream at the end of the tile or slice-segment
+      if ( ctuTsAddr + 1 == boundingCtuTsAddrOfRange )
+      {
+        pcEntropyCoder->encodeTerminatingBit(1);
+        pcEntropyCoder->encodeSliceFinish();
+        // Byte-alignment in slice_data() when new tile
+        pcSubstreams[uiSubStrm].writeByteAlignment();
+        rangeSubstreamSize[range] = (pcSubstreams[uiSubStrm].getNumberOfWrittenBits() >> 3) + pcSubstreams[uiSubStrm].countStartCodeEmulations();
+      }
+    }
+    rangeBinsCoded[range] = pcBinCABAC->getBinsCoded();
+    rangeCoder    [range] = coderIdx;
+
+    std::lock_guard<std::mutex> lock( mutex );
+    freeCoders.push_back( coderIdx );
+  } );
+
+  // write sub-stream sizes, all but the last one
+  UInt numBinsCoded = 0;
+  for ( Int range = 0; range < numRanges; range++ )
+  {
+    if ( range + 1 < numRanges )
+    {
+      pcSlice->addSubstreamSize( rangeSubstreamSize[range] );
+    }
+    numBinsCoded += rangeBinsCoded[range];
+  }
+  m_pcBinCABAC->setBinsCoded( numBinsCoded );
+
+  m_pcEntropyCoder->setEntropyCoder( m_pcSbacCoder );
+  if ( rangeCoder[numRanges - 1] != 0 )
+  {
+    m_pcSbacCoder->loadContexts( sbacCoders[rangeCoder[numRanges - 1]] );
+  }
+}
+#endif
+
 Void TEncSlice::calculateBoundingCtuTsAddrForSlice(UInt &startCtuTSAddrSlice, UInt &boundingCtuTSAddrSlice, Bool &haveReachedTileBoundary,
                                                    TComPic* pcPic, const Int sliceMode, const Int sliceArgument)
 {
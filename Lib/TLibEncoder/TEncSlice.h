@@ -46,6 +46,10 @@
 #include "TEncCu.h"
 #include "WeightPredAnalysis.h"
 #include "TEncRateCtrl.h"
+#if WPP_PARALLEL_ENCODING
+#include "TLibCommon/TComThreadPool.h"
+#include "TEncWppCoder.h"
+#endif
 
 //! \ingroup TLibEncoder
 //! \{
@@ -98,9 +102,28 @@ private:
   TEncSbac                m_lastSliceSegmentEndContextState;    ///< context storage for state at the end of the previous slice-segment (used for dependent slices only).
   TEncSbac                m_entropyCodingSyncContextState;      ///< context storate for state of contexts at the wavefront/WPP/entropy-coding-sync second CTU of tile-row
   SliceType               m_encCABACTableIdx;
+#if WPP_PARALLEL_ENCODING
+  TEncTop*                m_pcEncTop;                           ///< encoder class, owns the coders of the wavefront threads
+  TEncSbac*               m_pcWppRowContextStates;              ///< context state after the second CTU of each CTU row
+  UInt                    m_uiNumWppRows;                       ///< number of entries of m_pcWppRowContextStates
+#endif
+#if FRAME_PARALLEL_ENCODING
+  Bool                    m_bFrameThread;                       ///< slice encoder of a frame thread, does not use the wavefront threads
+#endif
 
   Void     setUpLambda(TComSlice* slice, const Double dLambda, Int iQP);
   Void     calculateBoundingCtuTsAddrForSlice(UInt &startCtuTSAddrSlice, UInt &boundingCtuTSAddrSlice, Bool &haveReachedTileBoundary, TComPic* pcPic, const Int sliceMode, const Int sliceArgument);
+  Void     xEncodeSAOBlkParam ( TComPic* pcPic, TEncEntropy* pcEntropyCoder, const UInt ctuRsAddr );
+#if WPP_PARALLEL_ENCODING
+  Bool     xUseWppThreads     ( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr );
+#if TILE_PARALLEL_ENCODING
+  Bool     xUseTileThreads    ( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr );
+  Void     xGetTileCtuRanges  ( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr, std::vector<UInt>& ctuTsAddrRanges );
+  Void     xEncodeSliceTiles  ( TComPic* pcPic, TComOutputBitstream* pcSubstreams, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr );
+#endif
+  Bool     xUseParallelCompress( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr );
+  Void     xCompressSliceParallel( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr, const Bool bFastDeltaQP );
+#endif
 
 public:
   TEncSlice();
@@ -109,6 +132,9 @@ public:
   Void    create              ( Int iWidth, Int iHeight, ChromaFormat chromaFormat, UInt iMaxCUWidth, UInt iMaxCUHeight, UChar uhTotalDepth );
   Void    destroy             ();
   Void    init                ( TEncTop* pcEncTop );
+#if FRAME_PARALLEL_ENCODING
+  Void    init                ( TEncTop* pcEncTop, TEncWppCoder* pcFrameCoder );
+#endif
 
   /// preparation of slice encoding (reference marking, QP and lambda)
   Void    initEncSlice        ( TComPic*  pcPic, const Int pocLast, const Int pocCurr,
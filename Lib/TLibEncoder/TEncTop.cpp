@@ -153,6 +153,26 @@ Void TEncTop::destroy ()
   m_cLoopFilter.        destroy();
   m_cRateCtrl.          destroy();
   m_cSearch.            destroy();
+#if WPP_PARALLEL_ENCODING
+  m_cWppThreadPool.     destroy();
+  for ( Int i = 0; i < (Int)m_wppCoders.size(); i++ )
+  {
+    m_wppCoders[i]->destroy();
+    delete m_wppCoders[i];
+  }
+  m_wppCoders.clear();
+#if FRAME_PARALLEL_ENCODING
+  for ( Int i = 0; i < (Int)m_frameCoders.size(); i++ )
+  {
+    m_frameSliceEncoders[i]->destroy();
+    delete m_frameSliceEncoders[i];
+    m_frameCoders[i]->destroy();
+    delete m_frameCoders[i];
+  }
+  m_frameSliceEncoders.clear();
+  m_frameCoders.clear();
+#endif
+#endif
   Int iDepth;
   for ( iDepth = 0; iDepth < m_maxTotalCUDepth+1; iDepth++ )
   {
@@ -225,6 +245,9 @@ Void TEncTop::init(Bool isFieldCoding)
   m_iMaxRefPicNum = 0;
 
   xInitScalingLists();
+#if WPP_PARALLEL_ENCODING
+  xInitWppCoders();
+#endif
 }
 
 Void TEncTop::xInitScalingLists()
@@ -288,6 +311,100 @@ Void TEncTop::xInitScalingLists()
   }
 }
 
+#if WPP_PARALLEL_ENCODING
+Void TEncTop::xInitWppCoders()
+{
+  Int numThreads = m_entropyCodingSyncEnabledFlag ? m_iWaveFrontThreads : 1;
+#if TILE_PARALLEL_ENCODING
+  if ( m_iNumColumnsMinus1 > 0 || m_iNumRowsMinus1 > 0 )
+  {
+    numThreads = std::max( numThreads, m_iTileThreads );
+  }
+#endif
+#if FRAME_PARALLEL_ENCODING
+  const Int numPoolThreads = std::max( numThreads, m_iFrameThreads );
+#else
+  const Int numPoolThreads = numThreads;
+#endif
+  if ( numPoolThreads <= 1 )
+  {
+    return;
+  }
+
+  m_cWppThreadPool.create( numPoolThreads );
+
+  // the encoding thread uses the encoder's own coders, every other thread gets a copy of them;
+  // the rows or tiles of a picture may run on all threads of the pool, which can be more than numThreads
+  for ( Int i = 1; numThreads > 1 && i < numPoolThreads; i++ )
+  {
+    m_wppCoders.push_back( xCreateWppCoder() );
+  }
+#if FRAME_PARALLEL_ENCODING
+  // likewise for the frame threads, which also need a slice encoder of their own
+  for ( Int i = 1; i < m_iFrameThreads; i++ )
+  {
+    TEncWppCoder* pcFrameCoder   = xCreateWppCoder();
+    TEncSlice*    pcSliceEncoder = new TEncSlice;
+    pcSliceEncoder->create( getSourceWidth(), getSourceHeight(), m_chromaFormatIDC, m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth );
+    pcSliceEncoder->init( this, pcFrameCoder );
+    m_frameCoders.push_back( pcFrameCoder );
+    m_frameSliceEncoders.push_back( pcSliceEncoder );
+  }
+#endif
+}
+
+/** create a copy of the encoder's CU level coders, initialised like them
+ */
+TEncWppCoder* TEncTop::xCreateWppCoder()
+{
+  const Int maxLog2TrDynamicRange[MAX_NUM_CHANNEL_TYPE] =
+  {
+      m_cSPS.getMaxLog2TrDynamicRange(CHANNEL_TYPE_LUMA),
+      m_cSPS.getMaxLog2TrDynamicRange(CHANNEL_TYPE_CHROMA)
+  };
+
+  TEncWppCoder* pcWppCoder = new TEncWppCoder;
+  pcWppCoder->create( m_maxTotalCUDepth, m_maxCUWidth, m_maxCUHeight, m_chromaFormatIDC );
+  pcWppCoder->getRdCost()->setCostMode( m_costMode );
+
+  TComTrQuant* pcTrQuant = pcWppCoder->getTrQuant();
+  pcTrQuant->init( 1 << m_uiQuadtreeTULog2MaxSize,
+                   m_useRDOQ,
+                   m_useRDOQTS,
+#if T0196_SELECTIVE_RDOQ
+                   m_useSelectiveRDOQ,
+#endif
+                   true
+                  ,m_useTransformSkipFast
+#if ADAPTIVE_QP_SELECTION
+                  ,m_bUseAdaptQpSelect
+#endif
+                  );
+#if ADAPTIVE_QP_SELECTION
+  if (m_bUseAdaptQpSelect)
+  {
+    pcTrQuant->initSliceQpDelta();
+  }
+#endif
+  if ( getUseScalingListId() == SCALING_LIST_OFF )
+  {
+    pcTrQuant->setFlatScalingList( maxLog2TrDynamicRange, m_cSPS.getBitDepths() );
+    pcTrQuant->setUseScalingList( false );
+  }
+  else
+  {
+    pcTrQuant->setScalingList( &(m_cSPS.getScalingList()), maxLog2TrDynamicRange, m_cSPS.getBitDepths() );
+    pcTrQuant->setUseScalingList( true );
+  }
+
+  pcWppCoder->getPredSearch()->init( this, pcTrQuant, m_iSearchRange, m_bipredSearchRange, m_motionEstimationSearchMethod, m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth,
+                                     pcWppCoder->getEntropyCoder(), pcWppCoder->getRdCost(), pcWppCoder->getRDSbacCoder(), pcWppCoder->getRDGoOnSbacCoder() );
+  pcWppCoder->getCuEncoder()->init( this, pcWppCoder->getPredSearch(), pcTrQuant, pcWppCoder->getRdCost(),
+                                    pcWppCoder->getEntropyCoder(), pcWppCoder->getRDSbacCoder(), pcWppCoder->getRDGoOnSbacCoder() );
+  return pcWppCoder;
+}
+#endif
+
 // ====================================================================================================================
 // Public member functions
 // ====================================================================================================================
@@ -57,6 +57,10 @@
 #include "TEncSampleAdaptiveOffset.h"
 #include "TEncPreanalyzer.h"
 #include "TEncRateCtrl.h"
+#if WPP_PARALLEL_ENCODING
+#include "TLibCommon/TComThreadPool.h"
+#include "TEncWppCoder.h"
+#endif
 #if SVIDEO_EXT && SVIDEO_VIEWPORT_PSNR
 #include "TLib360/TViewPortPSNR.h"
 #endif
@@ -113,6 +117,14 @@ private:
   TEncPreanalyzer         m_cPreanalyzer;                 ///< image characteristics analyzer for TM5-step3-like adaptive QP
 
   TEncRateCtrl            m_cRateCtrl;                    ///< Rate control class
+#if WPP_PARALLEL_ENCODING
+  TComThreadPool          m_cWppThreadPool;               ///< threads coding the CTU rows of a wavefront slice, the tiles of a slice or independent pictures
+  std::vector<TEncWppCoder*> m_wppCoders;                 ///< coders of the wavefront threads besides the encoder's own ones
+#if FRAME_PARALLEL_ENCODING
+  std::vector<TEncWppCoder*> m_frameCoders;               ///< coders of the frame threads besides the encoder's own ones
+  std::vector<TEncSlice*> m_frameSliceEncoders;           ///< slice encoders using m_frameCoders
+#endif
+#endif
 #if SVIDEO_EXT && SVIDEO_VIEWPORT_PSNR
   TViewPortPSNR           m_cViewPortPSNR;
 #endif
@@ -123,6 +135,10 @@ protected:
   Void  xInitSPS          ();                             ///< initialize SPS from encoder options
   Void  xInitPPS          ();                             ///< initialize PPS from encoder options
   Void  xInitScalingLists ();                             ///< initialize scaling lists
+#if WPP_PARALLEL_ENCODING
+  Void  xInitWppCoders    ();                             ///< create the coders of the wavefront and frame threads
+  TEncWppCoder* xCreateWppCoder();                        ///< create a copy of the CU level coders
+#endif
   Void  xInitHrdParameters();                             ///< initialize HRD parameters
 
   Void  xInitPPSforTiles  ();
@@ -159,6 +175,15 @@ public:
   TEncSbac***             getRDSbacCoder        () { return  m_pppcRDSbacCoder;       }
   TEncSbac*               getRDGoOnSbacCoder    () { return  &m_cRDGoOnSbacCoder;     }
   TEncRateCtrl*           getRateCtrl           () { return &m_cRateCtrl;             }
+#if WPP_PARALLEL_ENCODING
+  TComThreadPool*         getWppThreadPool      () { return &m_cWppThreadPool;        }
+  Int                     getNumWppCoders       () const { return (Int)m_wppCoders.size(); }
+  TEncWppCoder*           getWppCoder           ( Int i ) { return m_wppCoders[i];   }
+#if FRAME_PARALLEL_ENCODING
+  Int                     getNumFrameSliceEncoders() const { return (Int)m_frameSliceEncoders.size(); }
+  TEncSlice*              getFrameSliceEncoder  ( Int i ) { return m_frameSliceEncoders[i]; }
+#endif
+#endif
   Void selectReferencePictureSet(TComSlice* slice, Int POCCurr, Int GOPid );
   Int getReferencePictureSetIdxForSOP(Int POCCurr, Int GOPid );
   // -------------------------------------------------------------------------------------------------------------------
@@ -183,6 +208,9 @@ public:
   Void initSphericalPSNR(SVideoInfo& sRefVideoInfo, SVideoInfo& sRecVideoInfo, InputGeoParam *pInGeoParam, TVideoIOYuv& yuvInputFile, Int iInputWidth, Int iInputHeight);
   Void xCalculateViewPortPSNR( TComPic* pcPic, Double* pdPSNR) { if(m_cViewPortPSNR.isEnabled()) m_cViewPortPSNR.xCalculatePSNR(pcPic, pdPSNR); }
   Void printViewPortMetricsSummary() { m_cViewPortPSNR.printSummary(m_uiNumAllPicCoded); }
+#if SVIDEO_ASYNC_METRICS || SVIDEO_VIEWPORT_PSNR_MT
+  TViewPortPSNR* getViewPortPSNR() { return &m_cViewPortPSNR; }
+#endif
 #endif
 
 };
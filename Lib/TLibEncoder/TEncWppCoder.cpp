@@ -0,0 +1,121 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2016, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncWppCoder.cpp
+    \brief    CTU coding tools of one wavefront thread
+*/
+
+#include "TEncWppCoder.h"
+
+#if WPP_PARALLEL_ENCODING
+
+//! \ingroup TLibEncoder
+//! \{
+
+TEncWppCoder::TEncWppCoder()
+: m_uiNumDepths      (0)
+, m_pppcRDSbacCoder  (NULL)
+, m_pppcBinCoderCABAC(NULL)
+{
+  m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
+}
+
+TEncWppCoder::~TEncWppCoder()
+{
+  destroy();
+}
+
+Void TEncWppCoder::create( UInt maxTotalCUDepth, UInt maxCUWidth, UInt maxCUHeight, ChromaFormat chromaFormat )
+{
+  m_cCuEncoder.create( maxTotalCUDepth, maxCUWidth, maxCUHeight, chromaFormat );
+
+  m_uiNumDepths     = maxTotalCUDepth+1;
+  m_pppcRDSbacCoder = new TEncSbac** [m_uiNumDepths];
+#if FAST_BIT_EST
+  m_pppcBinCoderCABAC = new TEncBinCABACCounter** [m_uiNumDepths];
+#else
+  m_pppcBinCoderCABAC = new TEncBinCABAC** [m_uiNumDepths];
+#endif
+
+  for ( UInt uiDepth = 0; uiDepth < m_uiNumDepths; uiDepth++ )
+  {
+    m_pppcRDSbacCoder[uiDepth] = new TEncSbac* [CI_NUM];
+#if FAST_BIT_EST
+    m_pppcBinCoderCABAC[uiDepth] = new TEncBinCABACCounter* [CI_NUM];
+#else
+    m_pppcBinCoderCABAC[uiDepth] = new TEncBinCABAC* [CI_NUM];
+#endif
+
+    for ( Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++ )
+    {
+      m_pppcRDSbacCoder[uiDepth][iCIIdx] = new TEncSbac;
+#if FAST_BIT_EST
+      m_pppcBinCoderCABAC[uiDepth][iCIIdx] = new TEncBinCABACCounter;
+#else
+      m_pppcBinCoderCABAC[uiDepth][iCIIdx] = new TEncBinCABAC;
+#endif
+      m_pppcRDSbacCoder[uiDepth][iCIIdx]->init( m_pppcBinCoderCABAC[uiDepth][iCIIdx] );
+    }
+  }
+}
+
+Void TEncWppCoder::destroy()
+{
+  if ( m_pppcRDSbacCoder == NULL )
+  {
+    return;
+  }
+
+  m_cCuEncoder.destroy();
+
+  for ( UInt uiDepth = 0; uiDepth < m_uiNumDepths; uiDepth++ )
+  {
+    for ( Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++ )
+    {
+      delete m_pppcRDSbacCoder[uiDepth][iCIIdx];
+      delete m_pppcBinCoderCABAC[uiDepth][iCIIdx];
+    }
+    delete [] m_pppcRDSbacCoder[uiDepth];
+    delete [] m_pppcBinCoderCABAC[uiDepth];
+  }
+  delete [] m_pppcRDSbacCoder;
+  delete [] m_pppcBinCoderCABAC;
+
+  m_pppcRDSbacCoder   = NULL;
+  m_pppcBinCoderCABAC = NULL;
+  m_uiNumDepths       = 0;
+}
+
+//! \}
+
+#endif // WPP_PARALLEL_ENCODING
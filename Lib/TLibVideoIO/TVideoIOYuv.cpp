@@ -45,6 +45,10 @@
 
 #include "TLibCommon/TComRom.h"
 #include "TVideoIOYuv.h"
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER && !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -101,6 +105,41 @@ copyPlane(const TComPicYuv &src, const ComponentID srcPlane, TComPicYuv &dest, c
 // Public member functions
 // ====================================================================================================================
 
+#if SVIDEO_EXT && (SVIDEO_MMAP_YUV_READER || SVIDEO_FUSED_YUV_WRITE)
+TVideoIOYuv::TVideoIOYuv()
+#if SVIDEO_MMAP_YUV_READER
+  : m_bMemoryMapped(false)
+  , m_bReadAhead(false)
+  , m_iMapFd(-1)
+  , m_pMapBase(NULL)
+  , m_iMapSize(0)
+  , m_iMapPos(0)
+  , m_bMapEof(false)
+#endif
+#if SVIDEO_FUSED_YUV_WRITE
+#if SVIDEO_MMAP_YUV_READER
+  , m_bAsyncWrite(false)
+#else
+  : m_bAsyncWrite(false)
+#endif
+  , m_bFlushPending(false)
+  , m_bFlushStop(false)
+  , m_bFlushError(false)
+#endif
+{
+}
+
+TVideoIOYuv::~TVideoIOYuv()
+{
+#if SVIDEO_FUSED_YUV_WRITE
+  stopFlushThread();
+#endif
+#if SVIDEO_MMAP_YUV_READER
+  unmapFile();
+#endif
+}
+#endif
+
 /**
  * Open file for reading/writing Y'CbCr frames.
  *
@@ -149,6 +188,13 @@ Void TVideoIOYuv::open( const std::string &fileName, Bool bWriteMode, const Int
       printf("\nfailed to write reconstructed YUV file\n");
       exit(0);
     }
+#if SVIDEO_EXT && SVIDEO_FUSED_YUV_WRITE
+    m_bFlushPending = m_bFlushStop = m_bFlushError = false;
+    if(m_bAsyncWrite)
+    {
+      m_cFlushThread = std::thread(&TVideoIOYuv::flushLoop, this);
+    }
+#endif
   }
   else
   {
@@ -159,6 +205,12 @@ Void TVideoIOYuv::open( const std::string &fileName, Bool bWriteMode, const Int
       printf("\nfailed to open Input YUV file\n");
       exit(0);
     }
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER
+    if(m_bMemoryMapped && !mapFile(fileName))
+    {
+      printf("\nWARNING: cannot memory map %s, reading it as a stream\n", fileName.c_str());
+    }
+#endif
   }
 
   return;
@@ -166,19 +218,188 @@ Void TVideoIOYuv::open( const std::string &fileName, Bool bWriteMode, const Int
 
 Void TVideoIOYuv::close()
 {
+#if SVIDEO_EXT && SVIDEO_FUSED_YUV_WRITE
+  stopFlushThread();
+#endif
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER
+  unmapFile();
+#endif
   m_cHandle.close();
 }
 
 Bool TVideoIOYuv::isEof()
 {
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER
+  if(m_pMapBase)
+  {
+    return m_bMapEof;
+  }
+#endif
   return m_cHandle.eof();
 }
 
 Bool TVideoIOYuv::isFail()
 {
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER
+  if(m_pMapBase)
+  {
+    return m_bMapEof;
+  }
+#endif
   return m_cHandle.fail();
 }
 
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER
+/**
+ * Map the whole file read-only; regular non-empty files only, pipes and
+ * devices keep using the stream.
+ */
+Bool TVideoIOYuv::mapFile(const std::string &fileName)
+{
+#if !defined(_WIN32)
+  Int fd = ::open(fileName.c_str(), O_RDONLY);
+  if(fd < 0)
+  {
+    return false;
+  }
+  struct stat st;
+  if(fstat(fd, &st) || !S_ISREG(st.st_mode) || st.st_size <= 0)
+  {
+    ::close(fd);
+    return false;
+  }
+  Void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if(p == MAP_FAILED)
+  {
+    ::close(fd);
+    return false;
+  }
+  if(m_bReadAhead)
+  {
+    madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+  }
+  m_iMapFd = fd;
+  m_pMapBase = (UChar*)p;
+  m_iMapSize = st.st_size;
+  m_iMapPos = 0;
+  m_bMapEof = false;
+  return true;
+#else
+  return false;
+#endif
+}
+
+Void TVideoIOYuv::unmapFile()
+{
+#if !defined(_WIN32)
+  if(m_pMapBase)
+  {
+    munmap(m_pMapBase, (size_t)m_iMapSize);
+    ::close(m_iMapFd);
+  }
+#endif
+  m_pMapBase = NULL;
+  m_iMapFd = -1;
+  m_iMapSize = m_iMapPos = 0;
+  m_bMapEof = false;
+}
+
+Int64 TVideoIOYuv::getFrameSize(UInt width, UInt height, ChromaFormat format)
+{
+  Int64 frameSize = 0;
+  UInt wordsize=1; // default to 8-bit, unless a channel with more than 8-bits is detected.
+  for (UInt component = 0; component < getNumberValidComponents(format); component++)
+  {
+    ComponentID compID=ComponentID(component);
+    frameSize += (width >> getComponentScaleX(compID, format)) * (height >> getComponentScaleY(compID, format));
+    if (m_fileBitdepth[toChannelType(compID)] > 8)
+    {
+      wordsize=2;
+    }
+  }
+  return frameSize*wordsize;
+}
+
+/**
+ * Position the input at frame frameIdx, counted from the start of the file.
+ * O(1) for mapped and seekable files.
+ */
+Bool TVideoIOYuv::seekFrame(UInt frameIdx, UInt width, UInt height, ChromaFormat format)
+{
+  const Int64 offset = getFrameSize(width, height, format) * frameIdx;
+  if(m_pMapBase)
+  {
+    m_iMapPos = offset;
+    m_bMapEof = offset > m_iMapSize;
+    return !m_bMapEof;
+  }
+  m_cHandle.clear();
+  return !!m_cHandle.seekg(streamoff(offset), ios::beg);
+}
+#endif
+
+#if SVIDEO_EXT && SVIDEO_FUSED_YUV_WRITE
+Void TVideoIOYuv::flushLoop()
+{
+  std::unique_lock<std::mutex> lock(m_cFlushMutex);
+  while(true)
+  {
+    m_cFlushCond.wait(lock, [this]{ return m_bFlushPending || m_bFlushStop; });
+    if(!m_bFlushPending)
+    {
+      break;
+    }
+    //m_cFlushBuf is not touched by write() while a flush is pending;
+    lock.unlock();
+    m_cHandle.write(reinterpret_cast<const TChar*>(m_cFlushBuf.data()), m_cFlushBuf.size());
+    const Bool bError = m_cHandle.eof() || m_cHandle.fail();
+    lock.lock();
+    m_bFlushError |= bError;
+    m_bFlushPending = false;
+    m_cFlushCond.notify_all();
+  }
+}
+
+Bool TVideoIOYuv::flushFrame()
+{
+  if(!m_cFlushThread.joinable())
+  {
+    m_cHandle.write(reinterpret_cast<const TChar*>(m_cPackBuf.data()), m_cPackBuf.size());
+    return !(m_cHandle.eof() || m_cHandle.fail());
+  }
+  std::unique_lock<std::mutex> lock(m_cFlushMutex);
+  m_cFlushCond.wait(lock, [this]{ return !m_bFlushPending; });
+  m_cPackBuf.swap(m_cFlushBuf);
+  m_bFlushPending = true;
+  m_cFlushCond.notify_all();
+  //a failure is reported by the write following it;
+  return !m_bFlushError;
+}
+
+Void TVideoIOYuv::waitFlush()
+{
+  std::unique_lock<std::mutex> lock(m_cFlushMutex);
+  m_cFlushCond.wait(lock, [this]{ return !m_bFlushPending; });
+}
+
+Void TVideoIOYuv::stopFlushThread()
+{
+  if(m_cFlushThread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_cFlushMutex);
+      m_bFlushStop = true;
+    }
+    m_cFlushCond.notify_all();
+    m_cFlushThread.join();
+    if(m_bFlushError)
+    {
+      printf("\nWARNING: writing the output YUV file failed\n");
+    }
+  }
+}
+#endif
+
 /**
  * Skip numFrames in input.
  *
@@ -196,6 +417,14 @@ Void TVideoIOYuv::skipFrames(UInt numFrames, UInt width, UInt height, ChromaForm
     return;
   }
 
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER
+  const streamoff frameSize = getFrameSize(width, height, format);
+  if(m_pMapBase)
+  {
+    m_iMapPos = std::max<Int64>(m_iMapPos + frameSize * numFrames, 0);
+    return;
+  }
+#else
   //------------------
   //set the frame size according to the chroma format
   streamoff frameSize = 0;
@@ -211,6 +440,7 @@ Void TVideoIOYuv::skipFrames(UInt numFrames, UInt width, UInt height, ChromaForm
   }
   frameSize *= wordsize;
   //------------------
+#endif
 
   const streamoff offset = frameSize * numFrames;
 
@@ -387,6 +617,137 @@ static Bool readPlane(Pel* dst,
   return true;
 }
 
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER
+//unpack one line of 8-bit or 16-bit little-endian samples, scaled up by shiftbits; plain loops the compiler vectorises;
+static inline Void unpackLine8(Pel* dst, const UChar* src, UInt width, Int shiftbits)
+{
+  for (UInt x = 0; x < width; x++)
+  {
+    dst[x] = Pel(src[x]) << shiftbits;
+  }
+}
+
+static inline Void unpackLine16(Pel* dst, const UChar* src, UInt width, Int shiftbits)
+{
+  for (UInt x = 0; x < width; x++)
+  {
+    dst[x] = Pel(src[2*x] | (src[2*x+1]<<8)) << shiftbits;
+  }
+}
+
+/**
+ * Same as readPlane(), but reads the file data in place from a memory map
+ * and applies a positive bit-depth shift while unpacking.
+ *
+ * @param src          file data of the plane, advanced past the plane on return
+ * @param shiftbits    bit-depth increase applied to the samples, 0 if none
+ * @return file bytes of the plane
+ */
+static Int64 readPlaneMapped(Pel* dst,
+                             const UChar* src,
+                             Bool is16bit,
+                             UInt stride444,
+                             UInt width444,
+                             UInt height444,
+                             UInt pad_x444,
+                             UInt pad_y444,
+                             const ComponentID compID,
+                             const ChromaFormat destFormat,
+                             const ChromaFormat fileFormat,
+                             const UInt fileBitDepth,
+                             Int shiftbits)
+{
+  const UInt csx_file =getComponentScaleX(compID, fileFormat);
+  const UInt csy_file =getComponentScaleY(compID, fileFormat);
+  const UInt csx_dest =getComponentScaleX(compID, destFormat);
+  const UInt csy_dest =getComponentScaleY(compID, destFormat);
+
+  const UInt width_dest       = width444 >>csx_dest;
+  const UInt height_dest      = height444>>csy_dest;
+  const UInt pad_x_dest       = pad_x444>>csx_dest;
+  const UInt pad_y_dest       = pad_y444>>csy_dest;
+  const UInt stride_dest      = stride444>>csx_dest;
+
+  const UInt full_width_dest  = width_dest+pad_x_dest;
+  const UInt full_height_dest = height_dest+pad_y_dest;
+
+  const UInt stride_file      = (width444 * (is16bit ? 2 : 1)) >> csx_file;
+  const Int64 plane_size_file = (compID!=COMPONENT_Y && fileFormat==CHROMA_400)? 0 : Int64(stride_file)*(height444>>csy_file);
+
+  if (compID!=COMPONENT_Y && (fileFormat==CHROMA_400 || destFormat==CHROMA_400))
+  {
+    if (destFormat!=CHROMA_400)
+    {
+      // set chrominance data to mid-range: (1<<(fileBitDepth-1))
+      const Pel value=Pel(1<<(fileBitDepth-1)) << shiftbits;
+      for (UInt y = 0; y < full_height_dest; y++, dst+=stride_dest)
+      {
+        for (UInt x = 0; x < full_width_dest; x++)
+        {
+          dst[x] = value;
+        }
+      }
+    }
+    return plane_size_file;
+  }
+
+  const UInt mask_y_dest=(1<<csy_dest)-1;
+  for(UInt y444=0; y444<height444; y444++)
+  {
+    if ((y444&mask_y_dest)==0)
+    {
+      const UChar *buf = src + Int64(y444>>csy_file)*stride_file;
+      if (csx_file == csx_dest)
+      {
+        if (!is16bit)
+        {
+          unpackLine8(dst, buf, width_dest, shiftbits);
+        }
+        else
+        {
+          unpackLine16(dst, buf, width_dest, shiftbits);
+        }
+      }
+      else if (csx_file < csx_dest)
+      {
+        // eg file is 444, dest is 422.
+        const UInt sx=csx_dest-csx_file;
+        for (UInt x = 0; x < width_dest; x++)
+        {
+          dst[x] = (!is16bit? Pel(buf[x<<sx]) : Pel(buf[(x<<sx)*2+0] | (buf[(x<<sx)*2+1]<<8))) << shiftbits;
+        }
+      }
+      else
+      {
+        // eg file is 422, dest is 444.
+        const UInt sx=csx_file-csx_dest;
+        for (UInt x = 0; x < width_dest; x++)
+        {
+          dst[x] = (!is16bit? Pel(buf[x>>sx]) : Pel(buf[(x>>sx)*2+0] | (buf[(x>>sx)*2+1]<<8))) << shiftbits;
+        }
+      }
+
+      // process right hand side padding
+      const Pel val=dst[width_dest-1];
+      for (UInt x = width_dest; x < full_width_dest; x++)
+      {
+        dst[x] = val;
+      }
+
+      dst += stride_dest;
+    }
+  }
+
+  // process lower padding
+  for (UInt y = height_dest; y < full_height_dest; y++, dst+=stride_dest)
+  {
+    memcpy(dst, dst - stride_dest, full_width_dest*sizeof(Pel));
+  }
+  return plane_size_file;
+}
+#endif
+
+#if !(SVIDEO_EXT && SVIDEO_FUSED_YUV_WRITE)
 /**
  * Write an image plane (width444*height444 pixels) from src into output stream fd.
  *
@@ -524,6 +885,145 @@ static Bool writePlane(ostream& fd, Pel* src, Bool is16bit,
   }
   return true;
 }
+#endif
+
+#if SVIDEO_EXT && SVIDEO_FUSED_YUV_WRITE
+//pack one line of samples as 8-bit or 16-bit little-endian words; op is inlined so the loops vectorise;
+template<typename T>
+static inline Void packLine(UChar* dst, const Pel* src, UInt width, Bool is16bit, T op)
+{
+  if (!is16bit)
+  {
+    for (UInt x = 0; x < width; x++)
+    {
+      dst[x] = (UChar)op(src[x]);
+    }
+  }
+  else
+  {
+    for (UInt x = 0; x < width; x++)
+    {
+      const Pel val = op(src[x]);
+      dst[2*x  ] = (val>>0) & 0xff;
+      dst[2*x+1] = (val>>8) & 0xff;
+    }
+  }
+}
+
+static Void packLine(UChar* dst, const Pel* src, UInt width, Bool is16bit, Int shiftbits, Pel minval, Pel maxval)
+{
+  if (shiftbits > 0)
+  {
+    packLine(dst, src, width, is16bit, [shiftbits](Pel v) { return Pel(v << shiftbits); });
+  }
+  else if (shiftbits < 0)
+  {
+    const Int shift = -shiftbits;
+    const Pel rounding = 1 << (shift-1);
+    packLine(dst, src, width, is16bit, [shift, rounding, minval, maxval](Pel v) { return Clip3(minval, maxval, Pel((v + rounding) >> shift)); });
+  }
+  else
+  {
+    packLine(dst, src, width, is16bit, [](Pel v) { return v; });
+  }
+}
+
+//file bytes written by packPlane() for a plane;
+static Int64 getPackedPlaneSize(Bool is16bit, UInt width444, UInt height444, const ComponentID compID, const ChromaFormat fileFormat)
+{
+  if (compID!=COMPONENT_Y && fileFormat==CHROMA_400)
+  {
+    return 0;
+  }
+  const UInt stride_file = (width444 * (is16bit ? 2 : 1)) >> getComponentScaleX(compID, fileFormat);
+  return Int64(stride_file) * (height444 >> getComponentScaleY(compID, fileFormat));
+}
+
+/**
+ * Same output as scalePlane() followed by writePlane(), but packs into a
+ * memory buffer with the bit-depth scaling applied per line.
+ *
+ * @param dst          destination buffer of getPackedPlaneSize() bytes
+ * @param shiftbits    bit-depth change as for scalePlane()
+ * @param minval       minimum clipping value when dividing.
+ * @param maxval       maximum clipping value when dividing.
+ * @return bytes written to dst
+ */
+static Int64 packPlane(UChar* dst, const Pel* src, Bool is16bit,
+                       UInt stride444,
+                       UInt width444, UInt height444,
+                       const ComponentID compID,
+                       const ChromaFormat srcFormat,
+                       const ChromaFormat fileFormat,
+                       const UInt fileBitDepth,
+                       Int shiftbits, Pel minval, Pel maxval)
+{
+  const UInt csx_file =getComponentScaleX(compID, fileFormat);
+  const UInt csy_file =getComponentScaleY(compID, fileFormat);
+  const UInt csx_src  =getComponentScaleX(compID, srcFormat);
+  const UInt csy_src  =getComponentScaleY(compID, srcFormat);
+
+  const UInt stride_src      = stride444>>csx_src;
+
+  const UInt stride_file      = (width444 * (is16bit ? 2 : 1)) >> csx_file;
+  const UInt width_file       = width444 >>csx_file;
+  const UInt height_file      = height444>>csy_file;
+  const UChar *start          = dst;
+
+  if (compID!=COMPONENT_Y && (fileFormat==CHROMA_400 || srcFormat==CHROMA_400))
+  {
+    if (fileFormat!=CHROMA_400)
+    {
+      const Pel value=Pel(1<<(fileBitDepth-1));
+      std::vector<Pel> line(width_file, value);
+      for(UInt y=0; y< height_file; y++, dst+=stride_file)
+      {
+        packLine(dst, &line[0], width_file, is16bit, 0, minval, maxval);
+      }
+    }
+    return dst-start;
+  }
+
+  std::vector<Pel> line(csx_file != csx_src ? width_file : 0);
+  const UInt mask_y_file=(1<<csy_file)-1;
+  const UInt mask_y_src =(1<<csy_src )-1;
+  for(UInt y444=0; y444<height444; y444++)
+  {
+    if ((y444&mask_y_file)==0)
+    {
+      const Pel *pLine = src;
+      if (csx_file < csx_src)
+      {
+        // eg file is 444, source is 422.
+        const UInt sx=csx_src-csx_file;
+        for (UInt x = 0; x < width_file; x++)
+        {
+          line[x] = src[x>>sx];
+        }
+        pLine = &line[0];
+      }
+      else if (csx_file > csx_src)
+      {
+        // eg file is 422, src is 444.
+        const UInt sx=csx_file-csx_src;
+        for (UInt x = 0; x < width_file; x++)
+        {
+          line[x] = src[x<<sx];
+        }
+        pLine = &line[0];
+      }
+      packLine(dst, pLine, width_file, is16bit, shiftbits, minval, maxval);
+      dst += stride_file;
+    }
+
+    if ((y444&mask_y_src)==0)
+    {
+      src += stride_src;
+    }
+  }
+  return dst-start;
+}
+#endif
 
 static Bool writeField(ostream& fd, Pel* top, Pel* bottom, Bool is16bit,
                        UInt stride444,
@@ -711,6 +1211,19 @@ Bool TVideoIOYuv::read ( TComPicYuv*  pPicYuvUser, TComPicYuv* pPicYuvTrueOrg, c
   const UInt width444       = width_full444 - pad_h444;
   const UInt height444      = height_full444 - pad_v444;
 
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER
+  Int64 frameSize = 0;
+  if(m_pMapBase)
+  {
+    frameSize = getFrameSize(width444, height444, format);
+    if(m_iMapPos + frameSize > m_iMapSize)
+    {
+      m_iMapPos = m_iMapSize;
+      m_bMapEof = true;
+      return false;
+    }
+  }
+#endif
   for(UInt comp=0; comp<MAX_NUM_COMPONENT; comp++)
   {
     const ComponentID compID = ComponentID(comp);
@@ -722,6 +1235,21 @@ Bool TVideoIOYuv::read ( TComPicYuv*  pPicYuvUser, TComPicYuv* pPicYuvTrueOrg, c
     const Pel minval = b709Compliance? ((   1 << (desired_bitdepth - 8))   ) : 0;
     const Pel maxval = b709Compliance? ((0xff << (desired_bitdepth - 8)) -1) : (1 << desired_bitdepth) - 1;
 
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER
+    if(m_pMapBase)
+    {
+      //the bit-depth increase is fused into the unpacking, a decrease still needs rounding and clipping;
+      const Int iFusedShift = std::max(m_bitdepthShift[chType], 0);
+      m_iMapPos += readPlaneMapped(pPicYuv->getAddr(compID), m_pMapBase + m_iMapPos, is16bit, stride444, width444, height444, pad_h444, pad_v444, compID, pPicYuv->getChromaFormat(), format, m_fileBitdepth[chType], iFusedShift);
+      if (compID < pPicYuv->getNumberValidComponents() && m_bitdepthShift[chType] < 0)
+      {
+        const UInt csx=getComponentScaleX(compID, pPicYuv->getChromaFormat());
+        const UInt csy=getComponentScaleY(compID, pPicYuv->getChromaFormat());
+        scalePlane(pPicYuv->getAddr(compID), stride444>>csx, width_full444>>csx, height_full444>>csy, m_bitdepthShift[chType], minval, maxval);
+      }
+      continue;
+    }
+#endif
     if (! readPlane(pPicYuv->getAddr(compID), m_cHandle, is16bit, stride444, width444, height444, pad_h444, pad_v444, compID, pPicYuv->getChromaFormat(), format, m_fileBitdepth[chType]))
     {
       return false;
@@ -734,6 +1262,16 @@ Bool TVideoIOYuv::read ( TComPicYuv*  pPicYuvUser, TComPicYuv* pPicYuvTrueOrg, c
       scalePlane(pPicYuv->getAddr(compID), stride444>>csx, width_full444>>csx, height_full444>>csy, m_bitdepthShift[chType], minval, maxval);
     }
   }
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER && !defined(_WIN32)
+  if(m_pMapBase && m_bReadAhead && m_iMapPos < m_iMapSize)
+  {
+    //prefetch the next frame while this one is converted;
+    const Int64 iPage = sysconf(_SC_PAGESIZE);
+    const Int64 iStart = m_iMapPos & ~(iPage-1);
+    const Int64 iEnd = std::min(m_iMapPos + frameSize, m_iMapSize);
+    madvise(m_pMapBase + iStart, (size_t)(iEnd - iStart), MADV_WILLNEED);
+  }
+#endif
 #if SVIDEO_EXT
   if(pPicYuvUser)
     ColourSpaceConvert(*pPicYuvTrueOrg, *pPicYuvUser, ipcsc, true);
@@ -766,6 +1304,52 @@ Bool TVideoIOYuv::write( TComPicYuv* pPicYuvUser, const InputColourSpaceConversi
   }
   TComPicYuv *pPicYuv=(ipCSC==IPCOLOURSPACE_UNCHANGED) ? pPicYuvUser : &cPicYuvCSCd;
 
+#if SVIDEO_EXT && SVIDEO_FUSED_YUV_WRITE
+  Bool is16bit = false;
+  for(UInt ch=0; ch<MAX_NUM_CHANNEL_TYPE; ch++)
+  {
+    if (m_fileBitdepth[ch] > 8)
+    {
+      is16bit=true;
+    }
+  }
+  if (format>=NUM_CHROMA_FORMAT)
+  {
+    format=pPicYuv->getChromaFormat();
+  }
+
+  //scaling and packing of all planes into one buffer, written with a single call;
+  const Int  stride444 = pPicYuv->getStride(COMPONENT_Y);
+  const UInt width444  = pPicYuv->getWidth(COMPONENT_Y) - confLeft - confRight;
+  const UInt height444 = pPicYuv->getHeight(COMPONENT_Y) -  confTop  - confBottom;
+
+  if ((width444 == 0) || (height444 == 0))
+  {
+    printf ("\nWarning: writing %d x %d luma sample output picture!", width444, height444);
+  }
+
+  Int64 frameSize = 0;
+  for(UInt comp=0; comp<pPicYuv->getNumberValidComponents(); comp++)
+  {
+    frameSize += getPackedPlaneSize(is16bit, width444, height444, ComponentID(comp), format);
+  }
+  m_cPackBuf.resize((size_t)frameSize);
+
+  UChar *pDst = m_cPackBuf.data();
+  for(UInt comp=0; comp<pPicYuv->getNumberValidComponents(); comp++)
+  {
+    const ComponentID compID = ComponentID(comp);
+    const ChannelType ch=toChannelType(compID);
+    const Bool b709Compliance = bClipToRec709 && (-m_bitdepthShift[ch] < 0 && m_MSBExtendedBitDepth[ch] >= 8);     /* ITU-R BT.709 compliant clipping for converting say 10b to 8b */
+    const Pel minval = b709Compliance? ((   1 << (m_MSBExtendedBitDepth[ch] - 8))   ) : 0;
+    const Pel maxval = b709Compliance? ((0xff << (m_MSBExtendedBitDepth[ch] - 8)) -1) : (1 << m_MSBExtendedBitDepth[ch]) - 1;
+    const UInt csx = pPicYuv->getComponentScaleX(compID);
+    const UInt csy = pPicYuv->getComponentScaleY(compID);
+    const Int planeOffset =  (confLeft>>csx) + (confTop>>csy) * pPicYuv->getStride(compID);
+    pDst += packPlane(pDst, pPicYuv->getAddr(compID) + planeOffset, is16bit, stride444, width444, height444, compID, pPicYuv->getChromaFormat(), format, m_fileBitdepth[ch], -m_bitdepthShift[ch], minval, maxval);
+  }
+  const Bool retval = flushFrame();
+#else
   // compute actual YUV frame size excluding padding size
   Bool is16bit = false;
   Bool nonZeroBitDepthShift=false;
@@ -838,6 +1422,7 @@ Bool TVideoIOYuv::write( TComPicYuv* pPicYuvUser, const InputColourSpaceConversi
     dstPicYuv->destroy();
     delete dstPicYuv;
   }
+#endif
 
   cPicYuvCSCd.destroy();
 
@@ -858,6 +1443,13 @@ Bool TVideoIOYuv::write( TComPicYuv* pPicYuvUserTop, TComPicYuv* pPicYuvUserBott
   }
   TComPicYuv *pPicYuvTop    = (ipCSC==IPCOLOURSPACE_UNCHANGED) ? pPicYuvUserTop    : &cPicYuvTopCSCd;
   TComPicYuv *pPicYuvBottom = (ipCSC==IPCOLOURSPACE_UNCHANGED) ? pPicYuvUserBottom : &cPicYuvBottomCSCd;
+#if SVIDEO_EXT && SVIDEO_FUSED_YUV_WRITE
+  //fields are written directly, after any frame still queued for the flush thread;
+  if(m_cFlushThread.joinable())
+  {
+    waitFlush();
+  }
+#endif
 
   Bool is16bit = false;
   Bool nonZeroBitDepthShift=false;
@@ -46,6 +46,12 @@
 #if SVIDEO_EXT
 #include "TLib360/TGeometry.h"
 #endif
+#if SVIDEO_EXT && SVIDEO_FUSED_YUV_WRITE
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
 
 using namespace std;
 
@@ -61,10 +67,53 @@ private:
   Int       m_fileBitdepth[MAX_NUM_CHANNEL_TYPE]; ///< bitdepth of input/output video file
   Int       m_MSBExtendedBitDepth[MAX_NUM_CHANNEL_TYPE];  ///< bitdepth after addition of MSBs (with value 0)
   Int       m_bitdepthShift[MAX_NUM_CHANNEL_TYPE];  ///< number of bits to increase or decrease image by before/after write/read
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER
+  Bool      m_bMemoryMapped;                                ///< memory map requested for files opened in read mode
+  Bool      m_bReadAhead;                                   ///< advise the kernel to read ahead the next frame
+  Int       m_iMapFd;                                       ///< descriptor of the mapped file, -1: not mapped
+  UChar*    m_pMapBase;                                     ///< start of the mapped file
+  Int64     m_iMapSize;                                     ///< size of the mapped file in bytes
+  Int64     m_iMapPos;                                      ///< current read position in the mapped file
+  Bool      m_bMapEof;                                      ///< a read went past the end of the mapped file
+
+  Int64 getFrameSize(UInt width, UInt height, ChromaFormat format);
+  Bool  mapFile(const std::string &fileName);
+  Void  unmapFile();
+#endif
+#if SVIDEO_EXT && SVIDEO_FUSED_YUV_WRITE
+  Bool                    m_bAsyncWrite;                    ///< frames are flushed to the file on a background thread
+  std::vector<UChar>      m_cPackBuf;                       ///< frame being packed by write()
+  std::vector<UChar>      m_cFlushBuf;                      ///< frame being written by the flush thread
+  Bool                    m_bFlushPending;                  ///< m_cFlushBuf holds a frame not yet written
+  Bool                    m_bFlushStop;
+  Bool                    m_bFlushError;                    ///< a background write failed
+  std::thread             m_cFlushThread;
+  std::mutex              m_cFlushMutex;
+  std::condition_variable m_cFlushCond;
+
+  Void  flushLoop();
+  Bool  flushFrame();                                       ///< write m_cPackBuf, directly or through the flush thread
+  Void  waitFlush();                                        ///< wait until the pending frame is in the file
+  Void  stopFlushThread();
+#endif
 
 public:
+#if SVIDEO_EXT && (SVIDEO_MMAP_YUV_READER || SVIDEO_FUSED_YUV_WRITE)
+  TVideoIOYuv();
+  virtual ~TVideoIOYuv();
+#else
   TVideoIOYuv()           {}
   virtual ~TVideoIOYuv()  {}
+#endif
+
+#if SVIDEO_EXT && SVIDEO_MMAP_YUV_READER
+  Void  setMemoryMapped(Bool bEnable, Bool bReadAhead=false) { m_bMemoryMapped = bEnable; m_bReadAhead = bReadAhead; } ///< call before open(); falls back to the stream if the file cannot be mapped
+  Bool  isMemoryMapped() const { return m_pMapBase != NULL; }
+  Bool  seekFrame(UInt frameIdx, UInt width, UInt height, ChromaFormat format); ///< random access to a frame of a file opened in read mode
+#endif
+#if SVIDEO_EXT && SVIDEO_FUSED_YUV_WRITE
+  Void  setAsyncWrite(Bool b) { m_bAsyncWrite = b; }        ///< call before open() in write mode; write() then returns once the frame is packed
+#endif
 
   Void  open  ( const std::string &fileName, Bool bWriteMode, const Int fileBitDepth[MAX_NUM_CHANNEL_TYPE], const Int MSBExtendedBitDepth[MAX_NUM_CHANNEL_TYPE], const Int internalBitDepth[MAX_NUM_CHANNEL_TYPE] ); ///< open or create file
   Void  close ();                                           ///< close file